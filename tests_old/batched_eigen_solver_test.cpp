@@ -0,0 +1,249 @@
+#include "batched_eigen_solver_test.hpp"
+
+#include <vmmlib/batched_eigen_solver.hpp>
+#include <vmmlib/jacobi_solver.hpp>
+#include <vmmlib/lapack_svd.hpp>
+#include <vmmlib/lapack_sym_eigs.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+double
+test_value( size_t i, size_t seed )
+{
+    return double( ( i * 7919 + seed * 104729 ) % 2001 ) / 1000.0 - 1.0;
+}
+
+template< size_t N, typename T, size_t L >
+bool
+test_sym_eigs( double tolerance )
+{
+    // count is not a multiple of L, every 7th matrix nearly diagonal
+    const size_t count = 3 * L + 5;
+    std::vector< matrix< N, N, T > > a( count ), eigvectors( count );
+    std::vector< vector< N, T > > eigvalues( count );
+    for( size_t m = 0; m < count; ++m )
+    {
+        for( size_t i = 0; i < N; ++i )
+        {
+            for( size_t j = 0; j <= i; ++j )
+            {
+                T value = T( test_value( m * N * N + i * N + j, N ) );
+                if ( m % 7 == 0 && i != j )
+                    value *= T( 1e-9 );
+                a[ m ]( i, j ) = a[ m ]( j, i ) = value;
+            }
+        }
+    }
+
+    batched_sym_eigs< N, T, L >::compute( &a[ 0 ], &eigvectors[ 0 ], &eigvalues[ 0 ], count );
+
+    lapack_sym_eigs< N, double > lapack_eigs;
+    lapack_eigs.p.abstol = 0; // full accuracy
+    matrix< N, N, double > a_double, eigvectors_check;
+    vector< N, double > eigvalues_check;
+    bool ok = true;
+    for( size_t m = 0; m < count; ++m )
+    {
+        a_double.cast_from( a[ m ] );
+        lapack_eigs.compute_all( a_double, eigvectors_check, eigvalues_check );
+        for( size_t k = 0; k < N; ++k )
+        {
+            ok = ok && std::fabs( eigvalues[ m ]( k ) - eigvalues_check( k ) ) < tolerance;
+            // A * v = lambda * v, |v| = 1
+            double norm = 0;
+            for( size_t i = 0; i < N; ++i )
+            {
+                double av = 0;
+                for( size_t j = 0; j < N; ++j )
+                    av += a[ m ]( i, j ) * eigvectors[ m ]( j, k );
+                ok = ok && std::fabs( av - eigvalues[ m ]( k ) * eigvectors[ m ]( i, k ) ) < tolerance;
+                norm += eigvectors[ m ]( i, k ) * eigvectors[ m ]( i, k );
+            }
+            ok = ok && std::fabs( norm - 1.0 ) < tolerance;
+        }
+    }
+    return ok;
+}
+
+template< typename T, size_t L >
+bool
+test_svd3( double tolerance, bool rotations )
+{
+    const size_t count = 5 * L + 3;
+    std::vector< matrix< 3, 3, T > > a( count ), u( count ), v( count );
+    std::vector< vector< 3, T > > sigma( count );
+    for( size_t m = 0; m < count; ++m )
+    {
+        for( size_t i = 0; i < 9; ++i )
+            a[ m ].array[ i ] = T( test_value( m * 9 + i, 3 ) );
+    }
+    // rank deficient and zero matrices
+    a[ 1 ].set_row( 2, a[ 1 ].get_row( 0 ) );
+    a[ 2 ].zero();
+
+    if ( rotations )
+        batched_svd3< T, L >::compute_rotations( &a[ 0 ], &u[ 0 ], &sigma[ 0 ], &v[ 0 ], count );
+    else
+        batched_svd3< T, L >::compute( &a[ 0 ], &u[ 0 ], &sigma[ 0 ], &v[ 0 ], count );
+
+    lapack_svd< 3, 3, double > lapack_svd_;
+    matrix< 3, 3, double > a_double;
+    vector< 3, double > sigma_check;
+    bool ok = true;
+    for( size_t m = 0; m < count; ++m )
+    {
+        a_double.cast_from( a[ m ] );
+        lapack_svd_.compute( a_double, sigma_check );
+        for( size_t k = 0; k < 3; ++k )
+        {
+            ok = ok && std::fabs( std::fabs( sigma[ m ]( k ) ) - sigma_check( k ) ) < tolerance;
+            if ( ! rotations )
+                ok = ok && sigma[ m ]( k ) >= 0;
+        }
+
+        // U * diag( sigma ) * V^T = A, U and V orthogonal
+        for( size_t i = 0; i < 3; ++i )
+        {
+            for( size_t j = 0; j < 3; ++j )
+            {
+                double usv = 0, utu = 0, vtv = 0;
+                for( size_t k = 0; k < 3; ++k )
+                {
+                    usv += u[ m ]( i, k ) * sigma[ m ]( k ) * v[ m ]( j, k );
+                    utu += u[ m ]( k, i ) * u[ m ]( k, j );
+                    vtv += v[ m ]( k, i ) * v[ m ]( k, j );
+                }
+                ok = ok && std::fabs( usv - a[ m ]( i, j ) ) < tolerance;
+                ok = ok && std::fabs( utu - ( i == j ? 1.0 : 0.0 ) ) < tolerance;
+                ok = ok && std::fabs( vtv - ( i == j ? 1.0 : 0.0 ) ) < tolerance;
+            }
+        }
+        if ( rotations )
+        {
+            ok = ok && std::fabs( u[ m ].det() - 1.0 ) < tolerance;
+            ok = ok && std::fabs( v[ m ].det() - 1.0 ) < tolerance;
+        }
+    }
+    return ok;
+}
+
+template< typename T, size_t L >
+bool
+test_sym_eigs3( double tolerance, size_t n_refinement_sweeps )
+{
+    // random matrices and the hard cases of the closed form: multiple
+    // eigenvalues, planar and linear covariances, zero, badly scaled
+    const size_t count = 4 * L + 3;
+    std::vector< matrix< 3, 3, T > > a( count ), eigvectors( count );
+    std::vector< vector< 3, T > > eigvalues( count );
+    for( size_t m = 0; m < count; ++m )
+    {
+        for( size_t i = 0; i < 3; ++i )
+            for( size_t j = 0; j <= i; ++j )
+                a[ m ]( i, j ) = a[ m ]( j, i ) = T( test_value( m * 9 + i * 3 + j, 5 ) );
+    }
+    a[ 0 ] = matrix< 3, 3, T >::IDENTITY;
+    a[ 0 ] *= T( 2 );
+    a[ 1 ].zero();
+    for( size_t m = 2; m < 6; ++m )
+    {
+        // sum of outer products of 1 (line), 2 (plane) or 3 vectors
+        const vector< 3, T > x( T( 1 ), T( 2 ), T( -1 ));
+        const vector< 3, T > y( T( 0.5 ), T( -1 ), T( 3 ));
+        const vector< 3, T > z( T( -2 ), T( 1 ), T( 1 ));
+        for( size_t i = 0; i < 3; ++i )
+            for( size_t j = 0; j < 3; ++j )
+                a[ m ]( i, j ) = x( i ) * x( j ) + ( m > 2 ? y( i ) * y( j ) : T( 0 ))
+                               + ( m == 4 ? z( i ) * z( j ) : T( 0 ));
+    }
+    a[ 5 ] *= T( 1e20 );
+    for( size_t i = 0; i < 3; ++i )
+        for( size_t j = 0; j < i; ++j )
+            a[ 6 ]( i, j ) = a[ 6 ]( j, i ) *= T( 1e-9 );
+
+    batched_sym_eigs3< T, L >::compute( &a[ 0 ], &eigvectors[ 0 ], &eigvalues[ 0 ], count,
+                                        n_refinement_sweeps );
+
+    bool ok = true;
+    for( size_t m = 0; m < count; ++m )
+    {
+        // reference: solve_jacobi_3x3 in double, sorted
+        matrix< 3, 3, double > a_check, v_check;
+        vector< 3, double > w_check;
+        size_t rotations;
+        a_check.cast_from( a[ m ] );
+        solve_jacobi_3x3( a_check, w_check, v_check, rotations );
+        std::sort( w_check.array, w_check.array + 3 );
+
+        double norm_a = 0;
+        for( size_t i = 0; i < 9; ++i )
+            norm_a = (std::max)( norm_a, std::fabs( double( a[ m ].array[ i ] )));
+        const double scale = norm_a > 0 ? norm_a : 1;
+
+        for( size_t k = 0; k < 3; ++k )
+        {
+            ok = ok && std::fabs( eigvalues[ m ]( k ) - w_check( k ) ) < tolerance * scale;
+            // A * v = lambda * v, V orthogonal
+            for( size_t i = 0; i < 3; ++i )
+            {
+                double av = 0, vtv = 0;
+                for( size_t j = 0; j < 3; ++j )
+                {
+                    av += a[ m ]( i, j ) * eigvectors[ m ]( j, k );
+                    vtv += eigvectors[ m ]( j, i ) * eigvectors[ m ]( j, k );
+                }
+                ok = ok && std::fabs( av - eigvalues[ m ]( k ) * eigvectors[ m ]( i, k ) )
+                    < tolerance * scale;
+                ok = ok && std::fabs( vtv - ( i == k ? 1.0 : 0.0 ) ) < tolerance;
+            }
+        }
+    }
+    return ok;
+}
+
+} // anonymous namespace
+
+bool
+batched_eigen_solver_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    TEST((test_sym_eigs< 3, double, 4 >( 1e-12 )));
+    TEST((test_sym_eigs< 3, double, 8 >( 1e-12 )));
+    TEST((test_sym_eigs< 4, double, 8 >( 1e-12 )));
+    TEST((test_sym_eigs< 3, float, 16 >( 1e-5 )));
+    TEST((test_sym_eigs< 4, float, 8 >( 1e-5 )));
+    log( "batched symmetric eigen decomposition 3x3, 4x4 (Jacobi)", ok );
+
+    ok = true;
+    TEST((test_sym_eigs3< double, 4 >( 1e-12, 0 )));
+    TEST((test_sym_eigs3< double, 8 >( 1e-12, 0 )));
+    TEST((test_sym_eigs3< float, 8 >( 1e-5, 0 )));
+    // with refinement sweeps
+    TEST((test_sym_eigs3< double, 8 >( 1e-12, 1 )));
+    TEST((test_sym_eigs3< double, 8 >( 1e-12, 2 )));
+    log( "batched symmetric eigen decomposition 3x3 (closed form + Jacobi)", ok );
+
+    ok = true;
+    TEST((test_svd3< double, 4 >( 1e-12, false )));
+    TEST((test_svd3< double, 8 >( 1e-12, false )));
+    TEST((test_svd3< float, 16 >( 1e-5, false )));
+    log( "batched SVD 3x3 (quaternion Jacobi, Givens QR)", ok );
+
+    ok = true;
+    TEST((test_svd3< double, 8 >( 1e-12, true )));
+    TEST((test_svd3< float, 8 >( 1e-5, true )));
+    log( "batched SVD 3x3 with rotations U, V (polar decomposition)", ok );
+
+    return global_ok;
+}
+
+} // namespace vmml
@@ -0,0 +1,21 @@
+#ifndef __VMML__BATCHED_EIGEN_SOLVER_TEST__HPP__
+#define __VMML__BATCHED_EIGEN_SOLVER_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class batched_eigen_solver_test : public unit_test
+{
+public:
+    batched_eigen_solver_test() : unit_test( "batched 3x3/4x4 eigen and SVD solvers vs. lapack" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class batched_eigen_solver_test
+
+} // namespace vmml
+
+#endif
@@ -0,0 +1,115 @@
+#include "batched_gemm_perf_test.hpp"
+
+#include <vmmlib/batched_gemm.hpp>
+#include <vmmlib/matrix.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace vmml
+{
+
+void
+batched_gemm_perf_test::run()
+{
+    // scene graph: parent times local transforms
+    {
+        const size_t count = 200000;
+        std::vector< matrix< 4, 4, float > > parent( count ), local( count ), world( count );
+        for( size_t i = 0; i < count; ++i )
+            for( size_t k = 0; k < 16; ++k )
+            {
+                parent[ i ].array[ k ] = float( sin( double( i + k ) * 0.01 ));
+                local[ i ].array[ k ] = float( cos( double( i + k ) * 0.03 ));
+            }
+
+        // every round multiplies the previous result again, so that the
+        // rounds cannot be merged by the compiler
+        new_test( "200000 mat4f products, 10 rounds" );
+        start( "matrix::multiply" );
+        {
+            std::vector< matrix< 4, 4, float > > a( parent ), b( count );
+            for( size_t k = 0; k < 10; ++k )
+            {
+                for( size_t i = 0; i < count; ++i )
+                    b[ i ].multiply( a[ i ], local[ i ] );
+                a.swap( b );
+            }
+            world.swap( a );
+        }
+        stop();
+
+        start( "batched_gemm" );
+        {
+            std::vector< matrix< 4, 4, float > > a( parent );
+            for( size_t k = 0; k < 10; ++k )
+                batched_gemm< 4, 4, 4, float >::multiply( &a[ 0 ], &local[ 0 ], &a[ 0 ], count );
+            for( size_t i = 0; i < count; ++i )
+                if ( ! a[ i ].equals( world[ i ], 1e-3f ))
+                {
+                    std::cerr << "mat4f results differ" << std::endl;
+                    break;
+                }
+        }
+        stop();
+        compare();
+
+        new_test( "one parent times 200000 mat4f, 10 rounds" );
+        start( "matrix::multiply" );
+        {
+            std::vector< matrix< 4, 4, float > > a( local ), b( count );
+            for( size_t k = 0; k < 10; ++k )
+            {
+                for( size_t i = 0; i < count; ++i )
+                    b[ i ].multiply( parent[ 0 ], a[ i ] );
+                a.swap( b );
+            }
+        }
+        stop();
+
+        start( "batched_gemm" );
+        {
+            std::vector< matrix< 4, 4, float > > a( local );
+            for( size_t k = 0; k < 10; ++k )
+                batched_gemm< 4, 4, 4, float >::multiply( parent[ 0 ], &a[ 0 ], &a[ 0 ], count );
+        }
+        stop();
+        compare();
+    }
+
+    // slices of a tensor3 times a factor matrix
+    {
+        const size_t count = 2000;
+        std::vector< matrix< 16, 16, double > > u( 1 ), slice( count ), result( count );
+        for( size_t k = 0; k < 256; ++k )
+            u[ 0 ].array[ k ] = sin( double( k ) * 0.1 );
+        for( size_t i = 0; i < count; ++i )
+            for( size_t k = 0; k < 256; ++k )
+                slice[ i ].array[ k ] = cos( double( i * 256 + k ) * 0.001 );
+
+        new_test( "16 x 16 times 2000 16 x 16 double slices, 10 rounds" );
+        start( "matrix::multiply" );
+        {
+            std::vector< matrix< 16, 16, double > > a( slice );
+            for( size_t k = 0; k < 10; ++k )
+            {
+                for( size_t i = 0; i < count; ++i )
+                    result[ i ].multiply( u[ 0 ], a[ i ] );
+                a.swap( result );
+            }
+        }
+        stop();
+
+        start( "batched_gemm (blas)" );
+        {
+            std::vector< matrix< 16, 16, double > > a( slice );
+            for( size_t k = 0; k < 10; ++k )
+                batched_gemm< 16, 16, 16, double >::multiply( u[ 0 ], &a[ 0 ], &a[ 0 ], count );
+        }
+        stop();
+        compare();
+    }
+}
+
+} // namespace vmml
@@ -0,0 +1,241 @@
+#include "batched_gemm_test.hpp"
+
+#include <vmmlib/batched_gemm.hpp>
+#include <vmmlib/matrix.hpp>
+#include <cmath>
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+template< size_t M, size_t N, typename T >
+void
+fill( matrix< M, N, T >& m_, double seed_ )
+{
+    for( size_t i = 0; i < M * N; ++i )
+        m_.array[ i ] = T( sin( seed_ + 0.7 * double( i )));
+}
+
+} // anonymous namespace
+
+
+
+bool
+batched_gemm_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    {
+        // mat4f batch, the count is not a multiple of anything
+        typedef batched_gemm< 4, 4, 4, float > bgemm_t;
+        const size_t count = 37;
+        std::vector< matrix< 4, 4, float > > a( count ), b( count ), c( count ), check( count );
+        for( size_t i = 0; i < count; ++i )
+        {
+            fill( a[ i ], double( i ));
+            fill( b[ i ], 100.0 + double( i ));
+            check[ i ].multiply( a[ i ], b[ i ] );
+        }
+
+        bgemm_t::multiply( &a[ 0 ], &b[ 0 ], &c[ 0 ], count );
+        for( size_t i = 0; i < count; ++i )
+            TEST(c[ i ].equals( check[ i ], 1e-6f ));
+
+        // parent times the local transforms
+        for( size_t i = 0; i < count; ++i )
+            check[ i ].multiply( a[ 0 ], b[ i ] );
+        bgemm_t::multiply( a[ 0 ], &b[ 0 ], &c[ 0 ], count );
+        for( size_t i = 0; i < count; ++i )
+            TEST(c[ i ].equals( check[ i ], 1e-6f ));
+
+        for( size_t i = 0; i < count; ++i )
+            check[ i ].multiply( a[ i ], b[ 0 ] );
+        bgemm_t::multiply( &a[ 0 ], b[ 0 ], &c[ 0 ], count );
+        for( size_t i = 0; i < count; ++i )
+            TEST(c[ i ].equals( check[ i ], 1e-6f ));
+
+        // empty batch
+        c[ 0 ] = a[ 0 ];
+        bgemm_t::multiply( &a[ 0 ], &b[ 0 ], &c[ 0 ], 0 );
+        TEST(c[ 0 ] == a[ 0 ]);
+
+        log( "4x4 float: batch, broadcast left and right", ok );
+    }
+
+    {
+        // non-square, pointer arrays in reverse order, in place
+        ok = true;
+        typedef batched_gemm< 3, 2, 5, double > bgemm_t;
+        const size_t count = 11;
+        std::vector< matrix< 3, 2, double > > a( count );
+        std::vector< matrix< 2, 5, double > > b( count );
+        std::vector< matrix< 3, 5, double > > c( count ), check( count );
+        std::vector< const matrix< 3, 2, double >* > a_ptr( count );
+        std::vector< const matrix< 2, 5, double >* > b_ptr( count );
+        std::vector< matrix< 3, 5, double >* > c_ptr( count );
+        for( size_t i = 0; i < count; ++i )
+        {
+            fill( a[ i ], double( i ));
+            fill( b[ i ], -double( i ));
+        }
+        for( size_t i = 0; i < count; ++i )
+        {
+            a_ptr[ i ] = &a[ count - 1 - i ];
+            b_ptr[ i ] = &b[ i ];
+            c_ptr[ i ] = &c[ i ];
+            check[ i ].multiply( a[ count - 1 - i ], b[ i ] );
+        }
+        bgemm_t::multiply( &a_ptr[ 0 ], &b_ptr[ 0 ], &c_ptr[ 0 ], count );
+        for( size_t i = 0; i < count; ++i )
+            TEST(c[ i ].equals( check[ i ], 1e-14 ));
+
+        // A_i = A_i * R for a square right side
+        std::vector< matrix< 3, 3, double > > s( count ), s_check( count );
+        matrix< 3, 3, double > r;
+        fill( r, 0.5 );
+        for( size_t i = 0; i < count; ++i )
+        {
+            fill( s[ i ], double( i ));
+            s_check[ i ].multiply( s[ i ], r );
+        }
+        batched_gemm< 3, 3, 3, double >::multiply( &s[ 0 ], r, &s[ 0 ], count );
+        for( size_t i = 0; i < count; ++i )
+            TEST(s[ i ].equals( s_check[ i ], 1e-14 ));
+
+        log( "3x2 times 2x5 double: pointer arrays, in place", ok );
+    }
+
+    {
+        // raw strided arrays with padding between the matrices
+        ok = true;
+        const size_t count = 5;
+        const size_t stride = 20;
+        std::vector< float > a( count * stride, -1.0f ), b( count * stride, -2.0f );
+        std::vector< float > c( count * stride, 7.0f );
+        std::vector< matrix< 4, 4, float > > check( count );
+        for( size_t i = 0; i < count; ++i )
+        {
+            matrix< 4, 4, float > a_i, b_i;
+            fill( a_i, double( i ));
+            fill( b_i, 3.0 * double( i ));
+            for( size_t k = 0; k < 16; ++k )
+            {
+                a[ i * stride + k ] = a_i.array[ k ];
+                b[ i * stride + k ] = b_i.array[ k ];
+            }
+            check[ i ].multiply( a_i, b_i );
+        }
+        batched_gemm< 4, 4, 4, float >::multiply( &a[ 0 ], stride, &b[ 0 ], stride,
+                                                  &c[ 0 ], stride, count );
+        for( size_t i = 0; i < count; ++i )
+        {
+            matrix< 4, 4, float > c_i;
+            for( size_t k = 0; k < 16; ++k )
+                c_i.array[ k ] = c[ i * stride + k ];
+            TEST(c_i.equals( check[ i ], 1e-6f ));
+            // padding untouched
+            TEST(c[ i * stride + 16 ] == 7.0f && c[ i * stride + 19 ] == 7.0f);
+        }
+
+        log( "raw strided arrays", ok );
+    }
+
+    {
+        // products above BLAS_THRESHOLD go to blas, also in place; the
+        // batch is large enough to be split over threads
+        ok = true;
+        typedef batched_gemm< 8, 12, 10, double > bgemm_t;
+        TEST(8 * 12 * 10 >= bgemm_t::BLAS_THRESHOLD);
+        const size_t count = 70;
+        TEST(count * 8 * 12 * 10 >= bgemm_t::PARALLEL_THRESHOLD);
+        std::vector< matrix< 8, 12, double > > a( count );
+        std::vector< matrix< 12, 10, double > > b( count );
+        std::vector< matrix< 8, 10, double > > c( count ), check( count );
+        for( size_t i = 0; i < count; ++i )
+        {
+            fill( a[ i ], double( i ));
+            fill( b[ i ], 10.0 + double( i ));
+            check[ i ].multiply( a[ i ], b[ i ] );
+        }
+        bgemm_t::multiply( &a[ 0 ], &b[ 0 ], &c[ 0 ], count );
+        for( size_t i = 0; i < count; ++i )
+            TEST(c[ i ].equals( check[ i ], 1e-12 ));
+
+        std::vector< matrix< 8, 8, double > > s( count ), s_check( count );
+        for( size_t i = 0; i < count; ++i )
+        {
+            fill( s[ i ], double( i ));
+            s_check[ i ].multiply( s[ 0 ], s[ i ] );
+        }
+        const matrix< 8, 8, double > s0 = s[ 0 ];
+        batched_gemm< 8, 8, 8, double >::multiply( s0, &s[ 0 ], &s[ 0 ], count );
+        for( size_t i = 0; i < count; ++i )
+            TEST(s[ i ].equals( s_check[ i ], 1e-12 ));
+
+        // the broadcast matrix must not be one of the results
+        bool rejected = false;
+        try
+        {
+            batched_gemm< 8, 8, 8, double >::multiply( s[ 0 ], &s[ 0 ], &s[ 0 ], count );
+        }
+        catch(...)
+        {
+            rejected = true;
+        }
+        TEST(rejected);
+        rejected = false;
+        try
+        {
+            batched_gemm< 8, 8, 8, double >::multiply( &s[ 0 ], s[ count - 1 ], &s[ 0 ], count );
+        }
+        catch(...)
+        {
+            rejected = true;
+        }
+        TEST(rejected);
+        for( size_t i = 0; i < count; ++i )
+            TEST(s[ i ].equals( s_check[ i ], 1e-12 ));
+
+        log( "blas path, 8x12 times 12x10 and 8x8 in place", ok );
+    }
+
+    {
+        // interleaved lane group
+        ok = true;
+        const size_t L = 4;
+        typedef batched_gemm< 2, 3, 4, float, L > bgemm_t;
+        matrix< 2, 3, float > a[ L ];
+        matrix< 3, 4, float > b[ L ];
+        float a_lanes[ 2 ][ 3 ][ L ], b_lanes[ 3 ][ 4 ][ L ], c_lanes[ 2 ][ 4 ][ L ];
+        for( size_t l = 0; l < L; ++l )
+        {
+            fill( a[ l ], double( l ));
+            fill( b[ l ], 5.0 * double( l ));
+            for( size_t i = 0; i < 2; ++i )
+                for( size_t k = 0; k < 3; ++k )
+                    a_lanes[ i ][ k ][ l ] = a[ l ]( i, k );
+            for( size_t k = 0; k < 3; ++k )
+                for( size_t j = 0; j < 4; ++j )
+                    b_lanes[ k ][ j ][ l ] = b[ l ]( k, j );
+        }
+        bgemm_t::multiply_lanes( a_lanes, b_lanes, c_lanes );
+        for( size_t l = 0; l < L; ++l )
+        {
+            matrix< 2, 4, float > check;
+            check.multiply( a[ l ], b[ l ] );
+            for( size_t i = 0; i < 2; ++i )
+                for( size_t j = 0; j < 4; ++j )
+                    TEST(std::fabs( c_lanes[ i ][ j ][ l ] - check( i, j )) < 1e-6f);
+        }
+
+        log( "lane group in SoA layout", ok );
+    }
+
+    return global_ok;
+}
+
+} // namespace vmml
@@ -0,0 +1,21 @@
+#ifndef __VMML__BATCHED_GEMM_TEST__HPP__
+#define __VMML__BATCHED_GEMM_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class batched_gemm_test : public unit_test
+{
+public:
+    batched_gemm_test() : unit_test( "batched matrix-matrix products" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class batched_gemm_test
+
+} // namespace vmml
+
+#endif
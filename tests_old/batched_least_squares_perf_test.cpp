@@ -0,0 +1,171 @@
+#include "batched_least_squares_perf_test.hpp"
+
+#include <vmmlib/jacobi_solver.hpp>
+#include <vmmlib/batched_least_squares.hpp>
+#include <vmmlib/cholesky_solver.hpp>
+
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+double
+test_value( size_t i, size_t seed )
+{
+    return double( ( i * 7919 + seed * 104729 ) % 2001 ) / 1000.0 - 1.0;
+}
+
+// count neighborhoods of n_points points each, close to a plane
+void
+make_points( std::vector< vector< 3, double > >& points, size_t count, size_t n_points )
+{
+    points.resize( count * n_points );
+    for( size_t i = 0; i < points.size(); ++i )
+    {
+        const double x = test_value( i, 1 ), y = test_value( i * 13, 2 );
+        points[ i ] = vector< 3, double >( x, y, 0.3 * x - 0.2 * y + 0.1 * x * y );
+    }
+}
+
+} // anonymous namespace
+
+
+void
+batched_least_squares_perf_test::run()
+{
+    const size_t count = 100000;
+    const size_t n_points = 16;
+    std::vector< vector< 3, double > > points;
+    make_points( points, count, n_points );
+
+    std::vector< vector< 3, double > > centroid( count ), normal( count );
+    std::vector< double > curvature( count );
+
+    new_test( "plane fits, 100000 x 16 points" );
+    start( "covariance + jacobi per problem" );
+    for( size_t p = 0; p < count; ++p )
+    {
+        vector< 3, double > mean( 0.0 );
+        for( size_t s = 0; s < n_points; ++s )
+            mean += points[ p * n_points + s ];
+        mean /= double( n_points );
+
+        matrix< 3, 3, double > cov, v;
+        cov.zero();
+        for( size_t s = 0; s < n_points; ++s )
+        {
+            const vector< 3, double > d = points[ p * n_points + s ] - mean;
+            for( size_t i = 0; i < 3; ++i )
+                for( size_t j = 0; j < 3; ++j )
+                    cov( i, j ) += d( i ) * d( j );
+        }
+        vector< 3, double > eigvalues;
+        size_t rotations;
+        solve_jacobi_3x3( cov, eigvalues, v, rotations );
+        size_t smallest = 0;
+        for( size_t i = 1; i < 3; ++i )
+            smallest = eigvalues( i ) < eigvalues( smallest ) ? i : smallest;
+        centroid[ p ] = mean;
+        normal[ p ] = v.get_column( smallest );
+        curvature[ p ] = eigvalues( smallest ) / ( eigvalues( 0 ) + eigvalues( 1 ) + eigvalues( 2 ));
+    }
+    stop();
+
+    start( "batched_plane_fit" );
+    {
+        batched_plane_fit< double > planes( count );
+        for( size_t p = 0; p < count; ++p )
+            planes.add( p, &points[ p * n_points ], n_points );
+        planes.compute( &centroid[ 0 ], &normal[ 0 ], &curvature[ 0 ] );
+    }
+    stop();
+    compare();
+
+
+    // covariances of the neighborhoods
+    std::vector< matrix< 3, 3, double > > covariances( count ), eigvectors( count );
+    std::vector< vector< 3, double > > eigvalues( count );
+    for( size_t p = 0; p < count; ++p )
+    {
+        matrix< 3, 3, double >& cov = covariances[ p ];
+        cov.zero();
+        for( size_t s = 0; s < n_points; ++s )
+        {
+            const vector< 3, double > d = points[ p * n_points + s ] - centroid[ p ];
+            for( size_t i = 0; i < 3; ++i )
+                for( size_t j = 0; j < 3; ++j )
+                    cov( i, j ) += d( i ) * d( j );
+        }
+    }
+
+    new_test( "3x3 symmetric eigen decompositions, 100000 covariances" );
+    start( "solve_jacobi_3x3 per problem" );
+    for( size_t p = 0; p < count; ++p )
+    {
+        matrix< 3, 3, double > cov = covariances[ p ];
+        size_t rotations;
+        solve_jacobi_3x3( cov, eigvalues[ p ], eigvectors[ p ], rotations );
+    }
+    stop();
+
+    start( "batched_sym_eigs< 3 >, 4 sweeps" );
+    batched_sym_eigs< 3, double >::compute( &covariances[ 0 ], &eigvectors[ 0 ],
+                                            &eigvalues[ 0 ], count, 4 );
+    stop();
+    compare();
+
+    start( "batched_sym_eigs3, 1 refinement sweep" );
+    batched_sym_eigs3< double >::compute( &covariances[ 0 ], &eigvectors[ 0 ],
+                                          &eigvalues[ 0 ], count, 1 );
+    stop();
+    compare();
+
+    start( "batched_sym_eigs3, closed form only" );
+    batched_sym_eigs3< double >::compute( &covariances[ 0 ], &eigvectors[ 0 ],
+                                          &eigvalues[ 0 ], count, 0 );
+    stop();
+    compare();
+
+
+    std::vector< vector< 6, double > > coefficients( count );
+
+    new_test( "quadric fits, 100000 x 16 points" );
+    start( "normal equations + cholesky per problem" );
+    for( size_t p = 0; p < count; ++p )
+    {
+        matrix< 6, 6, double > ata;
+        vector< 6, double > atb( 0.0 );
+        ata.zero();
+        for( size_t s = 0; s < n_points; ++s )
+        {
+            const vector< 3, double >& q = points[ p * n_points + s ];
+            const double row[ 6 ] = { q.x() * q.x(), q.x() * q.y(), q.y() * q.y(), q.x(), q.y(), 1 };
+            for( size_t i = 0; i < 6; ++i )
+            {
+                atb( i ) += row[ i ] * q.z();
+                for( size_t j = 0; j < 6; ++j )
+                    ata( i, j ) += row[ i ] * row[ j ];
+            }
+        }
+        cholesky_solver< 6, double > solver;
+        solver.factorize( ata );
+        solver.solve( atb, coefficients[ p ] );
+    }
+    stop();
+
+    start( "batched_quadric_fit" );
+    {
+        batched_quadric_fit< double > quadrics( count );
+        for( size_t p = 0; p < count; ++p )
+            quadrics.add( p, &points[ p * n_points ], n_points );
+        quadrics.compute( &coefficients[ 0 ] );
+    }
+    stop();
+    compare();
+}
+
+
+} // namespace vmml
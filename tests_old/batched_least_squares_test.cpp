@@ -0,0 +1,268 @@
+#include "batched_least_squares_test.hpp"
+
+#include <vmmlib/batched_least_squares.hpp>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+double
+test_value( size_t i, size_t seed )
+{
+    return double( ( i * 7919 + seed * 104729 ) % 2001 ) / 1000.0 - 1.0;
+}
+
+// polynomial fits y = x0 + x1 t + x2 t^2 with known coefficients; every 5th
+// problem has all samples at the same t and cannot be solved
+template< typename T, size_t L >
+bool
+test_polynomial_fit( double tolerance )
+{
+    const size_t count = 3 * L + 5;
+    const size_t n_samples = 9;
+    batched_least_squares< 3, T, L > solver( count );
+    std::vector< vector< 3, T > > expected( count ), x( count );
+
+    for( size_t p = 0; p < count; ++p )
+    {
+        for( size_t i = 0; i < 3; ++i )
+            expected[ p ]( i ) = T( test_value( p * 3 + i, 1 ));
+        for( size_t s = 0; s < n_samples; ++s )
+        {
+            const T t = p % 5 == 0 ? T( 0.5 ) : T( test_value( p * n_samples + s, 2 ) * 2 );
+            const T row[ 3 ] = { 1, t, t * t };
+            const T y = expected[ p ]( 0 ) + expected[ p ]( 1 ) * t + expected[ p ]( 2 ) * t * t;
+            solver.add( p, row, y, T( 1 + s % 3 ));
+        }
+    }
+
+    bool solved[ 3 * L + 5 ];
+    std::vector< T > residual( count );
+    const size_t n_solved = solver.solve( &x[ 0 ], solved, &residual[ 0 ] );
+
+    bool ok = n_solved == count - ( count + 4 ) / 5;
+    for( size_t p = 0; p < count; ++p )
+    {
+        if ( p % 5 == 0 )
+        {
+            ok = ok && ! solved[ p ] && x[ p ] == vector< 3, T >( T( 0 ));
+            continue;
+        }
+        ok = ok && solved[ p ] && residual[ p ] < tolerance;
+        for( size_t i = 0; i < 3; ++i )
+            ok = ok && std::fabs( double( x[ p ]( i ) - expected[ p ]( i ))) < tolerance;
+    }
+
+    // a ridge makes the degenerate problems solvable
+    const size_t n_ridge = solver.solve( &x[ 0 ], solved, 0, T( 1e-3 ));
+    ok = ok && n_ridge == count;
+    return ok;
+}
+
+} // anonymous namespace
+
+bool
+batched_least_squares_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    TEST(( test_polynomial_fit< double, 4 >( 1e-10 )));
+    TEST(( test_polynomial_fit< double, 8 >( 1e-10 )));
+    TEST(( test_polynomial_fit< float, 8 >( 1e-3 )));
+    log( "batched polynomial least squares, singular problems detected", ok );
+
+
+    // noisy line fit y = 1 + 2 t with residuals +-0.1: residual is the
+    // weighted sum of squares
+    ok = true;
+    {
+        batched_least_squares< 2, double > solver( 1 );
+        const double t[] = { 0, 1, 2, 3 };
+        const double noise[] = { 0.1, -0.1, -0.1, 0.1 };
+        for( size_t s = 0; s < 4; ++s )
+            solver.add( 0, vector< 2, double >( 1, t[ s ] ), 1 + 2 * t[ s ] + noise[ s ] );
+        vector< 2, double > x;
+        double residual;
+        TEST( solver.solve( &x, 0, &residual ) == 1 );
+        TEST( x.equals( vector< 2, double >( 1, 2 ), 1e-12 ));
+        TEST( std::fabs( residual - 0.04 ) < 1e-12 );
+
+        solver.clear();
+        TEST( solver.solve( &x ) == 0 );
+    }
+    log( "residual of the weighted least squares fit", ok );
+
+
+    // points on planes far from the origin, normals and zero curvature
+    ok = true;
+    {
+        const size_t count = 21;
+        batched_plane_fit< float > planes( count );
+        std::vector< vector< 3, float > > normals( count );
+        std::vector< vector< 3, double > > centroids( count );
+        for( size_t p = 0; p < count; ++p )
+        {
+            vector< 3, double > n( test_value( p, 3 ), test_value( p, 4 ), test_value( p, 5 ) + 2 );
+            n.normalize();
+            normals[ p ] = vector< 3, float >( float( n.x() ), float( n.y() ), float( n.z() ));
+
+            // two directions in the plane
+            vector< 3, double > u = n.cross( vector< 3, double >( 1, 0, 0 ));
+            u.normalize();
+            const vector< 3, double > v = n.cross( u );
+            const vector< 3, double > center( 1000 + p, -2000, 500 );
+            vector< 3, double > sum( 0.0 );
+            for( size_t s = 0; s < 12; ++s )
+            {
+                const vector< 3, double > q = center
+                    + u * test_value( p * 12 + s, 6 ) + v * test_value( ( p * 12 + s ) * 13, 7 );
+                planes.add( p, vector< 3, float >( float( q.x() ), float( q.y() ), float( q.z() )));
+                sum += q;
+            }
+            centroids[ p ] = sum / 12.0;
+        }
+
+        std::vector< vector< 3, float > > centroid( count ), normal( count );
+        std::vector< float > curvature( count );
+        planes.compute( &centroid[ 0 ], &normal[ 0 ], &curvature[ 0 ] );
+        for( size_t p = 0; p < count; ++p )
+        {
+            TEST( std::fabs( std::fabs( normal[ p ].dot( normals[ p ] )) - 1.0f ) < 1e-4f );
+            TEST( curvature[ p ] < 1e-5f );
+            for( size_t i = 0; i < 3; ++i )
+                TEST( std::fabs( centroid[ p ]( i ) - centroids[ p ]( i )) < 1e-3 );
+        }
+
+        // points on a sphere cap are not flat
+        batched_plane_fit< double > cap( 2 );
+        for( size_t s = 0; s < 50; ++s )
+        {
+            const double x = test_value( s, 8 ) * 0.5, y = test_value( s * 13, 9 ) * 0.5;
+            cap.add( 0, vector< 3, double >( x, y, std::sqrt( 1 - x * x - y * y )));
+        }
+        vector< 3, double > c[ 2 ], n[ 2 ];
+        double k[ 2 ];
+        cap.compute( c, n, k );
+        TEST( std::fabs( std::fabs( n[ 0 ].z() ) - 1 ) < 1e-2 );
+        TEST( k[ 0 ] > 1e-3 );
+        TEST(( n[ 1 ] == vector< 3, double >( 0.0 ) && k[ 1 ] == 0 ));
+    }
+    log( "batched plane fit: normals, centroids and surface variation", ok );
+
+
+    // quadric height fields and their curvatures
+    ok = true;
+    {
+        const size_t count = 11;
+        batched_quadric_fit< double, 4 > quadrics( count );
+        std::vector< vector< 6, double > > expected( count ), coefficients( count );
+        for( size_t p = 0; p < count; ++p )
+        {
+            for( size_t i = 0; i < 6; ++i )
+                expected[ p ]( i ) = test_value( p * 6 + i, 10 );
+            for( size_t s = 0; s < 15; ++s )
+            {
+                const double x = test_value( p * 15 + s, 11 );
+                const double y = test_value( ( p * 15 + s ) * 13, 12 );
+                const double* q = expected[ p ].array;
+                const double z = q[ 0 ] * x * x + q[ 1 ] * x * y + q[ 2 ] * y * y
+                    + q[ 3 ] * x + q[ 4 ] * y + q[ 5 ];
+                quadrics.add( p, vector< 3, double >( x, y, z ));
+            }
+        }
+        TEST( quadrics.compute( &coefficients[ 0 ] ) == count );
+        for( size_t p = 0; p < count; ++p )
+            TEST( coefficients[ p ].equals( expected[ p ], 1e-9 ));
+
+        // z = ( x^2 + y^2 ) / 2 has unit principal curvatures at the apex
+        vector< 6, double > paraboloid( 0.0 );
+        paraboloid( 0 ) = paraboloid( 2 ) = 0.5;
+        double mean, gaussian;
+        batched_quadric_fit< double >::compute_curvatures( paraboloid, mean, gaussian );
+        TEST( std::fabs( mean - 1 ) < 1e-15 && std::fabs( gaussian - 1 ) < 1e-15 );
+    }
+    log( "batched quadric fit and curvatures", ok );
+
+
+    // adding a whole neighborhood at once equals single adds
+    ok = true;
+    {
+        const size_t n_points = 10;
+        std::vector< vector< 3, double > > points( n_points );
+        std::vector< double > weights( n_points );
+        for( size_t s = 0; s < n_points; ++s )
+        {
+            points[ s ] = vector< 3, double >( test_value( s, 13 ), test_value( s * 13, 14 ),
+                                               test_value( s * 29, 15 ));
+            weights[ s ] = 0.5 + s;
+        }
+
+        batched_plane_fit< double > planes( 2 );
+        batched_quadric_fit< double > quadrics( 2 );
+        for( size_t s = 0; s < n_points; ++s )
+        {
+            planes.add( 0, points[ s ], weights[ s ] );
+            quadrics.add( 0, points[ s ], weights[ s ] );
+        }
+        planes.add( 1, &points[ 0 ], 4, &weights[ 0 ] );
+        planes.add( 1, &points[ 4 ], n_points - 4, &weights[ 4 ] );
+        quadrics.add( 1, &points[ 0 ], n_points, &weights[ 0 ] );
+
+        vector< 3, double > c[ 2 ], n[ 2 ];
+        double k[ 2 ], r[ 2 ];
+        vector< 6, double > q[ 2 ];
+        planes.compute( c, n, k );
+        quadrics.compute( q, 0, r );
+        TEST( c[ 0 ].equals( c[ 1 ], 1e-14 ));
+        TEST( std::fabs( std::fabs( n[ 0 ].dot( n[ 1 ] )) - 1 ) < 1e-14 );
+        TEST( std::fabs( k[ 0 ] - k[ 1 ] ) < 1e-14 );
+        TEST( q[ 0 ].equals( q[ 1 ], 1e-12 ));
+        TEST( std::fabs( r[ 0 ] - r[ 1 ] ) < 1e-12 );
+    }
+    log( "add a neighborhood at once", ok );
+
+
+    // normals straight from moments accumulated by the caller
+    ok = true;
+    {
+        const size_t count = 13;
+        typedef batched_plane_fit< double, 4 > plane_fit;
+        plane_fit planes( count );
+        std::vector< double > moments( count * plane_fit::N_COVARIANCE_MOMENTS, 0.0 );
+        for( size_t p = 0; p < count; ++p )
+        {
+            const vector< 3, double > origin( 100.0 * p, -50, 20 );
+            for( size_t s = 0; s < 8 + p; ++s )
+            {
+                const vector< 3, double > q = origin + vector< 3, double >(
+                    test_value( p * 31 + s, 16 ), test_value( ( p * 31 + s ) * 13, 17 ),
+                    0.1 * test_value( ( p * 31 + s ) * 29, 18 ));
+                planes.add( p, q, 1.0 + 0.1 * s );
+                plane_fit::accumulate( &moments[ p * plane_fit::N_COVARIANCE_MOMENTS ],
+                                       q, origin, 1.0 + 0.1 * s );
+            }
+        }
+
+        std::vector< vector< 3, double > > c( count ), n( count ), n_check( count );
+        std::vector< double > k( count ), k_check( count );
+        planes.compute( &c[ 0 ], &n_check[ 0 ], &k_check[ 0 ] );
+        plane_fit::compute_normals( &moments[ 0 ], count, &n[ 0 ], &k[ 0 ] );
+        for( size_t p = 0; p < count; ++p )
+        {
+            TEST( std::fabs( std::fabs( n[ p ].dot( n_check[ p ] )) - 1 ) < 1e-12 );
+            TEST( std::fabs( k[ p ] - k_check[ p ] ) < 1e-12 );
+            TEST( k[ p ] > 0 && k[ p ] < 0.1 );
+        }
+    }
+    log( "batched plane fit: normals and surface variation from moments", ok );
+
+    return global_ok;
+}
+
+} // namespace vmml
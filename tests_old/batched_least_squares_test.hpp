@@ -0,0 +1,21 @@
+#ifndef __VMML__BATCHED_LEAST_SQUARES_TEST__HPP__
+#define __VMML__BATCHED_LEAST_SQUARES_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class batched_least_squares_test : public unit_test
+{
+public:
+    batched_least_squares_test() : unit_test( "batched least squares fitting" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class batched_least_squares_test
+
+} // namespace vmml
+
+#endif
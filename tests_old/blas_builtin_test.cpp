@@ -0,0 +1,190 @@
+#include "blas_builtin_test.hpp"
+
+#include <vmmlib/blas_builtin.hpp>
+#include <vmmlib/blas_dgemm.hpp>
+#include <cmath>
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+double
+test_value( int i, int seed )
+{
+    return double( ( i * 7919 + seed * 104729 ) % 201 - 100 ) / 37.0;
+}
+
+// reference column-major C = alpha * op(A) * op(B) + beta * C
+void
+naive_gemm( bool trans_a, bool trans_b, int m, int n, int k, double alpha,
+            const std::vector< double >& a, int lda, const std::vector< double >& b, int ldb,
+            double beta, std::vector< double >& c, int ldc )
+{
+    for( int j = 0; j < n; ++j )
+    {
+        for( int i = 0; i < m; ++i )
+        {
+            double sum = 0;
+            for( int p = 0; p < k; ++p )
+            {
+                const double a_ip = trans_a ? a[ p + i * lda ] : a[ i + p * lda ];
+                const double b_pj = trans_b ? b[ j + p * ldb ] : b[ p + j * ldb ];
+                sum += a_ip * b_pj;
+            }
+            c[ i + j * ldc ] = alpha * sum + beta * c[ i + j * ldc ];
+        }
+    }
+}
+
+double
+max_diff( const std::vector< double >& x, const std::vector< double >& y )
+{
+    double diff = 0;
+    for( size_t i = 0; i < x.size(); ++i )
+        diff = std::max( diff, std::fabs( x[ i ] - y[ i ] ) );
+    return diff;
+}
+
+} // anonymous namespace
+
+bool
+blas_builtin_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    // odd sizes exercise the partial micro-kernel tiles and, with k > GEMM_KC,
+    // several packed panels
+    const int sizes[][ 3 ] = { { 1, 1, 1 }, { 7, 5, 3 }, { 13, 17, 9 }, { 131, 67, 300 }, { 150, 9, 33 } };
+    for( size_t s = 0; s < sizeof( sizes ) / sizeof( sizes[ 0 ] ); ++s )
+    {
+        const int m = sizes[ s ][ 0 ];
+        const int n = sizes[ s ][ 1 ];
+        const int k = sizes[ s ][ 2 ];
+        for( int t = 0; t < 4; ++t )
+        {
+            const bool trans_a = ( t & 1 ) != 0;
+            const bool trans_b = ( t & 2 ) != 0;
+            // leading dimensions larger than needed
+            const int lda = ( trans_a ? k : m ) + 2;
+            const int ldb = ( trans_b ? n : k ) + 1;
+            const int ldc = m + 3;
+            std::vector< double > a( lda * ( trans_a ? m : k ) );
+            std::vector< double > b( ldb * ( trans_b ? k : n ) );
+            std::vector< double > c( ldc * n );
+            for( size_t i = 0; i < a.size(); ++i ) a[ i ] = test_value( int( i ), 1 );
+            for( size_t i = 0; i < b.size(); ++i ) b[ i ] = test_value( int( i ), 2 );
+            for( size_t i = 0; i < c.size(); ++i ) c[ i ] = test_value( int( i ), 3 );
+            std::vector< double > c_check( c );
+
+            naive_gemm( trans_a, trans_b, m, n, k, 0.5, a, lda, b, ldb, -2.0, c_check, ldc );
+            blas::builtin::gemm( trans_a, trans_b, m, n, k, 0.5, &a[ 0 ], lda, &b[ 0 ], ldb, -2.0, &c[ 0 ], ldc );
+            TEST( max_diff( c, c_check ) < 1e-10 );
+
+            // beta == 0 must ignore (even non-finite) values in C
+            for( size_t i = 0; i < c.size(); ++i ) c[ i ] = std::sqrt( -1.0 );
+            for( size_t i = 0; i < c.size(); ++i ) c_check[ i ] = 0;
+            naive_gemm( trans_a, trans_b, m, n, k, 1.0, a, lda, b, ldb, 0.0, c_check, ldc );
+            blas::builtin::gemm( trans_a, trans_b, m, n, k, 1.0, &a[ 0 ], lda, &b[ 0 ], ldb, 0.0, &c[ 0 ], ldc );
+            TEST( max_diff( c, c_check ) < 1e-10 );
+        }
+    }
+    log( "gemm, all transpose combinations, odd sizes, alpha/beta", ok );
+
+    // the matrix wrappers
+    ok = true;
+    {
+        matrix< 7, 11, double > a;
+        matrix< 11, 5, double > b;
+        matrix< 7, 5, double > c;
+        matrix< 7, 5, double > c_check;
+        for( size_t i = 0; i < 7 * 11; ++i ) a.array[ i ] = test_value( int( i ), 4 );
+        for( size_t i = 0; i < 11 * 5; ++i ) b.array[ i ] = test_value( int( i ), 5 );
+        c_check.multiply( a, b );
+
+        blas_dgemm< 7, 11, 5, double > dgemm_;
+        dgemm_.compute( a, b, c );
+        for( size_t i = 0; i < 7 * 5; ++i )
+            TEST( std::fabs( c.array[ i ] - c_check.array[ i ] ) < 1e-10 );
+
+        matrix< 7, 7, double > aat;
+        matrix< 7, 7, double > aat_check;
+        matrix< 11, 7, double > at;
+        a.transpose_to( at );
+        aat_check.multiply( a, at );
+        blas_dgemm< 7, 11, 7, double > syrk_;
+        syrk_.compute( a, aat );
+        for( size_t i = 0; i < 7 * 7; ++i )
+            TEST( std::fabs( aat.array[ i ] - aat_check.array[ i ] ) < 1e-10 );
+    }
+    log( "blas_dgemm on top of the builtin routines", ok );
+
+    ok = true;
+    {
+        const int n = 150;
+        const int k = 70;
+        std::vector< double > a( n * k );
+        for( size_t i = 0; i < a.size(); ++i ) a[ i ] = test_value( int( i ), 6 );
+        for( int upper = 0; upper < 2; ++upper )
+        {
+            for( int trans = 0; trans < 2; ++trans )
+            {
+                const int lda = trans ? k : n;
+                std::vector< double > c( n * n );
+                for( size_t i = 0; i < c.size(); ++i ) c[ i ] = test_value( int( i ), 7 );
+                std::vector< double > c_check( c );
+                naive_gemm( trans != 0, trans == 0, n, n, k, 1.5, a, lda, a, lda, 0.5, c_check, n );
+                blas::builtin::syrk( upper != 0, trans != 0, n, k, 1.5, &a[ 0 ], lda, 0.5, &c[ 0 ], n );
+
+                for( int j = 0; j < n; ++j )
+                {
+                    for( int i = 0; i < n; ++i )
+                    {
+                        const bool referenced = upper ? ( i <= j ) : ( i >= j );
+                        const double expected = referenced ? c_check[ i + j * n ] : test_value( i + j * n, 7 );
+                        TEST( std::fabs( c[ i + j * n ] - expected ) < 1e-10 );
+                    }
+                }
+            }
+        }
+    }
+    log( "syrk, upper/lower, transposed/non-transposed", ok );
+
+    ok = true;
+    {
+        const int n = 1003;
+        std::vector< float > x( n ), y( n );
+        double dot_check = 0;
+        for( int i = 0; i < n; ++i )
+        {
+            x[ i ] = float( i % 13 ) - 6.0f;
+            y[ i ] = float( i % 7 ) - 3.0f;
+            dot_check += double( x[ i ] ) * double( y[ i ] );
+        }
+        TEST( blas::builtin::dot( n, &x[ 0 ], 1, &y[ 0 ], 1 ) == float( dot_check ) );
+
+        // strided and negative increments
+        double dot_strided = 0;
+        for( int i = 0; i < n / 2; ++i )
+            dot_strided += double( x[ 2 * i ] ) * double( y[ n / 2 - 1 - i ] );
+        TEST( blas::builtin::dot( n / 2, &x[ 0 ], 2, &y[ 0 ], -1 ) == float( dot_strided ) );
+
+        std::vector< float > z( y );
+        blas::builtin::axpy( n, 2.0f, &x[ 0 ], 1, &z[ 0 ], 1 );
+        for( int i = 0; i < n; ++i )
+            TEST( z[ i ] == y[ i ] + 2.0f * x[ i ] );
+
+        z = y;
+        blas::builtin::axpy( n / 3, -1.0f, &x[ 0 ], 3, &z[ 0 ], 1 );
+        for( int i = 0; i < n / 3; ++i )
+            TEST( z[ i ] == y[ i ] - x[ 3 * i ] );
+    }
+    log( "dot, axpy with unit and non-unit increments", ok );
+
+    return global_ok;
+}
+
+} // namespace vmml
@@ -0,0 +1,21 @@
+#ifndef __VMML__BLAS_BUILTIN_TEST__HPP__
+#define __VMML__BLAS_BUILTIN_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class blas_builtin_test : public unit_test
+{
+public:
+    blas_builtin_test() : unit_test( "builtin blas routines (gemm, syrk, dot, axpy)" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class blas_builtin_test
+
+} // namespace vmml
+
+#endif
@@ -0,0 +1,156 @@
+#include "blas_config_test.hpp"
+
+#include <vmmlib/blas_config.hpp>
+#include <vmmlib/blas_dgemm.hpp>
+#include <vmmlib/blas_dot.hpp>
+#include <sstream>
+
+namespace vmml
+{
+
+namespace
+{
+
+// stands in for the thread control of a blas library
+int library_threads = 8;
+
+void
+set_library_threads( int threads_ )
+{
+    library_threads = threads_;
+}
+
+int
+get_library_threads()
+{
+    return library_threads;
+}
+
+} // anonymous namespace
+
+bool
+blas_config_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    blas::config& config = blas::config::get();
+    const blas::backend_type backend = config.get_backend();
+
+    // both backends compute the same products
+    {
+        matrix< 6, 5, double > a;
+        matrix< 5, 7, double > b;
+        matrix< 6, 7, double > c_builtin, c_default;
+        vector< 5, double > x, y;
+        for( size_t i = 0; i < 30; ++i )
+            a.array[ i ] = double( ( i * 7 ) % 11 ) - 5.0;
+        for( size_t i = 0; i < 35; ++i )
+            b.array[ i ] = double( ( i * 3 ) % 13 ) / 4.0;
+        for( size_t i = 0; i < 5; ++i )
+        {
+            x[ i ] = double( i ) - 2.0;
+            y[ i ] = double( i * i ) / 3.0;
+        }
+
+        blas_dgemm< 6, 5, 7, double > dgemm;
+        blas_dot< 5, double > dot;
+        double dot_builtin = 0, dot_default = 0;
+
+        config.set_backend( blas::BACKEND_BUILTIN );
+        TEST( config.use_builtin() );
+        dgemm.compute( a, b, c_builtin );
+        dot.compute( x, y, dot_builtin );
+
+        if ( blas::config::has_cblas() )
+            config.set_backend( blas::BACKEND_CBLAS );
+        dgemm.compute( a, b, c_default );
+        dot.compute( x, y, dot_default );
+
+        TEST( c_builtin.equals( c_default, 1e-12 ));
+        TEST( fabs( dot_builtin - dot_default ) < 1e-12 );
+
+        config.set_backend( backend );
+    }
+    log( "switch between builtin and cblas backend", ok );
+
+
+    // blas runs single-threaded inside vmmlib's parallel loops
+    ok = true;
+    {
+        const int threads_per_call = config.get_threads_per_call();
+        config.set_thread_control( &set_library_threads, &get_library_threads );
+        config.set_threads_per_call( 4 );
+        TEST( library_threads == 4 );
+        TEST( config.get_call_threads() == 4 );
+        {
+            // only entered if a parallel loop gets more than one thread
+            blas::serial_region outer;
+            const bool entered = config.in_serial_region();
+            const int region_threads = entered ? 1 : 4;
+            TEST( config.get_call_threads() == region_threads );
+            TEST( library_threads == region_threads );
+            {
+                blas::serial_region inner;
+                TEST( library_threads == region_threads );
+            }
+            TEST( library_threads == region_threads );
+        }
+        TEST( ! config.in_serial_region() );
+        TEST( library_threads == 4 );
+
+#ifdef VMMLIB_USE_OPENMP
+        {
+            const int max_threads = omp_get_max_threads();
+            omp_set_num_threads( 1 );
+            {
+                blas::serial_region region;
+                TEST( ! config.in_serial_region() );
+                TEST( library_threads == 4 );
+            }
+
+            // the region belongs to the thread that opened it
+            omp_set_num_threads( 2 );
+            bool other_in_region = true;
+            {
+                blas::serial_region region;
+                TEST( config.in_serial_region() );
+                TEST( library_threads == 1 );
+                #pragma omp parallel num_threads( 2 )
+                {
+                    if ( omp_get_thread_num() == 1 )
+                        other_in_region = config.in_serial_region();
+                }
+            }
+            TEST( ! other_in_region );
+            TEST( library_threads == 4 );
+            omp_set_num_threads( max_threads );
+        }
+#endif
+
+        config.set_serialize_nested( false );
+        {
+            blas::serial_region region;
+            TEST( ! config.in_serial_region() );
+            TEST( library_threads == 4 );
+        }
+        config.set_serialize_nested( true );
+
+        config.set_thread_control( 0, 0 );
+        config.set_threads_per_call( threads_per_call );
+    }
+    log( "thread budget and serial regions", ok );
+
+
+    ok = true;
+    {
+        std::stringstream ss;
+        ss << config;
+        TEST( ss.str().find( blas::config::get_backend_name( backend ) ) != std::string::npos );
+    }
+    log( "print effective configuration", ok );
+
+    return global_ok;
+}
+
+} // namespace vmml
@@ -0,0 +1,21 @@
+#ifndef __VMML__BLAS_CONFIG_TEST__HPP__
+#define __VMML__BLAS_CONFIG_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class blas_config_test : public unit_test
+{
+public:
+    blas_config_test() : unit_test( "runtime blas configuration" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class blas_config_test
+
+} // namespace vmml
+
+#endif
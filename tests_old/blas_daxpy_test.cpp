@@ -83,6 +83,41 @@ namespace vmml
 			log_error( ss.str() );
 		}
 
+
+		//rank-k update over several panels and a k range that is not a multiple of the unrolling
+		ok = true;
+		{
+			matrix< 37, 71, double >* left_l = new matrix< 37, 71, double >;
+			matrix< 37, 37, double >* cov_l = new matrix< 37, 37, double >;
+			for ( size_t i = 0; i < 37 * 71; ++i )
+			{
+				left_l->array[ i ] = double( ( i * 7 ) % 31 ) / 31.0 - 0.5;
+			}
+
+			blas_daxpy< 37, double > blas_daxpy3;
+			blas_daxpy3.compute_mmm( *left_l, *cov_l );
+
+			double max_diff = 0.0;
+			for ( size_t row = 0; row < 37; ++row )
+			{
+				for ( size_t col = 0; col < 37; ++col )
+				{
+					double sum = 0.0;
+					for ( size_t k = 0; k < 71; ++k )
+					{
+						sum += left_l->at( row, k ) * left_l->at( col, k );
+					}
+					const double diff = fabs( sum - cov_l->at( row, col ) );
+					max_diff = diff > max_diff ? diff : max_diff;
+				}
+			}
+			TEST( max_diff < 1e-12 );
+
+			delete cov_l;
+			delete left_l;
+		}
+		log( "compute 37x37 covariance (A*A^T) by blocked rank-k update", ok );
+
 		return global_ok;
 	}
 
@@ -203,6 +203,57 @@ namespace vmml
 			log_error( ss.str() );
 		}
 
+		//inputs are passed through without copies, output aliasing an input
+		ok = true;
+		{
+			matrix< 3, 3, double > X;
+			matrix< 3, 3, double > Y;
+			matrix< 3, 3, double > XY_check;
+			double XData[] = { 1, 2, 3, 4, 5, 6, 7, 8, 10 };
+			double YData[] = { 2, 0, 1, 1, 3, 0, 0, 1, 4 };
+			X = XData;
+			Y = YData;
+			XY_check.multiply( X, Y );
+
+			blas_dgemm< 3, 3, 3, double > blas_dgemm8;
+			blas_dgemm8.compute( X, Y, X );
+			TEST(X == XY_check);
+			TEST(blas_dgemm8.get_params().b == Y.array);
+		}
+		log( "matrix-matrix multiplication, output aliases input", ok );
+
+		//beta != 0 accumulates into C, also when C aliases an input
+		ok = true;
+		{
+			matrix< 3, 3, double > X;
+			matrix< 3, 3, double > Y;
+			matrix< 3, 3, double > Z;
+			matrix< 3, 3, double > XY;
+			matrix< 3, 3, double > check;
+			double XData[] = { 1, 2, 3, 4, 5, 6, 7, 8, 10 };
+			double YData[] = { 2, 0, 1, 1, 3, 0, 0, 1, 4 };
+			double ZData[] = { 1, -1, 2, 0, 3, 1, -2, 5, 4 };
+			X = XData;
+			Y = YData;
+			Z = ZData;
+			XY.multiply( X, Y );
+
+			blas_dgemm< 3, 3, 3, double > blas_dgemm9;
+			blas_dgemm9.p.alpha = 2;
+			blas_dgemm9.p.beta = 0.5;
+
+			matrix< 3, 3, double > C = Z;
+			blas_dgemm9.compute( X, Y, C );
+			check = XY * 2.0 + Z * 0.5;
+			TEST(C.equals( check, 1e-12 ));
+
+			matrix< 3, 3, double > Y_inplace = Y;
+			blas_dgemm9.compute( X, Y_inplace, Y_inplace );
+			check = XY * 2.0 + Y * 0.5;
+			TEST(Y_inplace.equals( check, 1e-12 ));
+		}
+		log( "matrix-matrix multiplication, beta != 0", ok );
+
 
 		return global_ok;
 	}
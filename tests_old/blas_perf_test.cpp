@@ -0,0 +1,142 @@
+#include "blas_perf_test.hpp"
+
+#include <vmmlib/blas_includes.hpp>
+#include <vmmlib/blas_builtin.hpp>
+#include <vmmlib/blas_dgemm.hpp>
+#include <vmmlib/blas_daxpy.hpp>
+#include <vector>
+
+
+namespace vmml
+{
+
+
+void
+blas_perf_test::run()
+{
+    const int n = 512;
+    const size_t iterations = 4;
+
+    std::vector< double > a( n * n ), b( n * n ), c( n * n );
+    for( size_t i = 0; i < a.size(); ++i )
+    {
+        a[ i ] = double( i % 17 ) / 17.0;
+        b[ i ] = double( i % 23 ) / 23.0;
+    }
+
+    new_test( "dgemm 512x512, column major" );
+    start( "naive" );
+    for( size_t it = 0; it < iterations; ++it )
+    {
+        for( int j = 0; j < n; ++j )
+        {
+            for( int i = 0; i < n; ++i )
+            {
+                double sum = 0;
+                for( int p = 0; p < n; ++p )
+                    sum += a[ i + p * n ] * b[ p + j * n ];
+                c[ i + j * n ] = sum;
+            }
+        }
+    }
+    stop();
+
+    start( "builtin" );
+    for( size_t it = 0; it < iterations; ++it )
+    {
+        blas::builtin::gemm( false, false, n, n, n, 1.0, &a[ 0 ], n, &b[ 0 ], n, 0.0, &c[ 0 ], n );
+    }
+    stop();
+
+#ifdef VMMLIB_USE_BLAS
+    start( "cblas" );
+    for( size_t it = 0; it < iterations; ++it )
+    {
+        cblas_dgemm( CblasColMajor, CblasNoTrans, CblasNoTrans, n, n, n,
+            1.0, &a[ 0 ], n, &b[ 0 ], n, 0.0, &c[ 0 ], n );
+    }
+    stop();
+#endif
+    compare();
+
+    new_test( "dsyrk 512x512 (A*A^T), column major" );
+    start( "builtin gemm" );
+    for( size_t it = 0; it < iterations; ++it )
+    {
+        blas::builtin::gemm( false, true, n, n, n, 1.0, &a[ 0 ], n, &a[ 0 ], n, 0.0, &c[ 0 ], n );
+    }
+    stop();
+
+    start( "builtin syrk" );
+    for( size_t it = 0; it < iterations; ++it )
+    {
+        blas::builtin::syrk( false, false, n, n, 1.0, &a[ 0 ], n, 0.0, &c[ 0 ], n );
+    }
+    stop();
+    compare();
+
+    // blas_dgemm used to copy its inputs before each call
+    typedef tensor3< 32, 64, 64, double > t3_type;
+    t3_type* t3 = new t3_type;
+    for( size_t i = 0; i < t3_type::SIZE; ++i )
+    {
+        t3->get_array_ptr()[ i ] = double( i % 29 ) / 29.0;
+    }
+    matrix< 32, 32, double >* cov = new matrix< 32, 32, double >;
+    blas_dgemm< 32, 64 * 64, 32, double >* dgemm = new blas_dgemm< 32, 64 * 64, 32, double >;
+    const size_t cov_iterations = 100;
+
+    new_test( "blas_dgemm covariance of a 32x64x64 tensor3 unfolding" );
+    start( "copied input" );
+    for( size_t it = 0; it < cov_iterations; ++it )
+    {
+        t3_type* copy = new t3_type( *t3 );
+        dgemm->compute( *copy, *cov );
+        delete copy;
+    }
+    stop();
+
+    start( "zero-copy" );
+    for( size_t it = 0; it < cov_iterations; ++it )
+    {
+        dgemm->compute( *t3, *cov );
+    }
+    stop();
+    compare();
+
+    // the rank-k update of blas_daxpy is the alternative covariance path in t3_hosvd
+    typedef matrix< 32, 64 * 64, double > unfolding_type;
+    unfolding_type* unfolding = new unfolding_type;
+    for( size_t i = 0; i < 32 * 64 * 64; ++i )
+    {
+        unfolding->array[ i ] = double( i % 29 ) / 29.0;
+    }
+    blas_dgemm< 32, 64 * 64, 32, double >* dgemm_cov = new blas_dgemm< 32, 64 * 64, 32, double >;
+    blas_daxpy< 32, double >* daxpy_cov = new blas_daxpy< 32, double >;
+
+    new_test( "covariance of a 32x4096 unfolding" );
+    start( "blas_dgemm" );
+    for( size_t it = 0; it < cov_iterations; ++it )
+    {
+        dgemm_cov->compute( *unfolding, *cov );
+    }
+    stop();
+
+    start( "blas_daxpy rank-k" );
+    for( size_t it = 0; it < cov_iterations; ++it )
+    {
+        daxpy_cov->compute_mmm( *unfolding, *cov );
+    }
+    stop();
+    compare();
+
+    delete daxpy_cov;
+    delete dgemm_cov;
+    delete unfolding;
+    delete dgemm;
+    delete cov;
+    delete t3;
+}
+
+
+} // namespace vmml
@@ -0,0 +1,366 @@
+#include "cholesky_solver_test.hpp"
+
+#include <vmmlib/cholesky_solver.hpp>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+double
+test_value( size_t i, int seed )
+{
+    return double( int( ( i * 7919 + seed * 104729 ) % 201 ) - 100 ) / 37.0;
+}
+
+// A = B B^T + N I, symmetric positive definite
+template< size_t N, typename T >
+void
+make_spd( matrix< N, N, T >& A, int seed )
+{
+    matrix< N, N, T > B;
+    for( size_t i = 0; i < N * N; ++i )
+        B.array[ i ] = T( test_value( i, seed ));
+    for( size_t j = 0; j < N; ++j )
+        for( size_t i = 0; i < N; ++i )
+        {
+            T s = i == j ? T( N ) : T( 0 );
+            for( size_t k = 0; k < N; ++k )
+                s += B( i, k ) * B( j, k );
+            A( i, j ) = s;
+        }
+}
+
+// max | A X - B | / max | B |, A and X column-major n x n and n x nrhs
+template< typename T >
+double
+residual_error( size_t n, size_t nrhs, const T* a, const T* x, const T* b )
+{
+    double max_diff = 0, max_b = 0;
+    for( size_t k = 0; k < nrhs; ++k )
+        for( size_t i = 0; i < n; ++i )
+        {
+            double s = 0;
+            for( size_t j = 0; j < n; ++j )
+                s += double( a[ j * n + i ] ) * x[ k * n + j ];
+            const double diff = std::fabs( s - b[ k * n + i ] );
+            const double bi = std::fabs( double( b[ k * n + i ] ));
+            max_diff = diff > max_diff ? diff : max_diff;
+            max_b = bi > max_b ? bi : max_b;
+        }
+    return max_diff / ( max_b > 0 ? max_b : 1 );
+}
+
+template< size_t N, typename T >
+bool
+check_spd_solve( int seed, double tolerance )
+{
+    matrix< N, N, T > A;
+    make_spd( A, seed );
+
+    cholesky_solver< N, T > solver;
+    if ( ! solver.factorize( A ) || ! solver.is_spd() )
+        return false;
+
+    // A = L L^T, L lower triangular
+    const matrix< N, N, T >& L = solver.get_factor();
+    for( size_t j = 0; j < N; ++j )
+        for( size_t i = 0; i < N; ++i )
+        {
+            if ( i < j && L( i, j ) != T( 0 ) )
+                return false;
+            double s = 0;
+            for( size_t k = 0; k < N; ++k )
+                s += double( L( i, k ) ) * L( j, k );
+            if ( std::fabs( s - A( i, j ) ) > tolerance * N * N )
+                return false;
+        }
+
+    vector< N, T > b, x;
+    for( size_t i = 0; i < N; ++i )
+        b.array[ i ] = T( test_value( i, seed + 1 ));
+    solver.solve( b, x );
+
+    matrix< N, 3, T > B, X;
+    for( size_t i = 0; i < N * 3; ++i )
+        B.array[ i ] = T( test_value( i, seed + 2 ));
+    solver.solve( B, X );
+
+    // each column of the multiple right-hand side solve matches a single solve
+    bool same = true;
+    for( size_t k = 0; k < 3; ++k )
+    {
+        vector< N, T > bk, xk;
+        B.get_column( k, bk );
+        solver.solve( bk, xk );
+        for( size_t i = 0; i < N; ++i )
+            same = same && std::fabs( double( xk.array[ i ] - X( i, k ) ) ) <= tolerance;
+    }
+
+    matrix< N, N, T > inverse_, identity;
+    solver.compute_inverse( inverse_ );
+    identity = matrix< N, N, T >::IDENTITY;
+
+    return same
+        && residual_error( N, 1, A.array, x.array, b.array ) < tolerance
+        && residual_error( N, 3, A.array, X.array, B.array ) < tolerance
+        && residual_error( N, N, A.array, inverse_.array, identity.array ) < tolerance;
+}
+
+} // anonymous namespace
+
+bool
+cholesky_solver_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    // A = L L^T with L = [ 2 0 0; 6 1 0; -8 5 3 ], upper triangle is not referenced
+    {
+        double a[] = { 4, 12, -16, -1, 37, -43, -1, -1, 98 };
+        double l[] = { 2, 6, -8, 0, 1, 5, 0, 0, 3 };
+        matrix< 3, 3, double > A, L;
+        A.set( a, a + 9, false );
+        L.set( l, l + 9, false );
+
+        cholesky_solver< 3, double > solver;
+        TEST( solver.factorize( A ));
+        TEST( solver.get_factorization() == FACTORIZATION_CHOLESKY );
+        TEST( solver.get_factor().equals( L, 1e-14 ));
+
+        // x = ( 1 2 3 )^T, b = A x with the symmetric A
+        vector< 3, double > b( 4 + 24 - 48, 12 + 74 - 129, -16 - 86 + 294 );
+        solver.solve( b );
+        TEST( b.equals( vector< 3, double >( 1, 2, 3 ), 1e-12 ));
+
+        dynamic_cholesky_solver< double > dynamic_solver;
+        TEST( dynamic_solver.factorize( 3, a ));
+        TEST( dynamic_solver.is_spd() );
+        for( size_t i = 0; i < 9; ++i )
+            TEST( std::fabs( dynamic_solver.get_factor()[ i ] - l[ i ] ) < 1e-14 );
+    }
+    log( "factorize and solve a known 3x3 system", ok );
+
+
+    // unrolled kernels ( N <= 4 ) and the generic loops
+    ok = true;
+    TEST(( check_spd_solve< 1, double >( 1, 1e-13 )));
+    TEST(( check_spd_solve< 2, double >( 2, 1e-13 )));
+    TEST(( check_spd_solve< 3, double >( 3, 1e-13 )));
+    TEST(( check_spd_solve< 4, double >( 4, 1e-13 )));
+    TEST(( check_spd_solve< 5, double >( 5, 1e-13 )));
+    TEST(( check_spd_solve< 9, double >( 6, 1e-12 )));
+    TEST(( check_spd_solve< 3, float >( 7, 1e-5 )));
+    TEST(( check_spd_solve< 4, float >( 8, 1e-5 )));
+    log( "solve spd systems with one and multiple right-hand sides, N = 1..9", ok );
+
+
+    // not positive definite: Bunch-Kaufman L D L^T, singular matrices are reported
+    ok = true;
+    {
+        matrix< 2, 2, double > A;
+        A( 0, 0 ) = 1; A( 0, 1 ) = 2; A( 1, 0 ) = 2; A( 1, 1 ) = 1;
+        cholesky_solver< 2, double > solver;
+        TEST( solver.factorize( A ));
+        TEST( solver.get_factorization() == FACTORIZATION_LDLT );
+        TEST( ! solver.is_spd() );
+        vector< 2, double > x;
+        solver.solve( vector< 2, double >( 5, 4 ), x );
+        TEST( x.equals( vector< 2, double >( 1, 2 ), 1e-14 ));
+
+        // zero diagonal, needs a 2x2 block
+        A( 0, 0 ) = 0; A( 0, 1 ) = 1; A( 1, 0 ) = 1; A( 1, 1 ) = 0;
+        TEST( solver.factorize( A ));
+        TEST( solver.get_factorization() == FACTORIZATION_LDLT );
+        solver.solve( vector< 2, double >( 3, 7 ), x );
+        TEST( x.equals( vector< 2, double >( 7, 3 ), 1e-14 ));
+
+        A( 0, 0 ) = 1; A( 0, 1 ) = 1; A( 1, 0 ) = 1; A( 1, 1 ) = 1;
+        TEST( ! solver.factorize( A ));
+        TEST( ! solver.is_factorized() );
+        TEST( solver.reciprocal_condition_estimate() == 0 );
+
+        // tiny leading pivot, L D L^T without pivoting loses all digits
+        A( 0, 0 ) = 1e-14; A( 0, 1 ) = 1; A( 1, 0 ) = 1; A( 1, 1 ) = 1;
+        TEST( solver.factorize( A ));
+        solver.solve( vector< 2, double >( 1, 2 ), x );
+        TEST( residual_error( 2, 1, A.array, x.array, vector< 2, double >( 1, 2 ).array ) < 1e-15 );
+
+        // symmetric indefinite 5x5: spd matrix with a shifted diagonal
+        matrix< 5, 5, double > B, X, identity;
+        make_spd( B, 9 );
+        for( size_t i = 0; i < 5; ++i )
+            B( i, i ) -= 40;
+        cholesky_solver< 5, double > solver5;
+        TEST( solver5.factorize( B ));
+        TEST( ! solver5.is_spd() );
+        solver5.compute_inverse( X );
+        identity = matrix< 5, 5, double >::IDENTITY;
+        TEST( residual_error( 5, 5, B.array, X.array, identity.array ) < 1e-12 );
+
+        // saddle point [ I C; C^T 0 ]: zero diagonal in the trailing block,
+        // the pivots mix 1x1 and 2x2 blocks with interchanges
+        matrix< 7, 7, double > K, K_inv;
+        matrix< 7, 7, double > identity7 = matrix< 7, 7, double >::IDENTITY;
+        K.zero();
+        for( size_t i = 0; i < 4; ++i )
+        {
+            K( i, i ) = 1e-3 * double( i + 1 );
+            for( size_t j = 4; j < 7; ++j )
+                K( i, j ) = K( j, i ) = test_value( i * 7 + j, 13 );
+        }
+        cholesky_solver< 7, double > solver7;
+        TEST( solver7.factorize( K ));
+        TEST( solver7.get_factorization() == FACTORIZATION_LDLT );
+        solver7.compute_inverse( K_inv );
+        TEST( residual_error( 7, 7, K.array, K_inv.array, identity7.array ) < 1e-12 );
+        TEST( solver7.reciprocal_condition_estimate() > 0 );
+    }
+    log( "fall back to L D L^T for matrices that are not spd", ok );
+
+
+    // general square matrices: LU with partial pivoting from lu_kernels.hpp
+    ok = true;
+    {
+        matrix< 4, 4, double > A, A_inv;
+        for( size_t i = 0; i < 16; ++i )
+            A.array[ i ] = test_value( i, 14 );
+        A( 0, 0 ) = 0;
+
+        cholesky_solver< 4, double > solver;
+        TEST( solver.factorize_lu( A ));
+        TEST( solver.get_factorization() == FACTORIZATION_LU );
+        solver.compute_inverse( A_inv );
+        matrix< 4, 4, double > identity = matrix< 4, 4, double >::IDENTITY;
+        TEST( residual_error( 4, 4, A.array, A_inv.array, identity.array ) < 1e-12 );
+
+        // 1 / cond_1 needs || A^-1 ||_1 of the unsymmetric A, so the
+        // estimate solves with A^T as well
+        double norm_a = 0, norm_inv = 0;
+        for( size_t j = 0; j < 4; ++j )
+        {
+            double sum_a = 0, sum_inv = 0;
+            for( size_t i = 0; i < 4; ++i )
+            {
+                sum_a += std::fabs( A( i, j ));
+                sum_inv += std::fabs( A_inv( i, j ));
+            }
+            norm_a = sum_a > norm_a ? sum_a : norm_a;
+            norm_inv = sum_inv > norm_inv ? sum_inv : norm_inv;
+        }
+        const double rcond = 1.0 / ( norm_a * norm_inv );
+        const double estimate = solver.reciprocal_condition_estimate();
+        TEST( estimate >= rcond * ( 1 - 1e-12 ) && estimate <= 3 * rcond );
+
+        A.zero();
+        TEST( ! solver.factorize_lu( A ));
+    }
+    log( "LU for general square matrices", ok );
+
+
+    // 1 / cond_1: the estimate of || A^-1 ||_1 is a lower bound, usually exact
+    ok = true;
+    {
+        matrix< 6, 6, double > A, A_inv;
+        make_spd( A, 12 );
+        A( 5, 5 ) *= 1e6;
+        for( size_t pass = 0; pass < 2; ++pass )
+        {
+            cholesky_solver< 6, double > solver;
+            TEST( solver.factorize( A ));
+            TEST( solver.is_spd() == ( pass == 0 ));
+            solver.compute_inverse( A_inv );
+            double norm_a = 0, norm_inv = 0;
+            for( size_t j = 0; j < 6; ++j )
+            {
+                double sum_a = 0, sum_inv = 0;
+                for( size_t i = 0; i < 6; ++i )
+                {
+                    sum_a += std::fabs( A( i, j ));
+                    sum_inv += std::fabs( A_inv( i, j ));
+                }
+                norm_a = sum_a > norm_a ? sum_a : norm_a;
+                norm_inv = sum_inv > norm_inv ? sum_inv : norm_inv;
+            }
+            const double rcond = 1.0 / ( norm_a * norm_inv );
+            const double estimate = solver.reciprocal_condition_estimate();
+            TEST( estimate >= rcond * ( 1 - 1e-12 ) && estimate <= 3 * rcond );
+
+            // indefinite in the second pass
+            for( size_t i = 0; i < 6; ++i )
+                A( i, i ) -= 30;
+        }
+    }
+    log( "reciprocal condition estimate", ok );
+
+
+    // dynamic size, above CHOLESKY_LAPACK_THRESHOLD (LAPACK xPOTRF / xPOTRS
+    // and xSYTRF / xSYTRS if enabled)
+    ok = true;
+    {
+        const size_t sizes[] = { 7, CHOLESKY_LAPACK_THRESHOLD + 36 };
+        for( size_t s = 0; s < 2; ++s )
+        {
+            const size_t n = sizes[ s ];
+            const size_t nrhs = 4;
+            std::vector< double > a( n * n ), b( n * nrhs );
+            for( size_t j = 0; j < n; ++j )
+                for( size_t i = 0; i < n; ++i )
+                {
+                    double v = 0;
+                    for( size_t k = 0; k < n; ++k )
+                        v += test_value( k * n + i, 10 ) * test_value( k * n + j, 10 );
+                    a[ j * n + i ] = v + ( i == j ? double( n ) : 0.0 );
+                }
+            for( size_t i = 0; i < n * nrhs; ++i )
+                b[ i ] = test_value( i, 11 );
+
+            dynamic_cholesky_solver< double > solver;
+            TEST( solver.factorize( n, &a[ 0 ] ));
+            TEST( solver.is_spd() );
+            TEST( solver.get_factor()[ n ] == 0 );
+
+            std::vector< double > x( b );
+            solver.solve( &x[ 0 ], nrhs );
+            TEST( residual_error( n, nrhs, &a[ 0 ], &x[ 0 ], &b[ 0 ] ) < 1e-12 );
+
+            // the same factor again, one column at a time
+            for( size_t k = 0; k < nrhs; ++k )
+            {
+                std::vector< double > xk( b.begin() + k * n, b.begin() + ( k + 1 ) * n );
+                solver.solve( &xk[ 0 ] );
+                for( size_t i = 0; i < n; ++i )
+                    TEST( std::fabs( xk[ i ] - x[ k * n + i ] ) < 1e-12 );
+            }
+
+            // indefinite: shift the diagonal
+            for( size_t i = 0; i < n; ++i )
+                a[ i * n + i ] -= a[ ( n / 2 ) * n + n / 2 ];
+            TEST( solver.factorize( n, &a[ 0 ] ));
+            TEST( solver.get_factorization() == FACTORIZATION_LDLT );
+            x = b;
+            solver.solve( &x[ 0 ], nrhs );
+            TEST( residual_error( n, nrhs, &a[ 0 ], &x[ 0 ], &b[ 0 ] ) < 1e-10 );
+
+            // tiny diagonal, an unpivoted L D L^T would lose all digits
+            for( size_t j = 0; j < n; ++j )
+                for( size_t i = 0; i < n; ++i )
+                    a[ j * n + i ] = i == j ? 1e-13 * double( i + 1 )
+                        : test_value( ( i > j ? j * n + i : i * n + j ), 15 );
+            TEST( solver.factorize( n, &a[ 0 ] ));
+            TEST( solver.get_factorization() == FACTORIZATION_LDLT );
+            x = b;
+            solver.solve( &x[ 0 ], nrhs );
+            TEST( residual_error( n, nrhs, &a[ 0 ], &x[ 0 ], &b[ 0 ] ) < 1e-10 );
+        }
+    }
+    log( "dynamic size, spd and indefinite, factor reused for multiple right-hand sides", ok );
+
+    return global_ok;
+}
+
+} // namespace vmml
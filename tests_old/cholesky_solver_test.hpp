@@ -0,0 +1,21 @@
+#ifndef __VMML__CHOLESKY_SOLVER_TEST__HPP__
+#define __VMML__CHOLESKY_SOLVER_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class cholesky_solver_test : public unit_test
+{
+public:
+    cholesky_solver_test() : unit_test( "cholesky and ldl^t solvers" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class cholesky_solver_test
+
+} // namespace vmml
+
+#endif
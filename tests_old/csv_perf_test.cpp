@@ -0,0 +1,75 @@
+#include "csv_perf_test.hpp"
+
+#include <vmmlib/t3_converter.hpp>
+#include <cstdio>
+#include <fstream>
+
+
+namespace vmml
+{
+
+
+void
+csv_perf_test::run()
+{
+    typedef tensor3< 128, 128, 128, float > t3_type;
+    t3_type data, data_read;
+    for( size_t i = 0; i < data.SIZE; ++i )
+    {
+        data.get_array_ptr()[ i ] = float( i % 1000 ) / 7.0f;
+    }
+
+    new_test( "tensor3 128^3 float csv export" );
+    start( "iostream" );
+    {
+        std::ofstream outfile( ".~tmpPerf.csv" );
+        for( size_t i3 = 0; i3 < 128; ++i3 )
+        {
+            for( size_t i1 = 0; i1 < 128; ++i1 )
+            {
+                for( size_t i2 = 0; i2 < 128; ++i2 )
+                {
+                    outfile << data.at( i1, i2, i3 ) << ", ";
+                }
+                outfile << std::endl;
+            }
+            outfile << std::endl;
+        }
+    }
+    stop();
+
+    start( "csv_formatter" );
+    t3_converter< 128, 128, 128, float >::write_to_csv( data, "./", ".~tmpPerf.csv", 6 );
+    stop();
+    compare();
+
+    new_test( "tensor3 128^3 float csv import" );
+    start( "iostream" );
+    {
+        std::ifstream infile( ".~tmpPerf.csv" );
+        char separator;
+        for( size_t i3 = 0; i3 < 128; ++i3 )
+        {
+            for( size_t i1 = 0; i1 < 128; ++i1 )
+            {
+                for( size_t i2 = 0; i2 < 128; ++i2 )
+                {
+                    infile >> data_read.at( i1, i2, i3 );
+                    if ( i2 + 1 < 128 )
+                        infile >> separator;
+                }
+            }
+        }
+    }
+    stop();
+
+    start( "csv_formatter" );
+    t3_converter< 128, 128, 128, float >::read_from_csv( data_read, "./", ".~tmpPerf.csv" );
+    stop();
+    compare();
+
+    std::remove( ".~tmpPerf.csv" );
+}
+
+
+} // namespace vmml
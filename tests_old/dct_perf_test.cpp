@@ -0,0 +1,71 @@
+#include "dct_perf_test.hpp"
+
+#include <vmmlib/t3_dct.hpp>
+#ifdef VMMLIB_USE_BLAS
+#  include <vmmlib/t3_ttm.hpp>
+#endif
+
+#include <sstream>
+
+namespace vmml
+{
+
+namespace
+{
+
+// 3d dct of a I x I x I volume: n-mode products with the dense dct matrix
+// vs. the fast transform in place
+template< size_t I >
+void
+run_dct_comparison( performance_test& test, size_t iterations )
+{
+    typedef tensor3< I, I, I, float > t3_type;
+    t3_type* data = new t3_type;
+    t3_type* result = new t3_type;
+    for( size_t i3 = 0; i3 < I; ++i3 )
+        for( size_t i2 = 0; i2 < I; ++i2 )
+            for( size_t i1 = 0; i1 < I; ++i1 )
+                ( *data )( i1, i2, i3 ) = float( sin( double( i1 * i1 + i2 * 3 + i3 * 7 ) * 0.37 ));
+
+    std::stringstream name;
+    name << "3d dct of a " << I << "^3 volume";
+    test.new_test( name.str() );
+
+#ifdef VMMLIB_USE_BLAS
+    matrix< I, I, float >* C = new matrix< I, I, float >;
+    C->set_dct();
+    test.start( "t3_ttm with matrix::set_dct" );
+    for( size_t it = 0; it < iterations; ++it )
+        t3_ttm::full_tensor3_matrix_multiplication( *data, *C, *C, *C, *result );
+    test.stop();
+    delete C;
+#endif
+
+    test.start( "t3_dct" );
+    for( size_t it = 0; it < iterations; ++it )
+    {
+        *result = *data;
+        t3_dct::forward( *result );
+    }
+    test.stop();
+#ifdef VMMLIB_USE_BLAS
+    test.compare();
+#endif
+
+    delete data;
+    delete result;
+}
+
+} // anonymous namespace
+
+
+void
+dct_perf_test::run()
+{
+    run_dct_comparison< 64 >( *this, 10 );
+    run_dct_comparison< 128 >( *this, 5 );
+    run_dct_comparison< 96 >( *this, 5 );
+}
+
+
+} // namespace vmml
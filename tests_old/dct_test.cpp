@@ -0,0 +1,217 @@
+#include "dct_test.hpp"
+
+#include <vmmlib/dct.hpp>
+#include <vmmlib/t3_dct.hpp>
+#include <vmmlib/t4_dct.hpp>
+#include <vmmlib/matrix.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+// max | dct.forward( x ) - C x | and max | dct.inverse( dct.forward( x )) - x |
+template< size_t N >
+void
+dct_errors( double& forward_error, double& roundtrip_error )
+{
+    matrix< N, N, double > C;
+    C.set_dct();
+
+    vector< N, double > x, y;
+    for( size_t i = 0; i < N; ++i )
+        x( i ) = std::sin( double( i * i ) * 0.37 + 1.0 );
+
+    y = x;
+    dct< N, double > transform;
+    transform.forward( y );
+
+    forward_error = 0.0;
+    for( size_t k = 0; k < N; ++k )
+    {
+        double s = 0.0;
+        for( size_t n = 0; n < N; ++n )
+            s += C( k, n ) * x( n );
+        forward_error = (std::max)( forward_error, std::fabs( s - y( k )));
+    }
+
+    transform.inverse( y );
+    roundtrip_error = 0.0;
+    for( size_t n = 0; n < N; ++n )
+        roundtrip_error = (std::max)( roundtrip_error, std::fabs( y( n ) - x( n )));
+}
+
+template< size_t N >
+bool
+dct_ok( double tolerance )
+{
+    double forward_error, roundtrip_error;
+    dct_errors< N >( forward_error, roundtrip_error );
+    return forward_error < tolerance && roundtrip_error < tolerance;
+}
+
+} // anonymous namespace
+
+
+bool
+dct_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+#ifdef VMMLIB_USE_BLAS
+    // with the cblas backend, sizes that are not a power of two go to gemm
+    blas::config& config = blas::config::get();
+    const blas::backend_type backend = config.get_backend();
+    config.set_backend( blas::BACKEND_BUILTIN );
+#endif
+
+    // powers of two take the radix-2 fft, other sizes from DENSE_LIMIT on
+    // Bluestein's fft, the small ones the dense table
+    ok = dct_ok< 2 >( 1e-14 ) && dct_ok< 4 >( 1e-14 ) && dct_ok< 8 >( 1e-14 )
+        && dct_ok< 64 >( 1e-13 ) && dct_ok< 256 >( 1e-13 );
+    log( "fast dct-ii and dct-iii compared to matrix::set_dct", ok );
+
+    ok = ! dct< 127, double >::FAST && dct< 128, double >::FAST && dct< 129, double >::FAST;
+    {
+        dct< 129, double > transform;
+        ok = ok && transform.get_fft_size() == 512;
+    }
+    ok = ok && dct_ok< 129 >( 1e-13 ) && dct_ok< 200 >( 1e-12 ) && dct_ok< 243 >( 1e-12 );
+    log( "bluestein dct-ii and dct-iii for sizes that are not a power of two", ok );
+
+    ok = dct_ok< 1 >( 1e-15 ) && dct_ok< 3 >( 1e-14 ) && dct_ok< 6 >( 1e-14 )
+        && dct_ok< 10 >( 1e-14 ) && dct_ok< 17 >( 1e-13 ) && dct_ok< 100 >( 1e-13 );
+    log( "dense dct-ii and dct-iii compared to matrix::set_dct", ok );
+
+#ifdef VMMLIB_USE_BLAS
+    if ( blas::config::has_cblas() )
+        config.set_backend( blas::BACKEND_CBLAS );
+    ok = dct_ok< 1 >( 1e-15 ) && dct_ok< 6 >( 1e-14 ) && dct_ok< 17 >( 1e-13 )
+        && dct_ok< 100 >( 1e-13 ) && dct_ok< 243 >( 1e-12 );
+    log( "dct-ii and dct-iii through gemm for sizes that are not a power of two", ok );
+#endif
+
+    {
+        // strided lines, more than one block
+        const size_t lines = 37;
+        std::vector< double > data( 8 * lines ), reference( 8 * lines );
+        for( size_t i = 0; i < data.size(); ++i )
+            data[ i ] = std::sin( double( i * i ) * 0.37 );
+
+        matrix< 8, 8, double > C;
+        C.set_dct();
+        for( size_t l = 0; l < lines; ++l )
+            for( size_t k = 0; k < 8; ++k )
+            {
+                double s = 0.0;
+                for( size_t n = 0; n < 8; ++n )
+                    s += C( k, n ) * data[ l * 8 + n ];
+                reference[ l * 8 + k ] = s;
+            }
+
+        dct< 8, double > transform;
+        transform.forward( &data[ 0 ], lines, 1, 8 );
+        ok = true;
+        for( size_t i = 0; i < data.size(); ++i )
+            ok = ok && std::fabs( data[ i ] - reference[ i ] ) < 1e-14;
+        log( "dct of strided lines", ok );
+    }
+
+    {
+        tensor3< 8, 6, 16, double > t3, t3_dct_, t3_ref;
+        for( size_t i3 = 0; i3 < 16; ++i3 )
+            for( size_t i2 = 0; i2 < 6; ++i2 )
+                for( size_t i1 = 0; i1 < 8; ++i1 )
+                    t3( i1, i2, i3 ) = std::sin( double( i1 * 7 + i2 * i2 * 3 + i3 * i3 ) * 0.37 );
+
+        matrix< 8, 8, double > C1;
+        matrix< 6, 6, double > C2;
+        matrix< 16, 16, double > C3;
+        C1.set_dct();
+        C2.set_dct();
+        C3.set_dct();
+
+        ok = true;
+        for( size_t mode = 1; mode <= 3; ++mode )
+        {
+            t3_dct_ = t3;
+            t3_dct::forward( t3_dct_, mode );
+            for( size_t i3 = 0; i3 < 16; ++i3 )
+                for( size_t i2 = 0; i2 < 6; ++i2 )
+                    for( size_t i1 = 0; i1 < 8; ++i1 )
+                    {
+                        double s = 0.0;
+                        if ( mode == 1 )
+                            for( size_t n = 0; n < 8; ++n )
+                                s += C1( i1, n ) * t3( n, i2, i3 );
+                        else if ( mode == 2 )
+                            for( size_t n = 0; n < 6; ++n )
+                                s += C2( i2, n ) * t3( i1, n, i3 );
+                        else
+                            for( size_t n = 0; n < 16; ++n )
+                                s += C3( i3, n ) * t3( i1, i2, n );
+                        ok = ok && std::fabs( s - t3_dct_( i1, i2, i3 )) < 1e-13;
+                    }
+        }
+        log( "tensor3 dct along modes 1, 2 and 3", ok );
+
+        t3_dct_ = t3;
+        t3_dct::forward( t3_dct_ );
+        t3_dct::inverse( t3_dct_ );
+        ok = true;
+        for( size_t i3 = 0; i3 < 16; ++i3 )
+            for( size_t i2 = 0; i2 < 6; ++i2 )
+                for( size_t i1 = 0; i1 < 8; ++i1 )
+                    ok = ok && std::fabs( t3( i1, i2, i3 ) - t3_dct_( i1, i2, i3 )) < 1e-13;
+        log( "tensor3 dct and inverse dct along all modes", ok );
+    }
+
+    {
+        tensor4< 4, 3, 8, 5, float > t4, t4_dct_;
+        for( size_t i4 = 0; i4 < 5; ++i4 )
+            for( size_t i3 = 0; i3 < 8; ++i3 )
+                for( size_t i2 = 0; i2 < 3; ++i2 )
+                    for( size_t i1 = 0; i1 < 4; ++i1 )
+                        t4( i1, i2, i3, i4 ) = float( std::sin( double( i1 + i2 * 5 + i3 * i3 + i4 * 11 ) * 0.37 ));
+
+        matrix< 8, 8, double > C3;
+        C3.set_dct();
+
+        t4_dct_ = t4;
+        t4_dct::forward( t4_dct_, 3 );
+        ok = true;
+        for( size_t i4 = 0; i4 < 5; ++i4 )
+            for( size_t i3 = 0; i3 < 8; ++i3 )
+                for( size_t i2 = 0; i2 < 3; ++i2 )
+                    for( size_t i1 = 0; i1 < 4; ++i1 )
+                    {
+                        double s = 0.0;
+                        for( size_t n = 0; n < 8; ++n )
+                            s += C3( i3, n ) * t4( i1, i2, n, i4 );
+                        ok = ok && std::fabs( s - t4_dct_( i1, i2, i3, i4 )) < 1e-5;
+                    }
+
+        t4_dct_ = t4;
+        t4_dct::forward( t4_dct_ );
+        t4_dct::inverse( t4_dct_ );
+        for( size_t i4 = 0; i4 < 5; ++i4 )
+            for( size_t i3 = 0; i3 < 8; ++i3 )
+                for( size_t i2 = 0; i2 < 3; ++i2 )
+                    for( size_t i1 = 0; i1 < 4; ++i1 )
+                        ok = ok && std::fabs( t4( i1, i2, i3, i4 ) - t4_dct_( i1, i2, i3, i4 )) < 1e-5;
+        log( "tensor4 dct along mode 3, roundtrip along all modes (float)", ok );
+    }
+
+#ifdef VMMLIB_USE_BLAS
+    config.set_backend( backend );
+#endif
+
+    return global_ok;
+}
+
+} // namespace vmml
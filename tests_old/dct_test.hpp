@@ -0,0 +1,21 @@
+#ifndef __VMML__DCT_TEST__HPP__
+#define __VMML__DCT_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class dct_test : public unit_test
+{
+public:
+    dct_test() : unit_test( "dct along tensor modes" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class dct_test
+
+} // namespace vmml
+
+#endif
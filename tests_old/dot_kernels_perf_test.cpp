@@ -0,0 +1,80 @@
+#include "dot_kernels_perf_test.hpp"
+
+#include <vmmlib/dot_kernels.hpp>
+#include <iostream>
+#include <vector>
+
+
+namespace vmml
+{
+
+
+void
+dot_kernels_perf_test::run()
+{
+    const size_t n = 1 << 24;
+    const size_t iterations = 10;
+
+    std::vector< float > x( n ), y( n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        x[ i ] = float( i % 17 ) / 17.0f;
+        y[ i ] = float( i % 23 ) / 23.0f;
+    }
+
+    // keeps the compiler from dropping the loops
+    double checksum = 0;
+
+    new_test( "dot product of 16M floats" );
+    start( "scalar loop" );
+    for( size_t it = 0; it < iterations; ++it )
+    {
+        double sum = 0;
+        for( size_t i = 0; i < n; ++i )
+            sum += x[ i ] * y[ i ];
+        checksum += sum;
+    }
+    stop();
+
+    start( "plain" );
+    for( size_t it = 0; it < iterations; ++it )
+        checksum += kernels::dot( &x[ 0 ], &y[ 0 ], n, kernels::SUMMATION_PLAIN );
+    stop();
+
+    start( "pairwise" );
+    for( size_t it = 0; it < iterations; ++it )
+        checksum += kernels::dot( &x[ 0 ], &y[ 0 ], n, kernels::SUMMATION_PAIRWISE );
+    stop();
+
+    start( "kahan" );
+    for( size_t it = 0; it < iterations; ++it )
+        checksum += kernels::dot( &x[ 0 ], &y[ 0 ], n, kernels::SUMMATION_KAHAN );
+    stop();
+    compare();
+
+    new_test( "norm of the difference of 16M floats" );
+    start( "scalar loop" );
+    for( size_t it = 0; it < iterations; ++it )
+    {
+        double sum = 0;
+        for( size_t i = 0; i < n; ++i )
+        {
+            const double diff = x[ i ] - y[ i ];
+            sum += diff * diff;
+        }
+        checksum += sum;
+    }
+    stop();
+
+    start( "pairwise" );
+    for( size_t it = 0; it < iterations; ++it )
+        checksum += kernels::squared_distance( &x[ 0 ], &y[ 0 ], n );
+    stop();
+    compare();
+
+    if ( checksum == 0 )
+        std::cout << "checksum " << checksum << std::endl;
+}
+
+
+} // namespace vmml
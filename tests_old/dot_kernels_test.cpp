@@ -0,0 +1,133 @@
+#include "dot_kernels_test.hpp"
+
+#include <vmmlib/dot_kernels.hpp>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+double
+test_value( size_t i, int seed )
+{
+    return double( int( ( i * 7919 + seed * 104729 ) % 201 ) - 100 ) / 37.0;
+}
+
+double
+relative_error( double value, long double reference )
+{
+    const long double scale = reference < 0 ? -reference : reference;
+    const long double diff = value - reference;
+    return double( ( diff < 0 ? -diff : diff ) / ( scale > 1 ? scale : 1 ) );
+}
+
+template< typename T >
+bool
+check_against_reference( size_t n, kernels::summation_type summation, double tolerance )
+{
+    std::vector< T > x( n + 1 ), y( n + 1 );
+    long double ref_dot = 0, ref_norm = 0, ref_dist = 0;
+    for( size_t i = 0; i < n; ++i )
+    {
+        x[ i ] = T( test_value( i, 1 ) );
+        y[ i ] = T( test_value( i, 2 ) );
+        ref_dot += (long double)x[ i ] * y[ i ];
+        ref_norm += (long double)x[ i ] * x[ i ];
+        const long double diff = (long double)x[ i ] - y[ i ];
+        ref_dist += diff * diff;
+    }
+
+    return relative_error( kernels::dot( &x[ 0 ], &y[ 0 ], n, summation ), ref_dot ) < tolerance
+        && relative_error( kernels::squared_norm( &x[ 0 ], n, summation ), ref_norm ) < tolerance
+        && relative_error( kernels::squared_distance( &x[ 0 ], &y[ 0 ], n, summation ), ref_dist ) < tolerance;
+}
+
+} // anonymous namespace
+
+bool
+dot_kernels_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    // lengths around the unrolling, the pairwise block and the chunk size
+    const size_t lengths[] = { 0, 1, 7, 8, 129, 8191, 8192, 8193, 100003 };
+    const kernels::summation_type summations[] = {
+        kernels::SUMMATION_PLAIN, kernels::SUMMATION_PAIRWISE, kernels::SUMMATION_KAHAN };
+    for( size_t s = 0; s < 3; ++s )
+    {
+        for( size_t l = 0; l < sizeof( lengths ) / sizeof( size_t ); ++l )
+        {
+            TEST( check_against_reference< double >( lengths[ l ], summations[ s ], 1e-13 ));
+            TEST( check_against_reference< float >( lengths[ l ], summations[ s ], 1e-13 ));
+        }
+    }
+    log( "dot, squared norm and squared distance against extended precision reference", ok );
+
+
+    // a million additions of 0.1 drift with one accumulator, but not with compensation
+    ok = true;
+    {
+        const size_t n = 1000003;
+        std::vector< double > x( n, 0.1 ), ones( n, 1.0 );
+        const long double reference = (long double)0.1 * n;
+
+        const double kahan = kernels::dot( &x[ 0 ], &ones[ 0 ], n, kernels::SUMMATION_KAHAN );
+        const double pairwise = kernels::dot( &x[ 0 ], &ones[ 0 ], n, kernels::SUMMATION_PAIRWISE );
+
+        TEST( relative_error( kahan, reference ) < 2e-16 );
+        TEST( relative_error( pairwise, reference ) < 1e-14 );
+
+        if ( ! ok )
+        {
+            std::stringstream ss;
+            ss.precision( 20 );
+            ss << "reference " << double( reference ) << ", kahan " << kahan
+               << ", pairwise " << pairwise << std::endl;
+            log_error( ss.str() );
+        }
+    }
+    log( "compensated and pairwise summation", ok );
+
+
+    // chunking does not depend on the number of threads
+    ok = true;
+    {
+        const size_t n = 300007;
+        std::vector< float > x( n ), y( n );
+        for( size_t i = 0; i < n; ++i )
+        {
+            x[ i ] = float( test_value( i, 3 ) );
+            y[ i ] = float( test_value( i, 4 ) ) * 1e-3f;
+        }
+
+        for( size_t s = 0; s < 3; ++s )
+        {
+#ifdef VMMLIB_USE_OPENMP
+            const int max_threads = omp_get_max_threads();
+            omp_set_num_threads( 1 );
+#endif
+            const double single_dot = kernels::dot( &x[ 0 ], &y[ 0 ], n, summations[ s ] );
+            const double single_dist = kernels::distance( &x[ 0 ], &y[ 0 ], n, summations[ s ] );
+#ifdef VMMLIB_USE_OPENMP
+            omp_set_num_threads( max_threads > 1 ? max_threads : 4 );
+#endif
+            const double multi_dot = kernels::dot( &x[ 0 ], &y[ 0 ], n, summations[ s ] );
+            const double multi_dist = kernels::distance( &x[ 0 ], &y[ 0 ], n, summations[ s ] );
+#ifdef VMMLIB_USE_OPENMP
+            omp_set_num_threads( max_threads );
+#endif
+            TEST( single_dot == multi_dot );
+            TEST( single_dist == multi_dist );
+        }
+    }
+    log( "results independent of the thread count", ok );
+
+    return global_ok;
+}
+
+} // namespace vmml
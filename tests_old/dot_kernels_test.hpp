@@ -0,0 +1,21 @@
+#ifndef __VMML__DOT_KERNELS_TEST__HPP__
+#define __VMML__DOT_KERNELS_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class dot_kernels_test : public unit_test
+{
+public:
+    dot_kernels_test() : unit_test( "dot product and norm kernels" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class dot_kernels_test
+
+} // namespace vmml
+
+#endif
@@ -0,0 +1,80 @@
+#include "incremental_svd_perf_test.hpp"
+
+#ifdef VMMLIB_USE_LAPACK
+#  include <vmmlib/incremental_svd.hpp>
+#  include <vmmlib/lapack_svd.hpp>
+#endif
+
+#include <sstream>
+#include <vector>
+
+namespace vmml
+{
+
+#ifdef VMMLIB_USE_LAPACK
+namespace
+{
+
+// stream of M x 1 samples, the basis of the last W samples is recomputed
+// with lapack_svd after every sample vs. one incremental update of rank R
+template< size_t M, size_t W, size_t R >
+void
+run_streaming_comparison( performance_test& test, size_t n_samples )
+{
+    std::vector< vector< M, double > > samples( n_samples );
+    for( size_t k = 0; k < n_samples; ++k )
+        for( size_t i = 0; i < M; ++i )
+            samples[ k ]( i ) = sin( double( i * i ) * 0.37 + double( k ) * 0.01 )
+                + 0.01 * sin( double( i * k ) * 0.71 );
+
+    std::stringstream name;
+    name << "basis of a stream of " << n_samples << " samples of size " << M;
+    test.new_test( name.str() );
+
+    std::stringstream full_name;
+    full_name << "lapack_svd of the last " << W << " samples";
+    test.start( full_name.str() );
+    {
+        lapack_svd< M, W, double > svd;
+        matrix< M, W, double >* window = new matrix< M, W, double >;
+        matrix< M, W, double >* u = new matrix< M, W, double >;
+        vector< W, double > sigma;
+        matrix< W, W, double > vt;
+        window->zero();
+        for( size_t k = 0; k < n_samples; ++k )
+        {
+            window->set_column( k % W, samples[ k ] );
+            svd.compute( *window, *u, sigma, vt );
+        }
+        delete window;
+        delete u;
+    }
+    test.stop();
+
+    std::stringstream incremental_name;
+    incremental_name << "incremental_svd of rank " << R;
+    test.start( incremental_name.str() );
+    {
+        incremental_svd< M, R, double > isvd;
+        for( size_t k = 0; k < n_samples; ++k )
+            isvd.add_column( samples[ k ] );
+    }
+    test.stop();
+    test.compare();
+}
+
+} // anonymous namespace
+#endif
+
+
+void
+incremental_svd_perf_test::run()
+{
+#ifdef VMMLIB_USE_LAPACK
+    run_streaming_comparison< 256, 32, 16 >( *this, 1000 );
+    run_streaming_comparison< 1024, 32, 16 >( *this, 1000 );
+#endif
+}
+
+
+} // namespace vmml
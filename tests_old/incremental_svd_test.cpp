@@ -0,0 +1,320 @@
+#include "incremental_svd_test.hpp"
+
+#include <vmmlib/incremental_svd.hpp>
+#include <vmmlib/lapack_svd.hpp>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace vmml
+{
+
+namespace
+{
+
+// columns of a M x N matrix of rank <= K
+template< size_t M, size_t N, size_t K >
+void
+make_low_rank( matrix< M, N, double >& A, int seed )
+{
+    A.zero();
+    for( size_t k = 0; k < K; ++k )
+        for( size_t j = 0; j < N; ++j )
+        {
+            const double v = std::sin( double( j * j * ( k + 1 )) * 0.37 + double( seed ));
+            for( size_t i = 0; i < M; ++i )
+                A( i, j ) += v * std::sin( double( i * i * ( k + 1 )) * 0.13 + double( k ));
+        }
+}
+
+// singular values of the M x N matrix A, M <= N, via the SVD of A^T
+template< size_t M, size_t N >
+void
+reference_sigma( const matrix< M, N, double >& A, vector< M, double >& sigma )
+{
+    matrix< N, M, double > At;
+    A.transpose_to( At );
+    lapack_svd< N, M, double > svd;
+    svd.compute( At, sigma );
+}
+
+// max | U^T U - I | over the first rank_ columns
+template< size_t M, size_t R >
+double
+orthogonality_error( const matrix< M, R, double >& U, size_t rank_ )
+{
+    double error = 0.0;
+    for( size_t j = 0; j < rank_; ++j )
+        for( size_t k = 0; k < rank_; ++k )
+        {
+            double s = 0.0;
+            for( size_t i = 0; i < M; ++i )
+                s += U( i, j ) * U( i, k );
+            error = (std::max)( error, std::fabs( s - ( j == k ? 1.0 : 0.0 )));
+        }
+    return error;
+}
+
+// max | U U^T a - a | over the columns a of A
+template< size_t M, size_t R, size_t N >
+double
+span_error( const matrix< M, R, double >& U, const matrix< M, N, double >& A )
+{
+    double error = 0.0;
+    for( size_t j = 0; j < N; ++j )
+    {
+        vector< R, double > x;
+        for( size_t k = 0; k < R; ++k )
+        {
+            x( k ) = 0.0;
+            for( size_t i = 0; i < M; ++i )
+                x( k ) += U( i, k ) * A( i, j );
+        }
+        for( size_t i = 0; i < M; ++i )
+        {
+            double s = 0.0;
+            for( size_t k = 0; k < R; ++k )
+                s += U( i, k ) * x( k );
+            error = (std::max)( error, std::fabs( s - A( i, j )));
+        }
+    }
+    return error;
+}
+
+} // anonymous namespace
+
+
+bool
+incremental_svd_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    {
+        // rank 5 stream, the basis has room for all of it
+        matrix< 20, 30, double > A;
+        make_low_rank< 20, 30, 5 >( A, 1 );
+
+        incremental_svd< 20, 6, double > isvd;
+        vector< 20, double > c;
+        for( size_t j = 0; j < 30; ++j )
+        {
+            A.get_column( j, c );
+            isvd.add_column( c );
+        }
+
+        vector< 20, double > sigma;
+        reference_sigma( A, sigma );
+
+        matrix< 20, 6, double > U;
+        isvd.get_basis( U );
+
+        ok = isvd.get_rank() == 5 && isvd.get_sample_count() == 30;
+        for( size_t i = 0; i < 5; ++i )
+            ok = ok && std::fabs( isvd.get_singular_values()( i ) - sigma( i )) < 1e-10 * sigma( 0 );
+        ok = ok && orthogonality_error( U, 5 ) < 1e-12;
+        ok = ok && span_error( U, A ) < 1e-10 * sigma( 0 );
+        log( "add columns, low rank stream", ok );
+    }
+
+    {
+        // full rank stream, R = M, no truncation
+        matrix< 12, 40, double > A;
+        for( size_t i = 0; i < 12 * 40; ++i )
+            A.array[ i ] = std::sin( double( i * i ) * 0.37 + 2.0 );
+
+        incremental_svd< 12, 12, double > isvd;
+        isvd.set_reorthogonalization_interval( 7 );
+        vector< 12, double > c;
+        for( size_t j = 0; j < 40; ++j )
+        {
+            A.get_column( j, c );
+            isvd.add_column( c );
+        }
+
+        vector< 12, double > sigma;
+        reference_sigma( A, sigma );
+
+        matrix< 12, 12, double > U;
+        isvd.get_basis( U );
+
+        ok = isvd.get_rank() == 12;
+        for( size_t i = 0; i < 12; ++i )
+            ok = ok && std::fabs( isvd.get_singular_values()( i ) - sigma( i )) < 1e-10 * sigma( 0 );
+        ok = ok && orthogonality_error( U, 12 ) < 1e-12;
+        log( "add columns, full rank stream with reorthogonalization", ok );
+    }
+
+    {
+        // rank 4 plus noise, truncated to rank 4
+        matrix< 16, 50, double > A;
+        make_low_rank< 16, 50, 4 >( A, 3 );
+        for( size_t i = 0; i < 16 * 50; ++i )
+            A.array[ i ] += 1e-7 * std::sin( double( i * i ) * 0.71 );
+
+        incremental_svd< 16, 4, double > isvd;
+        vector< 16, double > c;
+        for( size_t j = 0; j < 50; ++j )
+        {
+            A.get_column( j, c );
+            isvd.add_column( c );
+        }
+
+        vector< 16, double > sigma;
+        reference_sigma( A, sigma );
+
+        matrix< 16, 4, double > U;
+        isvd.get_basis( U );
+
+        ok = isvd.get_rank() == 4;
+        for( size_t i = 0; i < 4; ++i )
+            ok = ok && std::fabs( isvd.get_singular_values()( i ) - sigma( i )) < 1e-5 * sigma( 0 );
+        ok = ok && orthogonality_error( U, 4 ) < 1e-12;
+        ok = ok && span_error( U, A ) < 1e-5 * sigma( 0 );
+
+        isvd.truncate( 2 );
+        ok = ok && isvd.get_rank() == 2 && isvd.get_singular_values()( 2 ) == 0.0;
+        ok = ok && std::fabs( isvd.get_singular_values()( 1 ) - sigma( 1 )) < 1e-5 * sigma( 0 );
+        log( "add columns with truncation to rank R, truncate", ok );
+    }
+
+    {
+        // full rank stream truncated to rank 4 without reorthogonalization,
+        // U0 runs out of columns and is folded; the reference recomputes
+        // the truncated SVD of [ U diag( sigma ), c ] for every column
+        matrix< 16, 60, double > A;
+        for( size_t i = 0; i < 16 * 60; ++i )
+            A.array[ i ] = std::sin( double( i * i ) * 0.53 + 1.0 );
+
+        incremental_svd< 16, 4, double > isvd;
+        isvd.set_reorthogonalization_interval( 0 );
+        matrix< 16, 4, double > U_ref;
+        vector< 4, double > sigma_ref;
+        matrix< 16, 5, double > B, B_u;
+        vector< 5, double > B_sigma;
+        matrix< 5, 5, double > B_vt;
+        lapack_svd< 16, 5, double > svd;
+        U_ref.zero();
+        sigma_ref = 0.0;
+
+        vector< 16, double > c;
+        for( size_t j = 0; j < 60; ++j )
+        {
+            A.get_column( j, c );
+            isvd.add_column( c );
+
+            for( size_t k = 0; k < 4; ++k )
+                for( size_t i = 0; i < 16; ++i )
+                    B( i, k ) = U_ref( i, k ) * sigma_ref( k );
+            B.set_column( 4, c );
+            svd.compute( B, B_u, B_sigma, B_vt );
+            for( size_t k = 0; k < 4; ++k )
+            {
+                sigma_ref( k ) = B_sigma( k );
+                for( size_t i = 0; i < 16; ++i )
+                    U_ref( i, k ) = B_u( i, k );
+            }
+        }
+
+        matrix< 16, 4, double > U;
+        isvd.get_basis( U );
+
+        ok = isvd.get_rank() == 4;
+        for( size_t i = 0; i < 4; ++i )
+            ok = ok && std::fabs( isvd.get_singular_values()( i ) - sigma_ref( i )) < 1e-10 * sigma_ref( 0 );
+        ok = ok && orthogonality_error( U, 4 ) < 1e-12;
+        ok = ok && span_error( U, U_ref ) < 1e-8;
+        log( "add columns with truncation, folded basis", ok );
+    }
+
+    {
+        // downdate the first column
+        matrix< 10, 25, double > A;
+        for( size_t i = 0; i < 10 * 25; ++i )
+            A.array[ i ] = std::sin( double( i * i ) * 0.37 + 4.0 );
+
+        incremental_svd< 10, 10, double > isvd;
+        vector< 10, double > c;
+        for( size_t j = 0; j < 25; ++j )
+        {
+            A.get_column( j, c );
+            isvd.add_column( c );
+        }
+        A.get_column( 0, c );
+        isvd.downdate( c );
+
+        for( size_t i = 0; i < 10; ++i )
+            A( i, 0 ) = 0.0;
+        vector< 10, double > sigma;
+        reference_sigma( A, sigma );
+
+        matrix< 10, 10, double > U;
+        isvd.get_basis( U );
+
+        ok = isvd.get_sample_count() == 24 && isvd.get_rank() == 10;
+        for( size_t i = 0; i < 10; ++i )
+            ok = ok && std::fabs( isvd.get_singular_values()( i ) - sigma( i )) < 1e-8 * sigma( 0 );
+        ok = ok && orthogonality_error( U, 10 ) < 1e-12;
+        log( "downdate", ok );
+    }
+
+    {
+        // projection coefficients and explicit reorthogonalization
+        matrix< 20, 30, double > A;
+        make_low_rank< 20, 30, 5 >( A, 5 );
+
+        incremental_svd< 20, 8, double > isvd;
+        isvd.set_reorthogonalization_interval( 0 );
+        vector< 20, double > c;
+        for( size_t j = 0; j < 30; ++j )
+        {
+            A.get_column( j, c );
+            isvd.add_column( c );
+        }
+        const vector< 8, double > sigma = isvd.get_singular_values();
+
+        matrix< 20, 8, double > U;
+        isvd.get_basis( U );
+        A.get_column( 3, c );
+        vector< 8, double > coefficients;
+        isvd.project( c, coefficients );
+
+        ok = true;
+        for( size_t k = 0; k < 8; ++k )
+        {
+            double s = 0.0;
+            for( size_t i = 0; i < 20; ++i )
+                s += U( i, k ) * c( i );
+            ok = ok && std::fabs( coefficients( k ) - s ) < 1e-12;
+        }
+
+        isvd.reorthogonalize();
+        isvd.get_basis( U );
+        ok = ok && isvd.get_rank() == 5;
+        for( size_t i = 0; i < 8; ++i )
+            ok = ok && std::fabs( isvd.get_singular_values()( i ) - sigma( i )) < 1e-12 * sigma( 0 );
+        ok = ok && orthogonality_error( U, 5 ) < 1e-14;
+        ok = ok && span_error( U, A ) < 1e-10 * sigma( 0 );
+        log( "project, reorthogonalize", ok );
+    }
+
+    {
+        incremental_svd< 6, 3, double > isvd;
+        vector< 6, double > c;
+        c = 0.0;
+        isvd.add_column( c );
+        ok = isvd.get_rank() == 0 && isvd.get_sample_count() == 1;
+        c( 2 ) = 3.0;
+        isvd.add_column( c );
+        isvd.add_column( c );
+        ok = ok && isvd.get_rank() == 1
+            && std::fabs( isvd.get_singular_values()( 0 ) - std::sqrt( 18.0 )) < 1e-14;
+        isvd.reset();
+        ok = ok && isvd.get_rank() == 0 && isvd.get_sample_count() == 0;
+        log( "zero columns, repeated columns, reset", ok );
+    }
+
+    return global_ok;
+}
+
+} // namespace vmml
@@ -0,0 +1,21 @@
+#ifndef __VMML__INCREMENTAL_SVD_TEST__HPP__
+#define __VMML__INCREMENTAL_SVD_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class incremental_svd_test : public unit_test
+{
+public:
+    incremental_svd_test() : unit_test( "incremental svd" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class incremental_svd_test
+
+} // namespace vmml
+
+#endif
@@ -0,0 +1,83 @@
+#include "jacobi_svd_perf_test.hpp"
+
+#include <vmmlib/jacobi_svd.hpp>
+#include <vmmlib/svd.hpp>
+#ifdef VMMLIB_USE_LAPACK
+#  include <vmmlib/lapack_svd.hpp>
+#  include <vmmlib/matrix_pseudoinverse.hpp>
+#endif
+
+#include <sstream>
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+template< size_t M, size_t N >
+void
+run_svd_comparison( performance_test& test, size_t count, size_t iterations )
+{
+    std::vector< matrix< M, N, double > > a( count ), u( count );
+    std::vector< vector< N, double > > sigma( count );
+    std::vector< matrix< N, N, double > > vt( count );
+    for( size_t k = 0; k < count; ++k )
+        for( size_t i = 0; i < M * N; ++i )
+            a[ k ].array[ i ] = sin( double( i * i ) * 0.37 + double( k ));
+
+    std::stringstream name;
+    name << "svd of " << count << " " << M << "x" << N << " matrices";
+    test.new_test( name.str() );
+
+    test.start( "svdecompose" );
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t k = 0; k < count; ++k )
+        {
+            u[ k ] = a[ k ];
+            svdecompose( u[ k ], sigma[ k ], vt[ k ] );
+        }
+    test.stop();
+
+#ifdef VMMLIB_USE_LAPACK
+    test.start( "lapack_svd" );
+    lapack_svd< M, N, double > svd_lapack;
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t k = 0; k < count; ++k )
+            svd_lapack.compute( a[ k ], u[ k ], sigma[ k ], vt[ k ] );
+    test.stop();
+#endif
+
+    test.start( "jacobi_svd" );
+    jacobi_svd< M, N, double > svd;
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t k = 0; k < count; ++k )
+            svd.compute( a[ k ], u[ k ], sigma[ k ], vt[ k ] );
+    test.stop();
+
+#ifdef VMMLIB_USE_LAPACK
+    test.start( "compute_pseudoinverse (jacobi_svd)" );
+    compute_pseudoinverse< matrix< M, N, double > > compute_pinv;
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t k = 0; k < count; ++k )
+            compute_pinv( a[ k ], u[ k ] );
+    test.stop();
+#endif
+    test.compare();
+}
+
+} // anonymous namespace
+
+
+void
+jacobi_svd_perf_test::run()
+{
+    run_svd_comparison< 3, 3 >( *this, 10000, 10 );
+    run_svd_comparison< 4, 4 >( *this, 10000, 10 );
+    run_svd_comparison< 6, 4 >( *this, 10000, 10 );
+    run_svd_comparison< 8, 8 >( *this, 10000, 10 );
+}
+
+
+} // namespace vmml
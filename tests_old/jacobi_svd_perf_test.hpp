@@ -0,0 +1,20 @@
+#ifndef __VMML__JACOBI_SVD_PERF_TEST__HPP__
+#define __VMML__JACOBI_SVD_PERF_TEST__HPP__
+
+#include "performance_test.hpp"
+
+namespace vmml
+{
+
+class jacobi_svd_perf_test : public performance_test
+{
+public:
+    virtual void run();
+
+protected:
+
+}; // class jacobi_svd_perf_test
+
+} // namespace vmml
+
+#endif
@@ -0,0 +1,224 @@
+#include "jacobi_svd_test.hpp"
+
+#include <vmmlib/jacobi_svd.hpp>
+#include <vmmlib/svd.hpp>
+#include <vmmlib/lapack_svd.hpp>
+#include <vmmlib/matrix_pseudoinverse.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <sstream>
+
+namespace vmml
+{
+
+namespace
+{
+
+double
+test_value( size_t i, int seed )
+{
+    return std::sin( double( i * i ) * 0.37 + double( seed ));
+}
+
+template< size_t M, size_t N, typename T >
+void
+make_matrix( matrix< M, N, T >& A, int seed )
+{
+    for( size_t i = 0; i < M * N; ++i )
+        A.array[ i ] = T( test_value( i, seed ));
+}
+
+// max | U * diag( sigma ) * Vt - A | and the deviation of U^T U (on the
+// columns with nonzero sigma) and Vt Vt^T from the identity
+template< size_t M, size_t N, typename T >
+void
+svd_errors( const matrix< M, N, T >& A, const matrix< M, N, T >& U,
+            const vector< N, T >& sigma, const matrix< N, N, T >& Vt,
+            double& reconstruction_error, double& orthogonality_error )
+{
+    reconstruction_error = 0.0;
+    for( size_t i = 0; i < M; ++i )
+        for( size_t j = 0; j < N; ++j )
+        {
+            double s = 0.0;
+            for( size_t k = 0; k < N; ++k )
+                s += double( U( i, k )) * sigma( k ) * Vt( k, j );
+            reconstruction_error = (std::max)( reconstruction_error,
+                                               std::fabs( s - A( i, j )));
+        }
+
+    orthogonality_error = 0.0;
+    for( size_t j = 0; j < N; ++j )
+        for( size_t k = 0; k < N; ++k )
+        {
+            double u = 0.0, v = 0.0;
+            for( size_t i = 0; i < M; ++i )
+                u += double( U( i, j )) * U( i, k );
+            for( size_t i = 0; i < N; ++i )
+                v += double( Vt( j, i )) * Vt( k, i );
+            const double id = j == k ? 1.0 : 0.0;
+            if ( sigma( j ) > 0 && sigma( k ) > 0 )
+                orthogonality_error = (std::max)( orthogonality_error, std::fabs( u - id ));
+            orthogonality_error = (std::max)( orthogonality_error, std::fabs( v - id ));
+        }
+}
+
+// compares jacobi_svd against lapack_svd and svdecompose
+template< size_t M, size_t N >
+bool
+check_against_reference( int seed, double tolerance, std::stringstream& error )
+{
+    matrix< M, N, double > A, U;
+    make_matrix( A, seed );
+    vector< N, double > sigma, sigma_lapack, sigma_old;
+    matrix< N, N, double > Vt;
+
+    jacobi_svd< M, N, double > svd;
+    bool ok = svd.compute( A, U, sigma, Vt );
+
+    lapack_svd< M, N, double > svd_lapack;
+    matrix< M, N, double > U_lapack;
+    matrix< N, N, double > Vt_lapack;
+    ok = ok && svd_lapack.compute( A, U_lapack, sigma_lapack, Vt_lapack );
+
+    matrix< M, N, double > U_old( A );
+    svdecompose( U_old, sigma_old, Vt_lapack );
+    std::sort( sigma_old.begin(), sigma_old.end(), std::greater< double >( ));
+
+    double max_diff = 0.0;
+    for( size_t k = 0; k < N; ++k )
+    {
+        max_diff = (std::max)( max_diff, std::fabs( sigma( k ) - sigma_lapack( k )));
+        max_diff = (std::max)( max_diff, std::fabs( sigma( k ) - sigma_old( k )));
+        ok = ok && ( k == 0 || sigma( k ) <= sigma( k - 1 ));
+    }
+
+    double reconstruction_error, orthogonality_error;
+    svd_errors( A, U, sigma, Vt, reconstruction_error, orthogonality_error );
+
+    vector< N, double > sigma_only;
+    svd.compute( A, sigma_only );
+
+    ok = ok && max_diff < tolerance * sigma_lapack( 0 )
+        && reconstruction_error < tolerance
+        && orthogonality_error < tolerance
+        && sigma_only.equals( sigma, tolerance );
+    if ( !ok )
+        error << M << "x" << N << ": sigma " << sigma
+              << " lapack " << sigma_lapack << " old " << sigma_old
+              << " reconstruction error " << reconstruction_error
+              << " orthogonality error " << orthogonality_error << std::endl;
+    return ok;
+}
+
+} // anonymous namespace
+
+
+bool
+jacobi_svd_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    {
+        std::stringstream error;
+        TEST(( check_against_reference< 3, 3 >( 1, 1e-13, error )));
+        TEST(( check_against_reference< 4, 4 >( 2, 1e-13, error )));
+        TEST(( check_against_reference< 6, 4 >( 3, 1e-13, error )));
+        TEST(( check_against_reference< 8, 8 >( 4, 1e-13, error )));
+        TEST(( check_against_reference< 8, 5 >( 5, 1e-13, error )));
+        log( "jacobi svd vs lapack_svd and svdecompose (3x3 .. 8x8)", ok );
+        if ( !ok )
+            log_error( error.str() );
+    }
+
+    // graded columns: the small singular values keep their relative accuracy
+    {
+        matrix< 5, 5, double > A, U;
+        make_matrix( A, 6 );
+        for( size_t j = 0; j < 5; ++j )
+            for( size_t i = 0; i < 5; ++i )
+                A( i, j ) *= std::pow( 1e-3, double( j ));
+        vector< 5, double > sigma, sigma_lapack;
+        matrix< 5, 5, double > Vt;
+        jacobi_svd< 5, 5, double > svd;
+        svd.compute( A, U, sigma, Vt );
+        lapack_svd< 5, 5, double > svd_lapack;
+        svd_lapack.compute( A, sigma_lapack );
+
+        ok = true;
+        for( size_t k = 0; k < 5; ++k )
+            TEST( std::fabs( sigma( k ) - sigma_lapack( k )) < 1e-10 * sigma_lapack( k ));
+        log( "jacobi svd, graded matrix", ok );
+    }
+
+    // rank deficient: two equal columns
+    {
+        matrix< 5, 3, double > A, U;
+        make_matrix( A, 7 );
+        for( size_t i = 0; i < 5; ++i )
+            A( i, 2 ) = A( i, 0 );
+        vector< 3, double > sigma;
+        matrix< 3, 3, double > Vt;
+        jacobi_svd< 5, 3, double > svd;
+        svd.compute( A, U, sigma, Vt );
+
+        double reconstruction_error, orthogonality_error;
+        svd_errors( A, U, sigma, Vt, reconstruction_error, orthogonality_error );
+
+        ok = true;
+        TEST( sigma( 2 ) < 1e-14 * sigma( 0 ));
+        TEST( reconstruction_error < 1e-13 && orthogonality_error < 1e-13 );
+        log( "jacobi svd, rank deficient matrix", ok );
+    }
+
+    // single precision, in place
+    {
+        matrix< 4, 3, float > A, U;
+        make_matrix( A, 8 );
+        U = A;
+        vector< 3, float > sigma;
+        matrix< 3, 3, float > Vt;
+        jacobi_svd< 4, 3, float > svd;
+        svd.compute_and_overwrite_input( U, sigma, Vt );
+
+        double reconstruction_error, orthogonality_error;
+        svd_errors( A, U, sigma, Vt, reconstruction_error, orthogonality_error );
+
+        ok = true;
+        TEST( reconstruction_error < 1e-5 && orthogonality_error < 1e-5 );
+        log( "jacobi svd, single precision", ok );
+    }
+
+    // compute_pseudoinverse uses jacobi_svd for small inputs:
+    // pinv( A ) * A = I for full column rank
+    {
+        typedef matrix< 6, 4, double > input_type;
+        input_type A, pinv_transposed;
+        make_matrix( A, 9 );
+        compute_pseudoinverse< input_type > compute_pinv;
+        compute_pinv( A, pinv_transposed );
+
+        matrix< 4, 6, double > pinv;
+        pinv_transposed.transpose_to( pinv );
+
+        ok = true;
+        TEST(( pinv * A ).equals( matrix< 4, 4, double >::IDENTITY, 1e-12 ));
+
+        typedef matrix< 3, 7, double > wide_type;
+        wide_type B, pinv_transposed_b;
+        make_matrix( B, 10 );
+        compute_pseudoinverse< wide_type > compute_pinv_b;
+        compute_pinv_b( B, pinv_transposed_b );
+
+        matrix< 7, 3, double > pinv_b;
+        pinv_transposed_b.transpose_to( pinv_b );
+        TEST(( B * pinv_b ).equals( matrix< 3, 3, double >::IDENTITY, 1e-12 ));
+        log( "compute_pseudoinverse with jacobi svd", ok );
+    }
+
+    return global_ok;
+}
+
+} // namespace vmml
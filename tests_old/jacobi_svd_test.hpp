@@ -0,0 +1,21 @@
+#ifndef __VMML__JACOBI_SVD_TEST__HPP__
+#define __VMML__JACOBI_SVD_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class jacobi_svd_test : public unit_test
+{
+public:
+    jacobi_svd_test() : unit_test( "one-sided jacobi svd" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class jacobi_svd_test
+
+} // namespace vmml
+
+#endif
@@ -1,8 +1,13 @@
 #include "lapack_svd_test.hpp"
 
 #include <vmmlib/lapack_svd.hpp>
+#include <vmmlib/lapack_solver_pool.hpp>
 #include <vmmlib/matrix_functors.hpp>
 
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+
 namespace vmml
 {
 
@@ -146,6 +151,78 @@ lapack_svd_test::run()
         log_error( ss.str() );
     }
 
+    // one solver reused for all variants, in-place variants, per-thread pool
+    ok = true;
+    {
+        lapack_svd< 6, 3, double > svd_reused;
+        matrix< 6, 3, double > A_copy( A );
+        matrix< 6, 3, double > U_red;
+        matrix< 3, 3, double > Vt_red;
+        vector< 3, double > sigma_red;
+
+        for( size_t i = 0; i < 3; ++i )
+        {
+            TEST(svd_reused.compute( A, U_red, sigma_red, Vt_red ));
+            TEST(sigma_red.equals( sigmaCorrect, tolerance ));
+            TEST(v_compare( Vt_red, V, tolerance ));
+            sigma_red.set( 0.0 );
+            TEST(svd_reused.compute( A, sigma_red ));
+            TEST(sigma_red.equals( sigmaCorrect, tolerance ));
+        }
+        TEST(A == A_copy);
+
+        matrix< 6, 3, double >& A_U = svd_reused.get_input_scratch();
+        A_U = A;
+        TEST(svd_reused.compute_and_overwrite_input( A_U, svd_reused.get_sigma_scratch(), Vt_red ));
+        TEST(svd_reused.get_sigma_scratch().equals( sigmaCorrect, tolerance ));
+        TEST(v_compare( Vt_red, V, tolerance ));
+        TEST(A_U.equals( U_red, tolerance ));
+
+        A_U = A;
+        TEST(svd_reused.compute_sigma_and_overwrite_input( A_U, sigma_red ));
+        TEST(sigma_red.equals( sigmaCorrect, tolerance ));
+
+        typedef lapack_svd< 6, 3, double > svd_type;
+        lapack_solver_pool< svd_type > pool;
+        int n_failed = 0;
+        #pragma omp parallel for reduction( + : n_failed )
+        for( int i = 0; i < 64; ++i )
+        {
+            svd_type& svd_local = pool.get();
+            matrix< 6, 3, double >& A_local = svd_local.get_input_scratch();
+            A_local = A;
+            A_local *= double( i + 1 );
+            vector< 3, double >& sigma_local = svd_local.get_sigma_scratch();
+            if ( ! svd_local.compute_sigma_and_overwrite_input( A_local, sigma_local ) )
+                ++n_failed;
+            else if ( ! sigma_local.equals( sigmaCorrect * double( i + 1 ), tolerance * ( i + 1 ) ) )
+                ++n_failed;
+        }
+        TEST(n_failed == 0);
+        TEST(&lapack_solver_pool< svd_type >::get_local() == &lapack_solver_pool< svd_type >::get_local());
+
+#ifdef _OPENMP
+        // inner regions of both outer threads run with thread number 0
+        svd_type* nested_solvers[ 2 ] = { 0, 0 };
+        int n_outer_threads = 0;
+        #pragma omp parallel num_threads( 2 )
+        {
+            const int outer = omp_get_thread_num();
+            #pragma omp single
+            n_outer_threads = omp_get_num_threads();
+            #pragma omp parallel num_threads( 1 )
+            {
+                nested_solvers[ outer ] = &lapack_solver_pool< svd_type >::get_local();
+            }
+        }
+        if ( n_outer_threads == 2 )
+        {
+            TEST(nested_solvers[ 0 ] != nested_solvers[ 1 ]);
+        }
+#endif
+    }
+    log( "reused lapack xGESVD solver, in-place variants and per-thread pool", ok );
+
 	return global_ok;
 }
 
@@ -1,6 +1,9 @@
 #include "lapack_sym_eigs_test.hpp"
 #include <vmmlib/matrix.hpp>
 #include <vmmlib/lapack_sym_eigs.hpp>
+#include <vmmlib/lapack_packed_sym_eigs.hpp>
+#include <vmmlib/lapack_banded_sym_eigs.hpp>
+#include <vmmlib/packed_matrix.hpp>
 
 namespace vmml
 {
@@ -103,6 +106,132 @@ namespace vmml
 		}
 		//end compute x largest eigenvalues
 
+		//reused solver and in-place variants
+		ok = true;
+		{
+			matrix< 4, 4, double > A_copy( A );
+			for( size_t i = 0; i < 3; ++i )
+			{
+				eigxvectors.zero();
+				eigxvalues.set( 0.0 );
+				TEST(eigs.compute_x( A, eigxvectors, eigxvalues ));
+				TEST(eigxvalues.equals( eigxvalues_check, precision ));
+				TEST(eigxvectors.equals( eigxvectors_check, precision ));
+			}
+			TEST(A == A_copy);
+
+			matrix< 4, 4, double >& A_scratch = eigs.get_input_scratch();
+			A_scratch = A;
+			TEST(eigs.compute_x_and_overwrite_input( A_scratch, eigxvectors, eigxvalues ));
+			TEST(eigxvalues.equals( eigxvalues_check, precision ));
+			TEST(eigxvectors.equals( eigxvectors_check, precision ));
+
+			A_scratch = A;
+			TEST(eigs.compute_1st_and_overwrite_input( A_scratch, eigvector, eigvalue ));
+			TEST(eigvector.equals( eigvector_check, precision ));
+			TEST(fabs( eigvalue - first_eigvalue ) < precision);
+
+			A_scratch = A;
+			TEST(eigs.compute_all_and_overwrite_input( A_scratch, eigvectors, eigvalues ));
+			TEST(eigvalues.equals( eigvalues_check, precision ));
+		}
+		log( "symmetric eigenvalue decomposition, reused solver and in-place variants", ok );
+
+		//packed storage (dspevd). the reference values above come from
+		//dsyevx with abstol 1e-4, dspevd converges fully: check the
+		//residuals and compare the eigenvalues at the dsyevx tolerance
+		ok = true;
+		{
+			symmetric_matrix< 4, double > A_packed;
+			A_packed.set( A );
+			symmetric_matrix< 4, double > A_packed_copy( A_packed );
+
+			lapack_packed_sym_eigs< 4, double > packed_eigs;
+			TEST(packed_eigs.compute_all( A_packed, eigvectors, eigvalues ));
+			TEST(eigvalues.equals( eigvalues_check, 1.0e-4 ));
+			TEST(A_packed == A_packed_copy);
+			for( size_t col = 0; col < 4; ++col )
+			{
+				vector< 4, double > v, av;
+				eigvectors.get_column( col, v );
+				A_packed.multiply( v, av );
+				TEST(( av - v * eigvalues( col ) ).length() < precision);
+			}
+
+			TEST(packed_eigs.compute_x( A_packed, eigxvectors, eigxvalues ));
+			TEST(eigxvalues.equals( eigxvalues_check, 1.0e-4 ));
+			for( size_t col = 0; col < 3; ++col )
+			{
+				vector< 4, double > v, av;
+				eigxvectors.get_column( col, v );
+				A_packed.multiply( v, av );
+				TEST(( av - v * eigxvalues( col ) ).length() < precision);
+			}
+
+			symmetric_matrix< 4, double >& A_scratch = packed_eigs.get_input_scratch();
+			A_scratch = A_packed;
+			vector< 4, double > eigvalues_packed( eigvalues );
+			TEST(packed_eigs.compute_all_and_overwrite_input( A_scratch, eigvectors, eigvalues ));
+			TEST(eigvalues.equals( eigvalues_packed, precision ));
+		}
+		log( "symmetric eigenvalue decomposition, packed storage", ok );
+
+
+		//symmetric band matrix, two sub- and superdiagonals: all
+		//eigenvalues against dsyevx (at its tolerance), selected
+		//eigenpairs against all of them
+		ok = true;
+		{
+			matrix< 8, 8, double > B;
+			B.zero();
+			for( size_t i = 0; i < 8; ++i )
+			{
+				B( i, i ) = 2.0 - 0.5 * i;
+				if ( i < 7 ) B( i, i + 1 ) = B( i + 1, i ) = 1.0 + 0.25 * i;
+				if ( i < 6 ) B( i, i + 2 ) = B( i + 2, i ) = -0.5;
+			}
+			banded_matrix< 8, 2, 2, double > B_band;
+			B_band.set( B );
+			banded_matrix< 8, 2, 2, double > B_band_copy( B_band );
+
+			matrix< 8, 8, double > dense_vectors, band_vectors;
+			vector< 8, double > dense_values, band_values;
+			lapack_sym_eigs< 8, double > dense_eigs;
+			TEST(dense_eigs.compute_all( B, dense_vectors, dense_values ));
+
+			lapack_banded_sym_eigs< 8, 2, double > band_eigs;
+			TEST(band_eigs.compute_all( B_band, band_vectors, band_values ));
+			TEST(band_values.equals( dense_values, 1.0e-4 ));
+			for( size_t i = 0; i < 8; ++i )
+				TEST(B_band.array[ i ] == B_band_copy.array[ i ]);
+			for( size_t col = 0; col < 8; ++col )
+			{
+				vector< 8, double > v, av;
+				band_vectors.get_column( col, v );
+				B_band.multiply( v, av );
+				TEST(( av - v * band_values( col ) ).length() < precision);
+			}
+
+			matrix< 8, 3, double > small_vectors;
+			vector< 3, double > small_values;
+			TEST(band_eigs.compute_smallest( B_band, small_vectors, small_values ));
+			matrix< 8, 2, double > large_vectors;
+			vector< 2, double > large_values;
+			TEST(band_eigs.compute_largest( B_band, large_vectors, large_values ));
+			for( size_t i = 0; i < 3; ++i )
+				TEST(fabs( small_values( i ) - band_values( i )) < precision);
+			for( size_t i = 0; i < 2; ++i )
+				TEST(fabs( large_values( i ) - band_values( 6 + i )) < precision);
+			for( size_t col = 0; col < 2; ++col )
+			{
+				vector< 8, double > v, av;
+				large_vectors.get_column( col, v );
+				B_band.multiply( v, av );
+				TEST(( av - v * large_values( col ) ).length() < precision);
+			}
+		}
+		log( "symmetric eigenvalue decomposition, band storage (selected eigenpairs)", ok );
+
 		return global_ok;
 	}
 
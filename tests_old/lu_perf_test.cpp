@@ -0,0 +1,73 @@
+#include "lu_perf_test.hpp"
+
+#include <vmmlib/matrix.hpp>
+
+#include <sstream>
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+template< size_t N >
+void
+run_lu_comparison( performance_test& test, size_t count, size_t iterations )
+{
+    typedef matrix< N, N, double > matrix_type;
+    std::vector< matrix_type > a( count );
+    for( size_t k = 0; k < count; ++k )
+        for( size_t row = 0; row < N; ++row )
+            for( size_t col = 0; col < N; ++col )
+                a[ k ].at( row, col ) =
+                    sin( double( row * col * 3 + row * 13 + col * 7 + k + 1 ));
+
+    vector< N, double > b;
+    for( size_t row = 0; row < N; ++row )
+        b( row ) = cos( double( row ));
+
+    matrix_type inverse_;
+    std::vector< vector< N, double > > x( count );
+    std::vector< double > det( count );
+
+    std::stringstream name;
+    name << count << " " << N << "x" << N << " systems";
+    test.new_test( name.str() );
+
+    test.start( "compute_inverse, then multiply" );
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t k = 0; k < count; ++k )
+        {
+            compute_inverse( a[ k ], inverse_ );
+            x[ k ] = inverse_ * b;
+        }
+    test.stop();
+
+    test.start( "compute_solve" );
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t k = 0; k < count; ++k )
+            compute_solve( a[ k ], b, x[ k ] );
+    test.stop();
+
+    test.start( "compute_determinant" );
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t k = 0; k < count; ++k )
+            det[ k ] = compute_determinant( a[ k ] );
+    test.stop();
+    test.compare();
+}
+
+} // anonymous namespace
+
+
+void
+lu_perf_test::run()
+{
+    run_lu_comparison< 6 >( *this, 10000, 10 );
+    run_lu_comparison< 16 >( *this, 1000, 10 );
+    run_lu_comparison< 64 >( *this, 100, 2 );
+}
+
+
+} // namespace vmml
@@ -114,6 +114,83 @@ namespace vmml
 		}
 
 
+		// pseudoinverse object: normal equations and svd fallback
+		{
+			ok = true;
+			typedef matrix< 6, 4, double > tall_type;
+			tall_type A, pinv_t, A_check;
+			matrix< 4, 6, double > pinv, pinv_svd;
+			for( size_t i = 0; i < 24; ++i )
+				A.array[ i ] = sin( double( i * i ) * 0.37 + 1.0 );
+
+			pseudoinverse_solver< 6, 4, double > pinv_solver;
+			pinv_solver.compute( A, pinv );
+			TEST( pinv_solver.used_normal_equations() );
+			TEST(( pinv * A ).equals( matrix< 4, 4, double >::IDENTITY, 1e-12 ));
+			pinv_solver.compute_transposed( A, pinv_t );
+			TEST( pinv_t.equals( transpose( pinv ), 1e-15 ));
+
+			pinv_solver.set_normal_equations( false );
+			pinv_solver.compute( A, pinv_svd );
+			TEST( !pinv_solver.used_normal_equations() && pinv_solver.get_rank() == 4 );
+			TEST( pinv_svd.equals( pinv, 1e-12 ));
+
+			// wide
+			matrix< 3, 7, double > B, B_pinv_t;
+			matrix< 7, 3, double > B_pinv;
+			for( size_t i = 0; i < 21; ++i )
+				B.array[ i ] = sin( double( i * i ) * 0.37 + 2.0 );
+			pseudoinverse_solver< 3, 7, double > pinv_solver_b;
+			pinv_solver_b.compute( B, B_pinv );
+			TEST( pinv_solver_b.used_normal_equations() );
+			TEST(( B * B_pinv ).equals( matrix< 3, 3, double >::IDENTITY, 1e-12 ));
+			pinv_solver_b.compute_transposed( B, B_pinv_t );
+			TEST( B_pinv_t.equals( transpose( B_pinv ), 1e-15 ));
+
+			// ill-conditioned: the gram matrix would lose all digits
+			tall_type C = A;
+			for( size_t i = 0; i < 6; ++i )
+				C( i, 3 ) = C( i, 2 ) + 1e-9 * C( i, 3 );
+			pinv_solver.set_normal_equations( true );
+			pinv_solver.compute( C, pinv );
+			TEST( !pinv_solver.used_normal_equations() );
+			TEST(( pinv * C ).equals( matrix< 4, 4, double >::IDENTITY, 1e-6 ));
+
+			// rank deficient: a duplicate column is truncated
+			for( size_t i = 0; i < 6; ++i )
+				C( i, 3 ) = C( i, 2 );
+			pinv_solver.compute( C, pinv );
+			TEST( pinv_solver.get_rank() == 3 );
+			TEST(( C * pinv * C ).equals( C, 1e-12 ));
+			TEST(( pinv * C * pinv ).equals( pinv, 1e-12 ));
+
+			// larger inputs use lapack_svd for the fallback
+			matrix< 40, 10, double > D;
+			matrix< 10, 40, double > D_pinv, D_pinv_svd;
+			for( size_t i = 0; i < 400; ++i )
+				D.array[ i ] = sin( double( i * i ) * 0.37 + 3.0 );
+			pseudoinverse_solver< 40, 10, double > pinv_solver_d;
+			pinv_solver_d.compute( D, D_pinv );
+			TEST( pinv_solver_d.used_normal_equations() );
+			pinv_solver_d.set_normal_equations( false );
+			pinv_solver_d.compute( D, D_pinv_svd );
+			TEST( D_pinv.equals( D_pinv_svd, 1e-12 ));
+
+			// float values, decomposed in double
+			matrix< 40, 10, float > D_f;
+			matrix< 10, 40, float > D_pinv_f, D_pinv_cast;
+			D_f.cast_from( D );
+			D_pinv_cast.cast_from( D_pinv );
+			pseudoinverse_solver< 40, 10, float > pinv_solver_f;
+			pinv_solver_f.compute( D_f, D_pinv_f );
+			TEST( D_pinv_f.equals( D_pinv_cast, 1e-5f ));
+			pinv_solver_f.set_normal_equations( false );
+			pinv_solver_f.compute( D_f, D_pinv_f );
+			TEST( D_pinv_f.equals( D_pinv_cast, 1e-5f ));
+
+			log( "pseudoinverse with normal equations and svd fallback", ok );
+		}
+
 
 		return global_ok;
 	}
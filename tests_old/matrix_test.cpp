@@ -4,6 +4,7 @@
 #include <vmmlib/vector.hpp>
 
 #include <sstream>
+#include <vector>
 
 namespace vmml
 {
@@ -670,6 +671,172 @@ bool matrix_test::run()
         }
     }
 
+    // fast inverses of rigid and affine 4x4 transformations
+    {
+        ok = true;
+        matrix< 4, 4, double > rigid, affine, general, inverse_, check;
+        rigid.rotate( 0.7, vector< 3, double >( 2, -1, 2 ) / 3.0 );
+        rigid.set_translation( 3.0, -4.0, 5.0 );
+        affine = rigid;
+        affine.scale( 2.0, 0.5, 3.0 );
+        affine.at( 0, 1 ) += 0.25; // shear
+        general = affine;
+        general.at( 3, 0 ) = 0.1; // projective
+
+        TEST( is_rigid_transform( rigid ));
+        TEST( !is_rigid_transform( affine ) && is_affine_transform( affine ));
+        TEST( !is_affine_transform( general ));
+
+        rigid.inverse( check );
+        rigid.inverse_rigid( inverse_ );
+        TEST( inverse_.equals( check, 1e-14 ));
+        TEST( rigid.inverse_fast( inverse_ ) && inverse_.equals( check, 1e-14 ));
+
+        affine.inverse( check );
+        TEST( affine.inverse_affine( inverse_ ) && inverse_.equals( check, 1e-14 ));
+        TEST( affine.inverse_fast( inverse_ ) && inverse_.equals( check, 1e-14 ));
+
+        general.inverse( check );
+        TEST( general.inverse_fast( inverse_ ) && inverse_.equals( check, 1e-14 ));
+
+        // in place
+        inverse_ = rigid;
+        compute_inverse_rigid( inverse_, inverse_ );
+        TEST( ( rigid * inverse_ ).equals( matrix< 4, 4, double >::IDENTITY, 1e-14 ));
+        inverse_ = affine;
+        TEST( compute_inverse_affine( inverse_, inverse_ ));
+        TEST( ( affine * inverse_ ).equals( matrix< 4, 4, double >::IDENTITY, 1e-14 ));
+
+        matrix< 4, 4, double > singular = affine;
+        singular.scale( 1.0, 0.0, 1.0 );
+        TEST( !singular.inverse_affine( inverse_ ));
+        TEST( !singular.inverse_fast( inverse_ ));
+
+        // batches
+        const size_t count = 12;
+        std::vector< matrix< 4, 4, double > > batch( count ), inverses( count );
+        for( size_t i = 0; i < count; ++i )
+        {
+            batch[ i ].rotate_z( 0.1 * double( i ));
+            batch[ i ].set_translation( double( i ), 1.0, -2.0 );
+        }
+        compute_inverse_rigid( &batch[ 0 ], &inverses[ 0 ], count );
+        bool batch_ok = true;
+        for( size_t i = 0; i < count; ++i )
+            batch_ok = batch_ok &&
+                ( batch[ i ] * inverses[ i ] ).equals( matrix< 4, 4, double >::IDENTITY, 1e-14 );
+        TEST( batch_ok );
+
+        batch[ 3 ] = affine;
+        batch[ 5 ] = general;
+        batch[ 7 ] = singular;
+        TEST( compute_inverse_fast( &batch[ 0 ], &inverses[ 0 ], count ) == count - 1 );
+        batch[ 7 ] = affine;
+        TEST( compute_inverse_affine( &batch[ 0 ], &inverses[ 0 ], 5 ) == 5 );
+        batch_ok = true;
+        for( size_t i = 0; i < 5; ++i )
+            batch_ok = batch_ok &&
+                ( batch[ i ] * inverses[ i ] ).equals( matrix< 4, 4, double >::IDENTITY, 1e-14 );
+        TEST( batch_ok );
+
+        log( "rigid, affine and auto-detected fast 4x4 inverses", ok );
+    }
+
+    // LU based determinant, inverse and solve for larger matrices
+    {
+        ok = true;
+
+        // 5x5 with a zero in the top left corner, so pivoting is needed.
+        // the determinant is checked against a laplace expansion.
+        matrix< 5, 5, double > m5;
+        for( size_t row = 0; row < 5; ++row )
+            for( size_t col = 0; col < 5; ++col )
+                m5.at( row, col ) = sin( double( row * col * 3 + row * 13 + col * 7 + 1 ));
+        m5.at( 0, 0 ) = 0.0;
+
+        matrix< 4, 4, double > minor_;
+        double laplace = 0.0;
+        for( size_t col = 0; col < 5; ++col )
+            laplace += ( col & 1 ? -1.0 : 1.0 ) * m5.at( 0, col )
+                * m5.get_minor( minor_, 0, col );
+        TEST( fabs( m5.det() - laplace ) < 1e-12 );
+
+        matrix< 5, 5, double > m5_inverse;
+        TEST( m5.inverse( m5_inverse ));
+        TEST( ( m5 * m5_inverse ).equals( matrix< 5, 5, double >::IDENTITY, 1e-12 ));
+
+        // triangular matrices, one with two rows swapped
+        matrix< 8, 8, double > m8 = matrix< 8, 8, double >::IDENTITY;
+        double diagonal = 1.0;
+        for( size_t col = 0; col < 8; ++col )
+        {
+            m8.at( col, col ) = double( col + 1 );
+            diagonal *= double( col + 1 );
+            for( size_t row = 0; row < col; ++row )
+                m8.at( row, col ) = 0.5;
+        }
+        TEST( fabs( m8.det() - diagonal ) < 1e-9 );
+        vector< 8, double > row_a, row_b;
+        m8.get_row( 2, row_a );
+        m8.get_row( 6, row_b );
+        m8.set_row( 2, row_b );
+        m8.set_row( 6, row_a );
+        TEST( fabs( m8.det() + diagonal ) < 1e-9 );
+
+        // 40x40 uses the blocked factorization
+        matrix< 40, 40, double > m40, m40_inverse;
+        for( size_t row = 0; row < 40; ++row )
+            for( size_t col = 0; col < 40; ++col )
+                m40.at( row, col ) = sin( double( row * col * 3 + row * 13 + col * 7 + 1 ));
+        TEST( m40.inverse( m40_inverse ));
+        TEST( ( m40 * m40_inverse ).equals( matrix< 40, 40, double >::IDENTITY, 1e-9 ));
+
+        matrix< 40, 3, double > b, x;
+        for( size_t row = 0; row < 40; ++row )
+            for( size_t col = 0; col < 3; ++col )
+                b.at( row, col ) = cos( double( row + col * 40 ));
+        TEST( m40.solve( b, x ));
+        TEST( ( m40 * x ).equals( b, 1e-9 ));
+
+        vector< 40, double > b_vector, x_vector;
+        b.get_column( 1, b_vector );
+        x_vector = b_vector;
+        TEST( compute_solve( m40, x_vector, x_vector ));
+        TEST( ( m40 * x_vector ).equals( b_vector, 1e-9 ));
+
+        // one workspace shared by several calls
+        lu_workspace< 40, double > workspace;
+        matrix< 40, 40, double > m40_shifted = m40;
+        for( size_t i = 0; i < 3; ++i )
+        {
+            for( size_t diag = 0; diag < 40; ++diag )
+                m40_shifted.at( diag, diag ) += 0.5;
+            TEST( compute_inverse( m40_shifted, m40_inverse, workspace ));
+            TEST( ( m40_shifted * m40_inverse ).equals( matrix< 40, 40, double >::IDENTITY, 1e-9 ));
+            TEST( compute_solve( m40_shifted, b, x, workspace ));
+            TEST( ( m40_shifted * x ).equals( b, 1e-9 ));
+            TEST( compute_solve( m40_shifted, b_vector, x_vector, workspace ));
+            TEST( ( m40_shifted * x_vector ).equals( b_vector, 1e-9 ));
+            TEST( fabs( compute_determinant( m40_shifted, workspace )
+                - m40_shifted.det() ) <= 1e-9 * fabs( m40_shifted.det() ));
+        }
+
+        // singular: two equal rows
+        matrix< 7, 7, double > m7, m7_inverse;
+        for( size_t row = 0; row < 7; ++row )
+            for( size_t col = 0; col < 7; ++col )
+                m7.at( row, col ) = sin( double( row * col * 3 + row * 13 + col * 7 + 1 ));
+        vector< 7, double > row_7, b_7, x_7;
+        m7.get_row( 1, row_7 );
+        m7.set_row( 4, row_7 );
+        b_7 = 1.0;
+        TEST( fabs( m7.det() ) < 1e-12 );
+        TEST( !m7.inverse( m7_inverse ));
+        TEST( !m7.solve( b_7, x_7 ));
+
+        log( "LU determinant, inverse and solve for matrices larger than 4x4", ok );
+    }
+
     // set( .... ), _translation()
     {
         ok = true;
@@ -0,0 +1,193 @@
+#include "packed_matrix_perf_test.hpp"
+
+#include <vmmlib/packed_matrix.hpp>
+#include <vmmlib/blas_dgemm.hpp>
+#include <vmmlib/blas_dsyrk.hpp>
+#include <vmmlib/cholesky_solver.hpp>
+#include <vmmlib/matrix.hpp>
+
+#ifdef VMMLIB_USE_LAPACK
+#  include <vmmlib/lapack_sym_eigs.hpp>
+#  include <vmmlib/lapack_packed_sym_eigs.hpp>
+#endif
+
+#include <cmath>
+
+namespace vmml
+{
+
+void
+packed_matrix_perf_test::run()
+{
+    // covariance of a mode unfolding as in t3_hosvd::eigs_mode1
+    {
+        typedef matrix< 128, 128 * 128, double > unfolding_type;
+        unfolding_type* unfolding = new unfolding_type;
+        for( size_t i = 0; i < 128 * 128 * 128; ++i )
+            unfolding->array[ i ] = sin( double( i ) * 0.001 );
+
+        matrix< 128, 128, double >* cov = new matrix< 128, 128, double >;
+        symmetric_matrix< 128, double >* cov_packed = new symmetric_matrix< 128, double >;
+
+        new_test( "covariance of a 128 x 16384 unfolding, 10 times" );
+        start( "blas_dgemm, dense" );
+        {
+            blas_dgemm< 128, 128 * 128, 128, double > dgemm;
+            for( size_t k = 0; k < 10; ++k )
+                dgemm.compute( *unfolding, *cov );
+        }
+        stop();
+
+        start( "blas_dsyrk, packed" );
+        {
+            blas_dsyrk< 128, 128 * 128, double > dsyrk;
+            for( size_t k = 0; k < 10; ++k )
+                dsyrk.compute( *unfolding, *cov_packed );
+        }
+        stop();
+        compare();
+
+        new_test( "symmetric_covariance of a 128 x 16384 unfolding" );
+        start( "dense" );
+        unfolding->symmetric_covariance( *cov );
+        stop();
+
+        start( "packed" );
+        unfolding->symmetric_covariance( *cov_packed );
+        stop();
+        compare();
+
+        delete unfolding;
+        delete cov;
+        delete cov_packed;
+    }
+
+    // R x R gram matrices of the factor matrices as in t3_hopm
+    {
+        matrix< 256, 32, float >* u = new matrix< 256, 32, float >;
+        for( size_t i = 0; i < 256 * 32; ++i )
+            u->array[ i ] = float( sin( double( i ) * 0.01 ));
+
+        matrix< 32, 32, float >* gram = new matrix< 32, 32, float >;
+        symmetric_matrix< 32, float >* gram_packed = new symmetric_matrix< 32, float >;
+        vector< 32, float > lambdas( 1.0f );
+        double sum = 0.0;
+
+        new_test( "gram matrix 32 x 32 of a 256 x 32 factor and its norm, 20000 times" );
+        start( "blas_dgemm, dense, hadamard with lambda lambda^T" );
+        {
+            blas_dgemm< 32, 256, 32, float > dgemm;
+            blas_dgemm< 32, 1, 32, float > outer;
+            matrix< 32, 32, float >* coeff = new matrix< 32, 32, float >;
+            for( size_t k = 0; k < 20000; ++k )
+            {
+                dgemm.compute_t( *u, *gram );
+                outer.compute_vv_outer( lambdas, lambdas, *coeff );
+                coeff->multiply_piecewise( *gram );
+                sum += coeff->sum_elements();
+            }
+            delete coeff;
+        }
+        stop();
+
+        start( "blas_dsyrk, packed, quadratic form" );
+        {
+            blas_dsyrk< 32, 256, float > dsyrk;
+            for( size_t k = 0; k < 20000; ++k )
+            {
+                dsyrk.compute_t( *u, *gram_packed );
+                sum -= gram_packed->quadratic_form( lambdas );
+            }
+        }
+        stop();
+        compare();
+
+        if ( fabs( sum ) > 1e-3 * 20000 * 1024 )
+            std::cerr << "gram matrix results differ" << std::endl;
+
+        delete u;
+        delete gram;
+        delete gram_packed;
+    }
+
+#ifdef VMMLIB_USE_LAPACK
+    // eigenvectors of a covariance as in t3_hosvd::get_eigs_u_red
+    {
+        matrix< 64, 256, double >* a = new matrix< 64, 256, double >;
+        for( size_t i = 0; i < 64 * 256; ++i )
+            a->array[ i ] = sin( double( i * i ) * 0.0007 );
+
+        matrix< 64, 64, double >* cov = new matrix< 64, 64, double >;
+        symmetric_matrix< 64, double >* cov_packed = new symmetric_matrix< 64, double >;
+        a->symmetric_covariance( *cov );
+        a->symmetric_covariance( *cov_packed );
+
+        matrix< 64, 16, double >* u = new matrix< 64, 16, double >;
+        vector< 16, double > w;
+
+        new_test( "16 largest eigenpairs of a 64 x 64 covariance, 200 times" );
+        start( "lapack_sym_eigs (dsyevx), dense" );
+        {
+            lapack_sym_eigs< 64, double > eigs;
+            for( size_t k = 0; k < 200; ++k )
+                eigs.compute_x( *cov, *u, w );
+        }
+        stop();
+
+        start( "lapack_packed_sym_eigs (dspevd), packed" );
+        {
+            lapack_packed_sym_eigs< 64, double > eigs;
+            for( size_t k = 0; k < 200; ++k )
+                eigs.compute_x( *cov_packed, *u, w );
+        }
+        stop();
+        compare();
+
+        delete a;
+        delete cov;
+        delete cov_packed;
+        delete u;
+    }
+#endif
+
+    // spd solve
+    {
+        symmetric_matrix< 32, double > g;
+        matrix< 32, 48, double >* a = new matrix< 32, 48, double >;
+        for( size_t i = 0; i < 32 * 48; ++i )
+            a->array[ i ] = sin( double( i ) * 0.37 );
+        g.set_aat( *a );
+        for( size_t i = 0; i < 32; ++i )
+            g( i, i ) += 32.0;
+        vector< 32, double > b( 1.0 ), x;
+        double sum = 0.0;
+
+        new_test( "cholesky solve 32 x 32, 20000 times" );
+        start( "cholesky_solver, dense" );
+        {
+            matrix< 32, 32, double > dense;
+            g.get( dense );
+            cholesky_solver< 32, double > solver;
+            for( size_t k = 0; k < 20000; ++k )
+            {
+                solver.factorize( dense );
+                solver.solve( b, x );
+                sum += x( 0 );
+            }
+        }
+        stop();
+
+        start( "symmetric_matrix::solve, packed cholesky" );
+        for( size_t k = 0; k < 20000; ++k )
+        {
+            g.solve( b, x );
+            sum -= x( 0 );
+        }
+        stop();
+        compare();
+
+        delete a;
+    }
+}
+
+} // namespace vmml
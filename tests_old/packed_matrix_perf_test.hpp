@@ -0,0 +1,20 @@
+#ifndef __VMML__PACKED_MATRIX_PERF_TEST__HPP__
+#define __VMML__PACKED_MATRIX_PERF_TEST__HPP__
+
+#include "performance_test.hpp"
+
+namespace vmml
+{
+
+class packed_matrix_perf_test : public performance_test
+{
+public:
+    virtual void run();
+
+protected:
+
+}; // class packed_matrix_perf_test
+
+} // namespace vmml
+
+#endif
@@ -0,0 +1,349 @@
+#include "packed_matrix_test.hpp"
+
+#include <vmmlib/packed_matrix.hpp>
+#include <vmmlib/blas_dsyrk.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+#include <cmath>
+
+namespace vmml
+{
+
+bool
+packed_matrix_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    const double precision = 1.0e-12;
+
+    // 4 x 3 data matrix and its products
+    matrix< 4, 3, double > a;
+    double a_data[] = {  1,  2, -1,
+                         0,  3,  1,
+                         2, -1,  4,
+                        -2,  1,  1 };
+    a.set( a_data, a_data + 12 );
+
+    matrix< 3, 4, double > a_t;
+    a.transpose_to( a_t );
+    matrix< 4, 4, double > aat;
+    aat.multiply( a, a_t );
+    matrix< 3, 3, double > ata;
+    ata.multiply( a_t, a );
+
+    {
+        // layout, accessors and conversions
+        symmetric_matrix< 4, double > s;
+        TEST(s.SIZE == 10);
+        TEST(s( 2, 2 ) == 1.0 && s( 2, 1 ) == 0.0);
+
+        s.set( aat );
+        TEST(s.array[ 0 ] == aat( 0, 0 ) && s.array[ 3 ] == aat( 3, 0 ));
+        TEST(s.array[ 4 ] == aat( 1, 1 ) && s.array[ 9 ] == aat( 3, 3 ));
+        TEST(s( 1, 3 ) == aat( 3, 1 ) && s( 3, 1 ) == aat( 1, 3 ));
+
+        s( 0, 2 ) = 42.0;
+        TEST(s( 2, 0 ) == 42.0);
+
+        matrix< 4, 4, double > dense;
+        s.set( aat );
+        s.get( dense );
+        TEST(dense == aat);
+
+        log( "symmetric matrix: packed layout, accessors, conversion to and from dense", ok );
+    }
+
+    {
+        // products
+        ok = true;
+        symmetric_matrix< 4, double > s, s_check;
+        s.set_aat( a );
+        s_check.set( aat );
+        TEST(s == s_check);
+
+        symmetric_matrix< 3, double > g, g_check;
+        g.set_ata( a );
+        g_check.set( ata );
+        TEST(g == g_check);
+
+        vector< 4, double > x( 1.0, -2.0, 0.5, 3.0 );
+        vector< 4, double > y, y_check;
+        s.multiply( x, y );
+        y_check = aat * x;
+        TEST(y.equals( y_check, precision ));
+
+        double q_check = x.dot( y_check );
+        TEST(fabs( s.quadratic_form( x ) - q_check ) < precision);
+
+        matrix< 4, 3, double > sb, sb_check;
+        s.multiply( a, sb );
+        sb_check.multiply( aat, a );
+        TEST(sb.equals( sb_check, precision ));
+
+        TEST(fabs( s.sum_elements() - aat.sum_elements() ) < precision);
+        TEST(fabs( s.frobenius_norm() - aat.frobenius_norm() ) < precision);
+
+        symmetric_matrix< 4, double > h( s );
+        h.multiply_piecewise( s );
+        matrix< 4, 4, double > h_dense, h_check( aat );
+        h_check.multiply_piecewise( aat );
+        h.get( h_dense );
+        TEST(h_dense == h_check);
+
+        symmetric_matrix< 4, double > cov;
+        a.symmetric_covariance( cov );
+        TEST(cov == s_check);
+
+        log( "symmetric matrix: A A^T, A^T A, multiply, quadratic form, hadamard product", ok );
+    }
+
+    {
+        // blas syrk into packed storage
+        ok = true;
+        symmetric_matrix< 4, double > s, s_check;
+        s_check.set( aat );
+        blas_dsyrk< 4, 3, double > syrk;
+        syrk.compute( a, s );
+        TEST(s.equals( s_check, precision ));
+
+        symmetric_matrix< 3, double > g, g_check;
+        g_check.set( ata );
+        blas_dsyrk< 3, 4, double > syrk_t;
+        syrk_t.compute_t( a, g );
+        TEST(g.equals( g_check, precision ));
+
+        matrix< 4, 3, float > a_f;
+        a_f.cast_from( a );
+        symmetric_matrix< 3, float > g_f;
+        blas_dsyrk< 3, 4, float > syrk_f;
+        syrk_f.compute_t( a_f, g_f );
+        for( size_t i = 0; i < g_f.SIZE; ++i )
+            TEST(fabs( g_f.array[ i ] - g_check.array[ i ] ) < 1e-5);
+
+        // large enough for the syrk (not gemm) path
+        matrix< 64, 20, double > b;
+        for( size_t i = 0; i < 64 * 20; ++i )
+            b.array[ i ] = sin( double( i * i ) * 0.01 );
+        symmetric_matrix< 64, double > bbt, bbt_check;
+        bbt_check.set_aat( b );
+        blas_dsyrk< 64, 20, double > syrk_large;
+        syrk_large.compute( b, bbt );
+        TEST(bbt.equals( bbt_check, precision ));
+
+        log( "blas syrk into packed symmetric storage", ok );
+    }
+
+    {
+        // dense outputs, both triangles are filled
+        matrix< 4, 4, double > aat_dense;
+        blas_dsyrk< 4, 3, double > syrk;
+        syrk.compute( a, aat_dense );
+        TEST(aat_dense.equals( aat, precision ));
+
+        matrix< 3, 3, double > ata_dense;
+        blas_dsyrk< 3, 4, double > syrk_t;
+        syrk_t.compute_t( a, ata_dense );
+        TEST(ata_dense.equals( ata, precision ));
+
+        matrix< 64, 20, double > b;
+        for( size_t i = 0; i < 64 * 20; ++i )
+            b.array[ i ] = sin( double( i * i ) * 0.01 );
+        matrix< 64, 64, double > bbt, bbt_check;
+        matrix< 20, 64, double > bt;
+        b.transpose_to( bt );
+        bbt_check.multiply( b, bt );
+        blas_dsyrk< 64, 20, double > syrk_large;
+        syrk_large.compute( b, bbt );
+        TEST(bbt.equals( bbt_check, precision ));
+
+        log( "blas syrk into dense storage", ok );
+    }
+
+    {
+        // cholesky and solve
+        ok = true;
+        symmetric_matrix< 3, double > g;
+        g.set_ata( a );
+
+        triangular_matrix< 3, double > l;
+        TEST(g.cholesky( l ));
+        matrix< 3, 3, double > l_dense, l_t, llt;
+        l.get( l_dense );
+        l_dense.transpose_to( l_t );
+        llt.multiply( l_dense, l_t );
+        TEST(llt.equals( ata, precision ));
+        TEST(l( 0, 1 ) == 0.0 && l( 0, 2 ) == 0.0 && l( 1, 2 ) == 0.0);
+
+        vector< 3, double > b( 1.0, 2.0, 3.0 );
+        vector< 3, double > x;
+        TEST(g.solve( b, x ));
+        TEST(( ata * x ).equals( b, precision ));
+
+        // indefinite
+        symmetric_matrix< 2, double > indefinite;
+        indefinite( 1, 0 ) = 2.0;
+        triangular_matrix< 2, double > l_indefinite;
+        TEST(! indefinite.cholesky( l_indefinite ));
+
+        log( "symmetric matrix: cholesky factorization and solve", ok );
+    }
+
+    {
+        // triangular, lower and upper
+        ok = true;
+        matrix< 3, 3, double > dense;
+        double data[] = { 2, 1, -1,
+                          4, 3,  5,
+                          1, 2,  4 };
+        dense.set( data, data + 9 );
+
+        triangular_matrix< 3, double > lower;
+        lower.set( dense );
+        triangular_matrix< 3, double, true > upper;
+        upper.set( dense );
+        TEST(lower( 0, 0 ) == 2 && lower( 2, 1 ) == 2 && lower( 0, 2 ) == 0);
+        TEST(upper( 0, 2 ) == -1 && upper( 1, 2 ) == 5 && upper( 2, 0 ) == 0);
+        TEST(lower.at( 1, 0 ) == 4 && upper.at( 0, 1 ) == 1);
+
+        matrix< 3, 3, double > lower_dense, upper_dense;
+        lower.get( lower_dense );
+        upper.get( upper_dense );
+        matrix< 3, 3, double > sum( lower_dense );
+        sum += upper_dense;
+        for( size_t i = 0; i < 3; ++i )
+            sum( i, i ) -= dense( i, i );
+        TEST(sum == dense);
+
+        vector< 3, double > v( 1.0, -1.0, 2.0 );
+        vector< 3, double > r, r_check, x;
+        lower.multiply( v, r );
+        r_check = lower_dense * v;
+        TEST(r.equals( r_check, precision ));
+        TEST(lower.solve( r, x ) && x.equals( v, precision ));
+
+        upper.multiply( v, r );
+        r_check = upper_dense * v;
+        TEST(r.equals( r_check, precision ));
+        TEST(upper.solve( r, x ) && x.equals( v, precision ));
+
+        matrix< 3, 3, double > lower_t;
+        lower_dense.transpose_to( lower_t );
+        lower.multiply_transposed( v, r );
+        r_check = lower_t * v;
+        TEST(r.equals( r_check, precision ));
+        TEST(lower.solve_transposed( r, x ) && x.equals( v, precision ));
+
+        matrix< 3, 3, double > upper_t;
+        upper_dense.transpose_to( upper_t );
+        upper.multiply_transposed( v, r );
+        r_check = upper_t * v;
+        TEST(r.equals( r_check, precision ));
+        TEST(upper.solve_transposed( r, x ) && x.equals( v, precision ));
+
+        matrix< 3, 2, double > b, xb, b_check;
+        double b_data[] = { 1, 0, 2, 1, -1, 3 };
+        b.set( b_data, b_data + 6 );
+        TEST(lower.solve( b, xb ));
+        b_check.multiply( lower_dense, xb );
+        TEST(b_check.equals( b, precision ));
+
+        TEST(fabs( lower.determinant() - 24.0 ) < precision);
+
+        triangular_matrix< 3, double > singular( lower );
+        singular.at( 1, 1 ) = 0.0;
+        TEST(! singular.solve( r, x ));
+
+        log( "triangular matrix: lower and upper packed storage, multiply and solve", ok );
+    }
+
+    {
+        // banded, one sub- and two superdiagonals
+        ok = true;
+        matrix< 5, 5, double > dense;
+        dense.zero();
+        for( size_t i = 0; i < 5; ++i )
+        {
+            dense( i, i ) = 4.0 + i;
+            if ( i > 0 ) dense( i, i - 1 ) = -1.0 - i;
+            if ( i < 4 ) dense( i, i + 1 ) = 2.0;
+            if ( i < 3 ) dense( i, i + 2 ) = 0.5 * i;
+        }
+
+        banded_matrix< 5, 1, 2, double > band;
+        TEST(band.LDAB == 4 && band.SIZE == 20);
+        band.set( dense );
+        TEST(band( 2, 2 ) == 6.0 && band( 3, 2 ) == -4.0 && band( 1, 3 ) == 0.5);
+        TEST(band( 4, 0 ) == 0.0 && band( 0, 4 ) == 0.0);
+        TEST(band.array[ band.index( 2, 1 ) ] == -3.0);
+
+        matrix< 5, 5, double > dense_back;
+        band.get( dense_back );
+        TEST(dense_back == dense);
+
+        vector< 5, double > x;
+        double x_data[] = { 1.0, 2.0, -1.0, 0.5, 3.0 };
+        x = x_data;
+        vector< 5, double > y, y_check;
+        band.multiply( x, y );
+        y_check = dense * x;
+        TEST(y.equals( y_check, precision ));
+
+        matrix< 5, 5, double > dense_t;
+        dense.transpose_to( dense_t );
+        band.multiply_transposed( x, y );
+        y_check = dense_t * x;
+        TEST(y.equals( y_check, precision ));
+
+        log( "banded matrix: lapack band storage, conversion and multiply", ok );
+    }
+
+    {
+        // banded LU, a small diagonal forces row interchanges and fill-in
+        ok = true;
+        matrix< 7, 7, double > dense;
+        dense.zero();
+        for( size_t i = 0; i < 7; ++i )
+        {
+            dense( i, i ) = i % 2 ? 1.0e-3 : 3.0 - i;
+            if ( i > 0 ) dense( i, i - 1 ) = 2.0 + i;
+            if ( i > 1 ) dense( i, i - 2 ) = -1.0;
+            if ( i < 6 ) dense( i, i + 1 ) = 1.5 - i;
+        }
+
+        banded_matrix< 7, 2, 1, double > band;
+        band.set( dense );
+
+        banded_matrix< 7, 2, 1, double >::lu_type lu;
+        size_t pivots[ 7 ];
+        TEST(band.lu( lu, pivots ));
+        bool swapped = false;
+        for( size_t i = 0; i < 7; ++i )
+            swapped = swapped || pivots[ i ] != i;
+        TEST(swapped);
+
+        vector< 7, double > x, b, x_check;
+        for( size_t i = 0; i < 7; ++i )
+            x_check( i ) = 1.0 - 0.5 * i;
+        band.multiply( x_check, b );
+        TEST(band.solve( b, x ) && x.equals( x_check, precision ));
+
+        matrix< 7, 3, double > B, X, X_check;
+        for( size_t i = 0; i < 21; ++i )
+            X_check.array[ i ] = double( i % 5 ) - 2.0;
+        B.multiply( dense, X_check );
+        TEST(band.solve( B, X ) && X.equals( X_check, precision ));
+
+        // singular: zero column
+        for( size_t i = 0; i < 7; ++i )
+            if ( band.is_stored( i, 3 ))
+                band.at( i, 3 ) = 0.0;
+        TEST(! band.solve( b, x ));
+
+        log( "banded matrix: LU with partial pivoting and solve", ok );
+    }
+
+    return global_ok;
+}
+
+} // namespace vmml
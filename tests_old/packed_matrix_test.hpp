@@ -0,0 +1,21 @@
+#ifndef __VMML__PACKED_MATRIX_TEST__HPP__
+#define __VMML__PACKED_MATRIX_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class packed_matrix_test : public unit_test
+{
+public:
+    packed_matrix_test() : unit_test( "packed symmetric, triangular and banded matrices" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class packed_matrix_test
+
+} // namespace vmml
+
+#endif
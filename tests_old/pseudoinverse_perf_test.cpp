@@ -0,0 +1,69 @@
+#include "pseudoinverse_perf_test.hpp"
+
+#if defined( VMMLIB_USE_LAPACK ) && defined( VMMLIB_USE_BLAS )
+#  include <vmmlib/matrix_pseudoinverse.hpp>
+#endif
+
+#include <sstream>
+#include <vector>
+
+namespace vmml
+{
+
+#if defined( VMMLIB_USE_LAPACK ) && defined( VMMLIB_USE_BLAS )
+namespace
+{
+
+template< size_t M, size_t N >
+void
+run_pseudoinverse_comparison( performance_test& test, size_t count, size_t iterations )
+{
+    typedef matrix< M, N, double > matrix_type;
+    std::vector< matrix_type > a( count ), pinv_t( count );
+    for( size_t k = 0; k < count; ++k )
+        for( size_t i = 0; i < M * N; ++i )
+            a[ k ].array[ i ] = sin( double( i * i ) * 0.37 + double( k ));
+
+    std::stringstream name;
+    name << "pseudoinverse of " << count << " " << M << "x" << N << " matrices";
+    test.new_test( name.str() );
+
+    test.start( "compute_pseudoinverse" );
+    compute_pseudoinverse< matrix_type > compute_pinv;
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t k = 0; k < count; ++k )
+            compute_pinv( a[ k ], pinv_t[ k ] );
+    test.stop();
+
+    pseudoinverse_solver< M, N, double > solver;
+    test.start( "pseudoinverse_solver (normal equations)" );
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t k = 0; k < count; ++k )
+            solver.compute_transposed( a[ k ], pinv_t[ k ] );
+    test.stop();
+
+    solver.set_normal_equations( false );
+    test.start( "pseudoinverse_solver (svd)" );
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t k = 0; k < count; ++k )
+            solver.compute_transposed( a[ k ], pinv_t[ k ] );
+    test.stop();
+    test.compare();
+}
+
+} // anonymous namespace
+#endif
+
+
+void
+pseudoinverse_perf_test::run()
+{
+#if defined( VMMLIB_USE_LAPACK ) && defined( VMMLIB_USE_BLAS )
+    run_pseudoinverse_comparison< 6, 4 >( *this, 10000, 10 );
+    run_pseudoinverse_comparison< 64, 8 >( *this, 1000, 10 );
+    run_pseudoinverse_comparison< 256, 16 >( *this, 100, 10 );
+#endif
+}
+
+
+} // namespace vmml
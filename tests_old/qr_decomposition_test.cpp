@@ -7,6 +7,70 @@
 
 namespace vmml
 {
+
+namespace
+{
+
+// max | Q^T Q - I |
+template< size_t M, size_t N, typename T >
+double
+orthogonality_error( const matrix< M, N, T >& Q )
+{
+    double error = 0;
+    for( size_t i = 0; i < N; ++i )
+    {
+        for( size_t j = 0; j < N; ++j )
+        {
+            double sum = 0;
+            for( size_t r = 0; r < M; ++r )
+                sum += double( Q( r, i ) ) * double( Q( r, j ) );
+            const double diff = fabs( sum - ( i == j ? 1.0 : 0.0 ) );
+            error = diff > error ? diff : error;
+        }
+    }
+    return error;
+}
+
+// max | Q R - A | / max | A |
+template< size_t M, size_t N, typename T >
+double
+residual_error( const matrix< M, N, T >& A, const matrix< M, N, T >& Q, const matrix< N, N, T >& R )
+{
+    double error = 0, a_max = 0;
+    for( size_t r = 0; r < M; ++r )
+    {
+        for( size_t j = 0; j < N; ++j )
+        {
+            double sum = 0;
+            for( size_t l = 0; l <= j; ++l )
+                sum += double( Q( r, l ) ) * double( R( l, j ) );
+            const double diff = fabs( sum - double( A( r, j ) ) );
+            error = diff > error ? diff : error;
+            a_max = fabs( double( A( r, j ) ) ) > a_max ? fabs( double( A( r, j ) ) ) : a_max;
+        }
+    }
+    return error / a_max;
+}
+
+template< size_t N, typename T >
+bool
+is_upper_triangular_with_positive_diagonal( const matrix< N, N, T >& R )
+{
+    for( size_t j = 0; j < N; ++j )
+    {
+        if ( R( j, j ) < T( 0 ) )
+            return false;
+        for( size_t i = j + 1; i < N; ++i )
+        {
+            if ( R( i, j ) != T( 0 ) )
+                return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
 bool
 qr_decomposition_test::run()
 {
@@ -96,6 +160,106 @@ qr_decomposition_test::run()
             }
         }
     }
+
+    // householder qr of the same matrix; R has a non-negative diagonal
+    ok = true;
+    {
+        matrix< 3, 3, double > A, Q, R;
+        double Adata[] = { 12, -51, 4, 6, 167, -68, -4, 24, -41 };
+        A.set( Adata, Adata + 9 );
+        qr_decompose_householder( A, Q, R );
+
+        double Qcorrect[] = {
+            6./7, -69./175, -58./175,
+            3./7, 158./175, 6./175,
+            -2./7, 6./35, -33./35 };
+        double Rcorrect[] = { 14, 21, -14, 0, 175, -70, 0, 0, 35 };
+        matrix< 3, 3, double > Qc, Rc;
+        Qc.set( Qcorrect, Qcorrect + 9 );
+        Rc.set( Rcorrect, Rcorrect + 9 );
+
+        TEST( Q.equals( Qc, 1e-12 ));
+        TEST( R.equals( Rc, 1e-12 ));
+        if ( ! ok )
+        {
+            std::stringstream error;
+            error << " Q " << Q << std::endl << " Qc " << Qc << std::endl
+                << " R " << R << std::endl << " Rc " << Rc << std::endl;
+            log_error( error.str() );
+        }
+    }
+    log( "QR decomposition using householder reflections", ok );
+
+
+    // several panels and a partial last panel
+    ok = true;
+    {
+        typedef matrix< 150, 70, double > tall_type;
+        tall_type* A = new tall_type;
+        tall_type* Q = new tall_type;
+        matrix< 70, 70, double >* R = new matrix< 70, 70, double >;
+        for( size_t i = 0; i < 150 * 70; ++i )
+            A->array[ i ] = double( int( ( i * 7919 ) % 201 ) - 100 ) / 37.0;
+
+        qr_decompose_householder( *A, *Q, *R );
+
+        TEST( orthogonality_error( *Q ) < 1e-13 );
+        TEST( residual_error( *A, *Q, *R ) < 1e-13 );
+        TEST( is_upper_triangular_with_positive_diagonal( *R ));
+
+        matrix< 150, 70, float >* Af = new matrix< 150, 70, float >;
+        matrix< 150, 70, float >* Qf = new matrix< 150, 70, float >;
+        matrix< 70, 70, float >* Rf = new matrix< 70, 70, float >;
+        Af->cast_from( *A );
+        qr_decompose_householder( *Af, *Qf, *Rf );
+        TEST( orthogonality_error( *Qf ) < 1e-5 );
+        TEST( residual_error( *Af, *Qf, *Rf ) < 1e-5 );
+
+        delete Rf;
+        delete Qf;
+        delete Af;
+        delete R;
+        delete Q;
+        delete A;
+    }
+    log( "blocked householder QR of a 150x70 matrix (double, float)", ok );
+
+
+    // a vandermonde matrix has condition ~1e9: gram-schmidt loses orthogonality,
+    // householder does not
+    ok = true;
+    {
+        matrix< 100, 12, double > A, Q, Q_gs_thin;
+        matrix< 100, 100, double >* Q_gs = new matrix< 100, 100, double >;
+        matrix< 12, 12, double > R, R_gs;
+        for( size_t i = 0; i < 100; ++i )
+        {
+            const double x = double( i ) / 99.0;
+            double power = 1.0;
+            for( size_t j = 0; j < 12; ++j, power *= x )
+                A( i, j ) = power;
+        }
+
+        qr_decompose_householder( A, Q, R );
+        qr_decompose_gram_schmidt( A, *Q_gs, R_gs );
+        Q_gs->get_sub_matrix( Q_gs_thin );
+
+        const double error = orthogonality_error( Q );
+        const double error_gs = orthogonality_error( Q_gs_thin );
+        TEST( error < 1e-13 );
+        TEST( residual_error( A, Q, R ) < 1e-13 );
+        TEST( error < error_gs );
+        if ( ! ok )
+        {
+            std::stringstream ss;
+            ss << "orthogonality error householder " << error
+                << ", gram-schmidt " << error_gs << std::endl;
+            log_error( ss.str() );
+        }
+        delete Q_gs;
+    }
+    log( "householder QR stability on an ill-conditioned matrix", ok );
+
     return global_ok;
 }
 
@@ -0,0 +1,53 @@
+#include "qr_perf_test.hpp"
+
+#include <vmmlib/qr_decomposition.hpp>
+
+
+namespace vmml
+{
+
+namespace
+{
+
+template< size_t M, size_t N >
+void
+run_qr_comparison( performance_test& test, const std::string& name, size_t iterations )
+{
+    typedef matrix< M, N, double > tall_type;
+    tall_type* A = new tall_type;
+    tall_type* Q = new tall_type;
+    matrix< M, M, double >* Q_full = new matrix< M, M, double >;
+    matrix< N, N, double >* R = new matrix< N, N, double >;
+    for( size_t i = 0; i < M * N; ++i )
+        A->array[ i ] = double( int( ( i * 7919 ) % 201 ) - 100 ) / 37.0;
+
+    test.new_test( name );
+    test.start( "gram-schmidt" );
+    for( size_t it = 0; it < iterations; ++it )
+        qr_decompose_gram_schmidt( *A, *Q_full, *R );
+    test.stop();
+
+    test.start( "blocked householder" );
+    for( size_t it = 0; it < iterations; ++it )
+        qr_decompose_householder( *A, *Q, *R );
+    test.stop();
+    test.compare();
+
+    delete R;
+    delete Q_full;
+    delete Q;
+    delete A;
+}
+
+} // anonymous namespace
+
+
+void
+qr_perf_test::run()
+{
+    run_qr_comparison< 256, 16 >( *this, "thin QR of a 256x16 matrix", 200 );
+    run_qr_comparison< 1024, 64 >( *this, "thin QR of a 1024x64 matrix", 10 );
+}
+
+
+} // namespace vmml
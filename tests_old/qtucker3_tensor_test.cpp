@@ -140,6 +140,59 @@ namespace vmml
 		}
 
 
+		//per-column quantization of the basis matrices with 8bit coefficients
+		typedef unsigned char T_coeff_8;
+		typedef tensor3< 6, 5, 4, T_value_2 > t3c_type;
+		typedef qtucker3_tensor< 3, 3, 2, 6, 5, 4, T_value_2, T_coeff_8 > tuck3c_type;
+		typedef t3_hooi< 3, 3, 2, 6, 5, 4, float > hooi_type2;
+		typedef tuck3c_type::u1_comp_type u1c_type;
+		typedef tuck3c_type::u2_comp_type u2c_type;
+
+		t3c_type t3_data_c;
+		for ( size_t i3 = 0; i3 < 4; ++i3 )
+			for ( size_t i2 = 0; i2 < 5; ++i2 )
+				for ( size_t i1 = 0; i1 < 6; ++i1 )
+					t3_data_c.at( i1, i2, i3 ) = T_value_2( (i1 * 37 + i2 * i2 * 11 + i3 * 53 + i1 * i3 * 7) % 251 );
+
+		t3c_type t3_data_c_reco;
+		tuck3c_type tuck3_c;
+		tuck3_c.enable_quantify_hot();
+		u1c_type u1_orig, u1_deq;
+		u2c_type u2_orig, u2_deq;
+
+		//error of the dequantized basis matrices with one global range
+		tuck3_c.decompose( t3_data_c, u_min, u_max, core_min, core_max, hooi_type2::init_hosvd() );
+		tuck3_c.get_u1_comp( u1_orig ); tuck3_c.get_u2_comp( u2_orig );
+		tuck3_c.reconstruct( t3_data_c_reco, u_min, u_max, core_min, core_max );
+		tuck3_c.get_u1_comp( u1_deq ); tuck3_c.get_u2_comp( u2_deq );
+		double error_global = ( u1_deq - u1_orig ).frobenius_norm() + ( u2_deq - u2_orig ).frobenius_norm();
+		double rmse_global = t3_data_c_reco.rmse( t3_data_c );
+
+		//one range per column
+		std::vector< float > u1_ranges, u2_ranges, u3_ranges;
+		tuck3_c.decompose( t3_data_c, u1_ranges, u2_ranges, u3_ranges, core_min, core_max, hooi_type2::init_hosvd() );
+		tuck3_c.reconstruct( t3_data_c_reco, u1_ranges, u2_ranges, u3_ranges, core_min, core_max );
+		tuck3_c.get_u1_comp( u1_deq ); tuck3_c.get_u2_comp( u2_deq );
+		double error_column = ( u1_deq - u1_orig ).frobenius_norm() + ( u2_deq - u2_orig ).frobenius_norm();
+		double rmse_column = t3_data_c_reco.rmse( t3_data_c );
+
+		ok = true;
+		TEST( u1_ranges.size() == 2 * 3 && u2_ranges.size() == 2 * 3 && u3_ranges.size() == 2 * 2 );
+		TESTINFO( error_column < error_global && rmse_column <= rmse_global + 1e-3,
+			"basis error global " << error_global << ", per column " << error_column
+			<< "; rmse global " << rmse_global << ", per column " << rmse_column );
+
+		//one range per block of 2 rows
+		tuck3_c.decompose( t3_data_c, u1_ranges, u2_ranges, u3_ranges, core_min, core_max, hooi_type2::init_hosvd(), 2 );
+		tuck3_c.reconstruct( t3_data_c_reco, u1_ranges, u2_ranges, u3_ranges, core_min, core_max, 2 );
+		tuck3_c.get_u1_comp( u1_deq ); tuck3_c.get_u2_comp( u2_deq );
+		double error_block = ( u1_deq - u1_orig ).frobenius_norm() + ( u2_deq - u2_orig ).frobenius_norm();
+
+		TEST( u1_ranges.size() == 2 * 3 * 3 && u2_ranges.size() == 2 * 3 * 3 && u3_ranges.size() == 2 * 2 * 2 );
+		TESTINFO( error_block < error_column, "basis error per column " << error_column << ", per block " << error_block );
+		log( "per-column and per-block basis matrices quantization (8bit)", ok );
+
+
 		//tucker3 reconstruction
 		typedef int T_value_3;
 		typedef int T_coeff_3;
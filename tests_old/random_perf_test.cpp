@@ -0,0 +1,69 @@
+#include "random_perf_test.hpp"
+
+#include <vmmlib/random.hpp>
+#include <vmmlib/matrix.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace vmml
+{
+
+void
+random_perf_test::run()
+{
+    const size_t n = 1 << 24;
+    std::vector< float > data( n );
+    random_generator rng( 1 );
+
+    new_test( "uniform fill of 16M floats" );
+    start( "rand() as in tensor3::fill_random" );
+    srand( 1 );
+    for( size_t i = 0; i < n; ++i )
+        data[ i ] = float( double( rand() ) / RAND_MAX );
+    stop();
+
+    start( "random_generator::fill_uniform" );
+    rng.fill_uniform( &data[ 0 ], n );
+    stop();
+    compare();
+
+
+    new_test( "normal fill of 16M floats" );
+    start( "rand() and Box-Muller" );
+    srand( 1 );
+    for( size_t i = 0; i + 1 < n; i += 2 )
+    {
+        const double u0 = ( double( rand() ) + 1.0 ) / ( double( RAND_MAX ) + 1.0 );
+        const double u1 = double( rand() ) / RAND_MAX;
+        const double r = std::sqrt( -2.0 * std::log( u0 ));
+        data[ i ] = float( r * std::cos( 6.283185307179586 * u1 ));
+        data[ i + 1 ] = float( r * std::sin( 6.283185307179586 * u1 ));
+    }
+    stop();
+
+    start( "random_generator::fill_normal" );
+    rng.fill_normal( &data[ 0 ], n );
+    stop();
+    compare();
+
+
+    const size_t count = 20000;
+    std::vector< matrix< 16, 16, double > > matrices( count );
+
+    new_test( "set_random on 20000 16x16 matrices" );
+    start( "set_random( seed )" );
+    srand( 1 );
+    for( size_t m = 0; m < count; ++m )
+        matrices[ m ].set_random();
+    stop();
+
+    start( "set_random( random_generator )" );
+    for( size_t m = 0; m < count; ++m )
+        matrices[ m ].set_random( rng );
+    stop();
+    compare();
+}
+
+} // namespace vmml
@@ -0,0 +1,145 @@
+#include "random_test.hpp"
+
+#include <vmmlib/random.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+bool
+block_equals( const random_generator& rng, random_generator::counter_type position,
+              random_generator::word_type w0, random_generator::word_type w1,
+              random_generator::word_type w2, random_generator::word_type w3 )
+{
+    random_generator::word_type block[ 4 ];
+    rng.get_block( position, block );
+    return block[ 0 ] == w0 && block[ 1 ] == w1 && block[ 2 ] == w2 && block[ 3 ] == w3;
+}
+
+} // anonymous namespace
+
+
+bool
+random_test::run()
+{
+    bool global_ok = true;
+    bool ok = true;
+
+    // known answers of Philox4x32-10 from Random123, counter
+    // ( position, stream ) and key seed, low words first
+    {
+        random_generator zero( 0 );
+        random_generator ones( 0xffffffffffffffffULL, 0xffffffffffffffffULL );
+        random_generator pi( 0x299f31d0a4093822ULL, 0x0370734413198a2eULL );
+        ok = block_equals( zero, 0, 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 )
+            && block_equals( ones, 0xffffffffffffffffULL,
+                             0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd )
+            && block_equals( pi, 0x85a308d3243f6a88ULL,
+                             0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 );
+    }
+    log( "philox4x32-10 known answers", ok );
+
+
+    // a fill equals fills of its parts, skip() equals consuming the blocks
+    ok = true;
+    {
+        const size_t n = 1001;
+        std::vector< double > all( n ), parts( n ), skipped( n - 100 );
+        random_generator rng( 42, 7 );
+        rng.fill_uniform( &all[ 0 ], n );
+        ok = rng.get_position() == ( n + 1 ) / 2;
+
+        rng.seed( 42, 7 );
+        rng.fill_uniform( &parts[ 0 ], 100 );
+        rng.fill_uniform( &parts[ 100 ], 333 );
+        rng.fill_uniform( &parts[ 433 ], n - 433 );
+        // 333 values leave the last value of their last block unused
+        ok = ok && std::equal( all.begin(), all.begin() + 433, parts.begin() );
+
+        rng.seed( 42, 7 );
+        rng.skip( 50 );
+        rng.fill_uniform( &skipped[ 0 ], n - 100 );
+        ok = ok && std::equal( skipped.begin(), skipped.end(), all.begin() + 100 );
+
+        // other seeds and streams give other values
+        random_generator other_seed( 43, 7 ), other_stream( 42, 8 );
+        double a, b;
+        other_seed.fill_uniform( &a, 1 );
+        other_stream.fill_uniform( &b, 1 );
+        ok = ok && a != all[ 0 ] && b != all[ 0 ] && a != b;
+    }
+    log( "reproducible fills, jump ahead, seeds and streams", ok );
+
+
+    // moments of large (parallel) uniform and normal fills
+    ok = true;
+    {
+        const size_t n = 1 << 18;
+        std::vector< float > u( n );
+        std::vector< double > z( n );
+        random_generator rng( 1 );
+        rng.fill_uniform( &u[ 0 ], n, -1.0, 3.0 );
+        rng.fill_normal( &z[ 0 ], n, 2.0, 0.5 );
+
+        double u_mean = 0, u_var = 0, z_mean = 0, z_var = 0;
+        float u_min = u[ 0 ], u_max = u[ 0 ];
+        for( size_t i = 0; i < n; ++i )
+        {
+            u_mean += u[ i ];
+            z_mean += z[ i ];
+            u_min = (std::min)( u_min, u[ i ] );
+            u_max = (std::max)( u_max, u[ i ] );
+        }
+        u_mean /= double( n );
+        z_mean /= double( n );
+        for( size_t i = 0; i < n; ++i )
+        {
+            u_var += ( u[ i ] - u_mean ) * ( u[ i ] - u_mean );
+            z_var += ( z[ i ] - z_mean ) * ( z[ i ] - z_mean );
+        }
+        u_var /= double( n - 1 );
+        z_var /= double( n - 1 );
+
+        // standard errors are about 0.0023 and 0.001 for the means
+        ok = u_min >= -1.0f && u_max < 3.0f && u_min < -0.999f && u_max > 2.999f;
+        ok = ok && std::fabs( u_mean - 1.0 ) < 0.01 && std::fabs( u_var - 16.0 / 12.0 ) < 0.02;
+        ok = ok && std::fabs( z_mean - 2.0 ) < 0.005 && std::fabs( z_var - 0.25 ) < 0.005;
+
+        // the values of the parallel fill equal single draws
+        rng.seed( 1 );
+        ok = ok && float( -1.0 + 4.0 * rng.uniform() ) == u[ 0 ];
+        rng.skip( n / 2 - 1 );
+        ok = ok && std::fabs( 2.0 + 0.5 * rng.normal() - z[ 0 ] ) < 1e-15;
+    }
+    log( "uniform and normal distributions", ok );
+
+
+    // set_random overloads
+    ok = true;
+    {
+        matrix< 5, 7, double > m0, m1;
+        vector< 9, float > v0, v1;
+        random_generator rng( 3 );
+        m0.set_random( rng );
+        v0.set_random( rng );
+        rng.seed( 3 );
+        m1.set_random( rng );
+        v1.set_random( rng );
+        ok = m0 == m1 && v0 == v1;
+        for( size_t i = 0; i < 35; ++i )
+            ok = ok && m0.array[ i ] >= -1.0 && m0.array[ i ] < 1.0;
+        ok = ok && m0( 0, 0 ) != m0( 1, 0 ) && v0( 0 ) != float( m0( 0, 0 ));
+    }
+    log( "matrix and vector set_random with a generator", ok );
+
+    return global_ok;
+}
+
+} // namespace vmml
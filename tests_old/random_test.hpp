@@ -0,0 +1,21 @@
+#ifndef __VMML__RANDOM_TEST__HPP__
+#define __VMML__RANDOM_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+class random_test : public unit_test
+{
+public:
+    random_test() : unit_test( "counter-based random number generator" ) {}
+    virtual bool run();
+
+protected:
+
+}; // class random_test
+
+} // namespace vmml
+
+#endif
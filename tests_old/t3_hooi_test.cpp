@@ -77,6 +77,16 @@ namespace vmml
 		t3_hooi< 2, 2, 1, 3, 2, 2, double >::derive_core( t3_data, u1_check, u2_check, u3_check, core );
 
 		TEST(core.equals( core_check, precision));
+
+		//solvers reused by repeated calls give the same core
+		t3_hooi< 2, 2, 1, 3, 2, 2, double >::core_solvers solvers;
+		tensor3< 2, 2, 1, double > core_reused;
+		for ( size_t i = 0; i < 2; ++i )
+		{
+			core_reused.zero();
+			t3_hooi< 2, 2, 1, 3, 2, 2, double >::derive_core( t3_data, u1_check, u2_check, u3_check, core_reused, solvers );
+			TEST(core_reused == core);
+		}
 		if (ok)
 		{
 			log( "derive core tensor", true  );
@@ -0,0 +1,120 @@
+#include "t3_predictive_codec_test.hpp"
+
+#include <vmmlib/t3_predictive_codec.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace vmml
+{
+
+	bool
+	t3_predictive_codec_test::run()
+	{
+		bool global_ok = true;
+		bool ok = true;
+
+		//smooth test volume (not a multiple of the brick size)
+		typedef tensor3< 40, 33, 20, unsigned char > t3_uchar_t;
+		typedef t3_predictive_codec< 40, 33, 20, unsigned char > codec_t;
+		t3_uchar_t data;
+		for ( size_t i3 = 0; i3 < 20; ++i3 )
+			for ( size_t i2 = 0; i2 < 33; ++i2 )
+				for ( size_t i1 = 0; i1 < 40; ++i1 )
+					data.at( i1, i2, i3 ) = (unsigned char)( 128 + 100 * sin( 0.1 * i1 ) * cos( 0.15 * i2 ) + 2 * i3 + ( ( i1 * 7919 + i2 * 104729 + i3 * 1299709 ) >> 3 ) % 5 );
+
+		std::vector< unsigned char > coded;
+		codec_t::encode( data, coded, 16 );
+		t3_uchar_t decoded;
+		decoded.zero();
+		codec_t::decode( coded, decoded );
+		TEST( decoded == data );
+		TEST( coded.size() < data.SIZE );
+		log( "lossless predictive coding (unsigned char)", ok );
+
+		//random access
+		ok = true;
+		t3_uchar_t brick;
+		brick.zero();
+		size_t n_bricks = codec_t::get_number_of_bricks( 16 );
+		TEST( n_bricks == 3 * 3 * 2 );
+		TEST( codec_t::get_brick_size( coded ) == 16 );
+		codec_t::decode_brick( coded, 4, brick );
+		for ( size_t i3 = 0; i3 < 16; ++i3 )
+			for ( size_t i2 = 16; i2 < 32; ++i2 )
+				for ( size_t i1 = 16; i1 < 32; ++i1 )
+					TEST( brick.at( i1, i2, i3 ) == data.at( i1, i2, i3 ) );
+		TEST( brick.at( 0, 0, 0 ) == 0 && brick.at( 39, 32, 19 ) == 0 );
+		log( "decoding of a single brick", ok );
+
+		//16 bit data with large values
+		ok = true;
+		tensor3< 40, 33, 20, unsigned short > data_us, decoded_us;
+		for ( size_t i3 = 0; i3 < 20; ++i3 )
+			for ( size_t i2 = 0; i2 < 33; ++i2 )
+				for ( size_t i1 = 0; i1 < 40; ++i1 )
+					data_us.at( i1, i2, i3 ) = (unsigned short)( ( i1 * 1031 + i2 * 97 + i3 * 4099 ) % 65536 );
+		data_us.at( 3, 4, 5 ) = 65535;
+		data_us.at( 3, 5, 5 ) = 0;
+		t3_predictive_codec< 40, 33, 20, unsigned short >::encode( data_us, coded, 7 );
+		t3_predictive_codec< 40, 33, 20, unsigned short >::decode( coded, decoded_us );
+		TEST( decoded_us == data_us );
+		log( "lossless predictive coding (unsigned short)", ok );
+
+		//near-lossless
+		ok = true;
+		std::vector< unsigned char > coded_lossy;
+		codec_t::encode( data, coded_lossy, 16, 2 );
+		codec_t::decode( coded_lossy, decoded );
+		int max_diff = 0;
+		for ( size_t i = 0; i < data.SIZE; ++i )
+		{
+			int diff = abs( int( decoded.get_array_ptr()[i] ) - int( data.get_array_ptr()[i] ) );
+			max_diff = ( std::max )( max_diff, diff );
+		}
+		codec_t::encode( data, coded, 16 );
+		TEST( max_diff <= 2 );
+		TEST( coded_lossy.size() < coded.size() );
+		log( "near-lossless predictive coding (max error 2)", ok );
+
+		//residual to a reference volume
+		ok = true;
+		t3_uchar_t reference;
+		for ( size_t i = 0; i < data.SIZE; ++i )
+			reference.get_array_ptr()[i] = (unsigned char)( data.get_array_ptr()[i] ^ ( i % 50 == 0 ) );
+		std::vector< unsigned char > coded_ref;
+		codec_t::encode( data, reference, coded_ref, 16 );
+		decoded.zero();
+		codec_t::decode( coded_ref, reference, decoded );
+		TEST( decoded == data );
+		TEST( coded_ref.size() < coded.size() );
+		log( "predictive coding of the residual to a reference volume", ok );
+
+		//corrupt brick table: brick 1 ends before it begins
+		ok = true;
+		codec_t::encode( data, coded, 16 );
+		std::vector< unsigned char > corrupt( coded );
+		const size_t entry = codec_t::HEADER_SIZE + 8;
+		for ( size_t byte = 0; byte < 8; ++byte )
+			std::swap( corrupt[ entry + byte ], corrupt[ entry + 8 + byte ] );
+		try
+		{
+			codec_t::decode( corrupt, decoded );
+			TEST(false);
+		}
+		catch(...)
+		{}
+		//truncated payload
+		corrupt.assign( coded.begin(), coded.end() - 1 );
+		try
+		{
+			codec_t::decode( corrupt, decoded );
+			TEST(false);
+		}
+		catch(...)
+		{}
+		log( "corrupt and truncated coded data are rejected", ok );
+
+		return global_ok;
+	}
+
+} // namespace vmml
@@ -0,0 +1,21 @@
+#ifndef __VMML__T3_PREDICTIVE_CODEC_TEST__HPP__
+#define __VMML__T3_PREDICTIVE_CODEC_TEST__HPP__
+
+#include "unit_test.hpp"
+
+namespace vmml
+{
+
+	class t3_predictive_codec_test : public unit_test
+	{
+	public:
+		t3_predictive_codec_test() : unit_test( "tensor3 predictive (lorenzo) codec" ) {}
+		virtual bool run();
+
+	protected:
+
+	}; // class t3_predictive_codec_test
+
+} // namespace vmml
+
+#endif
@@ -62,6 +62,28 @@ namespace vmml
 			log_error( error.str(),  fail_test);
 		}
 
+        // Test writing and reading csv
+        ok = true;
+        t4r.zero();
+        conv.write_to_csv(t4, "./", ".~tmpCsv");
+        conv.read_from_csv(t4r, "./", ".~tmpCsv");
+        remove(".~tmpCsv.csv");
+        TEST( t4 == t4r );
+
+        tensor4< 3, 2, 2, 2, float > t4f, t4fr;
+        for ( size_t i = 0; i < t4f.SIZE; ++i )
+            t4f.get_array_ptr()[i] = ( float( i ) - 11.0f ) / 3.0f;
+        t4_converter< 3, 2, 2, 2, float >::write_to_csv(t4f, "./", ".~tmpCsv");
+        std::ifstream csv_file(".~tmpCsv.csv");
+        std::string first_line;
+        std::getline(csv_file, first_line);
+        csv_file.close();
+        t4_converter< 3, 2, 2, 2, float >::read_from_csv(t4fr, "./", ".~tmpCsv");
+        remove(".~tmpCsv.csv");
+        TEST( t4f == t4fr );
+        TEST( std::count(first_line.begin(), first_line.end(), ',') == 1 );
+        log( "tensor4 IO write/read .csv file", ok );
+
 
 
 		return global_ok;
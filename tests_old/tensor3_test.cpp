@@ -3,7 +3,10 @@
 #include <vmmlib/t3_converter.hpp>
 #include <vmmlib/tensor3.hpp>
 #include <vmmlib/tensor_mmapper.hpp>
+#include <cstring>
+#include <iterator>
 #include <sstream>
+#include <vector>
 
 namespace vmml
 {
@@ -286,6 +289,21 @@ namespace vmml
         tensor3< 2, 3, 4, int16_t >  t3s;
         t3s.fill_random_signed();
 
+        //with a generator the values are reproducible
+        {
+            tensor3< 2, 3, 4, int16_t > t3s_0, t3s_1;
+            random_generator rng( 5 );
+            t3s_0.fill_random_signed( rng );
+            rng.seed( 5 );
+            t3s_1.fill_random_signed( rng );
+            tensor3< 4, 5, 6, float > t3f;
+            t3f.fill_random( rng );
+            bool fill_ok = t3s_0 == t3s_1 && t3f.get_min() >= 0.0f && t3f.get_max() > 0.0f;
+            for( size_t i = 0; fill_ok && i < 2 * 3 * 4; ++i )
+                fill_ok = t3s_0.get_array_ptr()[ i ] >= -16383 && t3s_0.get_array_ptr()[ i ] < 16383;
+            log( "fill_random( random_generator ), fill_random_signed( random_generator )", fill_ok );
+        }
+
 
         //test get_n_vector functions
         int i1 = 1;
@@ -839,6 +857,140 @@ namespace vmml
             log_error( error.str() );
         }
 
+        //.dat descriptor and runtime dispatch of the .raw loading
+        {
+            ok = true;
+            tensor3< 4, 3, 2, unsigned short > t3_raw;
+            t3_raw.fill_increasing_values();
+            t3_raw *= 300;
+            t3_converter< 4, 3, 2, unsigned short >::write_to_raw( t3_raw, "./", ".~tmpT3" );
+            t3_converter< 4, 3, 2, unsigned short >::write_datfile( "./", ".~tmpT3" );
+
+            raw_descriptor desc;
+            raw_volume_loader::read_datfile( "./", ".~tmpT3.dat", desc );
+            TEST( desc.format == raw_descriptor::USHORT && desc.resolution[0] == 4 && desc.resolution[1] == 3 && desc.resolution[2] == 2 );
+            TEST( desc.object_file_name == ".~tmpT3.raw" );
+            TEST( desc.big_endian == raw_volume_loader::is_big_endian_host() );
+            std::ifstream dat_in( ".~tmpT3.dat" );
+            std::string dat_text( ( std::istreambuf_iterator< char >( dat_in ) ), std::istreambuf_iterator< char >() );
+            dat_in.close();
+            TEST( dat_text.find( "Endianness:" ) != std::string::npos );
+
+            tensor3< 4, 3, 2, float > t3_float, t3_float_check;
+            t3_float_check.cast_from( t3_raw );
+            t3_converter< 4, 3, 2, float >::read_from_dat( t3_float, "./", ".~tmpT3.dat" );
+            TEST( t3_float == t3_float_check );
+
+            raw_volume< double > volume;
+            raw_volume_loader::load( "./", ".~tmpT3.dat", volume );
+            TEST( volume.data.size() == 24 && volume.at( 3, 2, 1 ) == double( t3_raw.at( 3, 2, 1 ) ) );
+
+            //big endian file
+            std::ofstream dat( ".~tmpT3be.dat" );
+            dat << "ObjectFileName:\t.~tmpT3be.raw\nResolution:\t4 3 2\nFormat:\tUSHORT\nEndianness:\tBIG_ENDIAN\n";
+            dat.close();
+            std::ofstream raw_be( ".~tmpT3be.raw", std::ios::binary );
+            for ( size_t i = 0; i < t3_raw.SIZE; ++i )
+            {
+                unsigned short value = t3_raw.get_array_ptr()[i];
+                raw_be.put( char( value >> 8 ) );
+                raw_be.put( char( value & 0xff ) );
+            }
+            raw_be.close();
+            t3_float.zero();
+            t3_converter< 4, 3, 2, float >::read_from_dat( t3_float, "./", ".~tmpT3be.dat" );
+            TEST( t3_float == t3_float_check );
+
+            //file length and size mismatches are detected before reading
+            bool has_thrown = false;
+            try {
+                tensor3< 4, 3, 3, float > t3_wrong_size;
+                t3_converter< 4, 3, 3, float >::read_from_dat( t3_wrong_size, "./", ".~tmpT3.dat" );
+            } catch ( ... ) { has_thrown = true; }
+            TEST( has_thrown );
+
+            has_thrown = false;
+            raw_be.open( ".~tmpT3be.raw", std::ios::binary );
+            raw_be.put( 0 );
+            raw_be.close();
+            try {
+                raw_volume_loader::load( "./", ".~tmpT3be.dat", volume );
+            } catch ( ... ) { has_thrown = true; }
+            TEST( has_thrown );
+
+            std::remove( ".~tmpT3.dat" ); std::remove( ".~tmpT3.raw" );
+            std::remove( ".~tmpT3be.dat" ); std::remove( ".~tmpT3be.raw" );
+            log( "tensor3 .dat descriptor parsing and raw loading", ok );
+        }
+
+        //csv export/import
+        {
+            ok = true;
+            tensor3< 5, 4, 3, double > t3_csv, t3_csv_read;
+            for ( size_t i = 0; i < t3_csv.SIZE; ++i )
+                t3_csv.get_array_ptr()[i] = ( double( i ) - 29.0 ) / 7.0;
+            t3_converter< 5, 4, 3, double >::write_to_csv( t3_csv, "./", ".~tmpCsv" );
+            t3_converter< 5, 4, 3, double >::read_from_csv( t3_csv_read, "./", ".~tmpCsv" );
+            TEST( t3_csv == t3_csv_read );
+
+            tensor3< 5, 4, 3, unsigned char > t3_csv_uc, t3_csv_uc_read;
+            t3_csv_uc.fill_increasing_values();
+            t3_converter< 5, 4, 3, unsigned char >::write_to_csv( t3_csv_uc, "./", ".~tmpCsv.csv" );
+            std::ifstream csv_file( ".~tmpCsv.csv" );
+            std::string line;
+            std::getline( csv_file, line );
+            csv_file.close();
+            TEST( line == "0, 1, 2, 3" );
+            t3_converter< 5, 4, 3, unsigned char >::read_from_csv( t3_csv_uc_read, "./", ".~tmpCsv.csv" );
+            TEST( t3_csv_uc == t3_csv_uc_read );
+            std::remove( ".~tmpCsv.csv" );
+
+            char buffer[ 32 ];
+            long long min_ll = ( std::numeric_limits< long long >::min )();
+            TEST( std::string( buffer, csv_formatter::format_value( buffer, min_ll )) == "-9223372036854775808" );
+            //default precision is max_digits10
+            TEST( std::string( buffer, csv_formatter::format_value( buffer, 0.1 )) == "0.10000000000000001" );
+            TEST( std::string( buffer, csv_formatter::format_value( buffer, 0.1f )) == "0.100000001" );
+
+            //a token must be a single number, errors reach the caller
+            double values[ 4 ];
+            const std::string joined = "1,2,3,4-5";
+            bool has_thrown = false;
+            try {
+                csv_formatter::parse( joined.data(), joined.data() + joined.size(), values, 2, 2, 1 );
+            } catch ( ... ) { has_thrown = true; }
+            TEST( has_thrown );
+
+            std::string many;
+            for ( size_t i = 0; i < 20000; ++i )
+                many += ( i == 12345 ) ? "abc\n" : "1.5, ";
+            std::vector< double > many_values( 20000 );
+            has_thrown = false;
+            try {
+                csv_formatter::parse( many.data(), many.data() + many.size(), &many_values[ 0 ], 100, 200, 1 );
+            } catch ( ... ) { has_thrown = true; }
+            TEST( has_thrown );
+
+            unsigned char uc_value = 0;
+            signed char sc_value = 0;
+            const char* numbers[] = { "-1", "256", "99999999999999999999", "-129" };
+            for ( size_t i = 0; i < 4; ++i )
+            {
+                has_thrown = false;
+                try {
+                    if ( i < 3 )
+                        csv_formatter::parse_value( numbers[ i ], numbers[ i ] + strlen( numbers[ i ] ), uc_value );
+                    else
+                        csv_formatter::parse_value( numbers[ i ], numbers[ i ] + strlen( numbers[ i ] ), sc_value );
+                } catch ( ... ) { has_thrown = true; }
+                TEST( has_thrown );
+            }
+            const char* min_sc = "-128";
+            csv_formatter::parse_value( min_sc, min_sc + 4, sc_value );
+            TEST( sc_value == -128 );
+            log( "tensor3 csv export/import", ok );
+        }
+
         //get_min() + get_max()
 
         tensor3< 3, 2, 5, int >  t3_get_min_max;
@@ -0,0 +1,76 @@
+#include "transform_inverse_perf_test.hpp"
+
+#include <vmmlib/matrix.hpp>
+
+#include <vector>
+
+namespace vmml
+{
+
+namespace
+{
+
+typedef matrix< 4, 4, float > transform_type;
+
+void
+run_inverse_comparison( performance_test& test, const std::string& name,
+                        const std::vector< transform_type >& transforms,
+                        bool rigid, size_t iterations )
+{
+    const size_t count = transforms.size();
+    std::vector< transform_type > inverses( count );
+
+    test.new_test( name );
+    test.start( "compute_inverse (general 4x4)" );
+    for( size_t it = 0; it < iterations; ++it )
+        for( size_t i = 0; i < count; ++i )
+            compute_inverse( transforms[ i ], inverses[ i ] );
+    test.stop();
+
+    if( rigid )
+    {
+        test.start( "compute_inverse_rigid (batched)" );
+        for( size_t it = 0; it < iterations; ++it )
+            compute_inverse_rigid( &transforms[ 0 ], &inverses[ 0 ], count );
+        test.stop();
+    }
+    else
+    {
+        test.start( "compute_inverse_affine (batched)" );
+        for( size_t it = 0; it < iterations; ++it )
+            compute_inverse_affine( &transforms[ 0 ], &inverses[ 0 ], count );
+        test.stop();
+    }
+
+    test.start( "compute_inverse_fast (batched)" );
+    for( size_t it = 0; it < iterations; ++it )
+        compute_inverse_fast( &transforms[ 0 ], &inverses[ 0 ], count );
+    test.stop();
+    test.compare();
+}
+
+} // anonymous namespace
+
+
+void
+transform_inverse_perf_test::run()
+{
+    const size_t count = 10000;
+    std::vector< transform_type > rigid( count ), affine( count );
+    for( size_t i = 0; i < count; ++i )
+    {
+        const float angle = 0.001f * float( i );
+        rigid[ i ].rotate_z( angle );
+        rigid[ i ].pre_rotate_x( 2.0f * angle );
+        rigid[ i ].set_translation( float( i ), 1.0f, -2.0f );
+
+        affine[ i ] = rigid[ i ];
+        affine[ i ].scale( 1.0f + angle, 2.0f, 0.5f );
+    }
+
+    run_inverse_comparison( *this, "inverse of 10000 rigid 4x4 transforms", rigid, true, 100 );
+    run_inverse_comparison( *this, "inverse of 10000 affine 4x4 transforms", affine, false, 100 );
+}
+
+
+} // namespace vmml
@@ -321,6 +321,104 @@ namespace vmml
 		}
 
 
+		//export bytes with per-column quantized basis matrices
+		out_vecq_type export_vec_4;
+		tuck3q.decompose( t3_data2, u_min, u_max, core_min, core_max, hooi_type1::init_hosvd() );
+		tuck3q_exporter_t::export_column_quantized_to( export_vec_4, tuck3q );
+
+		u1q_type u1q_exported; u2q_type u2q_exported; u3q_type u3q_exported;
+		tuck3q.get_u1( u1q_exported ); tuck3q.get_u2( u2q_exported ); tuck3q.get_u3( u3q_exported );
+
+		tuck3q_type tuck3qi_4;
+		tuck3q_importer_t::import_column_quantized_from( export_vec_4, tuck3qi_4 );
+		tuck3qi_4.get_u1( u1q ); tuck3qi_4.get_u2( u2q ); tuck3qi_4.get_u3( u3q );
+
+		//block size, ranges per column (2 * (2 + 2 + 2) floats), 2 floats for the core, 8 bytes for the core
+		ok = true;
+		TEST( export_vec_4.size() == sizeof( uint32_t ) + 14 * sizeof( float ) + ( 6 + 4 + 4 ) * sizeof( T_coeff ) + 8 );
+		TEST( u1q == u1q_exported && u2q == u2q_exported && u3q == u3q_exported );
+
+		typedef tuck3q_type::u1_comp_type u1c_type;
+		u1c_type u1c_exported, u1c_imported;
+		tuck3q.get_u1_comp( u1c_exported ); tuck3qi_4.get_u1_comp( u1c_imported );
+		TEST( u1c_imported.equals( u1c_exported, 1e-4f ) );
+
+		//the block size is taken from the stream
+		out_vecq_type export_vec_4b;
+		tuck3q.decompose( t3_data2, u_min, u_max, core_min, core_max, hooi_type1::init_hosvd() );
+		tuck3q_exporter_t::export_column_quantized_to( export_vec_4b, tuck3q, 2 );
+		tuck3q.get_u1_comp( u1c_exported );
+		tuck3q_importer_t::import_column_quantized_from( export_vec_4b, tuck3qi_4 );
+		tuck3qi_4.get_u1_comp( u1c_imported );
+		TEST( export_vec_4b.size() > export_vec_4.size() );
+		TEST( u1c_imported.equals( u1c_exported, 1e-4f ) );
+
+		//block sizes outside of 1..max( I1, I2, I3 ) are rejected
+		const uint32_t bad_block_rows[] = { 0, 4, 0xffffffff };
+		for ( size_t i = 0; i < 3; ++i )
+		{
+			out_vecq_type corrupt = export_vec_4b;
+			memcpy( &corrupt[0], &bad_block_rows[i], sizeof( uint32_t ) );
+			bool rejected = false;
+			try
+			{
+				tuck3q_importer_t::import_column_quantized_from( corrupt, tuck3qi_4 );
+			}
+			catch(...)
+			{
+				rejected = true;
+			}
+			TEST( rejected );
+		}
+		log( "export/import tucker3 (bytes) with per-column basis quantization", ok );
+
+		//progressive export: core in bit-planes, import from prefixes
+		typedef tuck3q_type::t3_core_comp_type corec_type;
+		out_vecq_type export_vec_5;
+		tuck3q.enable_quantify_linear();
+		tuck3q.decompose( t3_data2, u_min, u_max, core_min, core_max, hooi_type1::init_hosvd() );
+		corec_type core_exact, core_prefix;
+		tuck3q.get_core_comp( core_exact );
+		tuck3q_exporter_t::export_progressive_to( export_vec_5, tuck3q, 12 );
+
+		size_t len_header = tuck3q_exporter_t::get_progressive_header_size();
+		ok = true;
+		TEST( export_vec_5.size() > len_header );
+		TEST( export_vec_5.size() <= len_header + ( 13 * 8 + 7 ) / 8 );
+
+		tuck3q_type tuck3qi_5, tuck3qi_6;
+		tuck3q_importer_t::core_coder_type decoder;
+		double error_prev = core_exact.frobenius_norm() + 1;
+		for ( size_t len = len_header; len <= export_vec_5.size(); ++len )
+		{
+			out_vecq_type prefix( export_vec_5.begin(), export_vec_5.begin() + len );
+			//one-shot import of the prefix and incremental import
+			tuck3q_importer_t::import_progressive_from( prefix, tuck3qi_5 );
+			tuck3qi_5.get_core_comp( core_prefix );
+			tuck3q_importer_t::import_progressive_from( prefix, tuck3qi_6, decoder );
+			corec_type core_incremental;
+			tuck3qi_6.get_core_comp( core_incremental );
+			TEST( core_incremental == core_prefix );
+			TEST( core_prefix.at( 0, 0, 0 ) == core_exact.at( 0, 0, 0 ) );
+
+			double error = ( core_exact - core_prefix ).frobenius_norm();
+			TEST( error <= error_prev + 1e-6 );
+			error_prev = error;
+		}
+		TEST( decoder.is_complete() );
+		u1c_type u1q_5, u1q_6;
+		tuck3qi_5.get_u1_comp( u1q_5 ); tuck3qi_6.get_u1_comp( u1q_6 );
+		TEST( u1q_5 == u1q_6 );
+		double core_abs_max = 0;
+		for ( size_t i = 1; i < 8; ++i )
+			core_abs_max = ( std::max )( core_abs_max, fabs( double( core_exact.get_array_ptr()[i] ) ) );
+		TEST( core_prefix.equals( core_exact, core_abs_max / 4095 ) );
+
+		t3q_type t3_reco5;
+		tuck3qi_5.reconstruct_dequantized( t3_reco5 );
+		log( "export/import tucker3 (bytes) with progressive bit-plane core", ok );
+
+
 		return global_ok;
 	}
 
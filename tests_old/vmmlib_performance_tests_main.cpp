@@ -1,16 +1,88 @@
 #include "performance_test.hpp"
 #include "matrix_compare_perf_test.hpp"
+#include "csv_perf_test.hpp"
+#include "blas_perf_test.hpp"
+#include "dot_kernels_perf_test.hpp"
+#include "qr_perf_test.hpp"
+#include "batched_least_squares_perf_test.hpp"
+#include "transform_inverse_perf_test.hpp"
+#include "lu_perf_test.hpp"
+#include "jacobi_svd_perf_test.hpp"
+#include "pseudoinverse_perf_test.hpp"
+#include "incremental_svd_perf_test.hpp"
+#include "dct_perf_test.hpp"
+#include "random_perf_test.hpp"
+#include "packed_matrix_perf_test.hpp"
+#include "batched_gemm_perf_test.hpp"
 
+#include <vmmlib/blas_config.hpp>
 #include <iostream>
 
 int
 main( int argc, const char* argv[] )
 {
+    std::cout << vmml::blas::config::get() << std::endl;
 
     vmml::matrix_compare_perf_test mcp_test;
     mcp_test.run();
     std::cout << mcp_test << std::endl;
 
+    vmml::csv_perf_test csv_test;
+    csv_test.run();
+    std::cout << csv_test << std::endl;
+
+    vmml::blas_perf_test blas_test;
+    blas_test.run();
+    std::cout << blas_test << std::endl;
+
+    vmml::dot_kernels_perf_test dot_test;
+    dot_test.run();
+    std::cout << dot_test << std::endl;
+
+    vmml::qr_perf_test qr_test;
+    qr_test.run();
+    std::cout << qr_test << std::endl;
+
+    vmml::batched_least_squares_perf_test batched_least_squares_test;
+    batched_least_squares_test.run();
+    std::cout << batched_least_squares_test << std::endl;
+
+    vmml::transform_inverse_perf_test transform_inverse_test;
+    transform_inverse_test.run();
+    std::cout << transform_inverse_test << std::endl;
+
+    vmml::lu_perf_test lu_test;
+    lu_test.run();
+    std::cout << lu_test << std::endl;
+
+    vmml::jacobi_svd_perf_test jacobi_svd_test;
+    jacobi_svd_test.run();
+    std::cout << jacobi_svd_test << std::endl;
+
+    vmml::pseudoinverse_perf_test pseudoinverse_test;
+    pseudoinverse_test.run();
+    std::cout << pseudoinverse_test << std::endl;
+
+    vmml::incremental_svd_perf_test incremental_svd_test;
+    incremental_svd_test.run();
+    std::cout << incremental_svd_test << std::endl;
+
+    vmml::dct_perf_test dct_test;
+    dct_test.run();
+    std::cout << dct_test << std::endl;
+
+    vmml::random_perf_test random_test;
+    random_test.run();
+    std::cout << random_test << std::endl;
+
+    vmml::packed_matrix_perf_test packed_matrix_test;
+    packed_matrix_test.run();
+    std::cout << packed_matrix_test << std::endl;
+
+    vmml::batched_gemm_perf_test batched_gemm_test;
+    batched_gemm_test.run();
+    std::cout << batched_gemm_test << std::endl;
+
 
 
     return 0;
@@ -2,6 +2,8 @@
 
 #include "unit_test_globals.hpp"
 
+#include <vmmlib/blas_config.hpp>
+
 #include "matrix_test.hpp"
 #include "lowpass_filter_test.hpp"
 #include "intersection_test.hpp"
@@ -9,12 +11,23 @@
 #include "qr_decomposition_test.hpp"
 #include "svd_test.hpp"
 #include "util_test.hpp"
+#include "blas_builtin_test.hpp"
+#include "dot_kernels_test.hpp"
+#include "blas_config_test.hpp"
+#include "cholesky_solver_test.hpp"
+#include "batched_least_squares_test.hpp"
+#include "random_test.hpp"
+#include "packed_matrix_test.hpp"
+#include "batched_gemm_test.hpp"
 
 #ifdef VMMLIB_USE_LAPACK
 #  include "lapack_linear_least_squares_test.hpp"
 #  include "lapack_gaussian_elimination_test.hpp"
 #  include "lapack_svd_test.hpp"
+#  include "jacobi_svd_test.hpp"
+#  include "incremental_svd_test.hpp"
 #  include "lapack_sym_eigs_test.hpp"
+#  include "batched_eigen_solver_test.hpp"
 #  include "cp3_tensor_test.hpp"
 #  include "qtucker3_tensor_test.hpp"
 #  include "t3_hooi_test.hpp"
@@ -23,6 +36,8 @@
 #  include "t3_ihopm_test.hpp"
 #  include "t3_ihooi_test.hpp"
 #  include "t3_ttm_test.hpp"
+#  include "dct_test.hpp"
+#  include "t3_predictive_codec_test.hpp"
 #  include "tensor3_iterator_test.hpp"
 #  include "tensor3_test.hpp"
 #  include "tucker3_exporter_importer_test.hpp"
@@ -48,6 +63,8 @@ void run_and_log( vmml::unit_test& test )
 
 int main( int, const char** )
 {
+    std::cout << vmml::blas::config::get() << std::endl;
+
     vmml::matrix_test matrix_test_;
     run_and_log( matrix_test_ );
 
@@ -69,10 +86,40 @@ int main( int, const char** )
     vmml::util_test util_test_;
     run_and_log( util_test_ );
 
+    vmml::blas_builtin_test blas_builtin_test_;
+    run_and_log( blas_builtin_test_ );
+
+    vmml::dot_kernels_test dot_kernels_test_;
+    run_and_log( dot_kernels_test_ );
+
+    vmml::blas_config_test blas_config_test_;
+    run_and_log( blas_config_test_ );
+
+    vmml::cholesky_solver_test cholesky_solver_test_;
+    run_and_log( cholesky_solver_test_ );
+
+    vmml::batched_least_squares_test batched_least_squares_test_;
+    run_and_log( batched_least_squares_test_ );
+
+    vmml::random_test random_test_;
+    run_and_log( random_test_ );
+
+    vmml::packed_matrix_test packed_matrix_test_;
+    run_and_log( packed_matrix_test_ );
+
+    vmml::batched_gemm_test batched_gemm_test_;
+    run_and_log( batched_gemm_test_ );
+
 #ifdef VMMLIB_USE_LAPACK
     vmml::lapack_svd_test lapack_svd_test_;
     run_and_log( lapack_svd_test_ );
 
+    vmml::jacobi_svd_test jacobi_svd_test_;
+    run_and_log( jacobi_svd_test_ );
+
+    vmml::incremental_svd_test incremental_svd_test_;
+    run_and_log( incremental_svd_test_ );
+
     vmml::lapack_linear_least_squares_test lapack_llsq_test;
     run_and_log( lapack_llsq_test );
 
@@ -81,6 +128,9 @@ int main( int, const char** )
 
 	vmml::lapack_sym_eigs_test lapack_sym_eigs_test_;
     run_and_log( lapack_sym_eigs_test_ );
+
+    vmml::batched_eigen_solver_test batched_eigen_solver_test_;
+    run_and_log( batched_eigen_solver_test_ );
 #endif
 
 #ifdef VMMLIB_USE_BLAS
@@ -129,6 +179,12 @@ int main( int, const char** )
     vmml::t3_ttm_test t3ttm;
     run_and_log( t3ttm );
 
+    vmml::dct_test dct_test_;
+    run_and_log( dct_test_ );
+
+    vmml::t3_predictive_codec_test t3pc;
+    run_and_log( t3pc );
+
     vmml::tucker3_tensor_test tt3t;
     run_and_log( tt3t );
 
@@ -0,0 +1,767 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__BATCHED_EIGEN_SOLVER__HPP__
+#define __VMML__BATCHED_EIGEN_SOLVER__HPP__
+
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+
+#include <cmath>
+#include <limits>
+#ifdef VMMLIB_USE_OPENMP
+#  include <omp.h>
+#endif
+
+/**
+ *
+ *   batched solvers for many small matrices:
+ *
+ *   batched_sym_eigs< N, T, L >: eigenvalues and eigenvectors of symmetric
+ *   NxN matrices (cyclic Jacobi).
+ *   batched_sym_eigs3< T, L >: symmetric 3x3 matrices in closed form. the
+ *   eigenvalues come from the trigonometric solution of the characteristic
+ *   cubic; the eigenvector of the best separated one is the largest cross
+ *   product of two rows of A - lambda I, the other two are the eigenvectors
+ *   of the 2x2 projection onto its orthogonal complement (Eberly, 2014: A
+ *   robust eigensolver for 3x3 symmetric matrices). the eigenvalues are
+ *   returned as the Rayleigh quotients diag( V^T * A * V ), optional
+ *   Jacobi sweeps on that almost diagonal matrix refine the result.
+ *   batched_svd3< T, L >: SVD of 3x3 matrices (Jacobi on A^T*A with the
+ *   rotation accumulated in a quaternion, then Givens QR of A*V, see
+ *   McAdams et al., 2011: Computing the singular value decomposition of
+ *   3x3 matrices with minimal branching and elementary floating point
+ *   operations).
+ *
+ *   L matrices are processed together in structure-of-arrays layout
+ *   (lane group), every scalar operation is a loop over the L lanes.
+ *   the code has no data-dependent branches: a fixed number of sweeps is
+ *   run and the rotations degenerate to the identity for zero
+ *   off-diagonal elements, so the compiler can vectorize the lane loops.
+ *   use L = 4, 8 or 16 depending on the vector width and T.
+ *
+ *   the lane groups of a batch are distributed over OpenMP threads.
+ *
+ **
+ */
+
+namespace vmml
+{
+
+template< size_t N, typename T = double, size_t L = 8 >
+struct batched_sym_eigs
+{
+    typedef matrix< N, N, T >   matrix_type;
+    typedef vector< N, T >      vector_type;
+
+    // 6 sweeps reach double precision for N <= 4
+    static const size_t DEFAULT_SWEEPS = 6;
+
+    // eigenvalues in ascending order (as lapack's xSYEVX), eigenvectors in
+    // the columns of eigvectors_. uses the lower triangle of A.
+    static void compute( const matrix_type* a_, matrix_type* eigvectors_,
+                         vector_type* eigvalues_, size_t count_,
+                         size_t n_sweeps_ = DEFAULT_SWEEPS );
+
+    // one lane group in SoA layout: a_[ row ][ col ][ lane ],
+    // a_ is overwritten (diagonalized)
+    static void compute_lanes( T a_[ N ][ N ][ L ], T v_[ N ][ N ][ L ],
+                               T w_[ N ][ L ], size_t n_sweeps_ = DEFAULT_SWEEPS );
+
+}; // struct batched_sym_eigs
+
+
+
+template< typename T = double, size_t L = 8 >
+struct batched_sym_eigs3
+{
+    typedef matrix< 3, 3, T >   matrix_type;
+    typedef vector< 3, T >      vector_type;
+
+    // the closed form is accurate to working precision, also for
+    // clustered eigenvalues, and needs no refinement
+    static const size_t DEFAULT_REFINEMENT_SWEEPS = 0;
+
+    // eigenvalues in ascending order, eigenvectors in the columns of
+    // eigvectors_ (as batched_sym_eigs). uses the lower triangle of A.
+    static void compute( const matrix_type* a_, matrix_type* eigvectors_,
+                         vector_type* eigvalues_, size_t count_,
+                         size_t n_refinement_sweeps_ = DEFAULT_REFINEMENT_SWEEPS );
+
+    // one lane group in SoA layout: a_[ row ][ col ][ lane ]
+    static void compute_lanes( const T a_[ 3 ][ 3 ][ L ], T v_[ 3 ][ 3 ][ L ],
+                               T w_[ 3 ][ L ],
+                               size_t n_refinement_sweeps_ = DEFAULT_REFINEMENT_SWEEPS );
+
+}; // struct batched_sym_eigs3
+
+
+
+template< typename T = double, size_t L = 8 >
+struct batched_svd3
+{
+    typedef matrix< 3, 3, T >   matrix_type;
+    typedef vector< 3, T >      vector_type;
+
+    static const size_t DEFAULT_SWEEPS = 6;
+
+    // A = U * diag( sigma ) * V^T, sigma non-negative and descending
+    static void compute( const matrix_type* a_, matrix_type* u_, vector_type* sigma_,
+                         matrix_type* v_, size_t count_, size_t n_sweeps_ = DEFAULT_SWEEPS );
+
+    // as compute, but U and V are rotations (det = +1); sigma( 2 ) is
+    // negative if det( A ) < 0. U * V^T is the rotation of the polar
+    // decomposition of A.
+    static void compute_rotations( const matrix_type* a_, matrix_type* u_, vector_type* sigma_,
+                                   matrix_type* v_, size_t count_, size_t n_sweeps_ = DEFAULT_SWEEPS );
+
+    // one lane group in SoA layout, signed (rotation) variant
+    static void compute_lanes( const T a_[ 3 ][ 3 ][ L ], T u_[ 3 ][ 3 ][ L ],
+                               T sigma_[ 3 ][ L ], T v_[ 3 ][ 3 ][ L ],
+                               size_t n_sweeps_ = DEFAULT_SWEEPS );
+
+protected:
+    static void compute( const matrix_type* a_, matrix_type* u_, vector_type* sigma_,
+                         matrix_type* v_, size_t count_, size_t n_sweeps_, bool rotations_ );
+
+}; // struct batched_svd3
+
+
+
+namespace batched_detail
+{
+
+// Jacobi rotation (c, s) that annihilates a_pq of a symmetric matrix,
+// t = tan( theta ) with |theta| <= pi/4, see Numerical Recipes 11.1
+template< typename T, size_t L >
+inline void
+jacobi_rotation( const T* a_pp, const T* a_qq, const T* a_pq, T* c_, T* s_ )
+{
+    const T tiny = (std::numeric_limits< T >::min)();
+    for( size_t l = 0; l < L; ++l )
+    {
+        const T tau = a_qq[ l ] - a_pp[ l ];
+        const T sign = tau < T( 0 ) ? T( -1 ) : T( 1 );
+        const T t = T( 2 ) * a_pq[ l ] * sign
+            / ( std::fabs( tau ) + std::sqrt( tau * tau + T( 4 ) * a_pq[ l ] * a_pq[ l ] ) + tiny );
+        c_[ l ] = T( 1 ) / std::sqrt( T( 1 ) + t * t );
+        s_[ l ] = t * c_[ l ];
+    }
+}
+
+// x' = c*x - s*y, y' = s*x + c*y
+template< typename T, size_t L >
+inline void
+rotate( T* x_, T* y_, const T* c_, const T* s_ )
+{
+    for( size_t l = 0; l < L; ++l )
+    {
+        const T x = x_[ l ];
+        const T y = y_[ l ];
+        x_[ l ] = c_[ l ] * x - s_[ l ] * y;
+        y_[ l ] = s_[ l ] * x + c_[ l ] * y;
+    }
+}
+
+// exchanges x and y where swap_ is set, negating the new y if negate_
+template< typename T, size_t L >
+inline void
+conditional_swap( T* x_, T* y_, const bool* swap_, bool negate_ )
+{
+    for( size_t l = 0; l < L; ++l )
+    {
+        const T x = x_[ l ];
+        const T y = y_[ l ];
+        x_[ l ] = swap_[ l ] ? y : x;
+        y_[ l ] = swap_[ l ] ? ( negate_ ? -x : x ) : y;
+    }
+}
+
+} // namespace batched_detail
+
+
+
+template< size_t N, typename T, size_t L >
+void
+batched_sym_eigs< N, T, L >::compute_lanes( T a_[ N ][ N ][ L ], T v_[ N ][ N ][ L ],
+                                            T w_[ N ][ L ], size_t n_sweeps_ )
+{
+    using namespace batched_detail;
+
+    for( size_t i = 0; i < N; ++i )
+        for( size_t j = 0; j < N; ++j )
+            for( size_t l = 0; l < L; ++l )
+                v_[ i ][ j ][ l ] = ( i == j ) ? T( 1 ) : T( 0 );
+
+    // symmetrize from the lower triangle
+    for( size_t i = 0; i < N; ++i )
+        for( size_t j = i + 1; j < N; ++j )
+            for( size_t l = 0; l < L; ++l )
+                a_[ i ][ j ][ l ] = a_[ j ][ i ][ l ];
+
+    T c[ L ], s[ L ];
+    for( size_t sweep = 0; sweep < n_sweeps_; ++sweep )
+    {
+        for( size_t p = 0; p + 1 < N; ++p )
+        {
+            for( size_t q = p + 1; q < N; ++q )
+            {
+                jacobi_rotation< T, L >( a_[ p ][ p ], a_[ q ][ q ], a_[ p ][ q ], c, s );
+
+                // A = P^T * A * P, V = V * P
+                for( size_t k = 0; k < N; ++k )
+                {
+                    rotate< T, L >( a_[ k ][ p ], a_[ k ][ q ], c, s );
+                }
+                for( size_t k = 0; k < N; ++k )
+                {
+                    rotate< T, L >( a_[ p ][ k ], a_[ q ][ k ], c, s );
+                }
+                for( size_t k = 0; k < N; ++k )
+                {
+                    rotate< T, L >( v_[ k ][ p ], v_[ k ][ q ], c, s );
+                }
+            }
+        }
+    }
+
+    for( size_t i = 0; i < N; ++i )
+        for( size_t l = 0; l < L; ++l )
+            w_[ i ][ l ] = a_[ i ][ i ][ l ];
+
+    // ascending order, bubble sorting network
+    bool swap[ L ];
+    for( size_t pass = 0; pass + 1 < N; ++pass )
+    {
+        for( size_t i = 0; i + 1 < N - pass; ++i )
+        {
+            for( size_t l = 0; l < L; ++l )
+                swap[ l ] = w_[ i ][ l ] > w_[ i + 1 ][ l ];
+            conditional_swap< T, L >( w_[ i ], w_[ i + 1 ], swap, false );
+            for( size_t k = 0; k < N; ++k )
+                conditional_swap< T, L >( v_[ k ][ i ], v_[ k ][ i + 1 ], swap, false );
+        }
+    }
+}
+
+
+
+template< size_t N, typename T, size_t L >
+void
+batched_sym_eigs< N, T, L >::compute( const matrix_type* a_, matrix_type* eigvectors_,
+                                      vector_type* eigvalues_, size_t count_, size_t n_sweeps_ )
+{
+    const long n_groups = static_cast< long >( ( count_ + L - 1 ) / L );
+
+#pragma omp parallel for
+    for( long group = 0; group < n_groups; ++group )
+    {
+        T a[ N ][ N ][ L ];
+        T v[ N ][ N ][ L ];
+        T w[ N ][ L ];
+
+        // gather, the lanes past the end get the identity
+        const size_t first = static_cast< size_t >( group ) * L;
+        for( size_t l = 0; l < L; ++l )
+        {
+            const bool valid = first + l < count_;
+            for( size_t i = 0; i < N; ++i )
+                for( size_t j = 0; j < N; ++j )
+                    a[ i ][ j ][ l ] = valid ? a_[ first + l ]( i, j ) : T( i == j );
+        }
+
+        compute_lanes( a, v, w, n_sweeps_ );
+
+        for( size_t l = 0; l < L && first + l < count_; ++l )
+        {
+            for( size_t i = 0; i < N; ++i )
+            {
+                eigvalues_[ first + l ]( i ) = w[ i ][ l ];
+                for( size_t j = 0; j < N; ++j )
+                    eigvectors_[ first + l ]( i, j ) = v[ i ][ j ][ l ];
+            }
+        }
+    }
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_sym_eigs3< T, L >::compute_lanes( const T a_[ 3 ][ 3 ][ L ], T v_[ 3 ][ 3 ][ L ],
+                                          T w_[ 3 ][ L ], size_t n_refinement_sweeps_ )
+{
+    using namespace batched_detail;
+
+    const T tiny = (std::numeric_limits< T >::min)();
+    const T third = T( 1 ) / T( 3 );
+    const T two_pi_3 = T( 2.09439510239319549230842892218633526 );
+
+    // scaled by the largest element against over- and underflow
+    T scale[ L ];
+    T b[ 3 ][ 3 ][ L ];
+    for( size_t l = 0; l < L; ++l )
+    {
+        T m = T( 0 );
+        for( size_t i = 0; i < 3; ++i )
+            for( size_t j = 0; j <= i; ++j )
+                m = (std::max)( m, std::fabs( a_[ i ][ j ][ l ] ));
+        scale[ l ] = m > T( 0 ) ? m : T( 1 );
+        const T inv_scale = T( 1 ) / scale[ l ];
+        for( size_t i = 0; i < 3; ++i )
+            for( size_t j = 0; j <= i; ++j )
+                b[ i ][ j ][ l ] = b[ j ][ i ][ l ] = a_[ i ][ j ][ l ] * inv_scale;
+    }
+
+    // eigenvalue of the best separated eigenvector: with B = q I + p C and
+    // det( C ) = 2 r, the eigenvalues are q + 2 p cos( acos( r ) / 3 + k 2pi / 3 ).
+    // for r >= 0 the largest one is the best separated, else the smallest.
+    T lambda[ L ];
+    for( size_t l = 0; l < L; ++l )
+    {
+        const T q = ( b[ 0 ][ 0 ][ l ] + b[ 1 ][ 1 ][ l ] + b[ 2 ][ 2 ][ l ] ) * third;
+        const T d0 = b[ 0 ][ 0 ][ l ] - q;
+        const T d1 = b[ 1 ][ 1 ][ l ] - q;
+        const T d2 = b[ 2 ][ 2 ][ l ] - q;
+        const T b10 = b[ 1 ][ 0 ][ l ];
+        const T b20 = b[ 2 ][ 0 ][ l ];
+        const T b21 = b[ 2 ][ 1 ][ l ];
+        const T p2 = d0 * d0 + d1 * d1 + d2 * d2
+                   + T( 2 ) * ( b10 * b10 + b20 * b20 + b21 * b21 );
+        const T p = std::sqrt( p2 / T( 6 ));
+        const T det = d0 * ( d1 * d2 - b21 * b21 )
+                    - b10 * ( b10 * d2 - b21 * b20 )
+                    + b20 * ( b10 * b21 - d1 * b20 );
+        T r = det / ( T( 2 ) * p * p * p + tiny );
+        r = r < T( -1 ) ? T( -1 ) : ( r > T( 1 ) ? T( 1 ) : r );
+        const T phi = std::acos( r ) * third;
+        lambda[ l ] = r >= T( 0 )
+            ? q + T( 2 ) * p * std::cos( phi )
+            : q + T( 2 ) * p * std::cos( phi + two_pi_3 );
+    }
+
+    // V = [ v0 u w ], v0 the eigenvector of lambda, u and w the
+    // eigenvectors of the 2x2 projection onto its complement
+    T v[ 3 ][ 3 ][ L ];
+    T c[ L ], s[ L ], m00[ L ], m01[ L ], m11[ L ];
+    for( size_t l = 0; l < L; ++l )
+    {
+        const T r0[ 3 ] = { b[ 0 ][ 0 ][ l ] - lambda[ l ], b[ 0 ][ 1 ][ l ], b[ 0 ][ 2 ][ l ] };
+        const T r1[ 3 ] = { b[ 1 ][ 0 ][ l ], b[ 1 ][ 1 ][ l ] - lambda[ l ], b[ 1 ][ 2 ][ l ] };
+        const T r2[ 3 ] = { b[ 2 ][ 0 ][ l ], b[ 2 ][ 1 ][ l ], b[ 2 ][ 2 ][ l ] - lambda[ l ] };
+
+        T x01[ 3 ], x02[ 3 ], x12[ 3 ];
+        x01[ 0 ] = r0[ 1 ] * r1[ 2 ] - r0[ 2 ] * r1[ 1 ];
+        x01[ 1 ] = r0[ 2 ] * r1[ 0 ] - r0[ 0 ] * r1[ 2 ];
+        x01[ 2 ] = r0[ 0 ] * r1[ 1 ] - r0[ 1 ] * r1[ 0 ];
+        x02[ 0 ] = r0[ 1 ] * r2[ 2 ] - r0[ 2 ] * r2[ 1 ];
+        x02[ 1 ] = r0[ 2 ] * r2[ 0 ] - r0[ 0 ] * r2[ 2 ];
+        x02[ 2 ] = r0[ 0 ] * r2[ 1 ] - r0[ 1 ] * r2[ 0 ];
+        x12[ 0 ] = r1[ 1 ] * r2[ 2 ] - r1[ 2 ] * r2[ 1 ];
+        x12[ 1 ] = r1[ 2 ] * r2[ 0 ] - r1[ 0 ] * r2[ 2 ];
+        x12[ 2 ] = r1[ 0 ] * r2[ 1 ] - r1[ 1 ] * r2[ 0 ];
+        const T n01 = x01[ 0 ] * x01[ 0 ] + x01[ 1 ] * x01[ 1 ] + x01[ 2 ] * x01[ 2 ];
+        const T n02 = x02[ 0 ] * x02[ 0 ] + x02[ 1 ] * x02[ 1 ] + x02[ 2 ] * x02[ 2 ];
+        const T n12 = x12[ 0 ] * x12[ 0 ] + x12[ 1 ] * x12[ 1 ] + x12[ 2 ] * x12[ 2 ];
+
+        // the largest cross product; e0 if B = lambda I
+        const bool use01 = n01 >= n02 && n01 >= n12;
+        const bool use02 = ! use01 && n02 >= n12;
+        const T n = use01 ? n01 : ( use02 ? n02 : n12 );
+        const bool degenerate = ! ( n > tiny );
+        const T inv_n = degenerate ? T( 0 ) : T( 1 ) / std::sqrt( n );
+        T v0[ 3 ];
+        for( size_t i = 0; i < 3; ++i )
+        {
+            const T x = use01 ? x01[ i ] : ( use02 ? x02[ i ] : x12[ i ] );
+            v0[ i ] = degenerate ? T( i == 0 ) : x * inv_n;
+        }
+
+        // u orthogonal to v0, w = v0 x u
+        const bool x_larger = std::fabs( v0[ 0 ] ) > std::fabs( v0[ 1 ] );
+        T u[ 3 ];
+        u[ 0 ] = x_larger ? -v0[ 2 ] : T( 0 );
+        u[ 1 ] = x_larger ? T( 0 ) : v0[ 2 ];
+        u[ 2 ] = x_larger ? v0[ 0 ] : -v0[ 1 ];
+        const T inv_u = T( 1 ) / std::sqrt( u[ 0 ] * u[ 0 ] + u[ 1 ] * u[ 1 ] + u[ 2 ] * u[ 2 ] );
+        for( size_t i = 0; i < 3; ++i )
+            u[ i ] *= inv_u;
+        const T w[ 3 ] = { v0[ 1 ] * u[ 2 ] - v0[ 2 ] * u[ 1 ],
+                           v0[ 2 ] * u[ 0 ] - v0[ 0 ] * u[ 2 ],
+                           v0[ 0 ] * u[ 1 ] - v0[ 1 ] * u[ 0 ] };
+
+        T bu[ 3 ], bw[ 3 ];
+        for( size_t i = 0; i < 3; ++i )
+        {
+            bu[ i ] = b[ i ][ 0 ][ l ] * u[ 0 ] + b[ i ][ 1 ][ l ] * u[ 1 ] + b[ i ][ 2 ][ l ] * u[ 2 ];
+            bw[ i ] = b[ i ][ 0 ][ l ] * w[ 0 ] + b[ i ][ 1 ][ l ] * w[ 1 ] + b[ i ][ 2 ][ l ] * w[ 2 ];
+        }
+        m00[ l ] = u[ 0 ] * bu[ 0 ] + u[ 1 ] * bu[ 1 ] + u[ 2 ] * bu[ 2 ];
+        m01[ l ] = u[ 0 ] * bw[ 0 ] + u[ 1 ] * bw[ 1 ] + u[ 2 ] * bw[ 2 ];
+        m11[ l ] = w[ 0 ] * bw[ 0 ] + w[ 1 ] * bw[ 1 ] + w[ 2 ] * bw[ 2 ];
+
+        for( size_t i = 0; i < 3; ++i )
+        {
+            v[ i ][ 0 ][ l ] = v0[ i ];
+            v[ i ][ 1 ][ l ] = u[ i ];
+            v[ i ][ 2 ][ l ] = w[ i ];
+        }
+    }
+
+    jacobi_rotation< T, L >( m00, m11, m01, c, s );
+    for( size_t i = 0; i < 3; ++i )
+        rotate< T, L >( v[ i ][ 1 ], v[ i ][ 2 ], c, s );
+
+    // Rayleigh quotients and refinement: Jacobi on V^T B V, which also
+    // sorts the eigenvalues
+    T a[ 3 ][ 3 ][ L ];
+    for( size_t i = 0; i < 3; ++i )
+    {
+        for( size_t j = 0; j <= i; ++j )
+        {
+            for( size_t l = 0; l < L; ++l )
+            {
+                T sum = T( 0 );
+                for( size_t k = 0; k < 3; ++k )
+                {
+                    const T bv_k = b[ k ][ 0 ][ l ] * v[ 0 ][ j ][ l ]
+                                 + b[ k ][ 1 ][ l ] * v[ 1 ][ j ][ l ]
+                                 + b[ k ][ 2 ][ l ] * v[ 2 ][ j ][ l ];
+                    sum += v[ k ][ i ][ l ] * bv_k;
+                }
+                a[ i ][ j ][ l ] = sum;
+            }
+        }
+    }
+
+    T v_refined[ 3 ][ 3 ][ L ];
+    batched_sym_eigs< 3, T, L >::compute_lanes( a, v_refined, w_, n_refinement_sweeps_ );
+
+    for( size_t i = 0; i < 3; ++i )
+    {
+        for( size_t j = 0; j < 3; ++j )
+        {
+            for( size_t l = 0; l < L; ++l )
+            {
+                v_[ i ][ j ][ l ] = v[ i ][ 0 ][ l ] * v_refined[ 0 ][ j ][ l ]
+                                  + v[ i ][ 1 ][ l ] * v_refined[ 1 ][ j ][ l ]
+                                  + v[ i ][ 2 ][ l ] * v_refined[ 2 ][ j ][ l ];
+            }
+        }
+    }
+    for( size_t i = 0; i < 3; ++i )
+        for( size_t l = 0; l < L; ++l )
+            w_[ i ][ l ] *= scale[ l ];
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_sym_eigs3< T, L >::compute( const matrix_type* a_, matrix_type* eigvectors_,
+                                    vector_type* eigvalues_, size_t count_,
+                                    size_t n_refinement_sweeps_ )
+{
+    const long n_groups = static_cast< long >( ( count_ + L - 1 ) / L );
+
+#pragma omp parallel for
+    for( long group = 0; group < n_groups; ++group )
+    {
+        T a[ 3 ][ 3 ][ L ];
+        T v[ 3 ][ 3 ][ L ];
+        T w[ 3 ][ L ];
+
+        // gather, the lanes past the end get the identity
+        const size_t first = static_cast< size_t >( group ) * L;
+        for( size_t l = 0; l < L; ++l )
+        {
+            const bool valid = first + l < count_;
+            for( size_t i = 0; i < 3; ++i )
+                for( size_t j = 0; j < 3; ++j )
+                    a[ i ][ j ][ l ] = valid ? a_[ first + l ]( i, j ) : T( i == j );
+        }
+
+        compute_lanes( a, v, w, n_refinement_sweeps_ );
+
+        for( size_t l = 0; l < L && first + l < count_; ++l )
+        {
+            for( size_t i = 0; i < 3; ++i )
+            {
+                eigvalues_[ first + l ]( i ) = w[ i ][ l ];
+                for( size_t j = 0; j < 3; ++j )
+                    eigvectors_[ first + l ]( i, j ) = v[ i ][ j ][ l ];
+            }
+        }
+    }
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_svd3< T, L >::compute_lanes( const T a_[ 3 ][ 3 ][ L ], T u_[ 3 ][ 3 ][ L ],
+                                     T sigma_[ 3 ][ L ], T v_[ 3 ][ 3 ][ L ], size_t n_sweeps_ )
+{
+    using namespace batched_detail;
+
+    // (1) S = A^T * A
+    T s[ 3 ][ 3 ][ L ];
+    for( size_t i = 0; i < 3; ++i )
+    {
+        for( size_t j = 0; j < 3; ++j )
+        {
+            for( size_t l = 0; l < L; ++l )
+            {
+                s[ i ][ j ][ l ] = a_[ 0 ][ i ][ l ] * a_[ 0 ][ j ][ l ]
+                                 + a_[ 1 ][ i ][ l ] * a_[ 1 ][ j ][ l ]
+                                 + a_[ 2 ][ i ][ l ] * a_[ 2 ][ j ][ l ];
+            }
+        }
+    }
+
+    // (2) Jacobi eigen decomposition of S, V accumulated as quaternion
+    //     (w, x, y, z). pair (p, q) rotates about axis k, (p, q, k) cyclic.
+    T qw[ L ], qv[ 3 ][ L ];
+    for( size_t l = 0; l < L; ++l )
+    {
+        qw[ l ] = T( 1 );
+        qv[ 0 ][ l ] = qv[ 1 ][ l ] = qv[ 2 ][ l ] = T( 0 );
+    }
+
+    T c[ L ], sn[ L ];
+    for( size_t sweep = 0; sweep < n_sweeps_; ++sweep )
+    {
+        for( size_t k = 0; k < 3; ++k )
+        {
+            const size_t p = ( k + 1 ) % 3;
+            const size_t q = ( k + 2 ) % 3;
+            jacobi_rotation< T, L >( s[ p ][ p ], s[ q ][ q ], s[ p ][ q ], c, sn );
+
+            for( size_t i = 0; i < 3; ++i )
+                rotate< T, L >( s[ i ][ p ], s[ i ][ q ], c, sn );
+            for( size_t i = 0; i < 3; ++i )
+                rotate< T, L >( s[ p ][ i ], s[ q ][ i ], c, sn );
+
+            // the rotation is by -theta about axis k: q_k = ( cos( theta/2 ), -sin( theta/2 ) e_k ),
+            // q = q * q_k
+            const size_t k1 = ( k + 1 ) % 3;
+            const size_t k2 = ( k + 2 ) % 3;
+            for( size_t l = 0; l < L; ++l )
+            {
+                const T ch = std::sqrt( ( T( 1 ) + c[ l ] ) * T( 0.5 ) );
+                const T sh = -sn[ l ] / ( T( 2 ) * ch );
+                const T w = qw[ l ];
+                const T x_k = qv[ k ][ l ];
+                const T x_k1 = qv[ k1 ][ l ];
+                const T x_k2 = qv[ k2 ][ l ];
+                qw[ l ]       = w * ch - x_k * sh;
+                qv[ k ][ l ]  = x_k * ch + w * sh;
+                qv[ k1 ][ l ] = x_k1 * ch + x_k2 * sh;
+                qv[ k2 ][ l ] = x_k2 * ch - x_k1 * sh;
+            }
+        }
+    }
+
+    // quaternion to rotation matrix (normalized, rounding errors of the products)
+    for( size_t l = 0; l < L; ++l )
+    {
+        const T norm = T( 1 ) / std::sqrt( qw[ l ] * qw[ l ] + qv[ 0 ][ l ] * qv[ 0 ][ l ]
+                                         + qv[ 1 ][ l ] * qv[ 1 ][ l ] + qv[ 2 ][ l ] * qv[ 2 ][ l ] );
+        const T w = qw[ l ] * norm;
+        const T x = qv[ 0 ][ l ] * norm;
+        const T y = qv[ 1 ][ l ] * norm;
+        const T z = qv[ 2 ][ l ] * norm;
+
+        v_[ 0 ][ 0 ][ l ] = T( 1 ) - T( 2 ) * ( y * y + z * z );
+        v_[ 0 ][ 1 ][ l ] = T( 2 ) * ( x * y - w * z );
+        v_[ 0 ][ 2 ][ l ] = T( 2 ) * ( x * z + w * y );
+        v_[ 1 ][ 0 ][ l ] = T( 2 ) * ( x * y + w * z );
+        v_[ 1 ][ 1 ][ l ] = T( 1 ) - T( 2 ) * ( x * x + z * z );
+        v_[ 1 ][ 2 ][ l ] = T( 2 ) * ( y * z - w * x );
+        v_[ 2 ][ 0 ][ l ] = T( 2 ) * ( x * z - w * y );
+        v_[ 2 ][ 1 ][ l ] = T( 2 ) * ( y * z + w * x );
+        v_[ 2 ][ 2 ][ l ] = T( 1 ) - T( 2 ) * ( x * x + y * y );
+    }
+
+    // (3) B = A * V, columns sorted by decreasing norm. a swap negates one
+    //     column to keep det( V ) = 1.
+    T b[ 3 ][ 3 ][ L ];
+    for( size_t i = 0; i < 3; ++i )
+    {
+        for( size_t j = 0; j < 3; ++j )
+        {
+            for( size_t l = 0; l < L; ++l )
+            {
+                b[ i ][ j ][ l ] = a_[ i ][ 0 ][ l ] * v_[ 0 ][ j ][ l ]
+                                 + a_[ i ][ 1 ][ l ] * v_[ 1 ][ j ][ l ]
+                                 + a_[ i ][ 2 ][ l ] * v_[ 2 ][ j ][ l ];
+            }
+        }
+    }
+
+    T norm2[ 3 ][ L ];
+    for( size_t j = 0; j < 3; ++j )
+        for( size_t l = 0; l < L; ++l )
+            norm2[ j ][ l ] = b[ 0 ][ j ][ l ] * b[ 0 ][ j ][ l ]
+                            + b[ 1 ][ j ][ l ] * b[ 1 ][ j ][ l ]
+                            + b[ 2 ][ j ][ l ] * b[ 2 ][ j ][ l ];
+
+    const size_t network[ 3 ][ 2 ] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+    bool swap[ L ];
+    for( size_t n = 0; n < 3; ++n )
+    {
+        const size_t i = network[ n ][ 0 ];
+        const size_t j = network[ n ][ 1 ];
+        for( size_t l = 0; l < L; ++l )
+            swap[ l ] = norm2[ i ][ l ] < norm2[ j ][ l ];
+        conditional_swap< T, L >( norm2[ i ], norm2[ j ], swap, false );
+        for( size_t k = 0; k < 3; ++k )
+        {
+            conditional_swap< T, L >( b[ k ][ i ], b[ k ][ j ], swap, true );
+            conditional_swap< T, L >( v_[ k ][ i ], v_[ k ][ j ], swap, true );
+        }
+    }
+
+    // (4) QR decomposition B = U * R with Givens rotations, sigma = diag( R )
+    for( size_t i = 0; i < 3; ++i )
+        for( size_t j = 0; j < 3; ++j )
+            for( size_t l = 0; l < L; ++l )
+                u_[ i ][ j ][ l ] = ( i == j ) ? T( 1 ) : T( 0 );
+
+    const size_t givens[ 3 ][ 3 ] = { { 0, 1, 0 }, { 0, 2, 0 }, { 1, 2, 1 } }; // rows p, q, column
+    const T tiny = (std::numeric_limits< T >::min)();
+    for( size_t n = 0; n < 3; ++n )
+    {
+        const size_t p = givens[ n ][ 0 ];
+        const size_t q = givens[ n ][ 1 ];
+        const size_t col = givens[ n ][ 2 ];
+        for( size_t l = 0; l < L; ++l )
+        {
+            const T x = b[ p ][ col ][ l ];
+            const T y = b[ q ][ col ][ l ];
+            const T rho = std::sqrt( x * x + y * y );
+            const bool zero = rho <= tiny;
+            c[ l ] = zero ? T( 1 ) : x / ( zero ? T( 1 ) : rho );
+            // rows: p' = c*p + s*q, q' = -s*p + c*q
+            sn[ l ] = zero ? T( 0 ) : -y / ( zero ? T( 1 ) : rho );
+        }
+        for( size_t k = 0; k < 3; ++k )
+            rotate< T, L >( b[ p ][ k ], b[ q ][ k ], c, sn );
+        // U = U * G^T
+        for( size_t k = 0; k < 3; ++k )
+            rotate< T, L >( u_[ k ][ p ], u_[ k ][ q ], c, sn );
+    }
+
+    for( size_t i = 0; i < 3; ++i )
+        for( size_t l = 0; l < L; ++l )
+            sigma_[ i ][ l ] = b[ i ][ i ][ l ];
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_svd3< T, L >::compute( const matrix_type* a_, matrix_type* u_, vector_type* sigma_,
+                               matrix_type* v_, size_t count_, size_t n_sweeps_ )
+{
+    compute( a_, u_, sigma_, v_, count_, n_sweeps_, false );
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_svd3< T, L >::compute_rotations( const matrix_type* a_, matrix_type* u_, vector_type* sigma_,
+                                         matrix_type* v_, size_t count_, size_t n_sweeps_ )
+{
+    compute( a_, u_, sigma_, v_, count_, n_sweeps_, true );
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_svd3< T, L >::compute( const matrix_type* a_, matrix_type* u_, vector_type* sigma_,
+                               matrix_type* v_, size_t count_, size_t n_sweeps_, bool rotations_ )
+{
+    const long n_groups = static_cast< long >( ( count_ + L - 1 ) / L );
+
+#pragma omp parallel for
+    for( long group = 0; group < n_groups; ++group )
+    {
+        T a[ 3 ][ 3 ][ L ];
+        T u[ 3 ][ 3 ][ L ];
+        T v[ 3 ][ 3 ][ L ];
+        T sigma[ 3 ][ L ];
+
+        const size_t first = static_cast< size_t >( group ) * L;
+        for( size_t l = 0; l < L; ++l )
+        {
+            const bool valid = first + l < count_;
+            for( size_t i = 0; i < 3; ++i )
+                for( size_t j = 0; j < 3; ++j )
+                    a[ i ][ j ][ l ] = valid ? a_[ first + l ]( i, j ) : T( i == j );
+        }
+
+        compute_lanes( a, u, sigma, v, n_sweeps_ );
+
+        if ( ! rotations_ )
+        {
+            // non-negative sigma, flip the last column of U instead
+            for( size_t l = 0; l < L; ++l )
+            {
+                const T sign = sigma[ 2 ][ l ] < T( 0 ) ? T( -1 ) : T( 1 );
+                sigma[ 2 ][ l ] *= sign;
+                u[ 0 ][ 2 ][ l ] *= sign;
+                u[ 1 ][ 2 ][ l ] *= sign;
+                u[ 2 ][ 2 ][ l ] *= sign;
+            }
+        }
+
+        for( size_t l = 0; l < L && first + l < count_; ++l )
+        {
+            for( size_t i = 0; i < 3; ++i )
+            {
+                sigma_[ first + l ]( i ) = sigma[ i ][ l ];
+                for( size_t j = 0; j < 3; ++j )
+                {
+                    u_[ first + l ]( i, j ) = u[ i ][ j ][ l ];
+                    v_[ first + l ]( i, j ) = v[ i ][ j ][ l ];
+                }
+            }
+        }
+    }
+}
+
+
+} // namespace vmml
+
+#endif
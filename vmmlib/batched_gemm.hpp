@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__BATCHED_GEMM__HPP__
+#define __VMML__BATCHED_GEMM__HPP__
+
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/blas_dgemm.hpp>
+#include <vmmlib/blas_config.hpp>
+
+#ifdef VMMLIB_USE_OPENMP
+#  include <omp.h>
+#endif
+
+/**
+ *
+ *   batched_gemm< M, K, N, T, L >: products C_i = A_i * B_i of many small
+ *   matrices of the same size, A_i M x K, B_i K x N, all column-major.
+ *
+ *   the batch is given as arrays of matrices, as arrays of pointers to
+ *   matrices or as raw arrays with a stride between consecutive matrices.
+ *   a stride of 0 (or the overloads taking a single matrix) uses the same
+ *   left or right matrix for the whole batch, e.g. one parent transform
+ *   times the local transforms of its children.
+ *
+ *   products with M * K * N < BLAS_THRESHOLD run a fixed-size kernel that
+ *   builds every column of C as a linear combination of the columns of A.
+ *   for mat4f a column is one 4-wide vector register. larger products call
+ *   blas gemm for each matrix.
+ *
+ *   batches of at least PARALLEL_THRESHOLD multiply-adds are distributed
+ *   over OpenMP threads. blas is switched to a single thread meanwhile
+ *   (see blas::serial_region).
+ *
+ *   multiply_lanes multiplies L matrices stored interleaved in
+ *   structure-of-arrays layout, a_[ row ][ col ][ lane ] (as the lane
+ *   groups of batched_eigen_solver.hpp). the lane loops vectorize over
+ *   the L matrices. the array-of-matrices overloads do not interleave:
+ *   gathering into the lane layout and scattering back cost more than the
+ *   column kernel for the sizes up to the blas threshold.
+ *
+ *   the result may be the same as the left or right input (in place),
+ *   but must not overlap them otherwise. a broadcast input is read by
+ *   every product, so it must not be one of the results of a batch of
+ *   more than one product (copy it first); this is rejected with an
+ *   exception.
+ *
+ **
+ */
+
+namespace vmml
+{
+
+template< size_t M, size_t K, size_t N, typename T = float, size_t L = 8 >
+struct batched_gemm
+{
+    typedef matrix< M, K, T >   left_type;
+    typedef matrix< K, N, T >   right_type;
+    typedef matrix< M, N, T >   result_type;
+
+    // products of at least 8x8x8 multiply-adds go to blas
+    static const size_t BLAS_THRESHOLD = 512;
+    // multiply-adds of a batch from which it is split over threads
+    static const size_t PARALLEL_THRESHOLD = 65536;
+
+    // result_[ i ] = left_[ i ] * right_[ i ]
+    static void multiply( const left_type* left_, const right_type* right_,
+                          result_type* result_, size_t count_ );
+
+    // result_[ i ] = left_ * right_[ i ], left_ must not be one of the results
+    static void multiply( const left_type& left_, const right_type* right_,
+                          result_type* result_, size_t count_ );
+
+    // result_[ i ] = left_[ i ] * right_, right_ must not be one of the results
+    static void multiply( const left_type* left_, const right_type& right_,
+                          result_type* result_, size_t count_ );
+
+    // *result_[ i ] = *left_[ i ] * *right_[ i ]
+    static void multiply( const left_type* const* left_, const right_type* const* right_,
+                          result_type* const* result_, size_t count_ );
+
+    // raw column-major arrays, matrix i starts at left_ + i * left_stride_
+    // etc.; a stride of 0 broadcasts an input
+    static void multiply( const T* left_, size_t left_stride_,
+                          const T* right_, size_t right_stride_,
+                          T* result_, size_t result_stride_, size_t count_ );
+
+    // a single product of column-major arrays
+    static void multiply( const T* left_, const T* right_, T* result_ );
+
+    // one lane group in SoA layout, result_ must not alias the inputs
+    static void multiply_lanes( const T left_[ M ][ K ][ L ], const T right_[ K ][ N ][ L ],
+                                T result_[ M ][ N ][ L ] );
+
+protected:
+    // element access for the batch loop
+    struct strided_array
+    {
+        strided_array( const T* data_, size_t stride_ ) : data( data_ ), stride( stride_ ) {}
+        const T* operator[]( size_t i_ ) const { return data + i_ * stride; }
+        const T* data;
+        size_t stride;
+    };
+
+    struct strided_result_array
+    {
+        strided_result_array( T* data_, size_t stride_ ) : data( data_ ), stride( stride_ ) {}
+        T* operator[]( size_t i_ ) const { return data + i_ * stride; }
+        T* data;
+        size_t stride;
+    };
+
+    template< typename matrix_t >
+    struct pointer_array
+    {
+        explicit pointer_array( const matrix_t* const* data_ ) : data( data_ ) {}
+        const T* operator[]( size_t i_ ) const { return data[ i_ ]->array; }
+        const matrix_t* const* data;
+    };
+
+    struct result_pointer_array
+    {
+        explicit result_pointer_array( result_type* const* data_ ) : data( data_ ) {}
+        T* operator[]( size_t i_ ) const { return data[ i_ ]->array; }
+        result_type* const* data;
+    };
+
+    template< typename left_t, typename right_t, typename result_t >
+    static void multiply_batch( const left_t& left_, const right_t& right_,
+                                const result_t& result_, size_t count_ );
+
+    template< typename left_t, typename right_t, typename result_t >
+    static void multiply_range( const left_t& left_, const right_t& right_,
+                                const result_t& result_, size_t count_, bool parallel_ );
+
+    // scratch_ holds the blas result of in-place products, it is allocated
+    // on first use and released by the caller
+    static void multiply( const T* left_, const T* right_, T* result_, T*& scratch_ );
+
+    static void multiply_kernel( const T* left_, const T* right_, T* result_ );
+    static void multiply_blas( const T* left_, const T* right_, T* result_, T*& scratch_ );
+
+    // whether a broadcast input of size_ elements lies within the results
+    // of a batch of more than one product
+    static bool is_result( const T* input_, size_t size_, const T* result_,
+                           size_t result_stride_, size_t count_ );
+
+    // distance between consecutive matrices in an array, may include
+    // padding (VMMLIB_ALIGN)
+    static size_t left_stride() { return sizeof( left_type ) / sizeof( T ); }
+    static size_t right_stride() { return sizeof( right_type ) / sizeof( T ); }
+    static size_t result_stride() { return sizeof( result_type ) / sizeof( T ); }
+
+}; // struct batched_gemm
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+void
+batched_gemm< M, K, N, T, L >::multiply( const left_type* left_, const right_type* right_,
+                                         result_type* result_, size_t count_ )
+{
+    if ( count_ == 0 )
+        return;
+    multiply( left_->array, left_stride(), right_->array, right_stride(),
+              result_->array, result_stride(), count_ );
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+void
+batched_gemm< M, K, N, T, L >::multiply( const left_type& left_, const right_type* right_,
+                                         result_type* result_, size_t count_ )
+{
+    if ( count_ == 0 )
+        return;
+    multiply( left_.array, 0, right_->array, right_stride(),
+              result_->array, result_stride(), count_ );
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+void
+batched_gemm< M, K, N, T, L >::multiply( const left_type* left_, const right_type& right_,
+                                         result_type* result_, size_t count_ )
+{
+    if ( count_ == 0 )
+        return;
+    multiply( left_->array, left_stride(), right_.array, 0,
+              result_->array, result_stride(), count_ );
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+void
+batched_gemm< M, K, N, T, L >::multiply( const left_type* const* left_,
+                                         const right_type* const* right_,
+                                         result_type* const* result_, size_t count_ )
+{
+    multiply_batch( pointer_array< left_type >( left_ ), pointer_array< right_type >( right_ ),
+                    result_pointer_array( result_ ), count_ );
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+void
+batched_gemm< M, K, N, T, L >::multiply( const T* left_, size_t left_stride_,
+                                         const T* right_, size_t right_stride_,
+                                         T* result_, size_t result_stride_, size_t count_ )
+{
+    if ( ( left_stride_ == 0 && is_result( left_, M * K, result_, result_stride_, count_ ) )
+        || ( right_stride_ == 0 && is_result( right_, K * N, result_, result_stride_, count_ ) ) )
+    {
+        VMMLIB_ERROR( "batched_gemm: broadcast input is overwritten by the batch", VMMLIB_HERE );
+    }
+    multiply_batch( strided_array( left_, left_stride_ ), strided_array( right_, right_stride_ ),
+                    strided_result_array( result_, result_stride_ ), count_ );
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+inline void
+batched_gemm< M, K, N, T, L >::multiply( const T* left_, const T* right_, T* result_ )
+{
+    T* scratch = 0;
+    multiply( left_, right_, result_, scratch );
+    delete[] scratch;
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+inline void
+batched_gemm< M, K, N, T, L >::multiply( const T* left_, const T* right_, T* result_,
+                                         T*& scratch_ )
+{
+    if ( M * K * N < BLAS_THRESHOLD )
+        multiply_kernel( left_, right_, result_ );
+    else
+        multiply_blas( left_, right_, result_, scratch_ );
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+template< typename left_t, typename right_t, typename result_t >
+void
+batched_gemm< M, K, N, T, L >::multiply_batch( const left_t& left_, const right_t& right_,
+                                               const result_t& result_, size_t count_ )
+{
+    const bool parallel = count_ * M * K * N >= PARALLEL_THRESHOLD;
+    if ( parallel && M * K * N >= BLAS_THRESHOLD )
+    {
+#ifdef VMMLIB_USE_OPENMP
+        blas::serial_region single_threaded_blas;
+#endif
+        multiply_range( left_, right_, result_, count_, true );
+    }
+    else
+    {
+        multiply_range( left_, right_, result_, count_, parallel );
+    }
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+template< typename left_t, typename right_t, typename result_t >
+void
+batched_gemm< M, K, N, T, L >::multiply_range( const left_t& left_, const right_t& right_,
+                                               const result_t& result_, size_t count_,
+                                               bool parallel_ )
+{
+    (void) parallel_;
+    const long n = static_cast< long >( count_ );
+
+#pragma omp parallel if( parallel_ )
+    {
+        // one scratch per thread for the in-place blas products
+        T* scratch = 0;
+#pragma omp for
+        for( long i = 0; i < n; ++i )
+        {
+            const size_t index = static_cast< size_t >( i );
+            multiply( left_[ index ], right_[ index ], result_[ index ], scratch );
+        }
+        delete[] scratch;
+    }
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+inline void
+batched_gemm< M, K, N, T, L >::multiply_kernel( const T* left_, const T* right_, T* result_ )
+{
+    // column j of C is sum_k A(:,k) * B(k,j), accumulated in a temporary
+    // so that result_ may alias an input
+    T c[ M * N ];
+    for( size_t j = 0; j < N; ++j )
+    {
+        const T* b = right_ + j * K;
+        T* c_j = c + j * M;
+        for( size_t i = 0; i < M; ++i )
+            c_j[ i ] = left_[ i ] * b[ 0 ];
+        for( size_t k = 1; k < K; ++k )
+        {
+            const T* a_k = left_ + k * M;
+            const T b_kj = b[ k ];
+            for( size_t i = 0; i < M; ++i )
+                c_j[ i ] += a_k[ i ] * b_kj;
+        }
+    }
+    for( size_t i = 0; i < M * N; ++i )
+        result_[ i ] = c[ i ];
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+void
+batched_gemm< M, K, N, T, L >::multiply_blas( const T* left_, const T* right_, T* result_,
+                                              T*& scratch_ )
+{
+    blas::dgemm_params< T > p;
+    p.order     = CblasColMajor;
+    p.trans_a   = CblasNoTrans;
+    p.trans_b   = CblasNoTrans;
+    p.m         = M;
+    p.n         = N;
+    p.k         = K;
+    p.alpha     = 1;
+    p.a         = left_;
+    p.lda       = M;
+    p.b         = right_;
+    p.ldb       = K;
+    p.beta      = 0;
+    p.c         = result_;
+    p.ldc       = M;
+
+    const bool aliased = result_ == left_ || result_ == right_;
+    if ( ! aliased )
+    {
+        blas::dgemm_call< T >( p );
+        return;
+    }
+
+    // in place: compute into the scratch
+    if ( ! scratch_ )
+        scratch_ = new T[ M * N ];
+    p.c = scratch_;
+    blas::dgemm_call< T >( p );
+    for( size_t i = 0; i < M * N; ++i )
+        result_[ i ] = scratch_[ i ];
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+bool
+batched_gemm< M, K, N, T, L >::is_result( const T* input_, size_t size_, const T* result_,
+                                          size_t result_stride_, size_t count_ )
+{
+    // a single product may run in place
+    if ( count_ < 2 )
+        return false;
+    const T* result_end = result_ + ( count_ - 1 ) * result_stride_ + M * N;
+    return input_ < result_end && result_ < input_ + size_;
+}
+
+
+
+template< size_t M, size_t K, size_t N, typename T, size_t L >
+void
+batched_gemm< M, K, N, T, L >::multiply_lanes( const T left_[ M ][ K ][ L ],
+                                               const T right_[ K ][ N ][ L ],
+                                               T result_[ M ][ N ][ L ] )
+{
+    for( size_t i = 0; i < M; ++i )
+    {
+        for( size_t j = 0; j < N; ++j )
+        {
+            T sum[ L ];
+            for( size_t l = 0; l < L; ++l )
+                sum[ l ] = left_[ i ][ 0 ][ l ] * right_[ 0 ][ j ][ l ];
+            for( size_t k = 1; k < K; ++k )
+                for( size_t l = 0; l < L; ++l )
+                    sum[ l ] += left_[ i ][ k ][ l ] * right_[ k ][ j ][ l ];
+            for( size_t l = 0; l < L; ++l )
+                result_[ i ][ j ][ l ] = sum[ l ];
+        }
+    }
+}
+
+} // namespace vmml
+
+#endif
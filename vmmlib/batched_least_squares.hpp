@@ -0,0 +1,734 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__BATCHED_LEAST_SQUARES__HPP__
+#define __VMML__BATCHED_LEAST_SQUARES__HPP__
+
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+#include <vmmlib/batched_eigen_solver.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#ifdef VMMLIB_USE_OPENMP
+#  include <omp.h>
+#endif
+
+/**
+ *
+ *   batched least squares fitting for many small, independent problems:
+ *
+ *   batched_least_squares< N, T, L >: min sum w ( row * x - y )^2 for an
+ *   N-vector x per problem. the normal equations are accumulated per
+ *   observation and solved with a branch-free Cholesky factorization.
+ *   batched_plane_fit< T, L >: total least squares plane (centroid, unit
+ *   normal and surface variation) from the covariance of the points,
+ *   see Pauly et al., 2002: Efficient simplification of point-sampled
+ *   surfaces. the covariance is decomposed with batched_sym_eigs3.
+ *   compute_normals() goes straight from moments accumulated by the
+ *   caller (e.g. per voxel or per k-neighbourhood) to normals and
+ *   surface variation without filling a batch.
+ *   batched_quadric_fit< T, L >: height field quadric
+ *   z = a x^2 + b xy + c y^2 + d x + e y + f in a local frame.
+ *
+ *   the moments of all problems are stored in structure-of-arrays layout
+ *   ( moment k of problem p at k * size() + p ). add() may be called
+ *   concurrently for different problems; adding all observations of a
+ *   problem in one call sums them up locally and touches the batch once.
+ *   the solve is done in lane groups of L problems as in
+ *   batched_eigen_solver.hpp, every scalar operation is a loop over the
+ *   L lanes so the compiler can vectorize it, and the lane groups are
+ *   distributed over OpenMP threads.
+ *
+ *   the plane fit accumulates the points relative to the first point
+ *   added to each problem, so the covariance does not suffer from
+ *   cancellation for points far from the origin.
+ *
+ **
+ */
+
+namespace vmml
+{
+
+template< size_t N, typename T = double, size_t L = 8 >
+class batched_least_squares
+{
+public:
+    typedef vector< N, T >  vector_type;
+
+    static const size_t N_NORMAL = N * ( N + 1 ) / 2; // packed lower triangle of A^T W A
+    static const size_t N_MOMENTS = N_NORMAL + N + 1; // A^T W A, A^T W y, y^T W y
+
+    explicit batched_least_squares( size_t count_ = 0 ) : _count( 0 ) { resize( count_ ); }
+
+    // resizes to count_ problems and clears all moments
+    void resize( size_t count_ );
+    void clear();
+    size_t size() const { return _count; }
+
+    // adds the observation row_ * x = y_ with weight_ to problem_
+    void add( size_t problem_, const T* row_, T y_, T weight_ = 1 );
+    void add( size_t problem_, const vector_type& row_, T y_, T weight_ = 1 )
+        { add( problem_, row_.array, y_, weight_ ); }
+
+    // adds n_rows_ observations (rows_ row-major, n_rows_ x N) at once,
+    // weights_ is optional. faster than single adds since the moments are
+    // summed up locally and written to the batch once.
+    void add( size_t problem_, const T* rows_, const T* y_, size_t n_rows_,
+              const T* weights_ = 0 );
+
+    // adds moments_[ N_MOMENTS ] summed up with accumulate()
+    void add_moments( size_t problem_, const T* moments_ );
+    static void accumulate( T* moments_, const T* row_, T y_, T weight_ = 1 );
+
+    // x_[ p ] minimizes sum w ( row * x - y )^2 + ridge_ |x|^2. problems
+    // with a singular normal matrix get x = 0 and solved_[ p ] = false.
+    // residual_[ p ] is the weighted sum of squared residuals. solved_ and
+    // residual_ are optional. returns the number of solved problems.
+    size_t solve( vector_type* x_, bool* solved_ = 0, T* residual_ = 0,
+                  T ridge_ = 0 ) const;
+
+    // one lane group: packed lower triangle ( index i * ( i + 1 ) / 2 + j )
+    // of the normal matrix and right-hand side
+    static void solve_lanes( const T ata_[ N_NORMAL ][ L ], const T atb_[ N ][ L ],
+                             T x_[ N ][ L ], bool solved_[ L ] );
+
+protected:
+    size_t              _count;
+    std::vector< T >    _moments;
+
+}; // class batched_least_squares
+
+
+
+template< typename T = double, size_t L = 8 >
+class batched_plane_fit
+{
+public:
+    typedef vector< 3, T >  vector_type;
+
+    // weight, weighted sum and packed second moments of the points
+    // relative to origin, and the origin itself
+    static const size_t N_MOMENTS = 13;
+    // the first 10 of them, see accumulate()
+    static const size_t N_COVARIANCE_MOMENTS = 10;
+
+    // Jacobi refinement sweeps after the closed form, see batched_sym_eigs3
+    static const size_t DEFAULT_SWEEPS = batched_sym_eigs3< T, L >::DEFAULT_REFINEMENT_SWEEPS;
+
+    explicit batched_plane_fit( size_t count_ = 0 ) : _count( 0 ) { resize( count_ ); }
+
+    void resize( size_t count_ );
+    void clear();
+    size_t size() const { return _count; }
+
+    void add( size_t problem_, const vector_type& point_, T weight_ = 1 );
+    // adds n_points_ points at once, weights_ is optional
+    void add( size_t problem_, const vector_type* points_, size_t n_points_,
+              const T* weights_ = 0 );
+
+    // centroid, unit normal (eigenvector of the smallest eigenvalue of the
+    // covariance, sign undefined) and surface variation
+    // lambda_0 / ( lambda_0 + lambda_1 + lambda_2 ) (0 for a plane).
+    // needs three points not on a line; problems without points get a zero
+    // normal. normal_ and curvature_ are optional.
+    void compute( vector_type* centroid_, vector_type* normal_,
+                  T* curvature_ = 0,
+                  size_t n_sweeps_ = DEFAULT_SWEEPS ) const;
+
+    // adds point_ - origin_ to moments_[ N_COVARIANCE_MOMENTS ] (weight,
+    // sum, packed lower second moments). origin_ is any point close to the
+    // points, it avoids cancellation in the covariance.
+    static void accumulate( T* moments_, const vector_type& point_,
+                            const vector_type& origin_, T weight_ = 1 );
+
+    // normal and surface variation as compute() for count_ problems with
+    // the moments of problem p at moments_ + p * N_COVARIANCE_MOMENTS.
+    // curvature_ is optional.
+    static void compute_normals( const T* moments_, size_t count_,
+                                 vector_type* normal_, T* curvature_ = 0,
+                                 size_t n_sweeps_ = DEFAULT_SWEEPS );
+
+    // one lane group: weight_ and the lower triangle of the covariance,
+    // lanes with zero weight get a zero normal and curvature
+    static void compute_lanes( const T weight_[ L ], const T c_[ 3 ][ 3 ][ L ],
+                               T normal_[ 3 ][ L ], T curvature_[ L ],
+                               size_t n_sweeps_ = DEFAULT_SWEEPS );
+
+protected:
+    void _add_moments( size_t problem_, const T* moments_, const T* origin_ );
+
+    size_t              _count;
+    std::vector< T >    _moments;
+
+}; // class batched_plane_fit
+
+
+
+template< typename T = double, size_t L = 8 >
+class batched_quadric_fit
+{
+public:
+    typedef vector< 3, T >  vector_type;
+    typedef vector< 6, T >  coefficients_type; // a, b, c, d, e, f
+
+    explicit batched_quadric_fit( size_t count_ = 0 ) : _solver( count_ ) {}
+
+    void resize( size_t count_ ) { _solver.resize( count_ ); }
+    void clear() { _solver.clear(); }
+    size_t size() const { return _solver.size(); }
+
+    // point_ in the local frame of the problem, z is the height
+    void add( size_t problem_, const vector_type& point_, T weight_ = 1 );
+    void add( size_t problem_, const vector_type* points_, size_t n_points_,
+              const T* weights_ = 0 );
+
+    // needs six points in general position, see batched_least_squares::solve
+    size_t compute( coefficients_type* coefficients_, bool* solved_ = 0,
+                    T* residual_ = 0, T ridge_ = 0 ) const
+        { return _solver.solve( coefficients_, solved_, residual_, ridge_ ); }
+
+    // mean and gaussian curvature of the height field at x = y = 0
+    static void compute_curvatures( const coefficients_type& coefficients_,
+                                    T& mean_, T& gaussian_ );
+
+protected:
+    batched_least_squares< 6, T, L >    _solver;
+
+}; // class batched_quadric_fit
+
+
+
+template< size_t N, typename T, size_t L >
+void
+batched_least_squares< N, T, L >::resize( size_t count_ )
+{
+    _count = count_;
+    _moments.assign( N_MOMENTS * count_, T( 0 ) );
+}
+
+
+
+template< size_t N, typename T, size_t L >
+void
+batched_least_squares< N, T, L >::clear()
+{
+    _moments.assign( _moments.size(), T( 0 ) );
+}
+
+
+
+template< size_t N, typename T, size_t L >
+void
+batched_least_squares< N, T, L >::add( size_t problem_, const T* row_, T y_, T weight_ )
+{
+    T* m = &_moments[ problem_ ];
+    size_t k = 0;
+    for( size_t i = 0; i < N; ++i )
+    {
+        const T wr = weight_ * row_[ i ];
+        for( size_t j = 0; j <= i; ++j, ++k )
+            m[ k * _count ] += wr * row_[ j ];
+    }
+    for( size_t i = 0; i < N; ++i )
+        m[ ( N_NORMAL + i ) * _count ] += weight_ * row_[ i ] * y_;
+    m[ ( N_NORMAL + N ) * _count ] += weight_ * y_ * y_;
+}
+
+
+
+template< size_t N, typename T, size_t L >
+void
+batched_least_squares< N, T, L >::accumulate( T* moments_, const T* row_, T y_, T weight_ )
+{
+    size_t k = 0;
+    for( size_t i = 0; i < N; ++i )
+    {
+        const T wr = weight_ * row_[ i ];
+        for( size_t j = 0; j <= i; ++j, ++k )
+            moments_[ k ] += wr * row_[ j ];
+        moments_[ N_NORMAL + i ] += wr * y_;
+    }
+    moments_[ N_NORMAL + N ] += weight_ * y_ * y_;
+}
+
+
+
+template< size_t N, typename T, size_t L >
+void
+batched_least_squares< N, T, L >::add_moments( size_t problem_, const T* moments_ )
+{
+    T* m = &_moments[ problem_ ];
+    for( size_t k = 0; k < N_MOMENTS; ++k )
+        m[ k * _count ] += moments_[ k ];
+}
+
+
+
+template< size_t N, typename T, size_t L >
+void
+batched_least_squares< N, T, L >::add( size_t problem_, const T* rows_, const T* y_,
+    size_t n_rows_, const T* weights_ )
+{
+    T moments[ N_MOMENTS ];
+    for( size_t k = 0; k < N_MOMENTS; ++k )
+        moments[ k ] = 0;
+    for( size_t r = 0; r < n_rows_; ++r )
+        accumulate( moments, rows_ + r * N, y_[ r ], weights_ ? weights_[ r ] : T( 1 ));
+    add_moments( problem_, moments );
+}
+
+
+
+template< size_t N, typename T, size_t L >
+void
+batched_least_squares< N, T, L >::solve_lanes( const T ata_[ N_NORMAL ][ L ],
+    const T atb_[ N ][ L ], T x_[ N ][ L ], bool solved_[ L ] )
+{
+    const T eps = std::numeric_limits< T >::epsilon() * T( N );
+
+    // Cholesky A^T A = G G^T row by row, a failing pivot is replaced by 1
+    // and the lane marked unsolved
+    T g[ N_NORMAL ][ L ];
+    T inv_diag[ N ][ L ];
+    for( size_t l = 0; l < L; ++l )
+        solved_[ l ] = true;
+
+    for( size_t i = 0; i < N; ++i )
+    {
+        const size_t row_i = i * ( i + 1 ) / 2;
+        for( size_t j = 0; j <= i; ++j )
+        {
+            const size_t row_j = j * ( j + 1 ) / 2;
+            T s[ L ];
+            for( size_t l = 0; l < L; ++l )
+                s[ l ] = ata_[ row_i + j ][ l ];
+            for( size_t k = 0; k < j; ++k )
+                for( size_t l = 0; l < L; ++l )
+                    s[ l ] -= g[ row_i + k ][ l ] * g[ row_j + k ][ l ];
+
+            if ( j < i )
+            {
+                for( size_t l = 0; l < L; ++l )
+                    g[ row_i + j ][ l ] = s[ l ] * inv_diag[ j ][ l ];
+            }
+            else
+            {
+                for( size_t l = 0; l < L; ++l )
+                {
+                    const bool ok = s[ l ] > eps * ata_[ row_i + i ][ l ];
+                    solved_[ l ] = solved_[ l ] && ok;
+                    const T d = std::sqrt( ok ? s[ l ] : T( 1 ) );
+                    g[ row_i + i ][ l ] = d;
+                    inv_diag[ i ][ l ] = T( 1 ) / d;
+                }
+            }
+        }
+    }
+
+    // G y = A^T b, G^T x = y
+    for( size_t i = 0; i < N; ++i )
+    {
+        const size_t row_i = i * ( i + 1 ) / 2;
+        for( size_t l = 0; l < L; ++l )
+            x_[ i ][ l ] = atb_[ i ][ l ];
+        for( size_t k = 0; k < i; ++k )
+            for( size_t l = 0; l < L; ++l )
+                x_[ i ][ l ] -= g[ row_i + k ][ l ] * x_[ k ][ l ];
+        for( size_t l = 0; l < L; ++l )
+            x_[ i ][ l ] *= inv_diag[ i ][ l ];
+    }
+    for( size_t i = N; i-- > 0; )
+    {
+        for( size_t k = i + 1; k < N; ++k )
+        {
+            const size_t row_k = k * ( k + 1 ) / 2;
+            for( size_t l = 0; l < L; ++l )
+                x_[ i ][ l ] -= g[ row_k + i ][ l ] * x_[ k ][ l ];
+        }
+        for( size_t l = 0; l < L; ++l )
+            x_[ i ][ l ] *= inv_diag[ i ][ l ];
+    }
+
+    for( size_t i = 0; i < N; ++i )
+        for( size_t l = 0; l < L; ++l )
+            x_[ i ][ l ] = solved_[ l ] ? x_[ i ][ l ] : T( 0 );
+}
+
+
+
+template< size_t N, typename T, size_t L >
+size_t
+batched_least_squares< N, T, L >::solve( vector_type* x_, bool* solved_,
+    T* residual_, T ridge_ ) const
+{
+    const long n_groups = static_cast< long >( ( _count + L - 1 ) / L );
+    long n_solved = 0;
+
+#pragma omp parallel for reduction(+:n_solved)
+    for( long group = 0; group < n_groups; ++group )
+    {
+        T ata[ N_NORMAL ][ L ];
+        T atb[ N ][ L ];
+        T yty[ L ];
+        T x[ N ][ L ];
+        bool solved[ L ];
+
+        // gather, the lanes past the end get the identity
+        const size_t first = static_cast< size_t >( group ) * L;
+        for( size_t l = 0; l < L; ++l )
+        {
+            const bool valid = first + l < _count;
+            const T* m = valid ? &_moments[ first + l ] : 0;
+            size_t k = 0;
+            for( size_t i = 0; i < N; ++i )
+                for( size_t j = 0; j <= i; ++j, ++k )
+                    ata[ k ][ l ] = valid ? m[ k * _count ] + ( i == j ? ridge_ : T( 0 ) )
+                                          : T( i == j );
+            for( size_t i = 0; i < N; ++i )
+                atb[ i ][ l ] = valid ? m[ ( N_NORMAL + i ) * _count ] : T( 0 );
+            yty[ l ] = valid ? m[ ( N_NORMAL + N ) * _count ] : T( 0 );
+        }
+
+        solve_lanes( ata, atb, x, solved );
+
+        for( size_t l = 0; l < L && first + l < _count; ++l )
+        {
+            vector_type& result = x_[ first + l ];
+            for( size_t i = 0; i < N; ++i )
+                result.array[ i ] = x[ i ][ l ];
+            n_solved += solved[ l ] ? 1 : 0;
+            if ( solved_ )
+                solved_[ first + l ] = solved[ l ];
+            if ( residual_ )
+            {
+                // y^T y - 2 x^T A^T y + x^T A^T A x, without the ridge term
+                T r = yty[ l ];
+                size_t k = 0;
+                for( size_t i = 0; i < N; ++i )
+                {
+                    r -= T( 2 ) * x[ i ][ l ] * atb[ i ][ l ];
+                    for( size_t j = 0; j <= i; ++j, ++k )
+                    {
+                        const T a = ata[ k ][ l ] - ( i == j ? ridge_ : T( 0 ) );
+                        r += ( i == j ? T( 1 ) : T( 2 ) ) * x[ i ][ l ] * a * x[ j ][ l ];
+                    }
+                }
+                residual_[ first + l ] = r > T( 0 ) ? r : T( 0 );
+            }
+        }
+    }
+    return static_cast< size_t >( n_solved );
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_plane_fit< T, L >::resize( size_t count_ )
+{
+    _count = count_;
+    _moments.assign( N_MOMENTS * count_, T( 0 ) );
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_plane_fit< T, L >::clear()
+{
+    _moments.assign( _moments.size(), T( 0 ) );
+}
+
+
+
+namespace batched_detail
+{
+
+// weight, sum and packed second moments of point_ - origin_
+template< typename T >
+inline void
+accumulate_point( T* moments_, const T* point_, const T* origin_, T weight_ )
+{
+    T d[ 3 ];
+    for( size_t i = 0; i < 3; ++i )
+        d[ i ] = point_[ i ] - origin_[ i ];
+
+    moments_[ 0 ] += weight_;
+    size_t k = 4;
+    for( size_t i = 0; i < 3; ++i )
+    {
+        const T wd = weight_ * d[ i ];
+        moments_[ 1 + i ] += wd;
+        for( size_t j = 0; j <= i; ++j, ++k )
+            moments_[ k ] += wd * d[ j ];
+    }
+}
+
+} // namespace batched_detail
+
+
+
+template< typename T, size_t L >
+void
+batched_plane_fit< T, L >::_add_moments( size_t problem_, const T* moments_,
+    const T* origin_ )
+{
+    // moments: 0 weight, 1..3 sum, 4..9 packed second moments, 10..12 origin
+    T* m = &_moments[ problem_ ];
+    for( size_t k = 0; k < 10; ++k )
+        m[ k * _count ] += moments_[ k ];
+    for( size_t i = 0; i < 3; ++i )
+        m[ ( 10 + i ) * _count ] = origin_[ i ];
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_plane_fit< T, L >::add( size_t problem_, const vector_type& point_, T weight_ )
+{
+    add( problem_, &point_, 1, &weight_ );
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_plane_fit< T, L >::add( size_t problem_, const vector_type* points_,
+    size_t n_points_, const T* weights_ )
+{
+    if ( n_points_ == 0 )
+        return;
+
+    // the first point added to a problem is its origin
+    const T* m = &_moments[ problem_ ];
+    T origin[ 3 ];
+    for( size_t i = 0; i < 3; ++i )
+        origin[ i ] = m[ 0 ] == T( 0 ) ? points_[ 0 ].array[ i ] : m[ ( 10 + i ) * _count ];
+
+    T moments[ 10 ];
+    for( size_t k = 0; k < 10; ++k )
+        moments[ k ] = 0;
+    for( size_t p = 0; p < n_points_; ++p )
+        batched_detail::accumulate_point( moments, points_[ p ].array, origin,
+                                          weights_ ? weights_[ p ] : T( 1 ));
+    _add_moments( problem_, moments, origin );
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_plane_fit< T, L >::compute( vector_type* centroid_, vector_type* normal_,
+    T* curvature_, size_t n_sweeps_ ) const
+{
+    const long n_groups = static_cast< long >( ( _count + L - 1 ) / L );
+
+#pragma omp parallel for
+    for( long group = 0; group < n_groups; ++group )
+    {
+        T mean[ 3 ][ L ];
+        T weight[ L ];
+        T c[ 3 ][ 3 ][ L ];
+        T normal[ 3 ][ L ];
+        T curvature[ L ];
+
+        // gather the covariance, the lanes past the end get the identity
+        const size_t first = static_cast< size_t >( group ) * L;
+        for( size_t l = 0; l < L; ++l )
+        {
+            const bool valid = first + l < _count;
+            const T* m = valid ? &_moments[ first + l ] : 0;
+            weight[ l ] = valid ? m[ 0 ] : T( 0 );
+            const T inv_w = weight[ l ] > T( 0 ) ? T( 1 ) / weight[ l ] : T( 0 );
+            for( size_t i = 0; i < 3; ++i )
+                mean[ i ][ l ] = valid ? m[ ( 1 + i ) * _count ] * inv_w : T( 0 );
+            size_t k = 4;
+            for( size_t i = 0; i < 3; ++i )
+                for( size_t j = 0; j <= i; ++j, ++k )
+                    c[ i ][ j ][ l ] = weight[ l ] > T( 0 )
+                        ? m[ k * _count ] * inv_w - mean[ i ][ l ] * mean[ j ][ l ]
+                        : T( i == j );
+        }
+
+        compute_lanes( weight, c, normal, curvature, n_sweeps_ );
+
+        for( size_t l = 0; l < L && first + l < _count; ++l )
+        {
+            const T* m = &_moments[ first + l ];
+            for( size_t i = 0; i < 3; ++i )
+            {
+                centroid_[ first + l ].array[ i ] = m[ ( 10 + i ) * _count ] + mean[ i ][ l ];
+                if ( normal_ )
+                    normal_[ first + l ].array[ i ] = normal[ i ][ l ];
+            }
+            if ( curvature_ )
+                curvature_[ first + l ] = curvature[ l ];
+        }
+    }
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_plane_fit< T, L >::accumulate( T* moments_, const vector_type& point_,
+    const vector_type& origin_, T weight_ )
+{
+    batched_detail::accumulate_point( moments_, point_.array, origin_.array, weight_ );
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_plane_fit< T, L >::compute_normals( const T* moments_, size_t count_,
+    vector_type* normal_, T* curvature_, size_t n_sweeps_ )
+{
+    const long n_groups = static_cast< long >( ( count_ + L - 1 ) / L );
+
+#pragma omp parallel for
+    for( long group = 0; group < n_groups; ++group )
+    {
+        T weight[ L ];
+        T c[ 3 ][ 3 ][ L ];
+        T normal[ 3 ][ L ];
+        T curvature[ L ];
+
+        const size_t first = static_cast< size_t >( group ) * L;
+        for( size_t l = 0; l < L; ++l )
+        {
+            const bool valid = first + l < count_;
+            const T* m = valid ? moments_ + ( first + l ) * N_COVARIANCE_MOMENTS : 0;
+            weight[ l ] = valid ? m[ 0 ] : T( 0 );
+            const T inv_w = weight[ l ] > T( 0 ) ? T( 1 ) / weight[ l ] : T( 0 );
+            size_t k = 4;
+            for( size_t i = 0; i < 3; ++i )
+                for( size_t j = 0; j <= i; ++j, ++k )
+                    c[ i ][ j ][ l ] = weight[ l ] > T( 0 )
+                        ? ( m[ k ] - m[ 1 + i ] * m[ 1 + j ] * inv_w ) * inv_w
+                        : T( i == j );
+        }
+
+        compute_lanes( weight, c, normal, curvature, n_sweeps_ );
+
+        for( size_t l = 0; l < L && first + l < count_; ++l )
+        {
+            for( size_t i = 0; i < 3; ++i )
+                normal_[ first + l ].array[ i ] = normal[ i ][ l ];
+            if ( curvature_ )
+                curvature_[ first + l ] = curvature[ l ];
+        }
+    }
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_plane_fit< T, L >::compute_lanes( const T weight_[ L ], const T c_[ 3 ][ 3 ][ L ],
+    T normal_[ 3 ][ L ], T curvature_[ L ], size_t n_sweeps_ )
+{
+    T v[ 3 ][ 3 ][ L ];
+    T w[ 3 ][ L ];
+    batched_sym_eigs3< T, L >::compute_lanes( c_, v, w, n_sweeps_ );
+
+    for( size_t l = 0; l < L; ++l )
+    {
+        const bool has_points = weight_[ l ] > T( 0 );
+        for( size_t i = 0; i < 3; ++i )
+            normal_[ i ][ l ] = has_points ? v[ i ][ 0 ][ l ] : T( 0 );
+        const T lambda_0 = w[ 0 ][ l ] > T( 0 ) ? w[ 0 ][ l ] : T( 0 );
+        const T sum = lambda_0 + w[ 1 ][ l ] + w[ 2 ][ l ];
+        curvature_[ l ] = has_points && sum > T( 0 ) ? lambda_0 / sum : T( 0 );
+    }
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_quadric_fit< T, L >::add( size_t problem_, const vector_type& point_, T weight_ )
+{
+    const T x = point_.array[ 0 ];
+    const T y = point_.array[ 1 ];
+    const T row[ 6 ] = { x * x, x * y, y * y, x, y, T( 1 ) };
+    _solver.add( problem_, row, point_.array[ 2 ], weight_ );
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_quadric_fit< T, L >::add( size_t problem_, const vector_type* points_,
+    size_t n_points_, const T* weights_ )
+{
+    typedef batched_least_squares< 6, T, L > solver_type;
+    T moments[ solver_type::N_MOMENTS ];
+    for( size_t k = 0; k < solver_type::N_MOMENTS; ++k )
+        moments[ k ] = 0;
+    for( size_t p = 0; p < n_points_; ++p )
+    {
+        const T x = points_[ p ].array[ 0 ];
+        const T y = points_[ p ].array[ 1 ];
+        const T row[ 6 ] = { x * x, x * y, y * y, x, y, T( 1 ) };
+        solver_type::accumulate( moments, row, points_[ p ].array[ 2 ],
+                                 weights_ ? weights_[ p ] : T( 1 ));
+    }
+    _solver.add_moments( problem_, moments );
+}
+
+
+
+template< typename T, size_t L >
+void
+batched_quadric_fit< T, L >::compute_curvatures( const coefficients_type& coefficients_,
+    T& mean_, T& gaussian_ )
+{
+    // z_xx = 2a, z_xy = b, z_yy = 2c, z_x = d, z_y = e at the origin
+    const T* q = coefficients_.array;
+    const T zxx = T( 2 ) * q[ 0 ];
+    const T zxy = q[ 1 ];
+    const T zyy = T( 2 ) * q[ 2 ];
+    const T zx = q[ 3 ];
+    const T zy = q[ 4 ];
+    const T g = T( 1 ) + zx * zx + zy * zy;
+
+    gaussian_ = ( zxx * zyy - zxy * zxy ) / ( g * g );
+    mean_ = ( ( T( 1 ) + zy * zy ) * zxx - T( 2 ) * zx * zy * zxy + ( T( 1 ) + zx * zx ) * zyy )
+          / ( T( 2 ) * g * std::sqrt( g ));
+}
+
+} // namespace vmml
+
+#endif
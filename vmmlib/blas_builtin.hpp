@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__VMMLIB_BLAS_BUILTIN__HPP__
+#define __VMML__VMMLIB_BLAS_BUILTIN__HPP__
+
+#include <vmmlib/blas_types.hpp>
+#include <vmmlib/blas_config.hpp>
+#include <algorithm>
+#include <vector>
+#ifdef VMMLIB_USE_OPENMP
+#  include <omp.h>
+#endif
+
+/**
+ *
+ *   portable implementation of the blas routines used by vmmlib
+ *   (GEMM, SYRK, DOT, AXPY) for builds without a blas library.
+ *
+ *   blas_includes.hpp selects it when VMMLIB_USE_BLAS is not defined; it
+ *   then also provides the cblas enums and cblas_* entry points, so the
+ *   blas wrappers (blas_dgemm, blas_dot, blas_daxpy) work unchanged.
+ *   the templates in vmml::blas::builtin and cblas_builtin_gemm/syrk are
+ *   always available, so the backend can also be switched at runtime
+ *   (blas_config.hpp).
+ *
+ *   GEMM follows the usual blocking scheme (Goto & van de Geijn, 2008):
+ *   KC x NC panels of op(B) and MC x KC blocks of op(A) are packed into
+ *   contiguous buffers (which also resolves the transposes), and an
+ *   MR x NR register-blocked micro-kernel with fixed trip counts, written
+ *   for the compiler's auto-vectorizer, updates C. the MC blocks of a
+ *   panel are distributed over config::get_call_threads() OpenMP threads.
+ *
+ **
+ */
+
+#ifndef VMMLIB_USE_BLAS
+
+enum CBLAS_ORDER { CblasRowMajor = 101, CblasColMajor = 102 };
+enum CBLAS_TRANSPOSE { CblasNoTrans = 111, CblasTrans = 112, CblasConjTrans = 113 };
+enum CBLAS_UPLO { CblasUpper = 121, CblasLower = 122 };
+
+#endif
+
+namespace vmml
+{
+namespace blas
+{
+namespace builtin
+{
+    //blocking parameters
+    static const blas_int GEMM_MR = 8;
+    static const blas_int GEMM_NR = 4;
+    static const blas_int GEMM_KC = 256;
+    static const blas_int GEMM_MC = 128;
+    static const blas_int GEMM_NC = 2048;
+    static const blas_int SYRK_BLOCK = 64;
+
+    //packs the mc x kc block of op(A) starting at (i0, p0) into row panels of GEMM_MR
+    template< typename float_t >
+    inline void
+    pack_a( bool trans_, const float_t* a_, blas_int lda_, blas_int i0_, blas_int p0_,
+            blas_int mc_, blas_int kc_, float_t* packed_ )
+    {
+        for ( blas_int ir = 0; ir < mc_; ir += GEMM_MR )
+        {
+            const blas_int mr = (std::min)( GEMM_MR, mc_ - ir );
+            for ( blas_int p = 0; p < kc_; ++p )
+            {
+                for ( blas_int i = 0; i < mr; ++i )
+                {
+                    const blas_int row = i0_ + ir + i;
+                    const blas_int col = p0_ + p;
+                    packed_[ i ] = trans_ ? a_[ col + row * lda_ ] : a_[ row + col * lda_ ];
+                }
+                for ( blas_int i = mr; i < GEMM_MR; ++i )
+                {
+                    packed_[ i ] = 0;
+                }
+                packed_ += GEMM_MR;
+            }
+        }
+    }
+
+    //packs the kc x nc panel of op(B) starting at (p0, j0) into column panels of GEMM_NR
+    template< typename float_t >
+    inline void
+    pack_b( bool trans_, const float_t* b_, blas_int ldb_, blas_int p0_, blas_int j0_,
+            blas_int kc_, blas_int nc_, float_t* packed_ )
+    {
+        for ( blas_int jr = 0; jr < nc_; jr += GEMM_NR )
+        {
+            const blas_int nr = (std::min)( GEMM_NR, nc_ - jr );
+            for ( blas_int p = 0; p < kc_; ++p )
+            {
+                for ( blas_int j = 0; j < nr; ++j )
+                {
+                    const blas_int row = p0_ + p;
+                    const blas_int col = j0_ + jr + j;
+                    packed_[ j ] = trans_ ? b_[ col + row * ldb_ ] : b_[ row + col * ldb_ ];
+                }
+                for ( blas_int j = nr; j < GEMM_NR; ++j )
+                {
+                    packed_[ j ] = 0;
+                }
+                packed_ += GEMM_NR;
+            }
+        }
+    }
+
+    //C(mr x nr) += alpha * A_panel * B_panel
+    template< typename float_t >
+    inline void
+    micro_kernel( blas_int kc_, float_t alpha_, const float_t* a_, const float_t* b_,
+                  float_t* c_, blas_int ldc_, blas_int mr_, blas_int nr_ )
+    {
+        float_t acc[ GEMM_MR * GEMM_NR ];
+        for ( blas_int i = 0; i < GEMM_MR * GEMM_NR; ++i )
+        {
+            acc[ i ] = 0;
+        }
+        for ( blas_int p = 0; p < kc_; ++p )
+        {
+            for ( blas_int j = 0; j < GEMM_NR; ++j )
+            {
+                const float_t b = b_[ j ];
+                for ( blas_int i = 0; i < GEMM_MR; ++i )
+                {
+                    acc[ j * GEMM_MR + i ] += a_[ i ] * b;
+                }
+            }
+            a_ += GEMM_MR;
+            b_ += GEMM_NR;
+        }
+        for ( blas_int j = 0; j < nr_; ++j )
+        {
+            float_t* c = c_ + j * ldc_;
+            for ( blas_int i = 0; i < mr_; ++i )
+            {
+                c[ i ] += alpha_ * acc[ j * GEMM_MR + i ];
+            }
+        }
+    }
+
+    //C = beta * C
+    template< typename float_t >
+    inline void
+    scale( blas_int m_, blas_int n_, float_t beta_, float_t* c_, blas_int ldc_ )
+    {
+        if ( beta_ == float_t( 1 ) )
+            return;
+        for ( blas_int j = 0; j < n_; ++j )
+        {
+            float_t* c = c_ + j * ldc_;
+            for ( blas_int i = 0; i < m_; ++i )
+            {
+                //beta == 0 overwrites C, as in the reference blas
+                c[ i ] = ( beta_ == float_t( 0 ) ) ? float_t( 0 ) : beta_ * c[ i ];
+            }
+        }
+    }
+
+    //column-major C = alpha * op(A) * op(B) + beta * C
+    template< typename float_t >
+    inline void
+    gemm( bool trans_a_, bool trans_b_, blas_int m_, blas_int n_, blas_int k_,
+          float_t alpha_, const float_t* a_, blas_int lda_,
+          const float_t* b_, blas_int ldb_,
+          float_t beta_, float_t* c_, blas_int ldc_ )
+    {
+        if ( m_ <= 0 || n_ <= 0 )
+            return;
+        scale( m_, n_, beta_, c_, ldc_ );
+        if ( k_ <= 0 || alpha_ == float_t( 0 ) )
+            return;
+
+        const blas_int nc_max = (std::min)( GEMM_NC, ( n_ + GEMM_NR - 1 ) / GEMM_NR * GEMM_NR );
+        const blas_int kc_max = (std::min)( GEMM_KC, k_ );
+        std::vector< float_t > packed_b( nc_max * kc_max );
+        const int n_threads = config::get().get_call_threads();
+        (void) n_threads;
+
+        for ( blas_int jc = 0; jc < n_; jc += GEMM_NC )
+        {
+            const blas_int nc = (std::min)( GEMM_NC, n_ - jc );
+            for ( blas_int pc = 0; pc < k_; pc += GEMM_KC )
+            {
+                const blas_int kc = (std::min)( GEMM_KC, k_ - pc );
+                pack_b( trans_b_, b_, ldb_, pc, jc, kc, nc, &packed_b[ 0 ] );
+
+                const blas_int n_blocks = ( m_ + GEMM_MC - 1 ) / GEMM_MC;
+#pragma omp parallel if ( n_blocks > 1 && n_threads > 1 ) num_threads( n_threads )
+                {
+                    std::vector< float_t > packed_a( GEMM_MC * kc );
+#pragma omp for schedule( dynamic )
+                    for ( blas_int block = 0; block < n_blocks; ++block )
+                    {
+                        const blas_int ic = block * GEMM_MC;
+                        const blas_int mc = (std::min)( GEMM_MC, m_ - ic );
+                        pack_a( trans_a_, a_, lda_, ic, pc, mc, kc, &packed_a[ 0 ] );
+
+                        for ( blas_int jr = 0; jr < nc; jr += GEMM_NR )
+                        {
+                            const blas_int nr = (std::min)( GEMM_NR, nc - jr );
+                            for ( blas_int ir = 0; ir < mc; ir += GEMM_MR )
+                            {
+                                const blas_int mr = (std::min)( GEMM_MR, mc - ir );
+                                micro_kernel( kc, alpha_, &packed_a[ ir * kc ], &packed_b[ jr * kc ],
+                                              c_ + ( ic + ir ) + ( jc + jr ) * ldc_, ldc_, mr, nr );
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    //column-major C = alpha * op(A) * op(A)^T + beta * C, only the upper or lower triangle of C is referenced
+    //op(A) is n x k: A if trans_ is false, A^T otherwise
+    template< typename float_t >
+    inline void
+    syrk( bool upper_, bool trans_, blas_int n_, blas_int k_,
+          float_t alpha_, const float_t* a_, blas_int lda_,
+          float_t beta_, float_t* c_, blas_int ldc_ )
+    {
+        //off-diagonal blocks go through gemm, diagonal blocks through a temporary
+        std::vector< float_t > diagonal( SYRK_BLOCK * SYRK_BLOCK );
+        for ( blas_int jb = 0; jb < n_; jb += SYRK_BLOCK )
+        {
+            const blas_int nb = (std::min)( SYRK_BLOCK, n_ - jb );
+            const float_t* a_j = trans_ ? a_ + jb * lda_ : a_ + jb;
+
+            gemm( trans_, ! trans_, nb, nb, k_, alpha_, a_j, lda_, a_j, lda_, float_t( 0 ), &diagonal[ 0 ], nb );
+            for ( blas_int j = 0; j < nb; ++j )
+            {
+                const blas_int i_begin = upper_ ? 0 : j;
+                const blas_int i_end = upper_ ? j + 1 : nb;
+                float_t* c = c_ + jb + ( jb + j ) * ldc_;
+                for ( blas_int i = i_begin; i < i_end; ++i )
+                {
+                    c[ i ] = ( beta_ == float_t( 0 ) ? float_t( 0 ) : beta_ * c[ i ] ) + diagonal[ j * nb + i ];
+                }
+            }
+
+            //rows below (lower) or above (upper) the diagonal block
+            const blas_int i0 = upper_ ? 0 : jb + nb;
+            const blas_int mb = upper_ ? jb : n_ - jb - nb;
+            if ( mb > 0 )
+            {
+                const float_t* a_i = trans_ ? a_ + i0 * lda_ : a_ + i0;
+                gemm( trans_, ! trans_, mb, nb, k_, alpha_, a_i, lda_, a_j, lda_, beta_, c_ + i0 + jb * ldc_, ldc_ );
+            }
+        }
+    }
+
+    template< typename float_t >
+    inline float_t
+    dot( blas_int n_, const float_t* x_, blas_int inc_x_, const float_t* y_, blas_int inc_y_ )
+    {
+        if ( n_ <= 0 )
+            return 0;
+        if ( inc_x_ == 1 && inc_y_ == 1 )
+        {
+            //independent partial sums, vectorizable
+            float_t sum[ 4 ] = { 0, 0, 0, 0 };
+            blas_int i = 0;
+            for ( ; i + 4 <= n_; i += 4 )
+            {
+                sum[ 0 ] += x_[ i ] * y_[ i ];
+                sum[ 1 ] += x_[ i + 1 ] * y_[ i + 1 ];
+                sum[ 2 ] += x_[ i + 2 ] * y_[ i + 2 ];
+                sum[ 3 ] += x_[ i + 3 ] * y_[ i + 3 ];
+            }
+            for ( ; i < n_; ++i )
+            {
+                sum[ 0 ] += x_[ i ] * y_[ i ];
+            }
+            return ( sum[ 0 ] + sum[ 1 ] ) + ( sum[ 2 ] + sum[ 3 ] );
+        }
+        const float_t* x = inc_x_ < 0 ? x_ - ( n_ - 1 ) * inc_x_ : x_;
+        const float_t* y = inc_y_ < 0 ? y_ - ( n_ - 1 ) * inc_y_ : y_;
+        float_t sum = 0;
+        for ( blas_int i = 0; i < n_; ++i )
+        {
+            sum += x[ i * inc_x_ ] * y[ i * inc_y_ ];
+        }
+        return sum;
+    }
+
+    template< typename float_t >
+    inline void
+    axpy( blas_int n_, float_t alpha_, const float_t* x_, blas_int inc_x_, float_t* y_, blas_int inc_y_ )
+    {
+        if ( n_ <= 0 || alpha_ == float_t( 0 ) )
+            return;
+        if ( inc_x_ == 1 && inc_y_ == 1 )
+        {
+            for ( blas_int i = 0; i < n_; ++i )
+            {
+                y_[ i ] += alpha_ * x_[ i ];
+            }
+            return;
+        }
+        const float_t* x = inc_x_ < 0 ? x_ - ( n_ - 1 ) * inc_x_ : x_;
+        float_t* y = inc_y_ < 0 ? y_ - ( n_ - 1 ) * inc_y_ : y_;
+        for ( blas_int i = 0; i < n_; ++i )
+        {
+            y[ i * inc_y_ ] += alpha_ * x[ i * inc_x_ ];
+        }
+    }
+
+} // namespace builtin
+} // namespace blas
+} // namespace vmml
+
+
+//cblas-style entry points of the builtin routines; the blas wrappers call
+//them when the builtin backend is selected (see blas_config.hpp)
+
+template< typename float_t >
+inline void
+cblas_builtin_gemm( CBLAS_ORDER order_, CBLAS_TRANSPOSE trans_a_, CBLAS_TRANSPOSE trans_b_,
+                    int m_, int n_, int k_, float_t alpha_, const float_t* a_, int lda_,
+                    const float_t* b_, int ldb_, float_t beta_, float_t* c_, int ldc_ )
+{
+    const bool trans_a = ( trans_a_ != CblasNoTrans );
+    const bool trans_b = ( trans_b_ != CblasNoTrans );
+    if ( order_ == CblasColMajor )
+    {
+        vmml::blas::builtin::gemm( trans_a, trans_b, m_, n_, k_, alpha_, a_, lda_, b_, ldb_, beta_, c_, ldc_ );
+    } else {
+        //row-major C is column-major C^T = op(B)^T * op(A)^T
+        vmml::blas::builtin::gemm( trans_b, trans_a, n_, m_, k_, alpha_, b_, ldb_, a_, lda_, beta_, c_, ldc_ );
+    }
+}
+
+template< typename float_t >
+inline void
+cblas_builtin_syrk( CBLAS_ORDER order_, CBLAS_UPLO uplo_, CBLAS_TRANSPOSE trans_,
+                    int n_, int k_, float_t alpha_, const float_t* a_, int lda_,
+                    float_t beta_, float_t* c_, int ldc_ )
+{
+    const bool upper = ( uplo_ == CblasUpper );
+    const bool trans = ( trans_ != CblasNoTrans );
+    if ( order_ == CblasColMajor )
+    {
+        vmml::blas::builtin::syrk( upper, trans, n_, k_, alpha_, a_, lda_, beta_, c_, ldc_ );
+    } else {
+        //row-major: the transposed problem with the other triangle
+        vmml::blas::builtin::syrk( ! upper, ! trans, n_, k_, alpha_, a_, lda_, beta_, c_, ldc_ );
+    }
+}
+
+
+#ifndef VMMLIB_USE_BLAS
+
+//cblas interface (subset used by vmmlib) on top of the builtin routines
+
+inline void
+cblas_sgemm( CBLAS_ORDER order_, CBLAS_TRANSPOSE trans_a_, CBLAS_TRANSPOSE trans_b_,
+             int m_, int n_, int k_, float alpha_, const float* a_, int lda_,
+             const float* b_, int ldb_, float beta_, float* c_, int ldc_ )
+{
+    cblas_builtin_gemm( order_, trans_a_, trans_b_, m_, n_, k_, alpha_, a_, lda_, b_, ldb_, beta_, c_, ldc_ );
+}
+
+inline void
+cblas_dgemm( CBLAS_ORDER order_, CBLAS_TRANSPOSE trans_a_, CBLAS_TRANSPOSE trans_b_,
+             int m_, int n_, int k_, double alpha_, const double* a_, int lda_,
+             const double* b_, int ldb_, double beta_, double* c_, int ldc_ )
+{
+    cblas_builtin_gemm( order_, trans_a_, trans_b_, m_, n_, k_, alpha_, a_, lda_, b_, ldb_, beta_, c_, ldc_ );
+}
+
+inline void
+cblas_ssyrk( CBLAS_ORDER order_, CBLAS_UPLO uplo_, CBLAS_TRANSPOSE trans_, int n_, int k_,
+             float alpha_, const float* a_, int lda_, float beta_, float* c_, int ldc_ )
+{
+    cblas_builtin_syrk( order_, uplo_, trans_, n_, k_, alpha_, a_, lda_, beta_, c_, ldc_ );
+}
+
+inline void
+cblas_dsyrk( CBLAS_ORDER order_, CBLAS_UPLO uplo_, CBLAS_TRANSPOSE trans_, int n_, int k_,
+             double alpha_, const double* a_, int lda_, double beta_, double* c_, int ldc_ )
+{
+    cblas_builtin_syrk( order_, uplo_, trans_, n_, k_, alpha_, a_, lda_, beta_, c_, ldc_ );
+}
+
+inline float
+cblas_sdot( int n_, const float* x_, int inc_x_, const float* y_, int inc_y_ )
+{
+    return vmml::blas::builtin::dot( n_, x_, inc_x_, y_, inc_y_ );
+}
+
+inline double
+cblas_ddot( int n_, const double* x_, int inc_x_, const double* y_, int inc_y_ )
+{
+    return vmml::blas::builtin::dot( n_, x_, inc_x_, y_, inc_y_ );
+}
+
+inline void
+cblas_saxpy( int n_, float alpha_, const float* x_, int inc_x_, float* y_, int inc_y_ )
+{
+    vmml::blas::builtin::axpy( n_, alpha_, x_, inc_x_, y_, inc_y_ );
+}
+
+inline void
+cblas_daxpy( int n_, double alpha_, const double* x_, int inc_x_, double* y_, int inc_y_ )
+{
+    vmml::blas::builtin::axpy( n_, alpha_, x_, inc_x_, y_, inc_y_ );
+}
+
+#endif
+
+#endif
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__VMMLIB_BLAS_CONFIG__HPP__
+#define __VMML__VMMLIB_BLAS_CONFIG__HPP__
+
+#include <vmmlib/exception.hpp>
+#include <vmmlib/vmmlib_config.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#ifdef VMMLIB_USE_BLAS
+#  ifdef __APPLE__
+#    include <Accelerate/Accelerate.h>
+#  else
+extern "C"
+{
+#    include <cblas.h>
+}
+#  endif
+#endif
+
+#ifdef VMMLIB_USE_OPENMP
+#  include <omp.h>
+#endif
+
+// the serial region depth is per thread
+#ifndef VMMLIB_THREAD_LOCAL
+#  error "blas_config needs VMMLIB_THREAD_LOCAL"
+#endif
+
+#if defined( VMMLIB_USE_BLAS ) && defined( OPENBLAS_VERSION ) && defined( __GNUC__ )
+// weak, so that linking against a libblas without them still works
+#  pragma weak openblas_set_num_threads
+#  pragma weak openblas_get_num_threads
+#  define VMMLIB_OPENBLAS_THREAD_CONTROL
+#endif
+
+/**
+ *
+ *   runtime configuration of the blas routines used by vmmlib.
+ *
+ *   - backend: the cblas library vmmlib was built against (VMMLIB_USE_BLAS)
+ *     or the portable routines of blas_builtin.hpp. blas_dgemm, blas_dot
+ *     and blas_daxpy dispatch on it for every call.
+ *   - threads per call: the number of threads one blas call may use
+ *     (0 keeps the library default). the builtin routines honor it
+ *     directly; a cblas library only through its thread control hook,
+ *     which defaults to openblas_set_num_threads for OpenBLAS and can be
+ *     set for others (e.g. mkl_set_num_threads / mkl_get_max_threads).
+ *   - serialize nested: vmmlib's own parallel loops over blas calls
+ *     (e.g. t3_ttm) open a serial_region, which switches blas to a single
+ *     thread while the loop runs. otherwise every loop thread would start
+ *     its own team of blas threads. the region is only opened when the
+ *     loop really runs on more than one thread. the builtin routines
+ *     check it per thread: blas calls of other application threads keep
+ *     their threads. the thread count of a cblas library is a process-wide
+ *     setting, it is restored when the last open region is left.
+ *
+ *   the defaults can be overridden through the environment:
+ *   VMMLIB_BLAS_BACKEND=cblas|builtin, VMMLIB_BLAS_THREADS=<n>,
+ *   VMMLIB_BLAS_SERIALIZE_NESTED=0|1 and VMMLIB_BLAS_VERBOSE=1, which
+ *   prints the effective configuration to std::cerr on first use.
+ *
+ *   the setters are meant to be called from the main thread, outside of
+ *   parallel regions.
+ *
+ **
+ */
+
+namespace vmml
+{
+namespace blas
+{
+
+enum backend_type
+{
+    BACKEND_CBLAS,
+    BACKEND_BUILTIN
+};
+
+
+class config
+{
+public:
+    typedef void (*set_threads_func)( int );
+    typedef int (*get_threads_func)();
+
+    static config& get()
+    {
+        static config instance;
+        return instance;
+    }
+
+    static bool has_cblas();
+    static const char* get_backend_name( backend_type backend_ );
+
+    backend_type get_backend() const { return _backend; }
+    void set_backend( backend_type backend_ );
+    bool use_builtin() const { return _backend == BACKEND_BUILTIN; }
+
+    int get_threads_per_call() const { return _threads_per_call; }
+    void set_threads_per_call( int threads_ );
+
+    bool get_serialize_nested() const { return _serialize_nested; }
+    void set_serialize_nested( bool serialize_ ) { _serialize_nested = serialize_; }
+
+    // hook to control the threads of the cblas library
+    void set_thread_control( set_threads_func set_threads_, get_threads_func get_threads_ );
+    bool has_thread_control() const { return _set_threads != 0; }
+
+    // threads a blas call issued from the calling thread will use
+    int get_call_threads() const;
+    // whether the calling thread has opened a serial_region
+    bool in_serial_region() const { return get_thread_serial_depth() > 0; }
+
+    void print( std::ostream& os ) const;
+
+    friend std::ostream& operator << ( std::ostream& os, const config& config_ )
+    {
+        config_.print( os );
+        return os;
+    }
+
+protected:
+    friend class serial_region;
+
+    config();
+    config( const config& );
+    config& operator=( const config& );
+
+    int get_default_threads() const;
+    bool enter_serial_region();
+    void leave_serial_region();
+
+    // whether a parallel loop started by the calling thread gets more
+    // than one thread
+    static bool is_parallel_loop();
+    // serial regions opened by the calling thread
+    static int& get_thread_serial_depth();
+
+    backend_type        _backend;
+    int                 _threads_per_call;
+    bool                _serialize_nested;
+    set_threads_func    _set_threads;
+    get_threads_func    _get_threads;
+    int                 _open_regions;      // all threads, vmmlib_blas_config lock
+    int                 _saved_threads;
+
+}; // class config
+
+
+// switches blas to a single thread while vmmlib runs its own parallel
+// loop; does nothing if the loop would run on a single thread
+class serial_region
+{
+public:
+    serial_region() : _entered( config::get().enter_serial_region() ) {}
+    ~serial_region() { if ( _entered ) config::get().leave_serial_region(); }
+
+private:
+    bool _entered;
+
+    serial_region( const serial_region& );
+    serial_region& operator=( const serial_region& );
+
+}; // class serial_region
+
+
+
+inline
+config::config()
+    : _backend( has_cblas() ? BACKEND_CBLAS : BACKEND_BUILTIN )
+    , _threads_per_call( 0 )
+    , _serialize_nested( true )
+    , _set_threads( 0 )
+    , _get_threads( 0 )
+    , _open_regions( 0 )
+    , _saved_threads( 0 )
+{
+#ifdef VMMLIB_OPENBLAS_THREAD_CONTROL
+    if ( &openblas_set_num_threads && &openblas_get_num_threads )
+    {
+        _set_threads = &openblas_set_num_threads;
+        _get_threads = &openblas_get_num_threads;
+    }
+#endif
+
+    const char* backend = getenv( "VMMLIB_BLAS_BACKEND" );
+    if ( backend && strcmp( backend, "builtin" ) == 0 )
+        _backend = BACKEND_BUILTIN;
+    else if ( backend && strcmp( backend, "cblas" ) == 0 && has_cblas() )
+        _backend = BACKEND_CBLAS;
+
+    const char* threads = getenv( "VMMLIB_BLAS_THREADS" );
+    if ( threads )
+        set_threads_per_call( atoi( threads ) );
+
+    const char* serialize = getenv( "VMMLIB_BLAS_SERIALIZE_NESTED" );
+    if ( serialize )
+        _serialize_nested = ( strcmp( serialize, "0" ) != 0 );
+
+    const char* verbose = getenv( "VMMLIB_BLAS_VERBOSE" );
+    if ( verbose && strcmp( verbose, "0" ) != 0 )
+        std::cerr << *this << std::endl;
+}
+
+
+inline bool
+config::has_cblas()
+{
+#ifdef VMMLIB_USE_BLAS
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+inline const char*
+config::get_backend_name( backend_type backend_ )
+{
+    if ( backend_ == BACKEND_BUILTIN )
+        return "builtin";
+#if defined( OPENBLAS_VERSION )
+    return "cblas (OpenBLAS)";
+#elif defined( __APPLE__ )
+    return "cblas (Accelerate)";
+#else
+    return "cblas";
+#endif
+}
+
+
+inline void
+config::set_backend( backend_type backend_ )
+{
+    if ( backend_ == BACKEND_CBLAS && ! has_cblas() )
+    {
+        VMMLIB_ERROR( "vmmlib was built without a cblas library (VMMLIB_USE_BLAS)", VMMLIB_HERE );
+    }
+    _backend = backend_;
+}
+
+
+inline void
+config::set_threads_per_call( int threads_ )
+{
+    _threads_per_call = threads_ > 0 ? threads_ : 0;
+#pragma omp critical( vmmlib_blas_config )
+    {
+        if ( _set_threads && _threads_per_call > 0 && _open_regions == 0 )
+            _set_threads( _threads_per_call );
+    }
+}
+
+
+inline void
+config::set_thread_control( set_threads_func set_threads_, get_threads_func get_threads_ )
+{
+#pragma omp critical( vmmlib_blas_config )
+    {
+        _set_threads = set_threads_;
+        _get_threads = get_threads_;
+        if ( _set_threads && _threads_per_call > 0 && _open_regions == 0 )
+            _set_threads( _threads_per_call );
+    }
+}
+
+
+inline int
+config::get_default_threads() const
+{
+#ifdef VMMLIB_USE_OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+
+inline int
+config::get_call_threads() const
+{
+    if ( _serialize_nested && get_thread_serial_depth() > 0 )
+        return 1;
+#ifdef VMMLIB_USE_OPENMP
+    if ( _serialize_nested && omp_in_parallel() )
+        return 1;
+#endif
+    return _threads_per_call > 0 ? _threads_per_call : get_default_threads();
+}
+
+
+inline bool
+config::is_parallel_loop()
+{
+#ifdef VMMLIB_USE_OPENMP
+    return omp_get_max_threads() > 1
+        && omp_get_active_level() < omp_get_max_active_levels();
+#else
+    return false;
+#endif
+}
+
+
+inline int&
+config::get_thread_serial_depth()
+{
+    static VMMLIB_THREAD_LOCAL int depth = 0;
+    return depth;
+}
+
+
+inline bool
+config::enter_serial_region()
+{
+    if ( ! _serialize_nested || ! is_parallel_loop() )
+        return false;
+    ++get_thread_serial_depth();
+#pragma omp critical( vmmlib_blas_config )
+    {
+        if ( _open_regions++ == 0 && _set_threads )
+        {
+            _saved_threads = _get_threads ? _get_threads() : _threads_per_call;
+            _set_threads( 1 );
+        }
+    }
+    return true;
+}
+
+
+inline void
+config::leave_serial_region()
+{
+    --get_thread_serial_depth();
+#pragma omp critical( vmmlib_blas_config )
+    {
+        if ( --_open_regions == 0 && _set_threads )
+        {
+            _set_threads( _saved_threads > 0 ? _saved_threads : get_default_threads() );
+        }
+    }
+}
+
+
+inline void
+config::print( std::ostream& os ) const
+{
+    os << "vmmlib blas backend: " << get_backend_name( _backend ) << std::endl;
+    os << "  threads per call: ";
+    if ( _threads_per_call > 0 )
+        os << _threads_per_call;
+    else if ( _backend == BACKEND_CBLAS && _get_threads )
+        os << _get_threads() << " (library default)";
+    else
+        os << get_default_threads() << " (default)";
+    if ( _backend == BACKEND_CBLAS && ! _set_threads )
+        os << ", no thread control for this library";
+    os << std::endl;
+    os << "  blas calls in vmmlib parallel loops: "
+       << ( _serialize_nested ? "single-threaded" : "unchanged" ) << std::endl;
+#ifdef VMMLIB_USE_OPENMP
+    os << "  openmp threads: " << omp_get_max_threads() << std::endl;
+#else
+    os << "  openmp: disabled" << std::endl;
+#endif
+}
+
+} // namespace blas
+} // namespace vmml
+
+#endif
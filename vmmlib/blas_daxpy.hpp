@@ -121,6 +121,11 @@ namespace vmml
 		daxpy_call( daxpy_params< float >& p )
 		{
 			//std::cout << "calling blas saxpy (single precision) " << std::endl;
+			if ( config::get().use_builtin() )
+			{
+				builtin::axpy( p.n, p.alpha, p.x, p.inc_x, p.y, p.inc_y );
+				return;
+			}
 			cblas_saxpy(
 							 p.n,
 							 p.alpha,
@@ -136,6 +141,11 @@ namespace vmml
 		daxpy_call( daxpy_params< double >& p )
 		{
 			//std::cout << "calling blas daxpy (double precision) " << std::endl;
+			if ( config::get().use_builtin() )
+			{
+				builtin::axpy( p.n, p.alpha, p.x, p.inc_x, p.y, p.inc_y );
+				return;
+			}
 			cblas_daxpy(
 							  p.n,
 							  p.alpha,
@@ -220,69 +230,103 @@ namespace vmml
 										  const matrix< K, N, float_t >& right_m_,
 										  matrix< M, N, float_t >& res_m_ )
 	{
-		for ( int n = 0; n < (int)N; ++n )
+		res_m_.zero();
+
+		// every column of the result is owned by exactly one iteration,
+		// so the daxpy's accumulate in place without races or temporaries
+#ifdef VMMLIB_USE_OPENMP
+		blas::serial_region single_threaded_blas;
+#endif
+#pragma omp parallel for
+		for ( long n = 0; n < (long)N; ++n )
 		{
-			vector_t* final_col = new vector_t;
-			final_col->set(0);
+			blas::daxpy_params< float_t > col_p = p;
+			col_p.y = res_m_.array + n * M;
 
-			for ( int k = 0; k < (int)K; ++k )
+			for ( size_t k = 0; k < K; ++k )
 			{
-				vector_t* in_col = new vector_t;
-				vector_t* out_col = new vector_t;
-				float_t a_val = right_m_.at( k, n );
-				left_m_.get_column( k, *in_col );
-
-				compute( a_val, *in_col, *out_col );
-
-				*final_col += *out_col;
-
-				delete in_col;
-				delete out_col;
+				col_p.alpha = right_m_.at( k, n );
+				// blas does not modify x
+				col_p.x = const_cast< float_t* >( left_m_.array + k * M );
+				blas::daxpy_call< float_t >( col_p );
 			}
-
-			res_m_.set_column( n, *final_col );
-
-			delete final_col;
 		}
 
-
 		return true;
 	}
 
 
+	/*
+	 *  rank-k update res = left * left^T. the lower triangle is accumulated
+	 *  column by column from blocks of COV_BLOCK_K columns of left_m_, which
+	 *  stay in cache while they are reused for a panel of COV_BLOCK_N result
+	 *  columns. the panels are disjoint, so each thread owns its part of the
+	 *  result; the upper triangle is mirrored at the end.
+	 */
 	template< size_t M, typename float_t >
 	template< size_t K >
 	bool
 	blas_daxpy< M, float_t >::compute_mmm(  const matrix< M, K, float_t >& left_m_,
 										  matrix< M, M, float_t >& res_m_ )
 	{
-#pragma omp parallel for
-		for ( int n = 0; n < (int)M; ++n )
-		{
-			vector_t* final_col = new vector_t;
-			final_col->set(0);
+		const size_t COV_BLOCK_K = 64;
+		const size_t COV_BLOCK_N = 16;
+		const long num_panels = (long)( ( M + COV_BLOCK_N - 1 ) / COV_BLOCK_N );
 
-#pragma omp parallel for
-			for ( int k = 0; k < (int)K; ++k )
-			{
-				vector_t* in_col = new vector_t;
-				vector_t* out_col = new vector_t;
-				float_t a_val = left_m_.at( n,k ); //reversed (k,n), because take value from transposed matrix left_m_
-				left_m_.get_column( k, *in_col );
+		res_m_.zero();
 
-				compute( a_val, *in_col, *out_col );
-
-				*final_col += *out_col;
+		// panels to the left hold longer columns, hence the dynamic schedule
+#pragma omp parallel for schedule(dynamic)
+		for ( long panel = 0; panel < num_panels; ++panel )
+		{
+			const size_t n_begin = panel * COV_BLOCK_N;
+			const size_t n_end = n_begin + COV_BLOCK_N < M ? n_begin + COV_BLOCK_N : M;
 
-				delete in_col;
-				delete out_col;
+			for ( size_t k_begin = 0; k_begin < K; k_begin += COV_BLOCK_K )
+			{
+				const size_t k_end = k_begin + COV_BLOCK_K < K ? k_begin + COV_BLOCK_K : K;
+
+				for ( size_t n = n_begin; n < n_end; ++n )
+				{
+					float_t* out_col = res_m_.array + n * M;
+					size_t k = k_begin;
+					// four columns per sweep, so out_col is loaded and stored once for four updates
+					for ( ; k + 4 <= k_end; k += 4 )
+					{
+						const float_t* in_col0 = left_m_.array + k * M;
+						const float_t* in_col1 = in_col0 + M;
+						const float_t* in_col2 = in_col1 + M;
+						const float_t* in_col3 = in_col2 + M;
+						const float_t a0 = in_col0[ n ];
+						const float_t a1 = in_col1[ n ];
+						const float_t a2 = in_col2[ n ];
+						const float_t a3 = in_col3[ n ];
+						for ( size_t i = n; i < M; ++i )
+						{
+							out_col[ i ] += a0 * in_col0[ i ] + a1 * in_col1[ i ]
+								+ a2 * in_col2[ i ] + a3 * in_col3[ i ];
+						}
+					}
+					for ( ; k < k_end; ++k )
+					{
+						const float_t* in_col = left_m_.array + k * M;
+						const float_t a_val = in_col[ n ];
+						for ( size_t i = n; i < M; ++i )
+						{
+							out_col[ i ] += a_val * in_col[ i ];
+						}
+					}
+				}
 			}
-
-			res_m_.set_column( n, *final_col );
-
-			delete final_col;
 		}
 
+		for ( size_t n = 0; n < M; ++n )
+		{
+			for ( size_t i = n + 1; i < M; ++i )
+			{
+				res_m_.array[ i * M + n ] = res_m_.array[ n * M + i ];
+			}
+		}
 
 		return true;
 	}
@@ -85,7 +85,7 @@ namespace vmml
         /* Subroutine */
         void cblas_dgemm(enum CBLAS_ORDER Order, enum CBLAS_TRANSPOSE TransA, enum CBLAS_TRANSPOSE TransB,
                          blasint M, blasint N, blasint K,
-                         double alpha, double *A, blasint lda, double *B, blasint ldb, double beta, double *C, blasint ldc);
+                         double alpha, const double *A, blasint lda, const double *B, blasint ldb, double beta, double *C, blasint ldc);
 
 #endif
 
@@ -99,9 +99,9 @@ namespace vmml
             blas_int        n;
             blas_int        k;
             float_t         alpha;
-            float_t*        a;
+            const float_t*  a;
             blas_int        lda; //leading dimension of input array matrix left
-            float_t*        b;
+            const float_t*  b;
             blas_int        ldb; //leading dimension of input array matrix right
             float_t         beta;
             float_t*        c;
@@ -146,6 +146,12 @@ namespace vmml
         dgemm_call( dgemm_params< float >& p )
         {
             //std::cout << "calling blas sgemm (single precision) " << std::endl;
+            if ( config::get().use_builtin() )
+            {
+                cblas_builtin_gemm( p.order, p.trans_a, p.trans_b, p.m, p.n, p.k,
+                    p.alpha, p.a, p.lda, p.b, p.ldb, p.beta, p.c, p.ldc );
+                return;
+            }
             cblas_sgemm(
                     p.order,
                     p.trans_a,
@@ -170,6 +176,12 @@ namespace vmml
         dgemm_call( dgemm_params< double >& p )
         {
             //std::cout << "calling blas dgemm (double precision) " << std::endl;
+            if ( config::get().use_builtin() )
+            {
+                cblas_builtin_gemm( p.order, p.trans_a, p.trans_b, p.m, p.n, p.k,
+                    p.alpha, p.a, p.lda, p.b, p.ldb, p.beta, p.c, p.ldc );
+                return;
+            }
             cblas_dgemm(
                    p.order,
                    p.trans_a,
@@ -228,6 +240,9 @@ namespace vmml
 
         const blas::dgemm_params< float_t >& get_params(){ return p; };
 
+    protected:
+        // runs dgemm on p; C_ may alias the inputs
+        void call( matrix_out_t& C_ );
 
     }; // struct blas_dgemm
 
@@ -253,6 +268,33 @@ namespace vmml
 
 
 
+    template< size_t M, size_t K, size_t N, typename float_t >
+    void
+    blas_dgemm< M, K, N, float_t >::call( matrix_out_t& C_ )
+    {
+        // op( A ) spans M*K, op( B ) K*N values
+        const float_t* c_begin = C_.array;
+        const float_t* c_end = C_.array + M * N;
+        const bool aliased = ( p.a < c_end && c_begin < p.a + M * K )
+                          || ( p.b < c_end && c_begin < p.b + K * N );
+        if ( ! aliased )
+        {
+            blas::dgemm_call< float_t >( p );
+            return;
+        }
+
+        // output overlaps an input: compute into a temporary that starts
+        // as a copy of C, which dgemm reads for beta != 0
+        matrix_out_t* CC = new matrix_out_t( C_ );
+        p.c = CC->array;
+        blas::dgemm_call< float_t >( p );
+        C_ = *CC;
+        p.c = C_.array;
+        delete CC;
+    }
+
+
+
     template< size_t M, size_t K, size_t N, typename float_t >
     bool
     blas_dgemm< M, K, N, float_t >::compute(
@@ -261,22 +303,15 @@ namespace vmml
                                                 matrix_out_t& C_
                                             )
     {
-        // blas needs non-const data
-        matrix_left_t* AA = new matrix_left_t( A_ );
-        matrix_right_t* BB = new matrix_right_t( B_ );
-        C_.zero();
-
-        p.a         = AA->array;
-        p.b         = BB->array;
+        // cblas takes const input pointers, the inputs are passed through
+        p.a         = A_.array;
+        p.b         = B_.array;
         p.c         = C_.array;
 
-        blas::dgemm_call< float_t >( p );
+        call( C_ );
 
         //std::cout << p << std::endl; //debug
 
-        delete AA;
-        delete BB;
-
         return true;
     }
 
@@ -289,21 +324,15 @@ namespace vmml
                                             matrix_out_t& C_
                                             )
     {
-        // blas needs non-const data
-        tensor3< M, I2, I3, float_t > AA( A_ );
-        matrix_right_t* BB = new matrix_right_t( B_ );
-        C_.zero();
-
-        p.a         = AA.get_array_ptr();
-        p.b         = BB->array;
+        // cblas takes const input pointers, the inputs are passed through
+        p.a         = A_.get_array_ptr();
+        p.b         = B_.array;
         p.c         = C_.array;
 
-        blas::dgemm_call< float_t >( p );
+        call( C_ );
 
         //std::cout << p << std::endl; //debug
 
-        delete BB;
-
         return true;
     }
 
@@ -312,22 +341,17 @@ namespace vmml
     bool
     blas_dgemm< M, K, N, float_t >::compute( const matrix_left_t& A_, matrix_out_t& C_ )
     {
-        // blas needs non-const data
-        matrix_left_t* AA = new matrix_left_t( A_ );
-        C_.zero();
-
+        // cblas takes const input pointers, the inputs are passed through
         p.trans_b   = CblasTrans;
-        p.a         = AA->array;
-        p.b         = AA->array;
+        p.a         = A_.array;
+        p.b         = A_.array;
         p.ldb       = N;
         p.c         = C_.array;
 
-        blas::dgemm_call< float_t >( p );
+        call( C_ );
 
         //std::cout << p << std::endl; //debug
 
-        delete AA;
-
         return true;
     }
 
@@ -336,17 +360,14 @@ namespace vmml
     bool
     blas_dgemm< M, K, N, float_t >::compute( const tensor3< M, I2, I3, float_t >& A_, matrix_out_t& C_ )
     {
-        // blas needs non-const data
-        tensor3< M, I2, I3, float_t > AA( A_ ) ;
-        C_.zero();
-
+        // cblas takes const input pointers, the inputs are passed through
         p.trans_b   = CblasTrans;
-        p.a         = AA.get_array_ptr();
-        p.b         = AA.get_array_ptr();
+        p.a         = A_.get_array_ptr();
+        p.b         = A_.get_array_ptr();
         p.ldb       = N;
         p.c         = C_.array;
 
-        blas::dgemm_call< float_t >( p );
+        call( C_ );
 
         //std::cout << p << std::endl; //debug
 
@@ -357,22 +378,17 @@ namespace vmml
     bool
     blas_dgemm< M, K, N, float_t >::compute_t( const matrix_right_t& B_, matrix_out_t& C_ )
     {
-        // blas needs non-const data
-        matrix_right_t* BB = new matrix_right_t( B_ );
-        C_.zero();
-
+        // cblas takes const input pointers, the inputs are passed through
         p.trans_a   = CblasTrans;
-        p.a         = BB->array;
-        p.b         = BB->array;
+        p.a         = B_.array;
+        p.b         = B_.array;
         p.lda       = K;
         p.c         = C_.array;
 
-        blas::dgemm_call< float_t >( p );
+        call( C_ );
 
         //std::cout << p << std::endl; //debug
 
-        delete BB;
-
         return true;
     }
 
@@ -383,24 +399,17 @@ namespace vmml
                                             const matrix_right_t_t& Bt_,
                                             matrix_out_t& C_ )
     {
-        // blas needs non-const data
-        matrix_left_t* AA = new matrix_left_t( A_ );
-        matrix_right_t_t* BB = new matrix_right_t_t( Bt_ );
-        C_.zero();
-
+        // cblas takes const input pointers, the inputs are passed through
         p.trans_b   = CblasTrans;
-        p.a         = AA->array;
-        p.b         = BB->array;
+        p.a         = A_.array;
+        p.b         = Bt_.array;
         p.c         = C_.array;
         p.ldb       = N;
 
-        blas::dgemm_call< float_t >( p );
+        call( C_ );
 
         //std::cout << p << std::endl; //debug
 
-        delete AA;
-        delete BB;
-
         return true;
     }
 
@@ -411,26 +420,19 @@ namespace vmml
                                                const matrix_right_t_t& Bt_,
                                                matrix_out_t& C_ )
     {
-        // blas needs non-const data
-        matrix_left_t_t* AA = new matrix_left_t_t( At_ );
-        matrix_right_t_t* BB = new matrix_right_t_t( Bt_ );
-        C_.zero();
-
+        // cblas takes const input pointers, the inputs are passed through
         p.trans_a   = CblasTrans;
         p.trans_b   = CblasTrans;
-        p.a         = AA->array;
-        p.b         = BB->array;
+        p.a         = At_.array;
+        p.b         = Bt_.array;
         p.c         = C_.array;
         p.ldb       = N;
         p.lda       = K;
 
-        blas::dgemm_call< float_t >( p );
+        call( C_ );
 
         //std::cout << p << std::endl; //debug
 
-        delete AA;
-        delete BB;
-
         return true;
     }
 
@@ -441,24 +443,17 @@ namespace vmml
                                               const vector_right_t& B_,
                                               matrix_out_t& C_ )
     {
-        // blas needs non-const data
-        vector_left_t* AA = new vector_left_t( A_ );
-        vector_right_t* BB = new vector_right_t( B_ );
-        C_.zero();
-
+        // cblas takes const input pointers, the inputs are passed through
         p.trans_a   = CblasTrans;
-        p.a         = AA->array;
-        p.b         = BB->array;
+        p.a         = A_.array;
+        p.b         = B_.array;
         p.c         = C_.array;
         p.lda       = K;
 
-        blas::dgemm_call< float_t >( p );
+        call( C_ );
 
         //std::cout << p << std::endl; //debug
 
-        delete AA;
-        delete BB;
-
         return true;
     }
 
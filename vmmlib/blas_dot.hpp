@@ -103,6 +103,9 @@ namespace blas
     dot_call( dot_params< float >& p )
     {
         //std::cout << "calling blas sdot (single precision) " << std::endl;
+        if ( config::get().use_builtin() )
+            return builtin::dot( p.n, p.x, p.inc_x, p.y, p.inc_y );
+
         float vvi = cblas_sdot(
                          p.n,
                          p.x,
@@ -118,6 +121,9 @@ namespace blas
     dot_call( dot_params< double >& p )
     {
         //std::cout << "calling blas ddot (double precision) " << std::endl;
+        if ( config::get().use_builtin() )
+            return builtin::dot( p.n, p.x, p.inc_x, p.y, p.inc_y );
+
         double vvi = cblas_ddot(
                           p.n,
                           p.x,
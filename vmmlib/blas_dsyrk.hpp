@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__VMMLIB_BLAS_DSYRK__HPP__
+#define __VMML__VMMLIB_BLAS_DSYRK__HPP__
+
+
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/packed_matrix.hpp>
+#include <vmmlib/blas_dgemm.hpp>
+#include <vmmlib/exception.hpp>
+#include <vmmlib/blas_includes.hpp>
+#include <vmmlib/blas_types.hpp>
+
+/**
+ *
+ *   a wrapper for blas's DSYRK routine.
+
+ SUBROUTINE DSYRK(UPLO,TRANS,N,K,ALPHA,A,LDA,BETA,C,LDC)
+ *     .. Scalar Arguments ..
+ DOUBLE PRECISION ALPHA,BETA
+ INTEGER K,LDA,LDC,N
+ CHARACTER TRANS,UPLO
+ *     ..
+ *     .. Array Arguments ..
+ DOUBLE PRECISION A(LDA,*),C(LDC,*)
+ *     ..
+ *
+ *  Purpose
+ *  =======
+ *
+ *  DSYRK  performs one of the symmetric rank k operations
+ *
+ *     C := alpha*A*A**T + beta*C,
+ *
+ *  or
+ *
+ *     C := alpha*A**T*A + beta*C,
+ *
+ *  where  alpha and beta  are scalars, C is an  n by n  symmetric matrix
+ *  and  A  is an  n by k  matrix in the first case and a  k by n  matrix
+ *  in the second case. only one triangle of C is referenced, i.e. half
+ *  the work of the equivalent dgemm.
+ *
+ *   dense outputs are written in place: syrk fills the lower triangle,
+ *   which is then mirrored. blas has no packed syrk, so a symmetric_matrix
+ *   output (see packed_matrix.hpp) goes through a dense N x N workspace,
+ *   allocated on first use, and is packed afterwards. below order
+ *   SYRK_GEMM_THRESHOLD the call overhead of syrk outweighs the saved
+ *   flops and the full product is computed with gemm instead.
+ *
+ *   more information in: http://www.netlib.org/blas/dsyrk.f
+ **
+ */
+
+
+namespace vmml
+{
+
+    namespace blas
+    {
+
+
+#if 0
+        /* Subroutine */
+        void cblas_dsyrk(enum CBLAS_ORDER Order, enum CBLAS_UPLO Uplo, enum CBLAS_TRANSPOSE Trans,
+                         blasint N, blasint K,
+                         double alpha, const double *A, blasint lda, double beta, double *C, blasint ldc);
+
+#endif
+
+        template< typename float_t >
+        struct dsyrk_params
+        {
+            CBLAS_ORDER     order;
+            CBLAS_UPLO      uplo;
+            CBLAS_TRANSPOSE trans;
+            blas_int        n;
+            blas_int        k;
+            float_t         alpha;
+            const float_t*  a;
+            blas_int        lda; //leading dimension of input array
+            float_t         beta;
+            float_t*        c;
+            blas_int        ldc; //leading dimension of output array
+
+            friend std::ostream& operator << ( std::ostream& os,
+                                              const dsyrk_params< float_t >& p )
+            {
+                os
+                << " (1)\torder "     << p.order << std::endl
+                << " (2)\tuplo "      << p.uplo << std::endl
+                << " (3)\ttrans "     << p.trans << std::endl
+                << " (4)\tn "         << p.n << std::endl
+                << " (5)\tk "         << p.k << std::endl
+                << " (6)\talpha "     << p.alpha << std::endl
+                << " (7)\ta "         << p.a << std::endl
+                << " (8)\tlda "       << p.lda << std::endl
+                << " (9)\tbeta "      << p.beta << std::endl
+                << " (10)\tc "        << p.c << std::endl
+                << " (11)\tldc "      << p.ldc << std::endl
+                << std::endl;
+                return os;
+            }
+
+        };
+
+
+
+        template< typename float_t >
+        inline void
+        dsyrk_call( dsyrk_params< float_t >& )
+        {
+            VMMLIB_ERROR( "not implemented for this type.", VMMLIB_HERE );
+        }
+
+
+        template<>
+        inline void
+        dsyrk_call( dsyrk_params< float >& p )
+        {
+            //std::cout << "calling blas ssyrk (single precision) " << std::endl;
+            if ( config::get().use_builtin() )
+            {
+                cblas_builtin_syrk( p.order, p.uplo, p.trans, p.n, p.k,
+                    p.alpha, p.a, p.lda, p.beta, p.c, p.ldc );
+                return;
+            }
+            cblas_ssyrk(
+                    p.order,
+                    p.uplo,
+                    p.trans,
+                    p.n,
+                    p.k,
+                    p.alpha,
+                    p.a,
+                    p.lda,
+                    p.beta,
+                    p.c,
+                    p.ldc
+                    );
+        }
+
+        template<>
+        inline void
+        dsyrk_call( dsyrk_params< double >& p )
+        {
+            //std::cout << "calling blas dsyrk (double precision) " << std::endl;
+            if ( config::get().use_builtin() )
+            {
+                cblas_builtin_syrk( p.order, p.uplo, p.trans, p.n, p.k,
+                    p.alpha, p.a, p.lda, p.beta, p.c, p.ldc );
+                return;
+            }
+            cblas_dsyrk(
+                    p.order,
+                    p.uplo,
+                    p.trans,
+                    p.n,
+                    p.k,
+                    p.alpha,
+                    p.a,
+                    p.lda,
+                    p.beta,
+                    p.c,
+                    p.ldc
+                    );
+        }
+
+    } // namespace blas
+
+
+
+    // order from which dsyrk beats the full dgemm (openblas, 256 x N inputs)
+    static const size_t SYRK_GEMM_THRESHOLD = 48;
+
+    template< size_t N, size_t K, typename float_t >
+    struct blas_dsyrk
+    {
+
+        typedef matrix< N, K, float_t > matrix_t;
+        typedef matrix< K, N, float_t > matrix_t_t;
+        typedef symmetric_matrix< N, float_t > matrix_out_t;
+        typedef matrix< N, N, float_t > matrix_dense_out_t;
+
+        // packed outputs allocate the N x N workspace once; keep the object
+        // around to reuse it for many products.
+        blas_dsyrk();
+        ~blas_dsyrk();
+
+        // C = A * A^T
+        bool compute( const matrix_t& A_, matrix_out_t& C_ );
+        bool compute( const matrix_t& A_, matrix_dense_out_t& C_ );
+
+        // C = A^T * A
+        bool compute_t( const matrix_t_t& A_, matrix_out_t& C_ );
+        bool compute_t( const matrix_t_t& A_, matrix_dense_out_t& C_ );
+
+        blas::dsyrk_params< float_t > p;
+
+        const blas::dsyrk_params< float_t >& get_params(){ return p; };
+
+    protected:
+        // runs dsyrk on p, the lower triangle of p.c is written
+        void call();
+
+        // packs the lower triangle of the workspace into C_
+        void call( matrix_out_t& C_ );
+
+        // mirrors the lower triangle of C_
+        void call( matrix_dense_out_t& C_ );
+
+        float_t*    _workspace;
+
+    private:
+        // owns the workspace
+        blas_dsyrk( const blas_dsyrk& );
+        blas_dsyrk& operator=( const blas_dsyrk& );
+
+    }; // struct blas_dsyrk
+
+
+    template< size_t N, size_t K, typename float_t >
+    blas_dsyrk< N, K, float_t >::blas_dsyrk()
+        : _workspace( 0 )
+    {
+        p.order      = CblasColMajor;
+        p.uplo       = CblasLower;
+        p.trans      = CblasNoTrans;
+        p.n          = N;
+        p.k          = K;
+        p.alpha      = 1;
+        p.a          = 0;
+        p.lda        = N;
+        p.beta       = 0;
+        p.c          = 0;
+        p.ldc        = N;
+    }
+
+
+    template< size_t N, size_t K, typename float_t >
+    blas_dsyrk< N, K, float_t >::~blas_dsyrk()
+    {
+        delete[] _workspace;
+    }
+
+
+    template< size_t N, size_t K, typename float_t >
+    void
+    blas_dsyrk< N, K, float_t >::call()
+    {
+        // with beta == 0, dsyrk overwrites C without reading it
+        if ( N >= SYRK_GEMM_THRESHOLD )
+        {
+            blas::dsyrk_call< float_t >( p );
+        } else {
+            blas::dgemm_params< float_t > g;
+            g.order     = p.order;
+            g.trans_a   = p.trans;
+            g.trans_b   = p.trans == CblasNoTrans ? CblasTrans : CblasNoTrans;
+            g.m         = p.n;
+            g.n         = p.n;
+            g.k         = p.k;
+            g.alpha     = p.alpha;
+            g.a         = p.a;
+            g.lda       = p.lda;
+            g.b         = p.a;
+            g.ldb       = p.lda;
+            g.beta      = p.beta;
+            g.c         = p.c;
+            g.ldc       = p.ldc;
+            blas::dgemm_call< float_t >( g );
+        }
+    }
+
+
+    template< size_t N, size_t K, typename float_t >
+    void
+    blas_dsyrk< N, K, float_t >::call( matrix_out_t& C_ )
+    {
+        if ( _workspace == 0 )
+            _workspace = new float_t[ N * N ];
+        p.c = _workspace;
+        call();
+
+        float_t* c = C_.array;
+        for( size_t col = 0; col < N; ++col )
+        {
+            const float_t* w = _workspace + col * N;
+            for( size_t row = col; row < N; ++row )
+                *c++ = w[ row ];
+        }
+    }
+
+
+    template< size_t N, size_t K, typename float_t >
+    void
+    blas_dsyrk< N, K, float_t >::call( matrix_dense_out_t& C_ )
+    {
+        p.c = C_.array;
+        call();
+
+        // below SYRK_GEMM_THRESHOLD gemm has written both triangles
+        if ( N < SYRK_GEMM_THRESHOLD )
+            return;
+        for( size_t col = 0; col < N; ++col )
+            for( size_t row = col + 1; row < N; ++row )
+                C_( col, row ) = C_( row, col );
+    }
+
+
+    template< size_t N, size_t K, typename float_t >
+    bool
+    blas_dsyrk< N, K, float_t >::compute( const matrix_t& A_, matrix_out_t& C_ )
+    {
+        // cblas takes const input pointers, the input is passed through
+        p.trans     = CblasNoTrans;
+        p.a         = A_.array;
+        p.lda       = N;
+
+        call( C_ );
+
+        //std::cout << p << std::endl; //debug
+
+        return true;
+    }
+
+
+    template< size_t N, size_t K, typename float_t >
+    bool
+    blas_dsyrk< N, K, float_t >::compute( const matrix_t& A_, matrix_dense_out_t& C_ )
+    {
+        p.trans     = CblasNoTrans;
+        p.a         = A_.array;
+        p.lda       = N;
+
+        call( C_ );
+
+        return true;
+    }
+
+
+    template< size_t N, size_t K, typename float_t >
+    bool
+    blas_dsyrk< N, K, float_t >::compute_t( const matrix_t_t& A_, matrix_out_t& C_ )
+    {
+        // cblas takes const input pointers, the input is passed through
+        p.trans     = CblasTrans;
+        p.a         = A_.array;
+        p.lda       = K;
+
+        call( C_ );
+
+        //std::cout << p << std::endl; //debug
+
+        return true;
+    }
+
+
+    template< size_t N, size_t K, typename float_t >
+    bool
+    blas_dsyrk< N, K, float_t >::compute_t( const matrix_t_t& A_, matrix_dense_out_t& C_ )
+    {
+        p.trans     = CblasTrans;
+        p.a         = A_.array;
+        p.lda       = K;
+
+        call( C_ );
+
+        return true;
+    }
+
+
+} // namespace vmml
+
+#endif
@@ -32,6 +32,8 @@
 #ifndef __VMML__BLAS_INCLUDES__HPP__
 #define __VMML__BLAS_INCLUDES__HPP__
 
+#ifdef VMMLIB_USE_BLAS
+
 #ifdef __APPLE__
 
 #include <Accelerate/Accelerate.h>
@@ -45,5 +47,12 @@ extern "C"
 
 #endif
 
+#endif
+
+// portable builtin routines; without a blas library they also provide the
+// cblas interface
+#include <vmmlib/blas_builtin.hpp>
+#include <vmmlib/blas_config.hpp>
+
 #endif /* __VMML__BLAS_INCLUDES__HPP__ */
 
@@ -0,0 +1,1099 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__CHOLESKY_SOLVER__HPP__
+#define __VMML__CHOLESKY_SOLVER__HPP__
+
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+#include <vmmlib/exception.hpp>
+#include <vmmlib/lu_kernels.hpp>
+
+#ifdef VMMLIB_USE_LAPACK
+#  include <vmmlib/lapack_cholesky.hpp>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/*
+* solvers for symmetric systems A x = B
+*
+* cholesky_solver< N, T > (fixed size) and dynamic_cholesky_solver< T >
+* (size known at runtime) factorize A once and can then solve for any
+* number of right-hand sides without refactorizing.
+*
+* factorize() first tries A = L L^T. if A is not positive definite it falls
+* back to the Bunch-Kaufman factorization P A P^T = L D L^T with symmetric
+* pivoting and 1x1 / 2x2 blocks in D, which is stable for indefinite A;
+* get_factorization() tells which one was used. factorize() returns false
+* only if A is singular. both reference the lower triangle of A only.
+*
+* cholesky_solver::factorize_lu() factorizes a general square A with
+* kernels::lu_factorize (partial pivoting, full matrix referenced).
+*
+* reciprocal_condition_estimate() estimates 1 / cond_1( A ) from || A ||_1
+* and Hager's estimate of || A^-1 ||_1 (as LAPACK xPOCON), it costs a few
+* solves.
+*
+* for N <= 4 the L L^T factorization and the solves are fully unrolled.
+* from CHOLESKY_LAPACK_THRESHOLD on, float and double systems are handed
+* to LAPACK xPOTRF / xPOTRS and xSYTRF / xSYTRS if VMMLIB_USE_LAPACK is
+* defined, smaller ones use the builtin loops.
+*
+* all factors are stored column-major in a single N x N array with the
+* upper triangle set to zero: L in the lower triangle; for L D L^T the
+* unit L below the diagonal and D on it, a 2x2 block of D keeps its
+* off-diagonal entry below the diagonal (the layout of LAPACK xSYTRF,
+* uplo 'L'); for LU the unit L below and U on and above the diagonal.
+*/
+
+namespace vmml
+{
+
+enum factorization_type
+{
+    FACTORIZATION_NONE,
+    FACTORIZATION_CHOLESKY,
+    FACTORIZATION_LDLT,
+    FACTORIZATION_LU
+};
+
+static const size_t CHOLESKY_LAPACK_THRESHOLD = 64;
+
+namespace cholesky_detail
+{
+
+// L D L^T pivots, one-based as LAPACK xSYTRF returns them
+#ifdef VMMLIB_USE_LAPACK
+typedef lapack::lapack_int pivot_int;
+#else
+typedef long pivot_int;
+#endif
+
+template< typename T >
+inline T
+abs_value( const T x )
+{
+    return x < T( 0 ) ? -x : x;
+}
+
+// 1-norm of a symmetric matrix given by its lower triangle
+template< typename T >
+T
+norm1_symmetric( const size_t n, const T* a, const size_t lda )
+{
+    T result = 0;
+    for( size_t j = 0; j < n; ++j )
+    {
+        T sum = 0;
+        for( size_t i = 0; i < j; ++i )
+            sum += abs_value( a[ i * lda + j ] );
+        for( size_t i = j; i < n; ++i )
+            sum += abs_value( a[ j * lda + i ] );
+        if ( sum > result )
+            result = sum;
+    }
+    return result;
+}
+
+template< typename T >
+T
+norm1_general( const size_t n, const T* a, const size_t lda )
+{
+    T result = 0;
+    for( size_t j = 0; j < n; ++j )
+    {
+        T sum = 0;
+        for( size_t i = 0; i < n; ++i )
+            sum += abs_value( a[ j * lda + i ] );
+        if ( sum > result )
+            result = sum;
+    }
+    return result;
+}
+
+template< typename T >
+void
+copy_square( const size_t n, const T* a, const size_t lda, T* f )
+{
+    for( size_t j = 0; j < n; ++j )
+        for( size_t i = 0; i < n; ++i )
+            f[ j * n + i ] = a[ j * lda + i ];
+}
+
+template< typename T >
+void
+zero_upper( const size_t n, T* a, const size_t lda )
+{
+    for( size_t j = 1; j < n; ++j )
+        for( size_t i = 0; i < j; ++i )
+            a[ j * lda + i ] = 0;
+}
+
+// right-looking L L^T, column updates are contiguous in memory
+template< typename T >
+bool
+llt_factorize( const size_t n, T* a, const size_t lda )
+{
+    for( size_t j = 0; j < n; ++j )
+    {
+        T* cj = a + j * lda;
+        const T d = cj[ j ];
+        if ( !( d > T( 0 ) ) )
+            return false;
+        cj[ j ] = std::sqrt( d );
+        const T r = T( 1 ) / cj[ j ];
+        for( size_t i = j + 1; i < n; ++i )
+            cj[ i ] *= r;
+
+        for( size_t c = j + 1; c < n; ++c )
+        {
+            const T f = cj[ c ];
+            T* cc = a + c * lda;
+            for( size_t i = c; i < n; ++i )
+                cc[ i ] -= cj[ i ] * f;
+        }
+    }
+    zero_upper( n, a, lda );
+    return true;
+}
+
+// solves L L^T x = b for one right-hand side, x replaces b
+template< typename T >
+void
+llt_solve( const size_t n, const T* l, const size_t lda, T* b )
+{
+    for( size_t j = 0; j < n; ++j )
+    {
+        const T* cj = l + j * lda;
+        b[ j ] /= cj[ j ];
+        const T bj = b[ j ];
+        for( size_t i = j + 1; i < n; ++i )
+            b[ i ] -= cj[ i ] * bj;
+    }
+    for( size_t j = n; j-- > 0; )
+    {
+        const T* cj = l + j * lda;
+        T s = b[ j ];
+        for( size_t i = j + 1; i < n; ++i )
+            s -= cj[ i ] * b[ i ];
+        b[ j ] = s / cj[ j ];
+    }
+}
+
+// Bunch-Kaufman P A P^T = L D L^T on the lower triangle (LAPACK xSYTF2,
+// uplo 'L'). ipiv[ k ] > 0: 1x1 block, rows / columns k and ipiv[ k ] - 1
+// were interchanged. ipiv[ k ] = ipiv[ k + 1 ] < 0: 2x2 block, k + 1 and
+// -ipiv[ k ] - 1 were interchanged. returns false if D is singular.
+template< typename T >
+bool
+ldlt_factorize( const size_t n, T* a, const size_t lda, pivot_int* ipiv )
+{
+    // bounds the growth of the entries of L
+    const T alpha = ( T( 1 ) + std::sqrt( T( 17 ) ) ) / T( 8 );
+
+    for( size_t k = 0; k < n; )
+    {
+        T* ck = a + k * lda;
+        const T abs_kk = abs_value( ck[ k ] );
+        size_t i_max = k;
+        T col_max = 0;
+        for( size_t i = k + 1; i < n; ++i )
+        {
+            if ( abs_value( ck[ i ] ) > col_max )
+            {
+                col_max = abs_value( ck[ i ] );
+                i_max = i;
+            }
+        }
+        if ( !( abs_kk > T( 0 ) ) && !( col_max > T( 0 ) ) )
+            return false;
+
+        size_t step = 1;
+        size_t kp = k;
+        if ( abs_kk < alpha * col_max )
+        {
+            // largest off-diagonal entry in row / column i_max of the
+            // trailing matrix, at least col_max
+            const T* ci = a + i_max * lda;
+            T row_max = 0;
+            for( size_t j = k; j < i_max; ++j )
+                if ( abs_value( a[ j * lda + i_max ] ) > row_max )
+                    row_max = abs_value( a[ j * lda + i_max ] );
+            for( size_t i = i_max + 1; i < n; ++i )
+                if ( abs_value( ci[ i ] ) > row_max )
+                    row_max = abs_value( ci[ i ] );
+
+            if ( abs_kk >= alpha * col_max * ( col_max / row_max ) )
+                kp = k;
+            else if ( abs_value( ci[ i_max ] ) >= alpha * row_max )
+                kp = i_max;
+            else
+            {
+                kp = i_max;
+                step = 2;
+            }
+        }
+
+        // symmetric interchange of kk and kp in the trailing matrix
+        const size_t kk = k + step - 1;
+        if ( kp != kk )
+        {
+            T* c_kk = a + kk * lda;
+            T* c_kp = a + kp * lda;
+            for( size_t i = kp + 1; i < n; ++i )
+                std::swap( c_kk[ i ], c_kp[ i ] );
+            for( size_t j = kk + 1; j < kp; ++j )
+                std::swap( c_kk[ j ], a[ j * lda + kp ] );
+            std::swap( c_kk[ kk ], c_kp[ kp ] );
+            if ( step == 2 )
+                std::swap( ck[ k + 1 ], ck[ kp ] );
+        }
+
+        if ( step == 1 )
+        {
+            // A22 -= a21 a21^T / d, then l21 = a21 / d
+            const T r = T( 1 ) / ck[ k ];
+            for( size_t j = k + 1; j < n; ++j )
+            {
+                T* cj = a + j * lda;
+                const T f = ck[ j ] * r;
+                for( size_t i = j; i < n; ++i )
+                    cj[ i ] -= ck[ i ] * f;
+            }
+            for( size_t i = k + 1; i < n; ++i )
+                ck[ i ] *= r;
+            ipiv[ k ] = pivot_int( kp + 1 );
+        }
+        else
+        {
+            // A22 -= A21 D^-1 A21^T, then L21 = A21 D^-1, D = [ d11 d21; d21 d22 ]
+            T* ck1 = ck + lda;
+            if ( k + 2 < n )
+            {
+                const T d21 = ck[ k + 1 ];
+                const T d11 = ck1[ k + 1 ] / d21;
+                const T d22 = ck[ k ] / d21;
+                const T s = T( 1 ) / ( ( d11 * d22 - T( 1 ) ) * d21 );
+                for( size_t j = k + 2; j < n; ++j )
+                {
+                    const T w0 = s * ( d11 * ck[ j ] - ck1[ j ] );
+                    const T w1 = s * ( d22 * ck1[ j ] - ck[ j ] );
+                    T* cj = a + j * lda;
+                    for( size_t i = j; i < n; ++i )
+                        cj[ i ] -= ck[ i ] * w0 + ck1[ i ] * w1;
+                    ck[ j ] = w0;
+                    ck1[ j ] = w1;
+                }
+            }
+            ipiv[ k ] = ipiv[ k + 1 ] = -pivot_int( kp + 1 );
+        }
+        k += step;
+    }
+    return true;
+}
+
+// solves P^T L D L^T P x = b for one right-hand side, x replaces b
+template< typename T >
+void
+ldlt_solve( const size_t n, const T* f, const size_t lda, const pivot_int* ipiv, T* b )
+{
+    // L D y = P b
+    for( size_t k = 0; k < n; )
+    {
+        const T* ck = f + k * lda;
+        if ( ipiv[ k ] > 0 )
+        {
+            const size_t kp = size_t( ipiv[ k ] - 1 );
+            if ( kp != k )
+                std::swap( b[ k ], b[ kp ] );
+            const T bk = b[ k ];
+            for( size_t i = k + 1; i < n; ++i )
+                b[ i ] -= ck[ i ] * bk;
+            b[ k ] = bk / ck[ k ];
+            ++k;
+        }
+        else
+        {
+            const size_t kp = size_t( -ipiv[ k ] - 1 );
+            if ( kp != k + 1 )
+                std::swap( b[ k + 1 ], b[ kp ] );
+            const T* ck1 = ck + lda;
+            const T b0 = b[ k ];
+            const T b1 = b[ k + 1 ];
+            for( size_t i = k + 2; i < n; ++i )
+                b[ i ] -= ck[ i ] * b0 + ck1[ i ] * b1;
+
+            // 2x2 block, scaled by its off-diagonal entry as in xSYTRS
+            const T d21 = ck[ k + 1 ];
+            const T d11 = ck[ k ] / d21;
+            const T d22 = ck1[ k + 1 ] / d21;
+            const T denominator = d11 * d22 - T( 1 );
+            const T y0 = b0 / d21;
+            const T y1 = b1 / d21;
+            b[ k ] = ( d22 * y0 - y1 ) / denominator;
+            b[ k + 1 ] = ( d11 * y1 - y0 ) / denominator;
+            k += 2;
+        }
+    }
+
+    // L^T P x = y, j is the last index of the current block
+    for( size_t k = n; k > 0; )
+    {
+        const size_t j = k - 1;
+        const T* cj = f + j * lda;
+        T s = b[ j ];
+        for( size_t i = j + 1; i < n; ++i )
+            s -= cj[ i ] * b[ i ];
+        b[ j ] = s;
+
+        size_t kp;
+        if ( ipiv[ j ] > 0 )
+        {
+            kp = size_t( ipiv[ j ] - 1 );
+            --k;
+        }
+        else
+        {
+            const T* cj0 = cj - lda;
+            T s0 = b[ j - 1 ];
+            for( size_t i = j + 1; i < n; ++i )
+                s0 -= cj0[ i ] * b[ i ];
+            b[ j - 1 ] = s0;
+            kp = size_t( -ipiv[ j ] - 1 );
+            k -= 2;
+        }
+        if ( kp != j )
+            std::swap( b[ j ], b[ kp ] );
+    }
+}
+
+// L L^T for large systems, LAPACK for float and double if available
+template< typename T >
+inline bool
+llt_factorize_large( const size_t n, T* a, const size_t lda )
+{
+    return llt_factorize( n, a, lda );
+}
+
+template< typename T >
+inline void
+llt_solve_large( const size_t n, const size_t nrhs, const T* l, const size_t lda,
+    T* b, const size_t ldb )
+{
+    for( size_t k = 0; k < nrhs; ++k )
+        llt_solve( n, l, lda, b + k * ldb );
+}
+
+// L D L^T for large systems, LAPACK for float and double if available
+template< typename T >
+inline bool
+ldlt_factorize_large( const size_t n, T* a, const size_t lda, pivot_int* ipiv )
+{
+    return ldlt_factorize( n, a, lda, ipiv );
+}
+
+template< typename T >
+inline void
+ldlt_solve_large( const size_t n, const size_t nrhs, const T* f, const size_t lda,
+    const pivot_int* ipiv, T* b, const size_t ldb )
+{
+    for( size_t k = 0; k < nrhs; ++k )
+        ldlt_solve( n, f, lda, ipiv, b + k * ldb );
+}
+
+#ifdef VMMLIB_USE_LAPACK
+
+template< typename T >
+inline bool
+lapack_llt_factorize( const size_t n, T* a, const size_t lda )
+{
+    lapack::xpotrf_params< T > p;
+    p.uplo  = 'L';
+    p.n     = n;
+    p.a     = a;
+    p.lda   = lda;
+    p.info  = 0;
+    lapack::xpotrf_call( p );
+    if ( p.info < 0 )
+        VMMLIB_ERROR( "invalid value in input matrix", VMMLIB_HERE );
+    if ( p.info > 0 )
+        return false;
+    zero_upper( n, a, lda );
+    return true;
+}
+
+template< typename T >
+inline void
+lapack_llt_solve( const size_t n, const size_t nrhs, const T* l, const size_t lda,
+    T* b, const size_t ldb )
+{
+    lapack::xpotrs_params< T > p;
+    p.uplo  = 'L';
+    p.n     = n;
+    p.nrhs  = nrhs;
+    p.a     = const_cast< T* >( l );
+    p.lda   = lda;
+    p.b     = b;
+    p.ldb   = ldb;
+    p.info  = 0;
+    lapack::xpotrs_call( p );
+    if ( p.info != 0 )
+        VMMLIB_ERROR( "invalid value in input matrix", VMMLIB_HERE );
+}
+
+template< typename T >
+inline bool
+lapack_ldlt_factorize( const size_t n, T* a, const size_t lda, pivot_int* ipiv )
+{
+    T work_size = 0;
+    lapack::xsytrf_params< T > p;
+    p.uplo  = 'L';
+    p.n     = n;
+    p.a     = a;
+    p.lda   = lda;
+    p.ipiv  = ipiv;
+    p.work  = &work_size;
+    p.lwork = -1;
+    p.info  = 0;
+    lapack::xsytrf_call( p );
+
+    std::vector< T > work( work_size > T( 1 ) ? size_t( work_size ) : 1 );
+    p.work  = &work[ 0 ];
+    p.lwork = work.size();
+    lapack::xsytrf_call( p );
+    if ( p.info < 0 )
+        VMMLIB_ERROR( "invalid value in input matrix", VMMLIB_HERE );
+    return p.info == 0;
+}
+
+template< typename T >
+inline void
+lapack_ldlt_solve( const size_t n, const size_t nrhs, const T* f, const size_t lda,
+    const pivot_int* ipiv, T* b, const size_t ldb )
+{
+    lapack::xsytrs_params< T > p;
+    p.uplo  = 'L';
+    p.n     = n;
+    p.nrhs  = nrhs;
+    p.a     = const_cast< T* >( f );
+    p.lda   = lda;
+    p.ipiv  = const_cast< pivot_int* >( ipiv );
+    p.b     = b;
+    p.ldb   = ldb;
+    p.info  = 0;
+    lapack::xsytrs_call( p );
+    if ( p.info != 0 )
+        VMMLIB_ERROR( "invalid value in input matrix", VMMLIB_HERE );
+}
+
+template<>
+inline bool
+llt_factorize_large( const size_t n, float* a, const size_t lda )
+{
+    return lapack_llt_factorize( n, a, lda );
+}
+
+template<>
+inline bool
+llt_factorize_large( const size_t n, double* a, const size_t lda )
+{
+    return lapack_llt_factorize( n, a, lda );
+}
+
+template<>
+inline void
+llt_solve_large( const size_t n, const size_t nrhs, const float* l,
+    const size_t lda, float* b, const size_t ldb )
+{
+    lapack_llt_solve( n, nrhs, l, lda, b, ldb );
+}
+
+template<>
+inline void
+llt_solve_large( const size_t n, const size_t nrhs, const double* l,
+    const size_t lda, double* b, const size_t ldb )
+{
+    lapack_llt_solve( n, nrhs, l, lda, b, ldb );
+}
+
+template<>
+inline bool
+ldlt_factorize_large( const size_t n, float* a, const size_t lda, pivot_int* ipiv )
+{
+    return lapack_ldlt_factorize( n, a, lda, ipiv );
+}
+
+template<>
+inline bool
+ldlt_factorize_large( const size_t n, double* a, const size_t lda, pivot_int* ipiv )
+{
+    return lapack_ldlt_factorize( n, a, lda, ipiv );
+}
+
+template<>
+inline void
+ldlt_solve_large( const size_t n, const size_t nrhs, const float* f,
+    const size_t lda, const pivot_int* ipiv, float* b, const size_t ldb )
+{
+    lapack_ldlt_solve( n, nrhs, f, lda, ipiv, b, ldb );
+}
+
+template<>
+inline void
+ldlt_solve_large( const size_t n, const size_t nrhs, const double* f,
+    const size_t lda, const pivot_int* ipiv, double* b, const size_t ldb )
+{
+    lapack_ldlt_solve( n, nrhs, f, lda, ipiv, b, ldb );
+}
+
+#endif
+
+// L L^T for a fixed N, unrolled below for N = 2, 3, 4
+template< size_t N, typename T >
+struct small_llt
+{
+    static bool factorize( T* a ) { return llt_factorize( N, a, N ); }
+    static void solve( const T* l, T* b ) { llt_solve( N, l, N, b ); }
+};
+
+template< typename T >
+struct small_llt< 2, T >
+{
+    static bool factorize( T* a )
+    {
+        if ( !( a[ 0 ] > T( 0 ) ) )
+            return false;
+        const T l00 = std::sqrt( a[ 0 ] );
+        const T l10 = a[ 1 ] / l00;
+        const T d1 = a[ 3 ] - l10 * l10;
+        if ( !( d1 > T( 0 ) ) )
+            return false;
+        a[ 0 ] = l00; a[ 1 ] = l10;
+        a[ 2 ] = 0;   a[ 3 ] = std::sqrt( d1 );
+        return true;
+    }
+
+    static void solve( const T* l, T* b )
+    {
+        const T y0 = b[ 0 ] / l[ 0 ];
+        const T y1 = ( b[ 1 ] - l[ 1 ] * y0 ) / l[ 3 ];
+        b[ 1 ] = y1 / l[ 3 ];
+        b[ 0 ] = ( y0 - l[ 1 ] * b[ 1 ] ) / l[ 0 ];
+    }
+};
+
+template< typename T >
+struct small_llt< 3, T >
+{
+    static bool factorize( T* a )
+    {
+        if ( !( a[ 0 ] > T( 0 ) ) )
+            return false;
+        const T l00 = std::sqrt( a[ 0 ] );
+        const T r0 = T( 1 ) / l00;
+        const T l10 = a[ 1 ] * r0;
+        const T l20 = a[ 2 ] * r0;
+
+        const T d1 = a[ 4 ] - l10 * l10;
+        if ( !( d1 > T( 0 ) ) )
+            return false;
+        const T l11 = std::sqrt( d1 );
+        const T l21 = ( a[ 5 ] - l20 * l10 ) / l11;
+
+        const T d2 = a[ 8 ] - l20 * l20 - l21 * l21;
+        if ( !( d2 > T( 0 ) ) )
+            return false;
+
+        a[ 0 ] = l00; a[ 1 ] = l10; a[ 2 ] = l20;
+        a[ 3 ] = 0;   a[ 4 ] = l11; a[ 5 ] = l21;
+        a[ 6 ] = 0;   a[ 7 ] = 0;   a[ 8 ] = std::sqrt( d2 );
+        return true;
+    }
+
+    static void solve( const T* l, T* b )
+    {
+        const T y0 = b[ 0 ] / l[ 0 ];
+        const T y1 = ( b[ 1 ] - l[ 1 ] * y0 ) / l[ 4 ];
+        const T y2 = ( b[ 2 ] - l[ 2 ] * y0 - l[ 5 ] * y1 ) / l[ 8 ];
+        const T x2 = y2 / l[ 8 ];
+        const T x1 = ( y1 - l[ 5 ] * x2 ) / l[ 4 ];
+        b[ 0 ] = ( y0 - l[ 1 ] * x1 - l[ 2 ] * x2 ) / l[ 0 ];
+        b[ 1 ] = x1;
+        b[ 2 ] = x2;
+    }
+};
+
+template< typename T >
+struct small_llt< 4, T >
+{
+    static bool factorize( T* a )
+    {
+        if ( !( a[ 0 ] > T( 0 ) ) )
+            return false;
+        const T l00 = std::sqrt( a[ 0 ] );
+        const T r0 = T( 1 ) / l00;
+        const T l10 = a[ 1 ] * r0;
+        const T l20 = a[ 2 ] * r0;
+        const T l30 = a[ 3 ] * r0;
+
+        const T d1 = a[ 5 ] - l10 * l10;
+        if ( !( d1 > T( 0 ) ) )
+            return false;
+        const T l11 = std::sqrt( d1 );
+        const T r1 = T( 1 ) / l11;
+        const T l21 = ( a[ 6 ] - l20 * l10 ) * r1;
+        const T l31 = ( a[ 7 ] - l30 * l10 ) * r1;
+
+        const T d2 = a[ 10 ] - l20 * l20 - l21 * l21;
+        if ( !( d2 > T( 0 ) ) )
+            return false;
+        const T l22 = std::sqrt( d2 );
+        const T l32 = ( a[ 11 ] - l30 * l20 - l31 * l21 ) / l22;
+
+        const T d3 = a[ 15 ] - l30 * l30 - l31 * l31 - l32 * l32;
+        if ( !( d3 > T( 0 ) ) )
+            return false;
+
+        a[ 0 ]  = l00; a[ 1 ]  = l10; a[ 2 ]  = l20; a[ 3 ]  = l30;
+        a[ 4 ]  = 0;   a[ 5 ]  = l11; a[ 6 ]  = l21; a[ 7 ]  = l31;
+        a[ 8 ]  = 0;   a[ 9 ]  = 0;   a[ 10 ] = l22; a[ 11 ] = l32;
+        a[ 12 ] = 0;   a[ 13 ] = 0;   a[ 14 ] = 0;   a[ 15 ] = std::sqrt( d3 );
+        return true;
+    }
+
+    static void solve( const T* l, T* b )
+    {
+        const T y0 = b[ 0 ] / l[ 0 ];
+        const T y1 = ( b[ 1 ] - l[ 1 ] * y0 ) / l[ 5 ];
+        const T y2 = ( b[ 2 ] - l[ 2 ] * y0 - l[ 6 ] * y1 ) / l[ 10 ];
+        const T y3 = ( b[ 3 ] - l[ 3 ] * y0 - l[ 7 ] * y1 - l[ 11 ] * y2 ) / l[ 15 ];
+        const T x3 = y3 / l[ 15 ];
+        const T x2 = ( y2 - l[ 11 ] * x3 ) / l[ 10 ];
+        const T x1 = ( y1 - l[ 6 ] * x2 - l[ 7 ] * x3 ) / l[ 5 ];
+        b[ 0 ] = ( y0 - l[ 1 ] * x1 - l[ 2 ] * x2 - l[ 3 ] * x3 ) / l[ 0 ];
+        b[ 1 ] = x1;
+        b[ 2 ] = x2;
+        b[ 3 ] = x3;
+    }
+};
+
+// Hager's estimate of || A^-1 ||_1 with Higham's alternative vector
+// (LAPACK xLACON); solve_( b ) replaces b by A^-1 b, solve_transposed_( b )
+// by A^-T b, for a symmetric A both are the same
+template< typename T, typename solve_t >
+T
+inverse_norm1_estimate( const size_t n, const solve_t& solve_,
+    const solve_t& solve_transposed_ )
+{
+    std::vector< T > x( n, T( 1 ) / T( n ) ), y( n ), z( n );
+    T estimate = 0;
+    for( size_t iteration = 0; iteration < 5; ++iteration )
+    {
+        y = x;
+        solve_( &y[ 0 ] );
+        T norm_y = 0;
+        for( size_t i = 0; i < n; ++i )
+            norm_y += abs_value( y[ i ] );
+        if ( iteration > 0 && !( norm_y > estimate ) )
+            break;
+        estimate = norm_y;
+
+        // z = A^-T sign( y )
+        for( size_t i = 0; i < n; ++i )
+            z[ i ] = y[ i ] < T( 0 ) ? T( -1 ) : T( 1 );
+        solve_transposed_( &z[ 0 ] );
+        size_t j_max = 0;
+        T z_max = abs_value( z[ 0 ] );
+        T z_x = 0;
+        for( size_t i = 0; i < n; ++i )
+        {
+            if ( abs_value( z[ i ] ) > z_max )
+            {
+                z_max = abs_value( z[ i ] );
+                j_max = i;
+            }
+            z_x += z[ i ] * x[ i ];
+        }
+        if ( !( z_max > z_x ) )
+            break;
+        std::fill( x.begin(), x.end(), T( 0 ) );
+        x[ j_max ] = 1;
+    }
+
+    const T denominator = n > 1 ? T( n - 1 ) : T( 1 );
+    for( size_t i = 0; i < n; ++i )
+        x[ i ] = ( i % 2 ? T( -1 ) : T( 1 ) ) * ( T( 1 ) + T( i ) / denominator );
+    solve_( &x[ 0 ] );
+    T norm_x = 0;
+    for( size_t i = 0; i < n; ++i )
+        norm_x += abs_value( x[ i ] );
+    const T alternative = T( 2 ) * norm_x / T( 3 * n );
+    return alternative > estimate ? alternative : estimate;
+}
+
+template< typename T >
+T
+reciprocal_condition( const T norm1, const T inverse_norm1 )
+{
+    if ( !( norm1 > T( 0 ) ) || !( inverse_norm1 > T( 0 ) ) )
+        return 0;
+    return T( 1 ) / ( norm1 * inverse_norm1 );
+}
+
+} // namespace cholesky_detail
+
+
+
+template< size_t N, typename T = double >
+class cholesky_solver
+{
+public:
+    cholesky_solver() : _norm1( 0 ), _type( FACTORIZATION_NONE ) {}
+
+    // returns false if A is singular; the factor is kept for solve()
+    bool factorize( const matrix< N, N, T >& A );
+
+    // LU with partial pivoting for a general square A
+    bool factorize_lu( const matrix< N, N, T >& A );
+
+    factorization_type get_factorization() const { return _type; }
+    bool is_factorized() const { return _type != FACTORIZATION_NONE; }
+    bool is_spd() const { return _type == FACTORIZATION_CHOLESKY; }
+
+    // x replaces b
+    void solve( vector< N, T >& b ) const;
+    void solve( const vector< N, T >& b, vector< N, T >& x ) const;
+
+    // solves for all K columns of B with the same factor, X replaces B
+    template< size_t K >
+    void solve( matrix< N, K, T >& B ) const;
+    template< size_t K >
+    void solve( const matrix< N, K, T >& B, matrix< N, K, T >& X ) const;
+
+    void compute_inverse( matrix< N, N, T >& inverse_ ) const;
+
+    // estimate of 1 / cond_1( A ), 0 if A was singular
+    T reciprocal_condition_estimate() const;
+
+    const matrix< N, N, T >& get_factor() const { return _factor; }
+
+protected:
+    void _solve_columns( T* b, const size_t nrhs, const bool transposed = false ) const;
+
+    struct column_solve
+    {
+        column_solve( const cholesky_solver& solver_, const bool transposed_ )
+            : solver( solver_ ), transposed( transposed_ ) {}
+        void operator()( T* b ) const { solver._solve_columns( b, 1, transposed ); }
+        const cholesky_solver& solver;
+        const bool transposed;
+    };
+
+    matrix< N, N, T >   _factor;
+    cholesky_detail::pivot_int _ldlt_pivots[ N ];
+    size_t              _lu_pivots[ N ];
+    T                   _norm1;
+    factorization_type  _type;
+
+}; // class cholesky_solver
+
+
+
+template< size_t N, typename T >
+bool
+cholesky_solver< N, T >::factorize( const matrix< N, N, T >& A )
+{
+    _norm1 = cholesky_detail::norm1_symmetric( N, A.array, N );
+    _factor = A;
+    const bool spd = N >= CHOLESKY_LAPACK_THRESHOLD
+        ? cholesky_detail::llt_factorize_large( N, _factor.array, N )
+        : cholesky_detail::small_llt< N, T >::factorize( _factor.array );
+
+    if ( spd )
+        _type = FACTORIZATION_CHOLESKY;
+    else
+    {
+        _factor = A;
+        const bool regular = N >= CHOLESKY_LAPACK_THRESHOLD
+            ? cholesky_detail::ldlt_factorize_large( N, _factor.array, N, _ldlt_pivots )
+            : cholesky_detail::ldlt_factorize( N, _factor.array, N, _ldlt_pivots );
+        cholesky_detail::zero_upper( N, _factor.array, N );
+        _type = regular ? FACTORIZATION_LDLT : FACTORIZATION_NONE;
+    }
+
+    return _type != FACTORIZATION_NONE;
+}
+
+
+
+template< size_t N, typename T >
+bool
+cholesky_solver< N, T >::factorize_lu( const matrix< N, N, T >& A )
+{
+    _norm1 = cholesky_detail::norm1_general( N, A.array, N );
+    _factor = A;
+    _type = kernels::lu_factorize< N >( _factor.array, _lu_pivots ) != 0
+        ? FACTORIZATION_LU : FACTORIZATION_NONE;
+    return _type != FACTORIZATION_NONE;
+}
+
+
+
+template< size_t N, typename T >
+T
+cholesky_solver< N, T >::reciprocal_condition_estimate() const
+{
+    if ( _type == FACTORIZATION_NONE )
+        return 0;
+    return cholesky_detail::reciprocal_condition( _norm1,
+        cholesky_detail::inverse_norm1_estimate< T >( N, column_solve( *this, false ),
+            column_solve( *this, true )));
+}
+
+
+
+template< size_t N, typename T >
+void
+cholesky_solver< N, T >::_solve_columns( T* b, const size_t nrhs,
+    const bool transposed ) const
+{
+    switch( _type )
+    {
+        case FACTORIZATION_CHOLESKY:
+            if ( N >= CHOLESKY_LAPACK_THRESHOLD )
+                cholesky_detail::llt_solve_large( N, nrhs, _factor.array, N, b, N );
+            else
+                for( size_t k = 0; k < nrhs; ++k )
+                    cholesky_detail::small_llt< N, T >::solve( _factor.array, b + k * N );
+            break;
+        case FACTORIZATION_LDLT:
+            if ( N >= CHOLESKY_LAPACK_THRESHOLD )
+                cholesky_detail::ldlt_solve_large( N, nrhs, _factor.array, N,
+                    _ldlt_pivots, b, N );
+            else
+                for( size_t k = 0; k < nrhs; ++k )
+                    cholesky_detail::ldlt_solve( N, _factor.array, N, _ldlt_pivots,
+                        b + k * N );
+            break;
+        case FACTORIZATION_LU:
+            if ( transposed )
+                kernels::lu_solve_transposed< N >( _factor.array, _lu_pivots, b, nrhs );
+            else
+                kernels::lu_solve< N >( _factor.array, _lu_pivots, b, nrhs );
+            break;
+        default:
+            VMMLIB_ERROR( "cholesky_solver - no factorization to solve with.", VMMLIB_HERE );
+    }
+}
+
+
+
+template< size_t N, typename T >
+void
+cholesky_solver< N, T >::solve( vector< N, T >& b ) const
+{
+    _solve_columns( b.array, 1 );
+}
+
+
+
+template< size_t N, typename T >
+void
+cholesky_solver< N, T >::solve( const vector< N, T >& b, vector< N, T >& x ) const
+{
+    x = b;
+    _solve_columns( x.array, 1 );
+}
+
+
+
+template< size_t N, typename T >
+template< size_t K >
+void
+cholesky_solver< N, T >::solve( matrix< N, K, T >& B ) const
+{
+    _solve_columns( B.array, K );
+}
+
+
+
+template< size_t N, typename T >
+template< size_t K >
+void
+cholesky_solver< N, T >::solve( const matrix< N, K, T >& B, matrix< N, K, T >& X ) const
+{
+    X = B;
+    _solve_columns( X.array, K );
+}
+
+
+
+template< size_t N, typename T >
+void
+cholesky_solver< N, T >::compute_inverse( matrix< N, N, T >& inverse_ ) const
+{
+    inverse_ = matrix< N, N, T >::IDENTITY;
+    _solve_columns( inverse_.array, N );
+}
+
+
+
+template< typename T = double >
+class dynamic_cholesky_solver
+{
+public:
+    dynamic_cholesky_solver() : _n( 0 ), _norm1( 0 ), _type( FACTORIZATION_NONE ) {}
+
+    // a is a column-major n x n matrix with leading dimension lda (0: n).
+    // returns false if it is singular; the factor is kept for solve()
+    bool factorize( const size_t n, const T* a, size_t lda = 0 );
+
+    size_t get_size() const { return _n; }
+    factorization_type get_factorization() const { return _type; }
+    bool is_factorized() const { return _type != FACTORIZATION_NONE; }
+    bool is_spd() const { return _type == FACTORIZATION_CHOLESKY; }
+
+    // solves for nrhs column-major right-hand sides with leading dimension
+    // ldb (0: n), x replaces b
+    void solve( T* b, const size_t nrhs = 1, size_t ldb = 0 ) const;
+
+    // estimate of 1 / cond_1( A ), 0 if A was singular
+    T reciprocal_condition_estimate() const;
+
+    // column-major n x n, see the layout notes at the top of this file
+    const T* get_factor() const { return _factor.empty() ? 0 : &_factor[ 0 ]; }
+
+protected:
+    struct column_solve
+    {
+        explicit column_solve( const dynamic_cholesky_solver& solver_ ) : solver( solver_ ) {}
+        void operator()( T* b ) const { solver.solve( b ); }
+        const dynamic_cholesky_solver& solver;
+    };
+
+    size_t              _n;
+    std::vector< T >    _factor;
+    std::vector< cholesky_detail::pivot_int > _pivots;
+    T                   _norm1;
+    factorization_type  _type;
+
+}; // class dynamic_cholesky_solver
+
+
+
+template< typename T >
+bool
+dynamic_cholesky_solver< T >::factorize( const size_t n, const T* a, size_t lda )
+{
+    if ( lda == 0 )
+        lda = n;
+    _n = n;
+    if ( n == 0 )
+    {
+        _type = FACTORIZATION_NONE;
+        return false;
+    }
+    _factor.resize( n * n );
+    _pivots.resize( n );
+
+    _norm1 = cholesky_detail::norm1_symmetric( n, a, lda );
+    T* f = &_factor[ 0 ];
+    cholesky_detail::copy_square( n, a, lda, f );
+    const bool spd = n >= CHOLESKY_LAPACK_THRESHOLD
+        ? cholesky_detail::llt_factorize_large( n, f, n )
+        : cholesky_detail::llt_factorize( n, f, n );
+
+    if ( spd )
+        _type = FACTORIZATION_CHOLESKY;
+    else
+    {
+        cholesky_detail::copy_square( n, a, lda, f );
+        const bool regular = n >= CHOLESKY_LAPACK_THRESHOLD
+            ? cholesky_detail::ldlt_factorize_large( n, f, n, &_pivots[ 0 ] )
+            : cholesky_detail::ldlt_factorize( n, f, n, &_pivots[ 0 ] );
+        cholesky_detail::zero_upper( n, f, n );
+        _type = regular ? FACTORIZATION_LDLT : FACTORIZATION_NONE;
+    }
+
+    return _type != FACTORIZATION_NONE;
+}
+
+
+
+template< typename T >
+T
+dynamic_cholesky_solver< T >::reciprocal_condition_estimate() const
+{
+    if ( _type == FACTORIZATION_NONE )
+        return 0;
+    return cholesky_detail::reciprocal_condition( _norm1,
+        cholesky_detail::inverse_norm1_estimate< T >( _n, column_solve( *this ),
+            column_solve( *this )));
+}
+
+
+
+template< typename T >
+void
+dynamic_cholesky_solver< T >::solve( T* b, const size_t nrhs, size_t ldb ) const
+{
+    if ( ldb == 0 )
+        ldb = _n;
+    const T* f = _factor.empty() ? 0 : &_factor[ 0 ];
+
+    switch( _type )
+    {
+        case FACTORIZATION_CHOLESKY:
+            if ( _n >= CHOLESKY_LAPACK_THRESHOLD )
+                cholesky_detail::llt_solve_large( _n, nrhs, f, _n, b, ldb );
+            else
+                for( size_t k = 0; k < nrhs; ++k )
+                    cholesky_detail::llt_solve( _n, f, _n, b + k * ldb );
+            break;
+        case FACTORIZATION_LDLT:
+            if ( _n >= CHOLESKY_LAPACK_THRESHOLD )
+                cholesky_detail::ldlt_solve_large( _n, nrhs, f, _n, &_pivots[ 0 ], b, ldb );
+            else
+                for( size_t k = 0; k < nrhs; ++k )
+                    cholesky_detail::ldlt_solve( _n, f, _n, &_pivots[ 0 ], b + k * ldb );
+            break;
+        default:
+            VMMLIB_ERROR( "dynamic_cholesky_solver - no factorization to solve with.", VMMLIB_HERE );
+    }
+}
+
+} // namespace vmml
+
+#endif
@@ -0,0 +1,542 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* fast text (csv) formatting and parsing for tensor data
+ *
+ * layout: one line per row (i1), the columns (i2) separated by ", ", an
+ * empty line after each frontal slice and an additional empty line after
+ * each group of slices (e.g., after each tensor3 of a tensor4).
+ *
+ * - integers are formatted/parsed with hand-written digit loops
+ * - floating point values are formatted like "%g" with the precision that
+ *   round-trips (max_digits10) unless a precision is given; up to 9 digits
+ *   (round-trip float) use the fast path, more go through snprintf
+ * - slabs of slices are formatted in parallel into separate buffers and
+ *   written in order with large block writes
+ * - decimal numbers are parsed exactly without strtod where possible
+ * - parsing counts the values per chunk in parallel, then parses the chunks
+ *   in parallel at their known output offsets
+ */
+
+#ifndef __VMML__CSV_FORMATTER__HPP__
+#define __VMML__CSV_FORMATTER__HPP__
+
+#include <vmmlib/exception.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef VMMLIB_USE_OPENMP
+#  include <omp.h>
+#endif
+
+namespace vmml {
+
+    class csv_formatter
+    {
+    public:
+        //number of slices formatted per parallel slab
+        static const size_t SLAB_SIZE = 64;
+
+        //data_ is a column-major sequence of rows_ x cols_ slices (as in tensor3/tensor4)
+        template< typename T >
+        static void write(const std::string& path_, const T* data_,
+                size_t rows_, size_t cols_, size_t n_slices_, size_t slices_per_group_ = 0, int precision_ = 0);
+
+        //reads exactly rows_ * cols_ * n_slices_ values, written in the layout of write, into data_
+        template< typename T >
+        static void read(const std::string& path_, T* data_, size_t rows_, size_t cols_, size_t n_slices_);
+
+        template< typename T >
+        static void format_slices(std::string& out_, const T* data_, size_t rows_, size_t cols_,
+                size_t first_slice_, size_t end_slice_, size_t slices_per_group_, int precision_);
+        template< typename T >
+        static void parse(const char* begin_, const char* end_, T* data_, size_t rows_, size_t cols_, size_t n_slices_);
+
+        template< typename T >
+        static char* format_value(char* out_, T value_, int precision_ = 0);
+        template< typename T >
+        static const char* parse_value(const char* in_, const char* end_, T& value_);
+
+    protected:
+        template< typename T >
+        static char* format_integer(char* out_, T value_);
+        static char* format_double(char* out_, double value_, int precision_);
+        static double get_power_of_ten(int exponent_);
+        static double round_half_even(double value_);
+        static double scale(double value_, int exponent_);
+        static const char* parse_double(const char* in_, const char* end_, double& value_);
+        template< typename T >
+        static const char* parse_integer(const char* in_, const char* end_, T& value_);
+
+        static bool is_delimiter(char c_) { return c_ == ',' || c_ == ' ' || c_ == '\n' || c_ == '\r' || c_ == '\t'; };
+        static size_t count_values(const char* begin_, const char* end_);
+
+    }; //end csv_formatter
+
+
+
+    template< typename T >
+    char*
+    csv_formatter::format_integer(char* out_, T value_) {
+        //digits are generated backwards into a small buffer
+        char digits[24];
+        char* digit = digits + sizeof (digits);
+        const bool negative = std::numeric_limits< T >::is_signed && value_ < T(0);
+        //negated in unsigned arithmetic, -LLONG_MIN does not fit into long long
+        unsigned long long magnitude = negative ? 0ull - (unsigned long long) value_ : (unsigned long long) value_;
+        do {
+            *--digit = char('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (negative)
+            *out_++ = '-';
+        const size_t len = digits + sizeof (digits) - digit;
+        memcpy(out_, digit, len);
+        return out_ + len;
+    }
+
+    template< typename T >
+    char*
+    csv_formatter::format_value(char* out_, T value_, int precision_) {
+        if (std::numeric_limits< T >::is_integer)
+            return format_integer(out_, value_);
+
+        //max_digits10 (C++11): 9 for float, 17 for double
+        const int precision = precision_ > 0 ? precision_ : 2 + std::numeric_limits< T >::digits * 30103 / 100000;
+        return format_double(out_, double(value_), precision);
+    }
+
+    inline double
+    csv_formatter::get_power_of_ten(int exponent_) {
+        static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        double power = 1.0;
+        int exponent = exponent_ < 0 ? -exponent_ : exponent_;
+        while (exponent > 22) {
+            power *= 1e22;
+            exponent -= 22;
+        }
+        power *= powers[exponent];
+        return exponent_ < 0 ? 1.0 / power : power;
+    }
+
+    inline double
+    csv_formatter::scale(double value_, int exponent_) {
+        //divide by exact powers of ten, so that decimal ties stay exact
+        return exponent_ < 0 ? value_ / get_power_of_ten(-exponent_) : value_ * get_power_of_ten(exponent_);
+    }
+
+    inline double
+    csv_formatter::round_half_even(double value_) {
+        //rounding of printf for exact ties
+        const double rounded = floor(value_);
+        const double fraction = value_ - rounded;
+        if (fraction > 0.5 || (fraction == 0.5 && fmod(rounded, 2.0) != 0.0))
+            return rounded + 1.0;
+        return rounded;
+    }
+
+    inline char*
+    csv_formatter::format_double(char* out_, double value_, int precision_) {
+        //equivalent of "%.*g": the digits are computed in double precision, which
+        //is exact enough for up to 9 significant digits (all float values round-trip).
+        //more digits, denormals and non-finite values go through snprintf
+        const double magnitude = fabs(value_);
+        if (precision_ > 9 || !(magnitude < (std::numeric_limits< double >::max)())
+                || (magnitude != 0.0 && magnitude < 1e-300))
+            return out_ + snprintf(out_, 32, "%.*g", precision_, value_);
+
+        if (value_ < 0.0)
+            *out_++ = '-';
+        if (magnitude == 0.0) {
+            *out_++ = '0';
+            return out_;
+        }
+
+        int exponent = int(floor(log10(magnitude)));
+        const double limit = get_power_of_ten(precision_);
+        double scaled = round_half_even(scale(magnitude, precision_ - 1 - exponent));
+        if (scaled >= limit) {
+            ++exponent;
+            scaled = round_half_even(scale(magnitude, precision_ - 1 - exponent));
+        } else if (scaled < limit / 10.0) {
+            --exponent;
+            scaled = round_half_even(scale(magnitude, precision_ - 1 - exponent));
+        }
+
+        //significant digits without trailing zeros
+        char digits[24];
+        unsigned long long mantissa = (unsigned long long) scaled;
+        int n_digits = precision_;
+        for (int digit = precision_ - 1; digit >= 0; --digit) {
+            digits[digit] = char('0' + mantissa % 10);
+            mantissa /= 10;
+        }
+        while (n_digits > 1 && digits[n_digits - 1] == '0') {
+            --n_digits;
+        }
+
+        if (exponent < -4 || exponent >= precision_) {
+            *out_++ = digits[0];
+            if (n_digits > 1) {
+                *out_++ = '.';
+                memcpy(out_, digits + 1, n_digits - 1);
+                out_ += n_digits - 1;
+            }
+            *out_++ = 'e';
+            *out_++ = exponent < 0 ? '-' : '+';
+            const int exponent_abs = exponent < 0 ? -exponent : exponent;
+            if (exponent_abs < 10)
+                *out_++ = '0';
+            return format_integer(out_, exponent_abs);
+        }
+        if (exponent < 0) {
+            *out_++ = '0';
+            *out_++ = '.';
+            for (int zero = -1; zero > exponent; --zero) {
+                *out_++ = '0';
+            }
+            memcpy(out_, digits, n_digits);
+            return out_ + n_digits;
+        }
+        const int n_integer = exponent + 1;
+        for (int digit = 0; digit < n_integer; ++digit) {
+            *out_++ = digit < n_digits ? digits[digit] : '0';
+        }
+        if (n_digits > n_integer) {
+            *out_++ = '.';
+            memcpy(out_, digits + n_integer, n_digits - n_integer);
+            out_ += n_digits - n_integer;
+        }
+        return out_;
+    }
+
+    template< typename T >
+    const char*
+    csv_formatter::parse_integer(const char* in_, const char* end_, T& value_) {
+        bool negative = false;
+        if (in_ < end_ && (*in_ == '-' || *in_ == '+')) {
+            negative = (*in_ == '-');
+            ++in_;
+        }
+        const unsigned long long max_magnitude = (std::numeric_limits< unsigned long long >::max)();
+        unsigned long long magnitude = 0;
+        const char* digits = in_;
+        while (in_ < end_ && *in_ >= '0' && *in_ <= '9') {
+            const unsigned long long digit = (unsigned long long) (*in_ - '0');
+            if (magnitude > (max_magnitude - digit) / 10)
+                VMMLIB_ERROR("csv: integer out of range", VMMLIB_HERE);
+            magnitude = magnitude * 10 + digit;
+            ++in_;
+        }
+        if (in_ == digits)
+            VMMLIB_ERROR("csv: invalid number", VMMLIB_HERE);
+
+        //-min = max + 1 for signed types, unsigned types only take -0
+        const unsigned long long max_value = (unsigned long long) (std::numeric_limits< T >::max)();
+        const unsigned long long max_negative = std::numeric_limits< T >::is_signed ? max_value + 1 : 0;
+        if (negative ? magnitude > max_negative : magnitude > max_value)
+            VMMLIB_ERROR("csv: integer out of range", VMMLIB_HERE);
+        //negated in unsigned arithmetic, -LLONG_MIN does not fit into long long
+        value_ = negative ? T(0ull - magnitude) : T(magnitude);
+        return in_;
+    }
+
+    template< typename T >
+    const char*
+    csv_formatter::parse_value(const char* in_, const char* end_, T& value_) {
+        //a value is the whole token up to the next delimiter, "4-5" is an error, not two values
+        const char* token_end = in_;
+        while (token_end < end_ && !is_delimiter(*token_end)) {
+            ++token_end;
+        }
+        if (std::numeric_limits< T >::is_integer) {
+            //integers written by other tools may still carry a fraction or exponent
+            const char* parsed = parse_integer(in_, token_end, value_);
+            if (parsed == token_end)
+                return parsed;
+        }
+        double value = 0.0;
+        const char* parsed = parse_double(in_, token_end, value);
+        if (parsed != token_end)
+            VMMLIB_ERROR("csv: invalid number", VMMLIB_HERE);
+        if (std::numeric_limits< T >::is_integer
+                && !(value >= double((std::numeric_limits< T >::min)())
+                && value <= double((std::numeric_limits< T >::max)())))
+            VMMLIB_ERROR("csv: integer out of range", VMMLIB_HERE);
+        value_ = T(value);
+        return parsed;
+    }
+
+    inline const char*
+    csv_formatter::parse_double(const char* in_, const char* end_, double& value_) {
+        //fast path (Clinger): up to 19 digits and a small decimal exponent are
+        //converted exactly, everything else goes through strtod
+        const char* in = in_;
+        const bool negative = (in < end_ && *in == '-');
+        if (in < end_ && (*in == '-' || *in == '+'))
+            ++in;
+        unsigned long long mantissa = 0;
+        int n_digits = 0;
+        int exponent = 0;
+        bool has_digits = false;
+        while (in < end_ && *in >= '0' && *in <= '9') {
+            has_digits = true;
+            if (n_digits < 19) {
+                mantissa = mantissa * 10 + (unsigned long long) (*in - '0');
+                if (mantissa > 0)
+                    ++n_digits;
+            } else {
+                ++exponent;
+            }
+            ++in;
+        }
+        if (in < end_ && *in == '.') {
+            ++in;
+            while (in < end_ && *in >= '0' && *in <= '9') {
+                has_digits = true;
+                if (n_digits < 19) {
+                    mantissa = mantissa * 10 + (unsigned long long) (*in - '0');
+                    if (mantissa > 0)
+                        ++n_digits;
+                    --exponent;
+                }
+                ++in;
+            }
+        }
+        if (has_digits && in < end_ && (*in == 'e' || *in == 'E')) {
+            const char* exponent_begin = in + 1;
+            int exponent_value = 0;
+            exponent_begin = parse_integer(exponent_begin, end_, exponent_value);
+            exponent += exponent_value;
+            in = exponent_begin;
+        }
+        const bool is_exact = has_digits && mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22
+                && (in >= end_ || is_delimiter(*in));
+        if (is_exact) {
+            double value = double(mantissa);
+            value = exponent < 0 ? value / get_power_of_ten(-exponent) : value * get_power_of_ten(exponent);
+            value_ = negative ? -value : value;
+            return in;
+        }
+
+        //the buffer is zero-terminated by read, so strtod stops at the delimiter at the latest
+        char* parsed = 0;
+        value_ = strtod(in_, &parsed);
+        if (parsed == in_)
+            VMMLIB_ERROR("csv: invalid number", VMMLIB_HERE);
+        return parsed;
+    }
+
+    template< typename T >
+    void
+    csv_formatter::format_slices(std::string& out_, const T* data_, size_t rows_, size_t cols_,
+            size_t first_slice_, size_t end_slice_, size_t slices_per_group_, int precision_) {
+        //upper bound per value: sign, digits, exponent, separator
+        const size_t max_len_value = 34;
+        const size_t n_slices = end_slice_ - first_slice_;
+        out_.resize(n_slices * (rows_ * (cols_ * max_len_value + 1) + 2));
+        char* begin = &out_[0];
+        char* out = begin;
+
+        for (size_t slice = first_slice_; slice < end_slice_; ++slice) {
+            const T* slice_data = data_ + slice * rows_ * cols_;
+            for (size_t row = 0; row < rows_; ++row) {
+                for (size_t col = 0; col < cols_; ++col) {
+                    out = format_value(out, slice_data[col * rows_ + row], precision_);
+                    if (col + 1 < cols_) {
+                        *out++ = ',';
+                        *out++ = ' ';
+                    }
+                }
+                *out++ = '\n';
+            }
+            *out++ = '\n';
+            if (slices_per_group_ > 0 && (slice + 1) % slices_per_group_ == 0)
+                *out++ = '\n';
+        }
+        out_.resize(out - begin);
+    }
+
+    template< typename T >
+    void
+    csv_formatter::write(const std::string& path_, const T* data_,
+            size_t rows_, size_t cols_, size_t n_slices_, size_t slices_per_group_, int precision_) {
+        std::ofstream outfile;
+        outfile.open(path_.c_str(), std::ios::out | std::ios::binary);
+        if (!outfile.is_open()) {
+            std::cout << "no file open" << std::endl;
+            return;
+        }
+
+        //format a batch of slabs in parallel, then write them in order
+        size_t n_threads = 1;
+#ifdef VMMLIB_USE_OPENMP
+        n_threads = omp_get_max_threads();
+#endif
+        const size_t n_slabs = (n_slices_ + SLAB_SIZE - 1) / SLAB_SIZE;
+        const size_t batch_size = 2 * n_threads;
+        std::vector< std::string > buffers(batch_size);
+        for (size_t first_slab = 0; first_slab < n_slabs; first_slab += batch_size) {
+            const long n_batch = long((std::min)(batch_size, n_slabs - first_slab));
+#pragma omp parallel for schedule(dynamic)
+            for (long slab = 0; slab < n_batch; ++slab) {
+                const size_t first_slice = (first_slab + slab) * SLAB_SIZE;
+                const size_t end_slice = (std::min)(first_slice + SLAB_SIZE, n_slices_);
+                format_slices(buffers[slab], data_, rows_, cols_, first_slice, end_slice, slices_per_group_, precision_);
+            }
+            for (long slab = 0; slab < n_batch; ++slab) {
+                outfile.write(buffers[slab].data(), buffers[slab].size());
+            }
+        }
+        outfile.close();
+    }
+
+    inline size_t
+    csv_formatter::count_values(const char* begin_, const char* end_) {
+        size_t count = 0;
+        bool in_value = false;
+        for (const char* c = begin_; c < end_; ++c) {
+            const bool delimiter = is_delimiter(*c);
+            if (!delimiter && !in_value)
+                ++count;
+            in_value = !delimiter;
+        }
+        return count;
+    }
+
+    template< typename T >
+    void
+    csv_formatter::parse(const char* begin_, const char* end_, T* data_, size_t rows_, size_t cols_, size_t n_slices_) {
+        const size_t n_values = rows_ * cols_ * n_slices_;
+        //split into chunks at delimiters, so that no value spans two chunks
+        size_t n_chunks = 1;
+#ifdef VMMLIB_USE_OPENMP
+        n_chunks = 4 * omp_get_max_threads();
+#endif
+        const size_t len = end_ - begin_;
+        n_chunks = (std::max)(size_t(1), (std::min)(n_chunks, len / 4096));
+        std::vector< const char* > bounds(n_chunks + 1, end_);
+        bounds[0] = begin_;
+        for (size_t chunk = 1; chunk < n_chunks; ++chunk) {
+            const char* bound = (std::max)(bounds[chunk - 1], begin_ + chunk * len / n_chunks);
+            while (bound < end_ && !is_delimiter(*bound)) {
+                ++bound;
+            }
+            bounds[chunk] = bound;
+        }
+
+        std::vector< size_t > offsets(n_chunks + 1, 0);
+#pragma omp parallel for
+        for (long chunk = 0; chunk < long(n_chunks); ++chunk) {
+            offsets[chunk + 1] = count_values(bounds[chunk], bounds[chunk + 1]);
+        }
+        for (size_t chunk = 0; chunk < n_chunks; ++chunk) {
+            offsets[chunk + 1] += offsets[chunk];
+        }
+        if (offsets[n_chunks] != n_values)
+            VMMLIB_ERROR("csv: number of values does not match the tensor size", VMMLIB_HERE);
+
+        //exceptions must not leave the parallel region, the first bad value is reported
+        const size_t no_error = (std::numeric_limits< size_t >::max)();
+        size_t invalid_value = no_error;
+#pragma omp parallel for
+        for (long chunk = 0; chunk < long(n_chunks); ++chunk) {
+            const char* in = bounds[chunk];
+            const char* chunk_end = bounds[chunk + 1];
+            //the text is row by row, the slices are stored column by column
+            size_t value = offsets[chunk];
+            size_t slice = value / (rows_ * cols_);
+            size_t row = (value / cols_) % rows_;
+            size_t col = value % cols_;
+            try {
+                while (true) {
+                    while (in < chunk_end && is_delimiter(*in)) {
+                        ++in;
+                    }
+                    if (in >= chunk_end)
+                        break;
+                    if (value >= n_values)
+                        VMMLIB_ERROR("csv: too many values", VMMLIB_HERE);
+                    in = parse_value(in, chunk_end, data_[(slice * cols_ + col) * rows_ + row]);
+                    ++value;
+                    if (++col == cols_) {
+                        col = 0;
+                        if (++row == rows_) {
+                            row = 0;
+                            ++slice;
+                        }
+                    }
+                }
+            } catch (...) {
+#pragma omp critical(vmmlib_csv_formatter)
+                invalid_value = (std::min)(invalid_value, value);
+            }
+        }
+        if (invalid_value != no_error) {
+            std::ostringstream error;
+            error << "csv: invalid number at value " << invalid_value;
+            VMMLIB_ERROR(error.str(), VMMLIB_HERE);
+        }
+    }
+
+    template< typename T >
+    void
+    csv_formatter::read(const std::string& path_, T* data_, size_t rows_, size_t cols_, size_t n_slices_) {
+        std::ifstream infile;
+        infile.open(path_.c_str(), std::ios::in | std::ios::binary);
+        if (!infile.is_open()) {
+            std::cout << "no file open" << std::endl;
+            return;
+        }
+        infile.seekg(0, std::ios::end);
+        const size_t len_file = size_t(infile.tellg());
+        infile.seekg(0, std::ios::beg);
+
+        std::vector< char > buffer(len_file + 1, 0);
+        if (len_file > 0)
+            infile.read(&buffer[0], len_file);
+        infile.close();
+
+        parse(&buffer[0], &buffer[0] + len_file, data_, rows_, cols_, n_slices_);
+    }
+
+}//end vmml namespace
+
+#endif
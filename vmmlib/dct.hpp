@@ -0,0 +1,687 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__DCT__HPP__
+#define __VMML__DCT__HPP__
+
+#include <vmmlib/vector.hpp>
+#ifdef VMMLIB_USE_BLAS
+#include <vmmlib/blas_dgemm.hpp>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ *
+ *   orthonormal DCT-II (forward) and DCT-III (inverse) of length N,
+ *
+ *       X( k ) = w( k ) sum_n x( n ) cos( pi ( 2n + 1 ) k / 2N ),
+ *       w( 0 ) = sqrt( 1 / N ), w( k ) = sqrt( 2 / N ),
+ *
+ *   i.e. the product with the matrix built by matrix::set_dct().
+ *
+ *   the transform is computed in O( N log N ) with Makhoul's method: the
+ *   even samples followed by the odd ones in reverse order are fed into an
+ *   N-point complex DFT, the result is rotated by exp( -i pi k / 2N ).
+ *   for N a power of two the DFT is an iterative radix-2 FFT. other sizes
+ *   use Bluestein's algorithm: with the chirp c( n ) = exp( -i pi n^2 / N ),
+ *   Z( k ) = c( k ) sum_n z( n ) c( n ) conj( c( k - n )), a convolution
+ *   that is done with radix-2 FFTs of length FFT_SIZE >= 2N - 1. below
+ *   DENSE_LIMIT the dense cosine table, O( N^2 ), is cheaper than that.
+ *   with VMMLIB_USE_BLAS and the cblas backend, sizes that are not a power
+ *   of two multiply with the cosine table in gemm instead, as the n-mode
+ *   product does, which beats Bluestein's constant factor up to N ~ 1000.
+ *   that needs the lines or their elements to be contiguous; other
+ *   layouts and the builtin backend take the FFT or dense path.
+ *
+ *   the transform works on many lines at once: 2 * BLOCK_SIZE lines are
+ *   gathered side by side into the workspace, so that every butterfly is a
+ *   loop over the block that the compiler can vectorize, and scattered
+ *   back. since the lines are real, one block goes into the real and one
+ *   into the imaginary part of the same complex FFT; the two spectra are
+ *   separated with the symmetry V( N - k ) = conj( V( k )).
+ *   element n of line l is data[ n * element_stride + l * line_stride ],
+ *   which covers the fibers of any tensor mode.
+ *
+ **
+ */
+
+namespace vmml
+{
+
+template< size_t N, typename T = double >
+class dct
+{
+public:
+    // width of the FFT block, 2 * BLOCK_SIZE lines are transformed together
+    static const size_t BLOCK_SIZE = 16;
+    static const size_t LINES = 2 * BLOCK_SIZE;
+
+    // sizes that are not a power of two and smaller than this use the
+    // dense table, larger ones Bluestein's FFT
+    static const size_t DENSE_LIMIT = 128;
+
+    // lines per gemm call on the BLAS path
+    static const size_t BLAS_LINES = 256;
+
+    static const bool POWER_OF_TWO = N >= 2 && ( N & ( N - 1 )) == 0;
+
+    // O( N log N ), dense otherwise
+    static const bool FAST = POWER_OF_TWO || N >= DENSE_LIMIT;
+
+    dct();
+
+    // DCT-II
+    void forward( vector< N, T >& x_ );
+    void forward( T* data_, size_t n_lines_, size_t element_stride_, size_t line_stride_ );
+
+    // DCT-III, the inverse of forward
+    void inverse( vector< N, T >& x_ );
+    void inverse( T* data_, size_t n_lines_, size_t element_stride_, size_t line_stride_ );
+
+    // length of the radix-2 FFTs, N for powers of two
+    size_t get_fft_size() const { return _fft_size; }
+
+protected:
+    void _transform( bool inverse_, T* data_, size_t n_lines_,
+                     size_t element_stride_, size_t line_stride_ );
+
+    // radix-2 FFT of length _fft_size on a block, input in bit-reversed order
+    void _fft( T* re_, T* im_ );
+
+    // N-point DFT of the block in _re, _im. the input is at _position[ m ],
+    // the output in natural order
+    void _dft();
+    void _bluestein();
+
+    void _forward_block();
+    void _inverse_block();
+    void _dense_block( bool inverse_ );
+#ifdef VMMLIB_USE_BLAS
+    void _gemm_transform( bool inverse_, T* data_, size_t n_lines_,
+                          size_t element_stride_, size_t line_stride_ );
+#endif
+
+    size_t                  _fft_size;
+    std::vector< T >        _re;
+    std::vector< T >        _im;
+    std::vector< T >        _work_re;
+    std::vector< T >        _work_im;
+    std::vector< T >        _tmp;
+    std::vector< T >        _twiddle_re;
+    std::vector< T >        _twiddle_im;
+    std::vector< T >        _shift_cos;
+    std::vector< T >        _shift_sin;
+    std::vector< T >        _scale;
+    std::vector< size_t >   _bit_reverse;
+    std::vector< size_t >   _position;
+    std::vector< size_t >   _permutation;
+    std::vector< T >        _chirp_re;
+    std::vector< T >        _chirp_im;
+    std::vector< T >        _kernel_re;
+    std::vector< T >        _kernel_im;
+    std::vector< T >        _cosines;
+    std::vector< T >        _gemm_out;
+
+}; // class dct
+
+
+
+template< size_t N, typename T >
+dct< N, T >::dct()
+    : _fft_size( N )
+    , _tmp( N * LINES )
+    , _scale( N )
+{
+    const double pi = 3.14159265358979323846;
+
+    for( size_t k = 0; k < N; ++k )
+        _scale[ k ] = T( std::sqrt(( k == 0 ? 1.0 : 2.0 ) / double( N )));
+
+    bool dense = ! FAST;
+#ifdef VMMLIB_USE_BLAS
+    if ( ! POWER_OF_TWO )
+    {
+        dense = true;
+        _gemm_out.resize( N * BLAS_LINES );
+    }
+#endif
+
+    if ( dense )
+    {
+        // _cosines[ k * N + n ] = w( k ) cos( pi ( 2n + 1 ) k / 2N )
+        _cosines.resize( N * N );
+        for( size_t k = 0; k < N; ++k )
+            for( size_t n = 0; n < N; ++n )
+                _cosines[ k * N + n ] = T( double( _scale[ k ] )
+                    * std::cos( pi * double(( 2 * n + 1 ) * k ) / double( 2 * N )));
+    }
+
+    if ( ! FAST )
+    {
+        _re.resize( N * LINES );
+        return;
+    }
+
+    if ( ! POWER_OF_TWO )
+    {
+        _fft_size = 1;
+        while( _fft_size < 2 * N - 1 )
+            _fft_size *= 2;
+    }
+    const size_t M = _fft_size;
+    _re.resize( M * BLOCK_SIZE );
+    _im.resize( M * BLOCK_SIZE );
+
+    _twiddle_re.resize( M / 2 );
+    _twiddle_im.resize( M / 2 );
+    for( size_t m = 0; m < M / 2; ++m )
+    {
+        _twiddle_re[ m ] = T( std::cos( 2.0 * pi * double( m ) / double( M )));
+        _twiddle_im[ m ] = T( -std::sin( 2.0 * pi * double( m ) / double( M )));
+    }
+
+    _shift_cos.resize( N );
+    _shift_sin.resize( N );
+    for( size_t k = 0; k < N; ++k )
+    {
+        _shift_cos[ k ] = T( std::cos( pi * double( k ) / double( 2 * N )));
+        _shift_sin[ k ] = T( std::sin( pi * double( k ) / double( 2 * N )));
+    }
+
+    size_t log_m = 0;
+    while(( size_t( 1 ) << log_m ) < M )
+        ++log_m;
+    _bit_reverse.resize( M );
+    for( size_t m = 0; m < M; ++m )
+    {
+        size_t r = 0;
+        for( size_t bit = 0; bit < log_m; ++bit )
+            if ( m & ( size_t( 1 ) << bit ))
+                r |= size_t( 1 ) << ( log_m - 1 - bit );
+        _bit_reverse[ m ] = r;
+    }
+
+    // the radix-2 FFT reads its input in bit-reversed order, Bluestein
+    // multiplies with the chirp first
+    _position.resize( N );
+    for( size_t m = 0; m < N; ++m )
+        _position[ m ] = POWER_OF_TWO ? _bit_reverse[ m ] : m;
+
+    // x( n ) goes to v( m ): even samples first, odd ones reversed
+    _permutation.resize( N );
+    for( size_t n = 0; n < N; ++n )
+        _permutation[ n ] = ( n % 2 == 0 ) ? n / 2 : N - 1 - n / 2;
+
+    if ( POWER_OF_TWO )
+        return;
+
+    // c( n ) = exp( -i pi n^2 / N ), n^2 mod 2N keeps the angle small
+    _chirp_re.resize( N );
+    _chirp_im.resize( N );
+    for( size_t n = 0; n < N; ++n )
+    {
+        const double angle = pi * double(( n * n ) % ( 2 * N )) / double( N );
+        _chirp_re[ n ] = T( std::cos( angle ));
+        _chirp_im[ n ] = T( -std::sin( angle ));
+    }
+
+    // spectrum of conj( c ) wrapped around to length M, divided by M for
+    // the inverse FFT; computed in the first column of the work block
+    _work_re.assign( M * BLOCK_SIZE, T( 0 ));
+    _work_im.assign( M * BLOCK_SIZE, T( 0 ));
+    for( size_t n = 0; n < N; ++n )
+    {
+        const size_t p0 = _bit_reverse[ n ] * BLOCK_SIZE;
+        _work_re[ p0 ] = _chirp_re[ n ];
+        _work_im[ p0 ] = -_chirp_im[ n ];
+        if ( n > 0 )
+        {
+            const size_t p1 = _bit_reverse[ M - n ] * BLOCK_SIZE;
+            _work_re[ p1 ] = _chirp_re[ n ];
+            _work_im[ p1 ] = -_chirp_im[ n ];
+        }
+    }
+    _fft( &_work_re[ 0 ], &_work_im[ 0 ] );
+    _kernel_re.resize( M );
+    _kernel_im.resize( M );
+    for( size_t k = 0; k < M; ++k )
+    {
+        _kernel_re[ k ] = _work_re[ k * BLOCK_SIZE ] / T( M );
+        _kernel_im[ k ] = _work_im[ k * BLOCK_SIZE ] / T( M );
+    }
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::forward( vector< N, T >& x_ )
+{
+    _transform( false, x_.array, 1, 1, N );
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::forward( T* data_, size_t n_lines_, size_t element_stride_,
+                      size_t line_stride_ )
+{
+    _transform( false, data_, n_lines_, element_stride_, line_stride_ );
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::inverse( vector< N, T >& x_ )
+{
+    _transform( true, x_.array, 1, 1, N );
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::inverse( T* data_, size_t n_lines_, size_t element_stride_,
+                      size_t line_stride_ )
+{
+    _transform( true, data_, n_lines_, element_stride_, line_stride_ );
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::_transform( bool inverse_, T* data_, size_t n_lines_,
+                         size_t element_stride_, size_t line_stride_ )
+{
+#ifdef VMMLIB_USE_BLAS
+    // gemm needs leading dimensions that do not overlap
+    const bool columns = element_stride_ == 1 && ( n_lines_ == 1 || line_stride_ >= N );
+    const bool rows = line_stride_ == 1 && element_stride_ >= n_lines_;
+    if ( ! POWER_OF_TWO && ! blas::config::get().use_builtin() && ( columns || rows ))
+    {
+        _gemm_transform( inverse_, data_, n_lines_, element_stride_, line_stride_ );
+        return;
+    }
+#endif
+
+    T* tmp = &_tmp[ 0 ];
+    for( size_t l0 = 0; l0 < n_lines_; l0 += LINES )
+    {
+        const size_t width = n_lines_ - l0 < LINES ? n_lines_ - l0 : LINES;
+        T* lines = data_ + l0 * line_stride_;
+
+        // gather, unused columns of the block are zero
+        for( size_t n = 0; n < N; ++n )
+        {
+            const T* src = lines + n * element_stride_;
+            T* row = tmp + n * LINES;
+            for( size_t b = 0; b < width; ++b )
+                row[ b ] = src[ b * line_stride_ ];
+            for( size_t b = width; b < LINES; ++b )
+                row[ b ] = T( 0 );
+        }
+
+        if ( ! FAST )
+            _dense_block( inverse_ );
+        else if ( inverse_ )
+            _inverse_block();
+        else
+            _forward_block();
+
+        // scatter
+        for( size_t n = 0; n < N; ++n )
+        {
+            T* dst = lines + n * element_stride_;
+            const T* row = tmp + n * LINES;
+            for( size_t b = 0; b < width; ++b )
+                dst[ b * line_stride_ ] = row[ b ];
+        }
+    }
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::_fft( T* re, T* im )
+{
+    const size_t M = _fft_size;
+    for( size_t half = 1; half < M; half *= 2 )
+    {
+        const size_t step = M / ( 2 * half );
+        for( size_t start = 0; start < M; start += 2 * half )
+        {
+            for( size_t j = 0; j < half; ++j )
+            {
+                const T w_re = _twiddle_re[ j * step ];
+                const T w_im = _twiddle_im[ j * step ];
+                T* a_re = re + ( start + j ) * BLOCK_SIZE;
+                T* a_im = im + ( start + j ) * BLOCK_SIZE;
+                T* b_re = a_re + half * BLOCK_SIZE;
+                T* b_im = a_im + half * BLOCK_SIZE;
+                for( size_t b = 0; b < BLOCK_SIZE; ++b )
+                {
+                    const T t_re = w_re * b_re[ b ] - w_im * b_im[ b ];
+                    const T t_im = w_re * b_im[ b ] + w_im * b_re[ b ];
+                    b_re[ b ] = a_re[ b ] - t_re;
+                    b_im[ b ] = a_im[ b ] - t_im;
+                    a_re[ b ] += t_re;
+                    a_im[ b ] += t_im;
+                }
+            }
+        }
+    }
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::_dft()
+{
+    if ( POWER_OF_TWO )
+        _fft( &_re[ 0 ], &_im[ 0 ] );
+    else
+        _bluestein();
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::_bluestein()
+{
+    const size_t M = _fft_size;
+    T* re = &_re[ 0 ];
+    T* im = &_im[ 0 ];
+    T* work_re = &_work_re[ 0 ];
+    T* work_im = &_work_im[ 0 ];
+
+    // a( n ) = z( n ) c( n ), zero padded to M, bit-reversed
+    std::fill( _work_re.begin(), _work_re.end(), T( 0 ));
+    std::fill( _work_im.begin(), _work_im.end(), T( 0 ));
+    for( size_t n = 0; n < N; ++n )
+    {
+        const T c = _chirp_re[ n ];
+        const T s = _chirp_im[ n ];
+        const T* z_re = re + n * BLOCK_SIZE;
+        const T* z_im = im + n * BLOCK_SIZE;
+        T* a_re = work_re + _bit_reverse[ n ] * BLOCK_SIZE;
+        T* a_im = work_im + _bit_reverse[ n ] * BLOCK_SIZE;
+        for( size_t b = 0; b < BLOCK_SIZE; ++b )
+        {
+            a_re[ b ] = z_re[ b ] * c - z_im[ b ] * s;
+            a_im[ b ] = z_re[ b ] * s + z_im[ b ] * c;
+        }
+    }
+
+    _fft( work_re, work_im );
+
+    // the inverse FFT of the product as conj( FFT( conj( . )))
+    for( size_t k = 0; k < M; ++k )
+    {
+        const T c = _kernel_re[ k ];
+        const T s = _kernel_im[ k ];
+        const T* a_re = work_re + k * BLOCK_SIZE;
+        const T* a_im = work_im + k * BLOCK_SIZE;
+        T* p_re = re + _bit_reverse[ k ] * BLOCK_SIZE;
+        T* p_im = im + _bit_reverse[ k ] * BLOCK_SIZE;
+        for( size_t b = 0; b < BLOCK_SIZE; ++b )
+        {
+            p_re[ b ] = a_re[ b ] * c - a_im[ b ] * s;
+            p_im[ b ] = -( a_re[ b ] * s + a_im[ b ] * c );
+        }
+    }
+
+    _fft( re, im );
+
+    // Z( k ) = c( k ) conj( . )
+    for( size_t k = 0; k < N; ++k )
+    {
+        const T c = _chirp_re[ k ];
+        const T s = _chirp_im[ k ];
+        T* z_re = re + k * BLOCK_SIZE;
+        T* z_im = im + k * BLOCK_SIZE;
+        for( size_t b = 0; b < BLOCK_SIZE; ++b )
+        {
+            const T f_re = z_re[ b ];
+            const T f_im = -z_im[ b ];
+            z_re[ b ] = f_re * c - f_im * s;
+            z_im[ b ] = f_re * s + f_im * c;
+        }
+    }
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::_forward_block()
+{
+    T* tmp = &_tmp[ 0 ];
+    T* re = &_re[ 0 ];
+    T* im = &_im[ 0 ];
+
+    // z = v_a + i v_b
+    for( size_t n = 0; n < N; ++n )
+    {
+        const T* src = tmp + n * LINES;
+        T* dst_re = re + _position[ _permutation[ n ]] * BLOCK_SIZE;
+        T* dst_im = im + _position[ _permutation[ n ]] * BLOCK_SIZE;
+        for( size_t b = 0; b < BLOCK_SIZE; ++b )
+        {
+            dst_re[ b ] = src[ b ];
+            dst_im[ b ] = src[ BLOCK_SIZE + b ];
+        }
+    }
+
+    _dft();
+
+    // V_a( k ) = ( Z( k ) + conj( Z( N - k ))) / 2,
+    // V_b( k ) = ( Z( k ) - conj( Z( N - k ))) / 2i,
+    // X( k ) = w( k ) Re( exp( -i pi k / 2N ) V( k ))
+    for( size_t k = 0; k < N; ++k )
+    {
+        const size_t nk = k == 0 ? 0 : N - k;
+        const T c = T( 0.5 ) * _scale[ k ] * _shift_cos[ k ];
+        const T s = T( 0.5 ) * _scale[ k ] * _shift_sin[ k ];
+        const T* z_re = re + k * BLOCK_SIZE;
+        const T* z_im = im + k * BLOCK_SIZE;
+        const T* zn_re = re + nk * BLOCK_SIZE;
+        const T* zn_im = im + nk * BLOCK_SIZE;
+        T* dst = tmp + k * LINES;
+        for( size_t b = 0; b < BLOCK_SIZE; ++b )
+        {
+            dst[ b ] = c * ( z_re[ b ] + zn_re[ b ] ) + s * ( z_im[ b ] - zn_im[ b ] );
+            dst[ BLOCK_SIZE + b ] = c * ( z_im[ b ] + zn_im[ b ] ) + s * ( zn_re[ b ] - z_re[ b ] );
+        }
+    }
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::_inverse_block()
+{
+    T* tmp = &_tmp[ 0 ];
+    T* re = &_re[ 0 ];
+    T* im = &_im[ 0 ];
+
+    // with a( k ) = X( k ) / ( w( k ) N ) and a( N ) = 0, the conjugate
+    // spectrum is W( k ) = exp( -i pi k / 2N ) ( a( k ) + i a( N - k )).
+    // its FFT is real, so Z = W_a + i W_b transforms to v_a + i v_b.
+    for( size_t k = 0; k < N; ++k )
+    {
+        const size_t nk = k == 0 ? 0 : N - k;
+        const T scale_k = T( 1 ) / ( _scale[ k ] * T( N ));
+        const T scale_nk = k == 0 ? T( 0 ) : T( 1 ) / ( _scale[ nk ] * T( N ));
+        const T c = _shift_cos[ k ];
+        const T s = _shift_sin[ k ];
+        const T* x_k = tmp + k * LINES;
+        const T* x_nk = tmp + nk * LINES;
+        T* dst_re = re + _position[ k ] * BLOCK_SIZE;
+        T* dst_im = im + _position[ k ] * BLOCK_SIZE;
+        for( size_t b = 0; b < BLOCK_SIZE; ++b )
+        {
+            const T a = scale_k * x_k[ b ];
+            const T a_n = scale_nk * x_nk[ b ];
+            const T b_ = scale_k * x_k[ BLOCK_SIZE + b ];
+            const T b_n = scale_nk * x_nk[ BLOCK_SIZE + b ];
+            // re( W_a ) - im( W_b ), im( W_a ) + re( W_b )
+            dst_re[ b ] = ( a * c + a_n * s ) - ( b_n * c - b_ * s );
+            dst_im[ b ] = ( a_n * c - a * s ) + ( b_ * c + b_n * s );
+        }
+    }
+
+    _dft();
+
+    // undo the permutation
+    for( size_t n = 0; n < N; ++n )
+    {
+        const T* src_re = re + _permutation[ n ] * BLOCK_SIZE;
+        const T* src_im = im + _permutation[ n ] * BLOCK_SIZE;
+        T* dst = tmp + n * LINES;
+        for( size_t b = 0; b < BLOCK_SIZE; ++b )
+        {
+            dst[ b ] = src_re[ b ];
+            dst[ BLOCK_SIZE + b ] = src_im[ b ];
+        }
+    }
+}
+
+
+
+template< size_t N, typename T >
+void
+dct< N, T >::_dense_block( bool inverse_ )
+{
+    T* tmp = &_tmp[ 0 ];
+    T* out = &_re[ 0 ];
+
+    // forward: out( k ) = sum_n C( k, n ) x( n ), inverse: out( n ) = sum_k C( k, n ) X( k )
+    T acc[ LINES ];
+    for( size_t i = 0; i < N; ++i )
+    {
+        for( size_t b = 0; b < LINES; ++b )
+            acc[ b ] = T( 0 );
+        for( size_t j = 0; j < N; ++j )
+        {
+            const T c = inverse_ ? _cosines[ j * N + i ] : _cosines[ i * N + j ];
+            const T* src = tmp + j * LINES;
+            for( size_t b = 0; b < LINES; ++b )
+                acc[ b ] += c * src[ b ];
+        }
+        T* dst = out + i * LINES;
+        for( size_t b = 0; b < LINES; ++b )
+            dst[ b ] = acc[ b ];
+    }
+
+    for( size_t i = 0; i < N * LINES; ++i )
+        tmp[ i ] = out[ i ];
+}
+
+
+
+#ifdef VMMLIB_USE_BLAS
+template< size_t N, typename T >
+void
+dct< N, T >::_gemm_transform( bool inverse_, T* data_, size_t n_lines_,
+                              size_t element_stride_, size_t line_stride_ )
+{
+    // _cosines holds C row by row, i.e. C^T in column-major order
+    T* out = &_gemm_out[ 0 ];
+
+    blas::dgemm_params< T > p;
+    p.order = CblasColMajor;
+    p.alpha = T( 1 );
+    p.beta  = T( 0 );
+    p.c     = out;
+
+    for( size_t l0 = 0; l0 < n_lines_; l0 += BLAS_LINES )
+    {
+        const size_t width = n_lines_ - l0 < BLAS_LINES ? n_lines_ - l0 : BLAS_LINES;
+        T* lines = data_ + l0 * line_stride_;
+
+        if ( element_stride_ == 1 && ( n_lines_ == 1 || line_stride_ >= N ))
+        {
+            // the lines are the columns of the N x width matrix X,
+            // forward C X, inverse C^T X
+            p.trans_a = inverse_ ? CblasNoTrans : CblasTrans;
+            p.trans_b = CblasNoTrans;
+            p.m       = N;
+            p.n       = width;
+            p.k       = N;
+            p.a       = &_cosines[ 0 ];
+            p.lda     = N;
+            p.b       = lines;
+            p.ldb     = line_stride_ < N ? N : line_stride_;
+            p.ldc     = N;
+            blas::dgemm_call< T >( p );
+
+            for( size_t l = 0; l < width; ++l )
+                for( size_t n = 0; n < N; ++n )
+                    lines[ l * line_stride_ + n ] = out[ l * N + n ];
+        }
+        else
+        {
+            // the lines are the rows of the width x N matrix X^T,
+            // forward X^T C^T, inverse X^T C
+            p.trans_a = CblasNoTrans;
+            p.trans_b = inverse_ ? CblasTrans : CblasNoTrans;
+            p.m       = width;
+            p.n       = N;
+            p.k       = N;
+            p.a       = lines;
+            p.lda     = element_stride_;
+            p.b       = &_cosines[ 0 ];
+            p.ldb     = N;
+            p.ldc     = width;
+            blas::dgemm_call< T >( p );
+
+            for( size_t n = 0; n < N; ++n )
+                for( size_t l = 0; l < width; ++l )
+                    lines[ n * element_stride_ + l ] = out[ n * width + l ];
+        }
+    }
+}
+#endif
+
+
+} // namespace vmml
+
+#endif
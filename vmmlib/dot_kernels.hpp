@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__DOT_KERNELS__HPP__
+#define __VMML__DOT_KERNELS__HPP__
+
+#include <vmmlib/exception.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#ifdef VMMLIB_USE_OPENMP
+#  include <omp.h>
+#endif
+
+/**
+ *  dot products, squared norms and squared distances over raw, contiguous
+ *  spans of any arithmetic type, accumulated in double precision.
+ *
+ *  the span is cut into chunks of DOT_CHUNK_SIZE elements. every chunk is
+ *  reduced into one partial sum (in parallel when VMMLIB_USE_OPENMP is set)
+ *  and the partial sums are combined in a fixed order afterwards. since the
+ *  chunk boundaries only depend on the length of the span, the result is
+ *  bitwise identical for any number of threads.
+ *
+ *  inside a chunk, the summation_type selects the accuracy / speed tradeoff:
+ *
+ *  SUMMATION_PLAIN     eight independent accumulators, so the loop is not
+ *                      serialized on the latency of a single add
+ *  SUMMATION_PAIRWISE  recursive pairwise summation down to blocks of
+ *                      DOT_PAIRWISE_BLOCK elements (error grows with log n)
+ *  SUMMATION_KAHAN     four Kahan-compensated accumulators; the partial
+ *                      sums are combined with compensation as well
+ *
+ *  note that -ffast-math lets the compiler optimize the compensation away.
+ */
+
+namespace vmml
+{
+namespace kernels
+{
+
+enum summation_type
+{
+    SUMMATION_PLAIN,
+    SUMMATION_PAIRWISE,
+    SUMMATION_KAHAN
+};
+
+static const size_t DOT_CHUNK_SIZE = 8192;
+static const size_t DOT_PAIRWISE_BLOCK = 128;
+
+
+template< typename T >
+double dot( const T* x, const T* y, size_t n,
+    summation_type summation = SUMMATION_PAIRWISE );
+
+template< typename T >
+double squared_norm( const T* x, size_t n,
+    summation_type summation = SUMMATION_PAIRWISE );
+
+template< typename T >
+double norm( const T* x, size_t n,
+    summation_type summation = SUMMATION_PAIRWISE );
+
+// squared euclidean norm of x - y
+template< typename T >
+double squared_distance( const T* x, const T* y, size_t n,
+    summation_type summation = SUMMATION_PAIRWISE );
+
+template< typename T >
+double distance( const T* x, const T* y, size_t n,
+    summation_type summation = SUMMATION_PAIRWISE );
+
+
+namespace detail
+{
+
+// the per-element terms of the reductions; y is ignored by square_term
+template< typename T >
+struct dot_term
+{
+    static double get( const T* x, const T* y, size_t i )
+    {
+        return double( x[ i ] ) * double( y[ i ] );
+    }
+};
+
+template< typename T >
+struct square_term
+{
+    static double get( const T* x, const T*, size_t i )
+    {
+        const double value = double( x[ i ] );
+        return value * value;
+    }
+};
+
+template< typename T >
+struct difference_square_term
+{
+    static double get( const T* x, const T* y, size_t i )
+    {
+        const double diff = double( x[ i ] ) - double( y[ i ] );
+        return diff * diff;
+    }
+};
+
+
+inline void
+kahan_add( double& sum, double& compensation, const double value )
+{
+    const double corrected = value - compensation;
+    const double new_sum = sum + corrected;
+    compensation = ( new_sum - sum ) - corrected;
+    sum = new_sum;
+}
+
+
+template< typename term_t, typename T >
+inline double
+sum_plain( const T* x, const T* y, const size_t n )
+{
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    double s4 = 0.0, s5 = 0.0, s6 = 0.0, s7 = 0.0;
+    // bound the unrolled loop by a multiple of 8, i + 8 <= n leaves the
+    // trip count of the remainder loop unknown to the compiler
+    const size_t n_unrolled = n - n % 8;
+    size_t i = 0;
+    for( ; i < n_unrolled; i += 8 )
+    {
+        s0 += term_t::get( x, y, i );
+        s1 += term_t::get( x, y, i + 1 );
+        s2 += term_t::get( x, y, i + 2 );
+        s3 += term_t::get( x, y, i + 3 );
+        s4 += term_t::get( x, y, i + 4 );
+        s5 += term_t::get( x, y, i + 5 );
+        s6 += term_t::get( x, y, i + 6 );
+        s7 += term_t::get( x, y, i + 7 );
+    }
+    for( ; i < n; ++i )
+    {
+        s0 += term_t::get( x, y, i );
+    }
+    return ( ( s0 + s1 ) + ( s2 + s3 ) ) + ( ( s4 + s5 ) + ( s6 + s7 ) );
+}
+
+
+template< typename term_t, typename T >
+inline double
+sum_pairwise( const T* x, const T* y, const size_t n )
+{
+    if ( n <= DOT_PAIRWISE_BLOCK )
+        return sum_plain< term_t >( x, y, n );
+
+    // split at a multiple of 8 to keep the unrolled loops busy
+    const size_t half = ( n / 2 + 7 ) & ~size_t( 7 );
+    return sum_pairwise< term_t >( x, y, half )
+        + sum_pairwise< term_t >( x + half, y + half, n - half );
+}
+
+
+template< typename term_t, typename T >
+inline double
+sum_kahan( const T* x, const T* y, const size_t n )
+{
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    double c0 = 0.0, c1 = 0.0, c2 = 0.0, c3 = 0.0;
+    const size_t n_unrolled = n - n % 4;
+    size_t i = 0;
+    for( ; i < n_unrolled; i += 4 )
+    {
+        kahan_add( s0, c0, term_t::get( x, y, i ) );
+        kahan_add( s1, c1, term_t::get( x, y, i + 1 ) );
+        kahan_add( s2, c2, term_t::get( x, y, i + 2 ) );
+        kahan_add( s3, c3, term_t::get( x, y, i + 3 ) );
+    }
+    for( ; i < n; ++i )
+    {
+        kahan_add( s0, c0, term_t::get( x, y, i ) );
+    }
+    kahan_add( s0, c0, s1 );
+    kahan_add( s0, c0, -c1 );
+    kahan_add( s0, c0, s2 );
+    kahan_add( s0, c0, -c2 );
+    kahan_add( s0, c0, s3 );
+    kahan_add( s0, c0, -c3 );
+    return s0 - c0;
+}
+
+
+template< typename term_t, typename T >
+inline double
+sum_chunk( const T* x, const T* y, const size_t n, const summation_type summation )
+{
+    switch( summation )
+    {
+    case SUMMATION_PLAIN:
+        return sum_plain< term_t >( x, y, n );
+    case SUMMATION_PAIRWISE:
+        return sum_pairwise< term_t >( x, y, n );
+    case SUMMATION_KAHAN:
+        return sum_kahan< term_t >( x, y, n );
+    default:
+        VMMLIB_ERROR( "unknown summation type", VMMLIB_HERE );
+    }
+    return 0.0;
+}
+
+
+inline double
+combine_pairwise( const double* partials, const size_t count )
+{
+    if ( count == 1 )
+        return partials[ 0 ];
+
+    const size_t half = count / 2;
+    return combine_pairwise( partials, half )
+        + combine_pairwise( partials + half, count - half );
+}
+
+
+inline double
+combine_kahan( const double* partials, const size_t count )
+{
+    double sum = 0.0;
+    double compensation = 0.0;
+    for( size_t i = 0; i < count; ++i )
+    {
+        kahan_add( sum, compensation, partials[ i ] );
+    }
+    return sum - compensation;
+}
+
+
+template< typename term_t, typename T >
+double
+reduce( const T* x, const T* y, const size_t n, const summation_type summation )
+{
+    if ( n <= DOT_CHUNK_SIZE )
+        return sum_chunk< term_t >( x, y, n, summation );
+
+    const long num_chunks = long( ( n + DOT_CHUNK_SIZE - 1 ) / DOT_CHUNK_SIZE );
+    std::vector< double > partials( num_chunks );
+
+#pragma omp parallel for schedule(static)
+    for( long chunk = 0; chunk < num_chunks; ++chunk )
+    {
+        const size_t offset = size_t( chunk ) * DOT_CHUNK_SIZE;
+        const size_t length = n - offset < DOT_CHUNK_SIZE ? n - offset : DOT_CHUNK_SIZE;
+        partials[ chunk ] = sum_chunk< term_t >( x + offset, y + offset, length, summation );
+    }
+
+    if ( summation == SUMMATION_KAHAN )
+        return combine_kahan( &partials[ 0 ], partials.size() );
+    return combine_pairwise( &partials[ 0 ], partials.size() );
+}
+
+} // namespace detail
+
+
+template< typename T >
+double
+dot( const T* x, const T* y, size_t n, summation_type summation )
+{
+    return detail::reduce< detail::dot_term< T > >( x, y, n, summation );
+}
+
+
+template< typename T >
+double
+squared_norm( const T* x, size_t n, summation_type summation )
+{
+    return detail::reduce< detail::square_term< T > >( x, x, n, summation );
+}
+
+
+template< typename T >
+double
+norm( const T* x, size_t n, summation_type summation )
+{
+    return sqrt( squared_norm( x, n, summation ) );
+}
+
+
+template< typename T >
+double
+squared_distance( const T* x, const T* y, size_t n, summation_type summation )
+{
+    return detail::reduce< detail::difference_square_term< T > >( x, y, n, summation );
+}
+
+
+template< typename T >
+double
+distance( const T* x, const T* y, size_t n, summation_type summation )
+{
+    return sqrt( squared_distance( x, y, n, summation ) );
+}
+
+} // namespace kernels
+} // namespace vmml
+
+#endif
@@ -0,0 +1,591 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__INCREMENTAL_SVD__HPP__
+#define __VMML__INCREMENTAL_SVD__HPP__
+
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+#include <vmmlib/exception.hpp>
+#include <vmmlib/lapack_svd.hpp>
+#include <vmmlib/lapack_sym_eigs.hpp>
+#include <vmmlib/qr_decomposition.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ *
+ *   incremental (Brand) SVD of a growing M x n matrix A whose columns
+ *   arrive one by one, truncated to rank R <= M. only the left basis U
+ *   (M x R) and the singular values are kept; the right singular vectors
+ *   grow with n and are not stored.
+ *
+ *   the basis is stored as U = U0 * Up: U0 has orthonormal columns, up to
+ *   C = min( 2 R, M ) of them, and the small C x R matrix Up has orthonormal
+ *   columns.
+ *
+ *   add_column projects the new column c onto U0, x = U0^T c, with the
+ *   residual r = c - U0 x. p = Up^T x are the coefficients in the basis and
+ *   z = x - Up p the part of c in span( U0 ) the basis does not cover
+ *   (directions dropped by earlier truncations). the SVD of the small core
+ *   matrix
+ *
+ *       K = | diag( sigma )  p   |    nu = | [ z, |r| ] |
+ *           |       0        nu  |
+ *
+ *   rotates [ U, ( U0 z + r ) / nu ] into the new basis, which is truncated
+ *   back to R columns. only Up changes: r / |r| is appended to U0 and Up
+ *   becomes [ Up, [ z; |r| ] / nu ] * Uc, so a sample costs O( M R + R^3 ).
+ *   U0 is folded, U0 = U0 * Up and Up = I, at O( M R^2 ) only when it runs
+ *   out of columns (at most every R samples) and on reorthogonalization.
+ *
+ *   downdate removes a column that was added before. it works on the gram
+ *   matrix U diag( sigma^2 ) U^T - c c^T and does not need the right
+ *   singular vectors; singular values below sqrt( eps ) * sigma_max lose
+ *   their relative accuracy and are dropped.
+ *
+ *   the basis slowly loses orthogonality under rounding errors. every
+ *   reorthogonalization interval updates it is restored with a householder
+ *   QR, U = Q Rq, followed by an SVD of Rq * diag( sigma ).
+ *
+ *   the core SVDs and eigen decompositions use lapack_svd and
+ *   lapack_sym_eigs, which are allocated once per object.
+ *
+ **
+ */
+
+namespace vmml
+{
+
+template< size_t M, size_t R, typename T = double >
+class incremental_svd
+{
+public:
+    typedef matrix< M, R, T >           basis_type;
+    typedef vector< M, T >              column_type;
+    typedef vector< R, T >              sigma_type;
+    typedef matrix< R, R, T >           rotation_type;
+    typedef matrix< R + 1, R + 1, T >   core_type;
+    typedef vector< R + 1, T >          core_sigma_type;
+
+    static const size_t DEFAULT_REORTHOGONALIZATION_INTERVAL = 64;
+
+    // columns of U0
+    static const size_t CAPACITY = 2 * R < M ? 2 * R : M;
+
+    incremental_svd();
+    ~incremental_svd();
+
+    // forgets all columns
+    void reset();
+
+    // appends the column c_ to A
+    void add_column( const column_type& c_ );
+
+    // removes the column c_, which must have been added before
+    void downdate( const column_type& c_ );
+
+    // keeps the rank_ largest singular values and their basis vectors
+    void truncate( size_t rank_ );
+
+    // restores the orthogonality of the basis
+    void reorthogonalize();
+
+    // U (M x R), columns beyond the rank are zero
+    void get_basis( basis_type& U_ ) const;
+
+    // U^T c_, the coefficients of c_ in the basis
+    void project( const column_type& c_, sigma_type& coefficients_ ) const;
+
+    const sigma_type& get_singular_values() const { return _sigma; }
+    size_t get_rank() const { return _rank; }
+    size_t get_sample_count() const { return _n_samples; }
+
+    // relative size of the residual below which a column is treated as
+    // lying in the span of the basis, default sqrt( eps )
+    void set_tolerance( T tolerance_ ) { _tolerance = tolerance_; }
+    T get_tolerance() const { return _tolerance; }
+
+    // 0 disables the periodic reorthogonalization
+    void set_reorthogonalization_interval( size_t interval_ ) { _reorthogonalization_interval = interval_; }
+    size_t get_reorthogonalization_interval() const { return _reorthogonalization_interval; }
+
+protected:
+    typedef matrix< M, CAPACITY, T >    u0_type;
+    typedef matrix< CAPACITY, R, T >    up_type;
+    typedef vector< CAPACITY, T >       u0_coefficients_type;
+
+    struct workspace
+    {
+        column_type         residual;
+        u0_coefficients_type x;
+        u0_coefficients_type z;
+        sigma_type          p;
+        sigma_type          tau;
+        core_type           core;
+        core_type           core_u;
+        core_type           core_vt;
+        core_sigma_type     core_sigma;
+        rotation_type       gram;
+        rotation_type       eigvectors;
+        sigma_type          eigvalues;
+        up_type             rotation;
+        lapack_svd< R + 1, R + 1, T >   core_svd;
+        lapack_sym_eigs< R, T >         gram_eigs;
+    };
+
+    // x = U0^T c_ on the first _cols entries, p = Up^T x on the first _rank
+    void _project( const column_type& c_, u0_coefficients_type& x_, sigma_type& p_ ) const;
+
+    // U0 = U0 * Up( :, 0:keep_ ), Up = I, drops everything beyond keep_
+    void _fold( size_t keep_ );
+
+    void _svd_of_core();
+
+    u0_type*        _u0;
+    basis_type*     _u0_tmp;
+    up_type         _up;
+    sigma_type      _sigma;
+    workspace*      _work;
+
+    size_t          _cols;
+    size_t          _rank;
+    size_t          _n_samples;
+    size_t          _n_updates;
+    size_t          _reorthogonalization_interval;
+    T               _tolerance;
+
+private:
+    // owns the workspace
+    incremental_svd( const incremental_svd& );
+    incremental_svd& operator=( const incremental_svd& );
+
+}; // class incremental_svd
+
+
+
+template< size_t M, size_t R, typename T >
+incremental_svd< M, R, T >::incremental_svd()
+    : _u0( new u0_type )
+    , _u0_tmp( new basis_type )
+    , _work( new workspace )
+    , _reorthogonalization_interval( DEFAULT_REORTHOGONALIZATION_INTERVAL )
+    , _tolerance( std::sqrt( std::numeric_limits< T >::epsilon() ))
+{
+    // eigenvalues to eps * | gram |, the default absolute tolerance is too coarse
+    _work->gram_eigs.p.abstol = 0;
+    reset();
+}
+
+
+
+template< size_t M, size_t R, typename T >
+incremental_svd< M, R, T >::~incremental_svd()
+{
+    delete _u0;
+    delete _u0_tmp;
+    delete _work;
+}
+
+
+
+template< size_t M, size_t R, typename T >
+void
+incremental_svd< M, R, T >::reset()
+{
+    _u0->zero();
+    _up.zero();
+    _sigma = T( 0 );
+    _cols       = 0;
+    _rank       = 0;
+    _n_samples  = 0;
+    _n_updates  = 0;
+}
+
+
+
+template< size_t M, size_t R, typename T >
+void
+incremental_svd< M, R, T >::_project( const column_type& c_, u0_coefficients_type& x_,
+                                      sigma_type& p_ ) const
+{
+    const T* u0 = _u0->array;
+    for( size_t j = 0; j < _cols; ++j )
+    {
+        const T* u0_j = u0 + j * M;
+        T sum = 0;
+        for( size_t i = 0; i < M; ++i )
+            sum += u0_j[ i ] * c_.array[ i ];
+        x_( j ) = sum;
+    }
+
+    for( size_t i = 0; i < _rank; ++i )
+    {
+        T sum = 0;
+        for( size_t j = 0; j < _cols; ++j )
+            sum += _up( j, i ) * x_( j );
+        p_( i ) = sum;
+    }
+}
+
+
+
+template< size_t M, size_t R, typename T >
+void
+incremental_svd< M, R, T >::_svd_of_core()
+{
+    workspace& w = *_work;
+    if ( ! w.core_svd.compute( w.core, w.core_u, w.core_sigma, w.core_vt ))
+    {
+        VMMLIB_ERROR( "incremental_svd - svd of the core matrix failed.", VMMLIB_HERE );
+    }
+}
+
+
+
+template< size_t M, size_t R, typename T >
+void
+incremental_svd< M, R, T >::add_column( const column_type& c_ )
+{
+    workspace& w = *_work;
+    const size_t k = _rank;
+
+    // make room for the residual
+    if ( _cols == CAPACITY && _cols > k )
+        _fold( k );
+    const size_t cols = _cols;
+    T* u0 = _u0->array;
+
+    // r = c - U0 U0^T c, twice for a residual orthogonal to working precision
+    w.residual = c_;
+    T* r = w.residual.array;
+    for( size_t j = 0; j < cols; ++j )
+        w.x( j ) = 0;
+    for( size_t pass = 0; pass < 2; ++pass )
+    {
+        for( size_t j = 0; j < cols; ++j )
+        {
+            const T* u0_j = u0 + j * M;
+            T y = 0;
+            for( size_t i = 0; i < M; ++i )
+                y += u0_j[ i ] * r[ i ];
+            for( size_t i = 0; i < M; ++i )
+                r[ i ] -= y * u0_j[ i ];
+            w.x( j ) += y;
+        }
+    }
+
+    T c_norm = 0, rho = 0;
+    for( size_t i = 0; i < M; ++i )
+    {
+        c_norm += c_.array[ i ] * c_.array[ i ];
+        rho += r[ i ] * r[ i ];
+    }
+    c_norm = std::sqrt( c_norm );
+    rho = std::sqrt( rho );
+
+    // p = Up^T x, z = x - Up p
+    for( size_t i = 0; i < k; ++i )
+    {
+        T sum = 0;
+        for( size_t j = 0; j < cols; ++j )
+            sum += _up( j, i ) * w.x( j );
+        w.p( i ) = sum;
+    }
+    T nu = 0;
+    for( size_t j = 0; j < cols; ++j )
+    {
+        T sum = w.x( j );
+        for( size_t i = 0; i < k; ++i )
+            sum -= _up( j, i ) * w.p( i );
+        w.z( j ) = sum;
+        nu += sum * sum;
+    }
+
+    const bool append = rho > _tolerance * c_norm && cols < CAPACITY;
+    if ( append )
+        nu += rho * rho;
+    nu = std::sqrt( nu );
+
+    ++_n_samples;
+    const bool expand = nu > _tolerance * c_norm;
+    if ( k == 0 && ! expand )
+        return;
+
+    w.core.zero();
+    for( size_t i = 0; i < k; ++i )
+    {
+        w.core( i, i ) = _sigma( i );
+        w.core( i, k ) = w.p( i );
+    }
+    if ( expand )
+        w.core( k, k ) = nu;
+    _svd_of_core();
+
+    if ( expand )
+    {
+        // U0 = [ U0, r / rho ], Up = [ Up, [ z; rho ] / nu ] * Uc( :, 0:k1 )
+        const size_t k1 = (std::min)( k + 1, R );
+        const size_t cols1 = append ? cols + 1 : cols;
+        const T inv_nu = T( 1 ) / nu;
+        for( size_t j = 0; j < k1; ++j )
+        {
+            const T s = w.core_u( k, j ) * inv_nu;
+            for( size_t i = 0; i < cols; ++i )
+            {
+                T sum = w.z( i ) * s;
+                for( size_t l = 0; l < k; ++l )
+                    sum += _up( i, l ) * w.core_u( l, j );
+                w.rotation( i, j ) = sum;
+            }
+            if ( append )
+                w.rotation( cols, j ) = rho * s;
+        }
+        for( size_t j = 0; j < k1; ++j )
+            for( size_t i = 0; i < cols1; ++i )
+                _up( i, j ) = w.rotation( i, j );
+
+        if ( append )
+        {
+            T* u0_new = u0 + cols * M;
+            const T inv_rho = T( 1 ) / rho;
+            for( size_t i = 0; i < M; ++i )
+                u0_new[ i ] = r[ i ] * inv_rho;
+        }
+        _cols = cols1;
+        _rank = k1;
+    }
+    else
+    {
+        // c is in the span of U, only the rotation changes: Up = Up * Uc
+        for( size_t j = 0; j < k; ++j )
+        {
+            for( size_t i = 0; i < cols; ++i )
+            {
+                T sum = 0;
+                for( size_t l = 0; l < k; ++l )
+                    sum += _up( i, l ) * w.core_u( l, j );
+                w.rotation( i, j ) = sum;
+            }
+        }
+        for( size_t j = 0; j < k; ++j )
+            for( size_t i = 0; i < cols; ++i )
+                _up( i, j ) = w.rotation( i, j );
+    }
+
+    for( size_t i = 0; i < R; ++i )
+        _sigma( i ) = i < _rank ? w.core_sigma( i ) : T( 0 );
+
+    ++_n_updates;
+    if ( _reorthogonalization_interval != 0
+        && _n_updates % _reorthogonalization_interval == 0 )
+        reorthogonalize();
+}
+
+
+
+template< size_t M, size_t R, typename T >
+void
+incremental_svd< M, R, T >::downdate( const column_type& c_ )
+{
+    if ( _rank == 0 )
+        return;
+
+    workspace& w = *_work;
+    const size_t k = _rank;
+    _project( c_, w.x, w.p );
+
+    // U diag( sigma^2 ) U^T - c c^T = U ( diag( sigma^2 ) - p p^T ) U^T
+    w.gram.zero();
+    for( size_t j = 0; j < k; ++j )
+    {
+        for( size_t i = 0; i < k; ++i )
+            w.gram( i, j ) = -w.p( i ) * w.p( j );
+        w.gram( j, j ) += _sigma( j ) * _sigma( j );
+    }
+
+    if ( ! w.gram_eigs.compute_all( w.gram, w.eigvectors, w.eigvalues ))
+    {
+        VMMLIB_ERROR( "incremental_svd - eigen decomposition of the core matrix failed.", VMMLIB_HERE );
+    }
+
+    // eigenvalues are ascending, the k largest belong to the basis
+    for( size_t j = 0; j < k; ++j )
+    {
+        const size_t src = R - 1 - j;
+        const T lambda = w.eigvalues( src );
+        _sigma( j ) = lambda > T( 0 ) ? std::sqrt( lambda ) : T( 0 );
+        for( size_t i = 0; i < _cols; ++i )
+        {
+            T sum = 0;
+            for( size_t l = 0; l < k; ++l )
+                sum += _up( i, l ) * w.eigvectors( l, src );
+            w.rotation( i, j ) = sum;
+        }
+    }
+    for( size_t j = 0; j < k; ++j )
+        for( size_t i = 0; i < _cols; ++i )
+            _up( i, j ) = w.rotation( i, j );
+
+    if ( _n_samples > 0 )
+        --_n_samples;
+
+    size_t rank = 0;
+    while( rank < k && _sigma( rank ) > _tolerance * _sigma( 0 ))
+        ++rank;
+    if ( rank < k )
+        _fold( rank );
+}
+
+
+
+template< size_t M, size_t R, typename T >
+void
+incremental_svd< M, R, T >::truncate( size_t rank_ )
+{
+    if ( rank_ < _rank )
+        _fold( rank_ );
+}
+
+
+
+template< size_t M, size_t R, typename T >
+void
+incremental_svd< M, R, T >::_fold( size_t keep_ )
+{
+    T* u0 = _u0->array;
+    T* u0_new = _u0_tmp->array;
+    for( size_t j = 0; j < keep_; ++j )
+    {
+        T* out_j = u0_new + j * M;
+        for( size_t i = 0; i < M; ++i )
+            out_j[ i ] = 0;
+        for( size_t l = 0; l < _cols; ++l )
+        {
+            const T s_l = _up( l, j );
+            const T* u0_l = u0 + l * M;
+            for( size_t i = 0; i < M; ++i )
+                out_j[ i ] += s_l * u0_l[ i ];
+        }
+    }
+    std::copy( u0_new, u0_new + keep_ * M, u0 );
+
+    _up.zero();
+    for( size_t j = 0; j < keep_; ++j )
+        _up( j, j ) = 1;
+    for( size_t j = keep_; j < R; ++j )
+        _sigma( j ) = 0;
+    _cols = keep_;
+    _rank = keep_;
+}
+
+
+
+template< size_t M, size_t R, typename T >
+void
+incremental_svd< M, R, T >::reorthogonalize()
+{
+    if ( _rank == 0 )
+        return;
+
+    workspace& w = *_work;
+    const size_t k = _rank;
+    _fold( k );
+
+    // U0 = Q Rq, Rq diag( sigma ) = Uc diag( sigma' ) Vc^T, U0 = Q Uc
+    T* u0 = _u0->array;
+    T* q = _u0_tmp->array;
+    qr_householder_factorize< T >( M, k, u0, M, w.tau.array );
+    w.core.zero();
+    for( size_t j = 0; j < k; ++j )
+        for( size_t i = 0; i <= j; ++i )
+            w.core( i, j ) = u0[ j * M + i ] * _sigma( j );
+    qr_householder_thin_q< T >( M, k, u0, M, w.tau.array, q, M );
+    _svd_of_core();
+
+    for( size_t j = 0; j < k; ++j )
+    {
+        T* out_j = u0 + j * M;
+        for( size_t i = 0; i < M; ++i )
+            out_j[ i ] = 0;
+        for( size_t l = 0; l < k; ++l )
+        {
+            const T s_l = w.core_u( l, j );
+            const T* q_l = q + l * M;
+            for( size_t i = 0; i < M; ++i )
+                out_j[ i ] += s_l * q_l[ i ];
+        }
+        _sigma( j ) = w.core_sigma( j );
+    }
+}
+
+
+
+template< size_t M, size_t R, typename T >
+void
+incremental_svd< M, R, T >::get_basis( basis_type& U_ ) const
+{
+    const T* u0 = _u0->array;
+    for( size_t j = 0; j < R; ++j )
+    {
+        T* out_j = U_.array + j * M;
+        for( size_t i = 0; i < M; ++i )
+            out_j[ i ] = 0;
+        if ( j >= _rank )
+            continue;
+        for( size_t l = 0; l < _cols; ++l )
+        {
+            const T s_l = _up( l, j );
+            const T* u0_l = u0 + l * M;
+            for( size_t i = 0; i < M; ++i )
+                out_j[ i ] += s_l * u0_l[ i ];
+        }
+    }
+}
+
+
+
+template< size_t M, size_t R, typename T >
+void
+incremental_svd< M, R, T >::project( const column_type& c_,
+                                     sigma_type& coefficients_ ) const
+{
+    u0_coefficients_type x;
+    coefficients_ = T( 0 );
+    _project( c_, x, coefficients_ );
+}
+
+
+} // namespace vmml
+
+#endif
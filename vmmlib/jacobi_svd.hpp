@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__JACOBI_SVD__HPP__
+#define __VMML__JACOBI_SVD__HPP__
+
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ *
+ *   singular value decomposition of small, fixed-size matrices with the
+ *   one-sided Jacobi method (Hestenes): plane rotations are applied to the
+ *   columns of A until they are mutually orthogonal, A * V = U * diag( sigma ).
+ *   the column norms are the singular values.
+ *
+ *   a fixed number of cyclic sweeps is run; rotations of column pairs that
+ *   are already orthogonal to working precision are skipped. all loop bounds
+ *   are known at compile time and everything lives on the stack, so there
+ *   are no allocations and no data-dependent loops. the accuracy is high
+ *   even for small singular values, since A^T * A is never formed.
+ *
+ *   the interface mirrors lapack_svd: sigma is sorted in descending order,
+ *   U is M x N and Vt is N x N. columns of U that belong to a zero singular
+ *   value are set to zero. meant for M, N <= 8 or so; lapack_svd is faster
+ *   for larger matrices.
+ *
+ **
+ */
+
+namespace vmml
+{
+
+template< size_t M, size_t N, typename T = double >
+class jacobi_svd
+{
+public:
+    typedef matrix< M, N, T >   matrix_mn_type;
+    typedef matrix< N, N, T >   matrix_nn_type;
+    typedef vector< N, T >      vector_type;
+
+    // double precision is reached after 4-5 sweeps for N <= 4 and after
+    // 6 for N <= 8, one more is run for safety
+    static const size_t DEFAULT_SWEEPS = N <= 4 ? 6 : 7;
+
+    jacobi_svd( size_t n_sweeps_ = DEFAULT_SWEEPS );
+
+    // reduced SVD, A = U * diag( sigma ) * Vt
+    bool compute( const matrix_mn_type& A, matrix_mn_type& U,
+                  vector_type& sigma, matrix_nn_type& Vt );
+
+    // singular values only
+    bool compute( const matrix_mn_type& A, vector_type& sigma );
+
+    // overwrites A with U
+    bool compute_and_overwrite_input( matrix_mn_type& A_U, vector_type& sigma );
+
+    bool compute_and_overwrite_input( matrix_mn_type& A_U, vector_type& sigma,
+                                      matrix_nn_type& Vt );
+
+    void set_sweeps( size_t n_sweeps_ ) { _n_sweeps = n_sweeps_; }
+    size_t get_sweeps() const { return _n_sweeps; }
+
+    // the decomposition on raw column-major storage: a_ (M x N) is replaced
+    // by U, v_ (N x N, V not transposed) may be 0.
+    static void decompose( T* a_, T* sigma_, T* v_, size_t n_sweeps_ );
+
+protected:
+    size_t  _n_sweeps;
+
+}; // class jacobi_svd
+
+
+
+template< size_t M, size_t N, typename T >
+jacobi_svd< M, N, T >::jacobi_svd( size_t n_sweeps_ )
+    : _n_sweeps( n_sweeps_ )
+{}
+
+
+
+template< size_t M, size_t N, typename T >
+void
+jacobi_svd< M, N, T >::decompose( T* a_, T* sigma_, T* v_, size_t n_sweeps_ )
+{
+    const T tiny = (std::numeric_limits< T >::min)();
+    const T eps2 = std::numeric_limits< T >::epsilon() * std::numeric_limits< T >::epsilon();
+
+    if ( v_ )
+    {
+        for( size_t i = 0; i < N * N; ++i )
+            v_[ i ] = T( 0 );
+        for( size_t i = 0; i < N; ++i )
+            v_[ i * N + i ] = T( 1 );
+    }
+
+    // squared column norms, recomputed every sweep and updated with the
+    // rotations in between
+    T norm2[ N ];
+    for( size_t sweep = 0; sweep < n_sweeps_; ++sweep )
+    {
+        for( size_t j = 0; j < N; ++j )
+        {
+            const T* a_j = a_ + j * M;
+            T sum = 0;
+            for( size_t i = 0; i < M; ++i )
+                sum += a_j[ i ] * a_j[ i ];
+            norm2[ j ] = sum;
+        }
+
+        for( size_t p = 0; p + 1 < N; ++p )
+        {
+            for( size_t q = p + 1; q < N; ++q )
+            {
+                T* a_p = a_ + p * M;
+                T* a_q = a_ + q * M;
+
+                // the 2x2 gram matrix of columns p and q
+                const T alpha = norm2[ p ];
+                const T beta = norm2[ q ];
+                T gamma = 0;
+                for( size_t i = 0; i < M; ++i )
+                    gamma += a_p[ i ] * a_q[ i ];
+
+                // skip columns that are orthogonal to working precision
+                if ( gamma * gamma <= eps2 * alpha * beta )
+                    continue;
+
+                // jacobi rotation that diagonalizes it, t = tan( theta )
+                // with |theta| <= pi/4
+                const T tau = beta - alpha;
+                const T sign = tau < T( 0 ) ? T( -1 ) : T( 1 );
+                const T t = T( 2 ) * gamma * sign
+                    / ( std::fabs( tau ) + std::sqrt( tau * tau + T( 4 ) * gamma * gamma ) + tiny );
+                const T c = T( 1 ) / std::sqrt( T( 1 ) + t * t );
+                const T s = t * c;
+                norm2[ p ] = alpha - t * gamma;
+                norm2[ q ] = beta + t * gamma;
+
+                for( size_t i = 0; i < M; ++i )
+                {
+                    const T x = a_p[ i ];
+                    const T y = a_q[ i ];
+                    a_p[ i ] = c * x - s * y;
+                    a_q[ i ] = s * x + c * y;
+                }
+
+                if ( v_ )
+                {
+                    T* v_p = v_ + p * N;
+                    T* v_q = v_ + q * N;
+                    for( size_t i = 0; i < N; ++i )
+                    {
+                        const T x = v_p[ i ];
+                        const T y = v_q[ i ];
+                        v_p[ i ] = c * x - s * y;
+                        v_q[ i ] = s * x + c * y;
+                    }
+                }
+            }
+        }
+    }
+
+    for( size_t j = 0; j < N; ++j )
+    {
+        const T* a_j = a_ + j * M;
+        T norm2 = 0;
+        for( size_t i = 0; i < M; ++i )
+            norm2 += a_j[ i ] * a_j[ i ];
+        sigma_[ j ] = std::sqrt( norm2 );
+    }
+
+    // selection sort, descending
+    for( size_t j = 0; j + 1 < N; ++j )
+    {
+        size_t max_index = j;
+        for( size_t k = j + 1; k < N; ++k )
+            if ( sigma_[ k ] > sigma_[ max_index ] )
+                max_index = k;
+        if ( max_index == j )
+            continue;
+
+        const T tmp = sigma_[ j ];
+        sigma_[ j ] = sigma_[ max_index ];
+        sigma_[ max_index ] = tmp;
+        std::swap_ranges( a_ + j * M, a_ + ( j + 1 ) * M, a_ + max_index * M );
+        if ( v_ )
+            std::swap_ranges( v_ + j * N, v_ + ( j + 1 ) * N, v_ + max_index * N );
+    }
+
+    for( size_t j = 0; j < N; ++j )
+    {
+        T* a_j = a_ + j * M;
+        const T scale = sigma_[ j ] > tiny ? T( 1 ) / sigma_[ j ] : T( 0 );
+        for( size_t i = 0; i < M; ++i )
+            a_j[ i ] *= scale;
+    }
+}
+
+
+
+template< size_t M, size_t N, typename T >
+bool
+jacobi_svd< M, N, T >::compute( const matrix_mn_type& A, matrix_mn_type& U,
+                                vector_type& sigma, matrix_nn_type& Vt )
+{
+    U = A;
+    return compute_and_overwrite_input( U, sigma, Vt );
+}
+
+
+
+template< size_t M, size_t N, typename T >
+bool
+jacobi_svd< M, N, T >::compute( const matrix_mn_type& A, vector_type& sigma )
+{
+    matrix_mn_type work( A );
+    return compute_and_overwrite_input( work, sigma );
+}
+
+
+
+template< size_t M, size_t N, typename T >
+bool
+jacobi_svd< M, N, T >::compute_and_overwrite_input( matrix_mn_type& A_U,
+                                                    vector_type& sigma )
+{
+    decompose( A_U.array, sigma.array, 0, _n_sweeps );
+    return true;
+}
+
+
+
+template< size_t M, size_t N, typename T >
+bool
+jacobi_svd< M, N, T >::compute_and_overwrite_input( matrix_mn_type& A_U,
+                                                    vector_type& sigma,
+                                                    matrix_nn_type& Vt )
+{
+    matrix_nn_type v;
+    decompose( A_U.array, sigma.array, v.array, _n_sweeps );
+    v.transpose_to( Vt );
+    return true;
+}
+
+
+} // namespace vmml
+
+#endif
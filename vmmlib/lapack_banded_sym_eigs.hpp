@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__VMMLIB_LAPACK_BANDED_SYM_EIGS__HPP__
+#define __VMML__VMMLIB_LAPACK_BANDED_SYM_EIGS__HPP__
+
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+#include <vmmlib/packed_matrix.hpp>
+#include <vmmlib/exception.hpp>
+
+#include <vmmlib/lapack_types.hpp>
+#include <vmmlib/lapack_includes.hpp>
+
+#include <limits>
+
+/**
+ *
+ *   a wrapper for lapack's DSBEVX routine.
+ *   DSBEVX computes selected eigenvalues and, optionally, eigenvectors
+ *   of a real symmetric band matrix A. the matrix is reduced to
+ *   tridiagonal form, then a range of eigenvalues is found by bisection
+ *   and the eigenvectors by inverse iteration, so only the requested
+ *   ones are computed.
+ *
+ *   the input is a banded_matrix< N, KD, KD, T >; only the lower band
+ *   is referenced (it is passed to lapack with uplo 'L' and the
+ *   leading dimension of the full band layout).
+ *
+ *   returns a boolean to indicate success of the operation.
+ *   if the return value is false, you can get the parameters using
+ *   get_params().
+ *   error states:
+ *
+ *  INFO    (output) INTEGER
+ *          = 0:  successful exit
+ *          < 0:  if INFO = -i, the i-th argument had an illegal value.
+ *          > 0:  if INFO = i, then i eigenvectors failed to converge.
+ *                Their indices are stored in array IFAIL.
+ *
+ *   more information in: http://www.netlib.org/lapack/double/dsbevx.f
+ **
+ */
+
+namespace vmml
+{
+
+namespace lapack
+{
+
+    template< typename float_t >
+    struct banded_eigs_params
+    {
+        char            jobz;
+        char            range; // 'A' all, 'I' the il-th through iu-th eigenvalue
+        char            uplo;
+        lapack_int      n;
+        lapack_int      kd; // number of sub- (super-) diagonals
+        float_t*        ab; //band input, destroyed
+        lapack_int      ldab;
+        float_t*        q; //orthogonal matrix of the tridiagonal reduction
+        lapack_int      ldq;
+        float_t         vl; //not used for range 'A' / 'I'
+        float_t         vu;
+        lapack_int      il; //first and last index, one-based, ascending order
+        lapack_int      iu;
+        float_t         abstol;
+        lapack_int      m; //number of eigenvalues found
+        float_t*        w; //eigenvalues in ascending order
+        float_t*        z; //eigenvectors
+        lapack_int      ldz; //leading dimension of z
+        float_t*        work; //7N
+        lapack_int*     iwork; //5N
+        lapack_int*     ifail; //N
+        lapack_int      info;
+
+        friend std::ostream& operator << ( std::ostream& os,
+                                          const banded_eigs_params< float_t >& p )
+        {
+            os
+            << " (1)\tjobz "     << p.jobz << std::endl
+            << " (2)\trange "    << p.range << std::endl
+            << " (3)\tuplo "     << p.uplo << std::endl
+            << " (4)\tn "        << p.n << std::endl
+            << " (5)\tkd "       << p.kd << std::endl
+            << " (7)\tldab "     << p.ldab << std::endl
+            << " (9)\tldq "      << p.ldq << std::endl
+            << " (12)\til "      << p.il << std::endl
+            << " (13)\tiu "      << p.iu << std::endl
+            << " (14)\tabstol "  << p.abstol << std::endl
+            << " (15)\tm "       << p.m << std::endl
+            << " (18)\tldz "     << p.ldz << std::endl
+            << " (22)\tinfo "    << p.info
+            << std::endl;
+            return os;
+        }
+
+    };
+
+
+#if 0
+    /* Subroutine */
+
+    int dsbevx_( char *jobz, char *range, char *uplo, integer *n, integer *kd,
+                doublereal *ab, integer *ldab, doublereal *q, integer *ldq,
+                doublereal *vl, doublereal *vu, integer *il, integer *iu,
+                doublereal *abstol, integer *m, doublereal *w, doublereal *z,
+                integer *ldz, doublereal *work, integer *iwork, integer *ifail,
+                integer *info );
+
+#endif
+
+
+    template< typename float_t >
+    inline void
+    banded_sym_eigs_call( banded_eigs_params< float_t >& )
+    {
+        VMMLIB_ERROR( "not implemented for this type.", VMMLIB_HERE );
+    }
+
+
+    template<>
+    inline void
+    banded_sym_eigs_call( banded_eigs_params< float >& p )
+    {
+        p.info = 0;
+        ssbevx_(
+                &p.jobz,
+                &p.range,
+                &p.uplo,
+                &p.n,
+                &p.kd,
+                p.ab,
+                &p.ldab,
+                p.q,
+                &p.ldq,
+                &p.vl,
+                &p.vu,
+                &p.il,
+                &p.iu,
+                &p.abstol,
+                &p.m,
+                p.w,
+                p.z,
+                &p.ldz,
+                p.work,
+                p.iwork,
+                p.ifail,
+                &p.info
+                );
+    }
+
+
+    template<>
+    inline void
+    banded_sym_eigs_call( banded_eigs_params< double >& p )
+    {
+        p.info = 0;
+        dsbevx_(
+                &p.jobz,
+                &p.range,
+                &p.uplo,
+                &p.n,
+                &p.kd,
+                p.ab,
+                &p.ldab,
+                p.q,
+                &p.ldq,
+                &p.vl,
+                &p.vu,
+                &p.il,
+                &p.iu,
+                &p.abstol,
+                &p.m,
+                p.w,
+                p.z,
+                &p.ldz,
+                p.work,
+                p.iwork,
+                p.ifail,
+                &p.info
+                );
+    }
+
+} // namespace lapack
+
+
+
+template< size_t N, size_t KD, typename float_t >
+struct lapack_banded_sym_eigs
+{
+
+    typedef banded_matrix< N, KD, KD, float_t > m_input_type;
+    typedef matrix< N, N, float_t > evectors_type;
+
+    typedef vector< N, float_t > evalues_type;
+    typedef vector< N, float_t > evector_type;
+
+    // allocates the workspace once; keep the solver around to reuse it
+    // for many decompositions.
+    lapack_banded_sym_eigs();
+    ~lapack_banded_sym_eigs();
+
+    // computes all eigenvalues (ascending) and eigenvectors for matrix A
+    bool compute_all(
+                 const m_input_type& A,
+                 evectors_type& eigvectors_,
+                 evalues_type& eigvalues_
+                 );
+
+    // computes the X smallest / largest eigenvalues (ascending) and their
+    // eigenvectors, the others are not computed
+    template< size_t X >
+    bool compute_smallest(
+                 const m_input_type& A,
+                 matrix< N, X, float_t >& eigvectors_,
+                 vector< X, float_t >& eigvalues_
+                 );
+
+    template< size_t X >
+    bool compute_largest(
+                 const m_input_type& A,
+                 matrix< N, X, float_t >& eigvectors_,
+                 vector< X, float_t >& eigvalues_
+                 );
+
+    lapack::banded_eigs_params< float_t > p;
+
+    const lapack::banded_eigs_params< float_t >& get_params(){ return p; };
+
+protected:
+    // eigenvalues il .. iu (one-based), range 'A' if all of them
+    bool _compute( const m_input_type& A, size_t il, size_t iu,
+                   float_t* eigvectors_, float_t* eigvalues_ );
+
+    m_input_type*                   _input;
+    evectors_type*                  _q;
+    evalues_type*                   _all_eigvalues;
+
+private:
+    // owns the workspace
+    lapack_banded_sym_eigs( const lapack_banded_sym_eigs& );
+    lapack_banded_sym_eigs& operator=( const lapack_banded_sym_eigs& );
+
+}; // struct lapack_banded_sym_eigs
+
+
+template< size_t N, size_t KD, typename float_t >
+lapack_banded_sym_eigs< N, KD, float_t >::lapack_banded_sym_eigs()
+    : _input( new m_input_type )
+    , _q( new evectors_type )
+    , _all_eigvalues( new evalues_type )
+{
+    p.jobz      = 'V'; // Compute eigenvalues and eigenvectors.
+    p.range     = 'A';
+    p.uplo      = 'L'; // Lower band of A is referenced.
+    p.n         = N;
+    p.kd        = KD;
+    p.ab        = _input->array + KD; // row KD of the band layout is the diagonal
+    p.ldab      = m_input_type::LDAB;
+    p.q         = _q->array;
+    p.ldq       = N;
+    p.vl        = 0;
+    p.vu        = 0;
+    p.il        = 1;
+    p.iu        = N;
+    // twice the underflow threshold gives the most accurate eigenvalues
+    p.abstol    = 2 * ( std::numeric_limits< float_t >::min )();
+    p.m         = 0;
+    p.w         = _all_eigvalues->array;
+    p.z         = 0;
+    p.ldz       = N;
+    p.work      = new float_t[ 7 * N ];
+    p.iwork     = new lapack::lapack_int[ 5 * N ];
+    p.ifail     = new lapack::lapack_int[ N ];
+    p.info      = 0;
+}
+
+
+
+template< size_t N, size_t KD, typename float_t >
+lapack_banded_sym_eigs< N, KD, float_t >::~lapack_banded_sym_eigs()
+{
+    delete[] p.work;
+    delete[] p.iwork;
+    delete[] p.ifail;
+    delete _input;
+    delete _q;
+    delete _all_eigvalues;
+}
+
+
+template< size_t N, size_t KD, typename float_t >
+bool
+lapack_banded_sym_eigs< N, KD, float_t >::_compute(
+                                        const m_input_type& A,
+                                        size_t il,
+                                        size_t iu,
+                                        float_t* eigvectors_,
+                                        float_t* eigvalues_
+                                        )
+{
+    // lapack destroys the contents of the input matrix
+    *_input = A;
+    p.range     = il == 1 && iu == N ? 'A' : 'I';
+    p.il        = il;
+    p.iu        = iu;
+    p.z         = eigvectors_;
+
+    //debug std::cout << p << std::endl;
+
+    lapack::banded_sym_eigs_call< float_t >( p );
+    if ( p.info != 0 || size_t( p.m ) != iu - il + 1 )
+        return false;
+
+    for( size_t i = 0; i < iu - il + 1; ++i )
+        eigvalues_[ i ] = _all_eigvalues->array[ i ];
+    return true;
+}
+
+
+template< size_t N, size_t KD, typename float_t >
+bool
+lapack_banded_sym_eigs< N, KD, float_t >::compute_all(
+                                        const m_input_type& A,
+                                        evectors_type& eigvectors_,
+                                        evalues_type& eigvalues_
+                                        )
+{
+    return _compute( A, 1, N, eigvectors_.array, eigvalues_.array );
+}
+
+
+template< size_t N, size_t KD, typename float_t >
+template< size_t X >
+bool
+lapack_banded_sym_eigs< N, KD, float_t >::compute_smallest(
+                                        const m_input_type& A,
+                                        matrix< N, X, float_t >& eigvectors_,
+                                        vector< X, float_t >& eigvalues_
+                                        )
+{
+    return _compute( A, 1, X, eigvectors_.array, eigvalues_.array );
+}
+
+
+template< size_t N, size_t KD, typename float_t >
+template< size_t X >
+bool
+lapack_banded_sym_eigs< N, KD, float_t >::compute_largest(
+                                        const m_input_type& A,
+                                        matrix< N, X, float_t >& eigvectors_,
+                                        vector< X, float_t >& eigvalues_
+                                        )
+{
+    return _compute( A, N - X + 1, N, eigvectors_.array, eigvalues_.array );
+}
+
+
+} // namespace vmml
+
+#endif
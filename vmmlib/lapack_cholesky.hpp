@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__VMMLIB_LAPACK_CHOLESKY__HPP__
+#define __VMML__VMMLIB_LAPACK_CHOLESKY__HPP__
+
+#include <vmmlib/exception.hpp>
+
+#include <vmmlib/lapack_types.hpp>
+#include <vmmlib/lapack_includes.hpp>
+
+#include <iostream>
+
+/**
+*
+* this is a wrapper for the following lapack routines:
+*
+* xPOTRF
+* xPOTRS
+* xSYTRF
+* xSYTRS
+*
+* the factor computed by xPOTRF (xSYTRF) is passed unchanged to xPOTRS
+* (xSYTRS), so a factorization can be reused for any number of right-hand
+* sides. xSYTRF is the Bunch-Kaufman L D L^T for symmetric indefinite
+* matrices.
+* see cholesky_solver.hpp for the fixed-size and dynamic solvers built
+* on top of it.
+*
+*/
+
+
+namespace vmml
+{
+
+namespace lapack
+{
+
+//
+//
+//
+// SPOTRF/DPOTRF
+//
+//
+
+template< typename float_t >
+struct xpotrf_params
+{
+    char            uplo; // 'L' - lower triangle of A is referenced and overwritten by L
+    lapack_int      n; // order of matrix A
+    float_t*        a; // input A, output L (or U)
+    lapack_int      lda; // leading dimension of A
+    lapack_int      info; // > 0: leading minor of order info is not positive definite
+
+    friend std::ostream& operator << ( std::ostream& os,
+        const xpotrf_params< float_t >& p )
+    {
+        os
+            << "uplo "      << p.uplo
+            << " n "        << p.n
+            << " lda "      << p.lda
+            << " info "     << p.info
+            << std::endl;
+        return os;
+    }
+
+};
+
+
+#if 0
+/* Subroutine */ int dpotrf_(char *uplo, integer *n, doublereal *a, integer *
+	lda, integer *info);
+#endif
+
+
+template< typename float_t >
+inline void
+xpotrf_call( xpotrf_params< float_t >& )
+{
+    VMMLIB_ERROR( "not implemented for this type.", VMMLIB_HERE );
+}
+
+
+template<>
+inline void
+xpotrf_call( xpotrf_params< float >& p )
+{
+    spotrf_(
+        &p.uplo,
+        &p.n,
+        p.a,
+        &p.lda,
+        &p.info
+    );
+}
+
+
+template<>
+inline void
+xpotrf_call( xpotrf_params< double >& p )
+{
+    dpotrf_(
+        &p.uplo,
+        &p.n,
+        p.a,
+        &p.lda,
+        &p.info
+    );
+}
+
+
+
+//
+//
+//
+// SPOTRS/DPOTRS
+//
+//
+
+template< typename float_t >
+struct xpotrs_params
+{
+    char            uplo; // must match the uplo used for xPOTRF
+    lapack_int      n; // order of matrix A
+    lapack_int      nrhs; // number of columns of B
+    float_t*        a; // the factor computed by xPOTRF
+    lapack_int      lda; // leading dimension of A
+    float_t*        b; // input B, output X
+    lapack_int      ldb; // leading dimension of B
+    lapack_int      info;
+
+    friend std::ostream& operator << ( std::ostream& os,
+        const xpotrs_params< float_t >& p )
+    {
+        os
+            << "uplo "      << p.uplo
+            << " n "        << p.n
+            << " nrhs "     << p.nrhs
+            << " lda "      << p.lda
+            << " ldb "      << p.ldb
+            << " info "     << p.info
+            << std::endl;
+        return os;
+    }
+
+};
+
+
+#if 0
+/* Subroutine */ int dpotrs_(char *uplo, integer *n, integer *nrhs,
+	doublereal *a, integer *lda, doublereal *b, integer *ldb, integer *
+	info);
+#endif
+
+
+template< typename float_t >
+inline void
+xpotrs_call( xpotrs_params< float_t >& )
+{
+    VMMLIB_ERROR( "not implemented for this type.", VMMLIB_HERE );
+}
+
+
+template<>
+inline void
+xpotrs_call( xpotrs_params< float >& p )
+{
+    spotrs_(
+        &p.uplo,
+        &p.n,
+        &p.nrhs,
+        p.a,
+        &p.lda,
+        p.b,
+        &p.ldb,
+        &p.info
+    );
+}
+
+
+template<>
+inline void
+xpotrs_call( xpotrs_params< double >& p )
+{
+    dpotrs_(
+        &p.uplo,
+        &p.n,
+        &p.nrhs,
+        p.a,
+        &p.lda,
+        p.b,
+        &p.ldb,
+        &p.info
+    );
+}
+
+
+
+//
+//
+//
+// SSYTRF/DSYTRF
+//
+//
+
+template< typename float_t >
+struct xsytrf_params
+{
+    char            uplo; // 'L' - lower triangle of A is referenced and overwritten by L and D
+    lapack_int      n; // order of matrix A
+    float_t*        a; // input A, output L and the block diagonal D
+    lapack_int      lda; // leading dimension of A
+    lapack_int*     ipiv; // interchanges and block structure of D (one-based)
+    float_t*        work; // workspace
+    lapack_int      lwork; // -1 for a workspace query, the optimal size is returned in work[ 0 ]
+    lapack_int      info; // > 0: D( info, info ) is exactly zero, D is singular
+
+    friend std::ostream& operator << ( std::ostream& os,
+        const xsytrf_params< float_t >& p )
+    {
+        os
+            << "uplo "      << p.uplo
+            << " n "        << p.n
+            << " lda "      << p.lda
+            << " lwork "    << p.lwork
+            << " info "     << p.info
+            << std::endl;
+        return os;
+    }
+
+};
+
+
+#if 0
+/* Subroutine */ int dsytrf_(char *uplo, integer *n, doublereal *a, integer *
+	lda, integer *ipiv, doublereal *work, integer *lwork, integer *info);
+#endif
+
+
+template< typename float_t >
+inline void
+xsytrf_call( xsytrf_params< float_t >& )
+{
+    VMMLIB_ERROR( "not implemented for this type.", VMMLIB_HERE );
+}
+
+
+template<>
+inline void
+xsytrf_call( xsytrf_params< float >& p )
+{
+    ssytrf_(
+        &p.uplo,
+        &p.n,
+        p.a,
+        &p.lda,
+        p.ipiv,
+        p.work,
+        &p.lwork,
+        &p.info
+    );
+}
+
+
+template<>
+inline void
+xsytrf_call( xsytrf_params< double >& p )
+{
+    dsytrf_(
+        &p.uplo,
+        &p.n,
+        p.a,
+        &p.lda,
+        p.ipiv,
+        p.work,
+        &p.lwork,
+        &p.info
+    );
+}
+
+
+
+//
+//
+//
+// SSYTRS/DSYTRS
+//
+//
+
+template< typename float_t >
+struct xsytrs_params
+{
+    char            uplo; // must match the uplo used for xSYTRF
+    lapack_int      n; // order of matrix A
+    lapack_int      nrhs; // number of columns of B
+    float_t*        a; // the factor computed by xSYTRF
+    lapack_int      lda; // leading dimension of A
+    lapack_int*     ipiv; // the pivots computed by xSYTRF
+    float_t*        b; // input B, output X
+    lapack_int      ldb; // leading dimension of B
+    lapack_int      info;
+
+    friend std::ostream& operator << ( std::ostream& os,
+        const xsytrs_params< float_t >& p )
+    {
+        os
+            << "uplo "      << p.uplo
+            << " n "        << p.n
+            << " nrhs "     << p.nrhs
+            << " lda "      << p.lda
+            << " ldb "      << p.ldb
+            << " info "     << p.info
+            << std::endl;
+        return os;
+    }
+
+};
+
+
+#if 0
+/* Subroutine */ int dsytrs_(char *uplo, integer *n, integer *nrhs,
+	doublereal *a, integer *lda, integer *ipiv, doublereal *b, integer *
+	ldb, integer *info);
+#endif
+
+
+template< typename float_t >
+inline void
+xsytrs_call( xsytrs_params< float_t >& )
+{
+    VMMLIB_ERROR( "not implemented for this type.", VMMLIB_HERE );
+}
+
+
+template<>
+inline void
+xsytrs_call( xsytrs_params< float >& p )
+{
+    ssytrs_(
+        &p.uplo,
+        &p.n,
+        &p.nrhs,
+        p.a,
+        &p.lda,
+        p.ipiv,
+        p.b,
+        &p.ldb,
+        &p.info
+    );
+}
+
+
+template<>
+inline void
+xsytrs_call( xsytrs_params< double >& p )
+{
+    dsytrs_(
+        &p.uplo,
+        &p.n,
+        &p.nrhs,
+        p.a,
+        &p.lda,
+        p.ipiv,
+        p.b,
+        &p.ldb,
+        &p.info
+    );
+}
+
+
+} // namespace lapack
+
+} // namespace vmml
+
+#endif
@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__VMMLIB_LAPACK_PACKED_SYM_EIGS__HPP__
+#define __VMML__VMMLIB_LAPACK_PACKED_SYM_EIGS__HPP__
+
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+#include <vmmlib/packed_matrix.hpp>
+#include <vmmlib/exception.hpp>
+
+#include <vmmlib/lapack_types.hpp>
+#include <vmmlib/lapack_includes.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/**
+ *
+ *   a wrapper for lapack's DSPEVD routine.
+ *   DSPEVD computes all the eigenvalues and, optionally, eigenvectors
+ *   of a real symmetric matrix A in packed storage (symmetric_matrix,
+ *   lower triangle). If eigenvectors are desired, it uses a divide and
+ *   conquer algorithm.
+ *
+ *   returns a boolean to indicate success of the operation.
+ *   if the return value is false, you can get the parameters using
+ *   get_params().
+ *   error states:
+ *
+ *  INFO    (output) INTEGER
+ *          = 0:  successful exit
+ *          < 0:  if INFO = -i, the i-th argument had an illegal value.
+ *          > 0:  if INFO = i, the algorithm failed to converge; i
+ *                off-diagonal elements of an intermediate tridiagonal
+ *                form did not converge to zero.
+ *
+ *   more information in: http://www.netlib.org/lapack/double/dspevd.f
+ **
+ */
+
+namespace vmml
+{
+
+namespace lapack
+{
+
+    template< typename float_t >
+    struct packed_eigs_params
+    {
+        char            jobz;
+        char            uplo;
+        lapack_int      n;
+        float_t*        ap; //packed input, destroyed
+        float_t*        w;  //eigenvalues in ascending order
+        float_t*        z;  //eigenvectors
+        lapack_int      ldz; //leading dimension of z
+        float_t*        work;
+        lapack_int      lwork;
+        lapack_int*     iwork;
+        lapack_int      liwork;
+        lapack_int      info;
+
+        friend std::ostream& operator << ( std::ostream& os,
+                                          const packed_eigs_params< float_t >& p )
+        {
+            os
+            << " (1)\tjobz "     << p.jobz << std::endl
+            << " (2)\tuplo "     << p.uplo << std::endl
+            << " (3)\tn "        << p.n << std::endl
+            << " (4)\tap "       << *p.ap << std::endl
+            << " (5)\tw "        << p.w << std::endl
+            << " (6)\tz "        << p.z << std::endl
+            << " (7)\tldz "      << p.ldz << std::endl
+            << " (8)\twork "     << *p.work << std::endl
+            << " (9)\tlwork "    << p.lwork << std::endl
+            << " (10)\tiwork "   << *p.iwork << std::endl
+            << " (11)\tliwork "  << p.liwork << std::endl
+            << " (12)\tinfo "    << p.info
+            << std::endl;
+            return os;
+        }
+
+    };
+
+
+#if 0
+    /* Subroutine */
+
+    int dspevd_( char *jobz, char *uplo, integer *n, doublereal *ap, doublereal *w, doublereal *z,
+                integer *ldz, doublereal *work, integer *lwork, integer *iwork, integer *liwork, integer *info );
+
+#endif
+
+
+    template< typename float_t >
+    inline void
+    packed_sym_eigs_call( packed_eigs_params< float_t >& )
+    {
+        VMMLIB_ERROR( "not implemented for this type.", VMMLIB_HERE );
+    }
+
+
+    template<>
+    inline void
+    packed_sym_eigs_call( packed_eigs_params< float >& p )
+    {
+        //std::cout << "calling lapack packed sym eigs (single precision) " << std::endl;
+        p.info = 0;
+        sspevd_(
+                &p.jobz,
+                &p.uplo,
+                &p.n,
+                p.ap,
+                p.w,
+                p.z,
+                &p.ldz,
+                p.work,
+                &p.lwork,
+                p.iwork,
+                &p.liwork,
+                &p.info
+                );
+    }
+
+
+    template<>
+    inline void
+    packed_sym_eigs_call( packed_eigs_params< double >& p )
+    {
+        //std::cout << "calling lapack packed sym eigs (double precision) " << std::endl;
+        p.info = 0;
+        dspevd_(
+                &p.jobz,
+                &p.uplo,
+                &p.n,
+                p.ap,
+                p.w,
+                p.z,
+                &p.ldz,
+                p.work,
+                &p.lwork,
+                p.iwork,
+                &p.liwork,
+                &p.info
+                );
+    }
+
+} // namespace lapack
+
+
+
+template< size_t N, typename float_t >
+struct lapack_packed_sym_eigs
+{
+
+    typedef symmetric_matrix< N, float_t > m_input_type;
+    typedef matrix< N, N, float_t > evectors_type;
+
+    typedef vector< N, float_t > evalues_type;
+    typedef vector< N, float_t > evector_type;
+
+    typedef std::pair< float_t, size_t >  eigv_pair_type;
+
+    // queries and allocates the workspace once; keep the solver around
+    // (or use lapack_solver_pool) to reuse it for many decompositions.
+    lapack_packed_sym_eigs();
+    ~lapack_packed_sym_eigs();
+
+    // computes the x largest magn. eigenvalues and their corresponding
+    // eigenvectors, sorted by decreasing magnitude
+    template< size_t X >
+    bool compute_x(
+                     const m_input_type& A,
+                     matrix< N, X, float_t >& eigvectors_,
+                     vector< X, float_t >& eigvalues_
+                     );
+
+    // computes all eigenvalues (ascending) and eigenvectors for matrix A
+    bool compute_all(
+                 const m_input_type& A,
+                 evectors_type& eigvectors_,
+                 evalues_type& eigvalues_
+                 );
+
+    // in-place versions of the above, A is destroyed
+    template< size_t X >
+    bool compute_x_and_overwrite_input(
+                     m_input_type& A,
+                     matrix< N, X, float_t >& eigvectors_,
+                     vector< X, float_t >& eigvalues_
+                     );
+
+    bool compute_all_and_overwrite_input(
+                 m_input_type& A,
+                 evectors_type& eigvectors_,
+                 evalues_type& eigvalues_
+                 );
+
+    // scratch matrix owned by the solver. fill it and pass it to the
+    // *_and_overwrite_input variants to avoid allocations.
+    m_input_type& get_input_scratch() { return *_input; }
+
+    lapack::packed_eigs_params< float_t > p;
+
+    const lapack::packed_eigs_params< float_t >& get_params(){ return p; };
+
+    // comparison functor
+    struct eigenvalue_compare
+    {
+        inline bool operator()( const eigv_pair_type& a, const eigv_pair_type& b )
+        {
+            return fabs( a.first ) > fabs( b.first );
+        }
+    };
+
+protected:
+    m_input_type*                   _input;
+    evectors_type*                  _all_eigvectors;
+    evalues_type*                   _all_eigvalues;
+    std::vector< eigv_pair_type >   _permutation;
+
+private:
+    // owns the workspace
+    lapack_packed_sym_eigs( const lapack_packed_sym_eigs& );
+    lapack_packed_sym_eigs& operator=( const lapack_packed_sym_eigs& );
+
+}; // struct lapack_packed_sym_eigs
+
+
+template< size_t N, typename float_t >
+lapack_packed_sym_eigs< N, float_t >::lapack_packed_sym_eigs()
+    : _input( new m_input_type )
+    , _all_eigvectors( new evectors_type )
+    , _all_eigvalues( new evalues_type )
+{
+    p.jobz      = 'V'; // Compute eigenvalues and eigenvectors.
+    p.uplo      = 'L'; // Lower triangle of A is stored (symmetric_matrix layout).
+    p.n         = N;
+    p.ap        = _input->array;
+    p.w         = _all_eigvalues->array;
+    p.z         = _all_eigvectors->array;
+    p.ldz       = N;
+
+    // workspace query; the documented minima are the fallback if the
+    // query does not report back (1 + 6N + N^2 and 3 + 5N for jobz = 'V')
+    float_t work_query = 0;
+    lapack::lapack_int iwork_query = 0;
+    p.work      = &work_query;
+    p.lwork     = -1;
+    p.iwork     = &iwork_query;
+    p.liwork    = -1;
+    lapack::packed_sym_eigs_call( p );
+
+    const lapack::lapack_int lwork_min = 1 + 6 * N + N * N;
+    const lapack::lapack_int liwork_min = 3 + 5 * N;
+    p.lwork = ( std::max )( static_cast< lapack::lapack_int >( work_query ), lwork_min );
+    p.liwork = ( std::max )( iwork_query, liwork_min );
+
+    p.work = new float_t[ p.lwork ];
+    p.iwork = new lapack::lapack_int[ p.liwork ];
+
+    _permutation.reserve( N );
+}
+
+
+
+template< size_t N, typename float_t >
+lapack_packed_sym_eigs< N, float_t >::~lapack_packed_sym_eigs()
+{
+    delete[] p.work;
+    delete[] p.iwork;
+    delete _input;
+    delete _all_eigvectors;
+    delete _all_eigvalues;
+}
+
+
+template< size_t N, typename float_t >
+bool
+lapack_packed_sym_eigs< N, float_t >::compute_all(
+                                        const m_input_type& A,
+                                        evectors_type& eigvectors_,
+                                        evalues_type& eigvalues_
+                                        )
+{
+    // lapack destroys the contents of the input matrix
+    *_input = A;
+    return compute_all_and_overwrite_input( *_input, eigvectors_, eigvalues_ );
+}
+
+
+template< size_t N, typename float_t >
+bool
+lapack_packed_sym_eigs< N, float_t >::compute_all_and_overwrite_input(
+                                        m_input_type& A,
+                                        evectors_type& eigvectors_,
+                                        evalues_type& eigvalues_
+                                        )
+{
+    p.ap        = A.array;
+    p.w         = eigvalues_.array;
+    p.z         = eigvectors_.array;
+
+    //debug std::cout << p << std::endl;
+
+    lapack::packed_sym_eigs_call< float_t >( p );
+
+    return p.info == 0;
+}
+
+
+template< size_t N, typename float_t >
+template< size_t X >
+bool
+lapack_packed_sym_eigs< N, float_t >::compute_x(
+                                        const m_input_type& A,
+                                        matrix< N, X, float_t >& eigvectors_,
+                                        vector< X, float_t >& eigvalues_
+                                        )
+{
+    *_input = A;
+    return compute_x_and_overwrite_input( *_input, eigvectors_, eigvalues_ );
+}
+
+
+template< size_t N, typename float_t >
+template< size_t X >
+bool
+lapack_packed_sym_eigs< N, float_t >::compute_x_and_overwrite_input(
+                                        m_input_type& A,
+                                        matrix< N, X, float_t >& eigvectors_,
+                                        vector< X, float_t >& eigvalues_
+                                        )
+{
+    //(1) get all eigenvalues and eigenvectors
+    if ( ! compute_all_and_overwrite_input( A, *_all_eigvectors, *_all_eigvalues ) )
+        return false;
+
+    //(2) sort the eigenvalues by decreasing magnitude
+    _permutation.clear();
+    for( size_t i = 0; i < N; ++i )
+        _permutation.push_back( eigv_pair_type( _all_eigvalues->array[ i ], i ) );
+    std::sort( _permutation.begin(), _permutation.end(), eigenvalue_compare() );
+
+    //(3) select the largest magnitude eigenvalues and the corresponding eigenvectors
+    for( size_t x = 0; x < X; ++x )
+    {
+        const size_t index = _permutation[ x ].second;
+        eigvalues_( x ) = _permutation[ x ].first;
+        for( size_t row = 0; row < N; ++row )
+        {
+            eigvectors_( row, x ) = (*_all_eigvectors)( row, index );
+        }
+    }
+
+    return true;
+}
+
+
+} // namespace vmml
+
+#endif
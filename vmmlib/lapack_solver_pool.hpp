@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__VMMLIB_LAPACK_SOLVER_POOL__HPP__
+#define __VMML__VMMLIB_LAPACK_SOLVER_POOL__HPP__
+
+#include <vmmlib/vmmlib_config.hpp>
+
+#include <map>
+
+#ifndef VMMLIB_THREAD_LOCAL
+#  error "lapack_solver_pool needs VMMLIB_THREAD_LOCAL"
+#endif
+
+/**
+ *
+ *   per-thread instances of a lapack solver (lapack_svd, lapack_sym_eigs),
+ *   for use from OpenMP parallel loops.
+ *
+ *   the solvers keep their workspace and scratch matrices, so reusing one
+ *   solver per thread avoids the workspace query and the allocations of
+ *   a new solver per call. a solver is created on the first get() of its
+ *   thread and only used by that thread afterwards.
+ *
+ *   get_local() returns the solver of the calling thread from a
+ *   process-wide pool per solver type. the pool is constructed during
+ *   static initialization, i.e., get_local() must not be called from
+ *   constructors of other statics.
+ *
+ *   solvers are keyed by a thread-local id, not by omp_get_thread_num(),
+ *   so threads of nested parallel regions and threads not started by
+ *   OpenMP each get their own solver. the solver of a thread that has
+ *   exited is kept until the pool is destroyed. the pool is guarded by
+ *   an OpenMP critical section; without OpenMP it must only be used
+ *   from one thread.
+ *
+ **
+ */
+
+namespace vmml
+{
+
+template< typename solver_t >
+class lapack_solver_pool
+{
+public:
+    lapack_solver_pool();
+    ~lapack_solver_pool();
+
+    // solver of the calling thread
+    solver_t& get();
+
+    // number of solvers created so far
+    size_t size() const;
+
+    // solver of the calling thread, process-wide pool
+    static solver_t& get_local();
+
+protected:
+    typedef std::map< size_t, solver_t* > solver_map;
+
+    // process-unique id of the calling thread, starting at 1
+    static size_t get_thread_id();
+
+    solver_map _solvers;
+
+    static lapack_solver_pool _local_pool;
+
+private:
+    lapack_solver_pool( const lapack_solver_pool& );
+    lapack_solver_pool& operator=( const lapack_solver_pool& );
+
+}; // class lapack_solver_pool
+
+
+template< typename solver_t >
+lapack_solver_pool< solver_t > lapack_solver_pool< solver_t >::_local_pool;
+
+
+
+template< typename solver_t >
+lapack_solver_pool< solver_t >::lapack_solver_pool()
+{}
+
+
+
+template< typename solver_t >
+lapack_solver_pool< solver_t >::~lapack_solver_pool()
+{
+    typename solver_map::iterator it = _solvers.begin(), it_end = _solvers.end();
+    for( ; it != it_end; ++it )
+    {
+        delete it->second;
+    }
+}
+
+
+
+template< typename solver_t >
+size_t
+lapack_solver_pool< solver_t >::get_thread_id()
+{
+    static VMMLIB_THREAD_LOCAL size_t thread_id = 0;
+    if ( ! thread_id )
+    {
+        // zero-initialized before any dynamic initialization
+        static size_t n_thread_ids = 0;
+        #pragma omp critical( vmmlib_lapack_solver_pool )
+        thread_id = ++n_thread_ids;
+    }
+    return thread_id;
+}
+
+
+
+template< typename solver_t >
+size_t
+lapack_solver_pool< solver_t >::size() const
+{
+    size_t n_solvers = 0;
+    #pragma omp critical( vmmlib_lapack_solver_pool )
+    n_solvers = _solvers.size();
+    return n_solvers;
+}
+
+
+
+template< typename solver_t >
+solver_t&
+lapack_solver_pool< solver_t >::get()
+{
+    const size_t thread_id = get_thread_id();
+
+    solver_t* solver = 0;
+    #pragma omp critical( vmmlib_lapack_solver_pool )
+    {
+        typename solver_map::const_iterator it = _solvers.find( thread_id );
+        if ( it != _solvers.end() )
+            solver = it->second;
+    }
+    if ( solver )
+        return *solver;
+
+    // only this thread inserts its id, the workspace query runs unlocked
+    solver = new solver_t;
+    #pragma omp critical( vmmlib_lapack_solver_pool )
+    _solvers[ thread_id ] = solver;
+    return *solver;
+}
+
+
+
+template< typename solver_t >
+solver_t&
+lapack_solver_pool< solver_t >::get_local()
+{
+    // the pool is only locked on the first call per thread
+    static VMMLIB_THREAD_LOCAL solver_t* solver = 0;
+    if ( ! solver )
+        solver = &_local_pool.get();
+    return *solver;
+}
+
+
+} // namespace vmml
+
+#endif
@@ -183,6 +183,11 @@ svd_call( svd_params< double >& p )
 template< size_t M, size_t N, typename float_t >
 struct lapack_svd
 {
+    typedef matrix< M, N, float_t > m_input_type;
+    typedef vector< N, float_t > sigma_type;
+
+    // queries and allocates the workspace once; keep the solver around
+    // (or use lapack_solver_pool) to reuse it for many decompositions.
     lapack_svd();
     ~lapack_svd();
 
@@ -209,23 +214,54 @@ struct lapack_svd
         vector< N, float_t >& sigma
         );
 
+    // reduced SVD, overwrites A with the result U
+    bool compute_and_overwrite_input(
+        matrix< M, N, float_t >& A_U,
+        vector< N, float_t >& sigma,
+        matrix< N, N, float_t >& Vt
+        );
+
     // fast version, use if only sigma is needed.
     bool compute(
         const matrix< M, N, float_t >& A,
         vector< N, float_t >& sigma
         );
 
+    // overwrites A, use if only sigma is needed.
+    bool compute_sigma_and_overwrite_input(
+        matrix< M, N, float_t >& A,
+        vector< N, float_t >& sigma
+        );
+
+    // scratch matrix and vector owned by the solver. fill the input and
+    // pass it to the *_and_overwrite_input variants to avoid allocations.
+    m_input_type& get_input_scratch() { return *_input; }
+    sigma_type& get_sigma_scratch() { return *_sigma; }
+
     inline bool test_success( lapack::lapack_int info );
 
     lapack::svd_params< float_t > p;
 
     const lapack::svd_params< float_t >& get_params(){ return p; };
 
+protected:
+    void query_workspace( char jobu_, char jobvt_ );
+
+    m_input_type*   _input;
+    sigma_type*     _sigma;
+
+private:
+    // owns the workspace
+    lapack_svd( const lapack_svd& );
+    lapack_svd& operator=( const lapack_svd& );
+
 }; // struct lapack_svd
 
 
 template< size_t M, size_t N, typename float_t >
 lapack_svd< M, N, float_t >::lapack_svd()
+    : _input( new m_input_type )
+    , _sigma( new sigma_type )
 {
     p.jobu      = 'N';
     p.jobvt     = 'N';
@@ -237,18 +273,18 @@ lapack_svd< M, N, float_t >::lapack_svd()
     p.u         = 0;
     p.ldu       = M;
     p.vt        = 0;
-    p.ldvt      = 1;
-    p.work      = new float_t;
-    p.lwork     = -1;
-
-    // workspace query
-    lapack::svd_call( p );
+    p.ldvt      = N;
+    p.work      = 0;
+    p.lwork     = 0;
 
-    p.lwork = static_cast< lapack::lapack_int >( p.work[0] );
-    delete p.work;
+    // the optimal workspace depends on the job, size it for all of them
+    query_workspace( 'N', 'N' );
+    query_workspace( 'S', 'S' );
+    query_workspace( 'A', 'A' );
+    query_workspace( 'O', 'N' );
+    query_workspace( 'O', 'S' );
 
     p.work = new float_t[ p.lwork ];
-
 }
 
 
@@ -257,6 +293,28 @@ template< size_t M, size_t N, typename float_t >
 lapack_svd< M, N, float_t >::~lapack_svd()
 {
     delete[] p.work;
+    delete _input;
+    delete _sigma;
+}
+
+
+
+template< size_t M, size_t N, typename float_t >
+void
+lapack_svd< M, N, float_t >::query_workspace( char jobu_, char jobvt_ )
+{
+    lapack::svd_params< float_t > q = p;
+    float_t work_size = 0;
+    q.jobu      = jobu_;
+    q.jobvt     = jobvt_;
+    q.work      = &work_size;
+    q.lwork     = -1;
+
+    lapack::svd_call( q );
+
+    const lapack::lapack_int lwork = static_cast< lapack::lapack_int >( work_size );
+    if ( lwork > p.lwork )
+        p.lwork = lwork;
 }
 
 
@@ -271,12 +329,11 @@ lapack_svd< M, N, float_t >::compute_full(
     )
 {
     // lapack destroys the contents of the input matrix
-    typedef matrix< M, N, float_t > m_type;
-    m_type* AA = new m_type( A );
+    *_input = A;
 
     p.jobu      = 'A';
     p.jobvt     = 'A';
-    p.a         = AA->array;
+    p.a         = _input->array;
     p.u         = U.array;
     p.s         = S.array;
     p.vt        = Vt.array;
@@ -284,8 +341,6 @@ lapack_svd< M, N, float_t >::compute_full(
 
     lapack::svd_call< float_t >( p );
 
-    delete AA;
-
     return p.info == 0;
 }
 
@@ -299,19 +354,17 @@ lapack_svd< M, N, float_t >::compute(
                                      )
 {
     // lapack destroys the contents of the input matrix
-    typedef matrix< M, N, float_t > m_type;
-    m_type* AA = new m_type( A );
+    *_input = A;
 
     p.jobu      = 'S';
     p.jobvt     = 'S';
-    p.a         = AA->array;
+    p.a         = _input->array;
     p.u         = U.array;
     p.s         = S.array;
     p.vt        = Vt.array;
     p.ldvt      = N;
 
     lapack::svd_call< float_t >( p );
-    delete AA;
     return p.info == 0;
 }
 
@@ -334,33 +387,59 @@ lapack_svd< M, N, float_t >::compute_and_overwrite_input(
     return p.info == 0;
 }
 
+
 template< size_t M, size_t N, typename float_t >
+bool
+lapack_svd< M, N, float_t >::compute_and_overwrite_input(
+    matrix< M, N, float_t >& A_U,
+    vector< N, float_t >& S,
+    matrix< N, N, float_t >& Vt
+    )
+{
+    p.jobu      = 'O';
+    p.jobvt     = 'S';
+    p.a         = A_U.array;
+    p.u         = 0;
+    p.s         = S.array;
+    p.vt        = Vt.array;
+    p.ldvt      = N;
 
-bool lapack_svd< M, N, float_t >::compute( const matrix< M, N, float_t >& A,
+    lapack::svd_call< float_t >( p );
+
+    return p.info == 0;
+}
 
-                                           vector< N, float_t >& S )
 
+template< size_t M, size_t N, typename float_t >
+bool
+lapack_svd< M, N, float_t >::compute( const matrix< M, N, float_t >& A,
+                                      vector< N, float_t >& S )
 {
-
     // lapack destroys the contents of the input matrix
+    *_input = A;
 
-    typedef matrix< M, N, float_t > m_type;
+    return compute_sigma_and_overwrite_input( *_input, S );
+}
 
-m_type* AA = new m_type( A );
 
+template< size_t M, size_t N, typename float_t >
+bool
+lapack_svd< M, N, float_t >::compute_sigma_and_overwrite_input(
+    matrix< M, N, float_t >& A,
+    vector< N, float_t >& S
+    )
+{
     p.jobu      = 'N';
     p.jobvt     = 'N';
-    p.a         = AA->array;
+    p.a         = A.array;
     p.u         = 0;
     p.s         = S.array;
     p.vt        = 0;
+    p.ldvt      = N;
 
     lapack::svd_call< float_t >( p );
 
- delete AA;
-
-     return p.info == 0;
-
+    return p.info == 0;
 }
 
 
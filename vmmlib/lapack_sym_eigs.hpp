@@ -231,6 +231,8 @@ struct lapack_sym_eigs
 
     typedef std::pair< float_t, size_t >  eigv_pair_type;
 
+    // queries and allocates the workspace once; keep the solver around
+    // (or use lapack_solver_pool) to reuse it for many decompositions.
     lapack_sym_eigs();
     ~lapack_sym_eigs();
 
@@ -259,6 +261,30 @@ struct lapack_sym_eigs
                  evalues_type& eigvalues_
                  );
 
+    // in-place versions of the above, A is destroyed
+    template< size_t X>
+    bool compute_x_and_overwrite_input(
+                     m_input_type& A,
+                     matrix< N, X, float_t >& eigvectors_,
+                     vector< X, float_t >& eigvalues_
+                     );
+
+    bool compute_1st_and_overwrite_input(
+                   m_input_type& A,
+                   evector_type& eigvector_,
+                   float_t& eigvalue_
+                   );
+
+    bool compute_all_and_overwrite_input(
+                 m_input_type& A,
+                 evectors_type& eigvectors_,
+                 evalues_type& eigvalues_
+                 );
+
+    // scratch matrix owned by the solver. fill it and pass it to the
+    // *_and_overwrite_input variants to avoid allocations.
+    m_input_type& get_input_scratch() { return *_input; }
+
     inline bool test_success( lapack::lapack_int info );
 
     lapack::eigs_params< float_t > p;
@@ -274,11 +300,28 @@ struct lapack_sym_eigs
         }
     };
 
+protected:
+    // sorts the eigenvalues in _all_eigvalues by decreasing magnitude into _permutation
+    void sort_by_magnitude();
+
+    m_input_type*                   _input;
+    evectors_type*                  _all_eigvectors;
+    evalues_type*                   _all_eigvalues;
+    std::vector< eigv_pair_type >   _permutation;
+
+private:
+    // owns the workspace
+    lapack_sym_eigs( const lapack_sym_eigs& );
+    lapack_sym_eigs& operator=( const lapack_sym_eigs& );
+
 }; // struct lapack_sym_eigs
 
 
 template< size_t N, typename float_t >
 lapack_sym_eigs< N, float_t >::lapack_sym_eigs()
+    : _input( new m_input_type )
+    , _all_eigvectors( new evectors_type )
+    , _all_eigvalues( new evalues_type )
 {
     p.jobz      = 'V'; // Compute eigenvalues and eigenvectors.
     p.range     = 'A'; // all eigenvalues will be found.
@@ -309,6 +352,7 @@ lapack_sym_eigs< N, float_t >::lapack_sym_eigs()
 
     p.work = new float_t[ p.lwork ];
 
+    _permutation.reserve( N );
 }
 
 
@@ -319,6 +363,9 @@ lapack_sym_eigs< N, float_t >::~lapack_sym_eigs()
     delete[] p.work;
     delete[] p.iwork;
     delete[] p.ifail;
+    delete _input;
+    delete _all_eigvectors;
+    delete _all_eigvalues;
 }
 
 template< size_t N, typename float_t >
@@ -330,10 +377,21 @@ lapack_sym_eigs< N, float_t >::compute_all(
                                         )
 {
     // lapack destroys the contents of the input matrix
-    m_input_type* AA = new m_input_type( A );
+    *_input = A;
+    return compute_all_and_overwrite_input( *_input, eigvectors_, eigvalues_ );
+}
+
 
+template< size_t N, typename float_t >
+bool
+lapack_sym_eigs< N, float_t >::compute_all_and_overwrite_input(
+                                        m_input_type& A,
+                                        evectors_type& eigvectors_,
+                                        evalues_type& eigvalues_
+                                        )
+{
     p.range     = 'A'; // all eigenvalues will be found.
-    p.a         = AA->array;
+    p.a         = A.array;
     p.ldz       = N;
     p.w         = eigvalues_.array;
     p.z         = eigvectors_.array;
@@ -342,72 +400,72 @@ lapack_sym_eigs< N, float_t >::compute_all(
 
     lapack::sym_eigs_call< float_t >( p );
 
-    delete AA;
-
     return p.info == 0;
 }
 
 
 template< size_t N, typename float_t >
-template< size_t X >
-bool
-lapack_sym_eigs< N, float_t >::compute_x(
-                                        const m_input_type& A,
-                                        matrix< N, X, float_t >& eigvectors_,
-                                        vector< X, float_t >& eigvalues_
-                                        )
+void
+lapack_sym_eigs< N, float_t >::sort_by_magnitude()
 {
-    //(1) get all eigenvalues and eigenvectors
-    evectors_type* all_eigvectors = new evectors_type;
-    evalues_type* all_eigvalues = new evalues_type;
-    compute_all( A, *all_eigvectors, *all_eigvalues );
-
-    //(2) sort the eigenvalues
     //std::pair< data, original_index >;
-    std::vector< eigv_pair_type >* eig_permutations = new std::vector< eigv_pair_type >;
+    _permutation.clear();
 
-    evalue_const_iterator it = all_eigvalues->begin(), it_end = all_eigvalues->end();
+    evalue_const_iterator it = _all_eigvalues->begin(), it_end = _all_eigvalues->end();
     size_t counter = 0;
     for( ; it != it_end; ++it, ++counter )
     {
-        eig_permutations->push_back( eigv_pair_type( *it, counter ) );
+        _permutation.push_back( eigv_pair_type( *it, counter ) );
     }
 
     std::sort(
-                eig_permutations->begin(),
-                eig_permutations->end(),
+                _permutation.begin(),
+                _permutation.end(),
                 eigenvalue_compare()
               );
+}
+
+
+template< size_t N, typename float_t >
+template< size_t X >
+bool
+lapack_sym_eigs< N, float_t >::compute_x(
+                                        const m_input_type& A,
+                                        matrix< N, X, float_t >& eigvectors_,
+                                        vector< X, float_t >& eigvalues_
+                                        )
+{
+    *_input = A;
+    return compute_x_and_overwrite_input( *_input, eigvectors_, eigvalues_ );
+}
 
-    delete all_eigvalues;
 
-    //sort the eigenvectors according to eigenvalue permutations
-    evectors_type* sorted_eigvectors = new evectors_type;
-    evalues_type* sorted_eigvalues = new evalues_type;
-    typename std::vector< eigv_pair_type >::const_iterator it2 = eig_permutations->begin(), it2_end = eig_permutations->end();
-    evalue_iterator evalues_it = sorted_eigvalues->begin();
+template< size_t N, typename float_t >
+template< size_t X >
+bool
+lapack_sym_eigs< N, float_t >::compute_x_and_overwrite_input(
+                                        m_input_type& A,
+                                        matrix< N, X, float_t >& eigvectors_,
+                                        vector< X, float_t >& eigvalues_
+                                        )
+{
+    //(1) get all eigenvalues and eigenvectors
+    compute_all_and_overwrite_input( A, *_all_eigvectors, *_all_eigvalues );
 
-    for( counter = 0; it2 != it2_end; ++it2, ++evalues_it, ++counter )
-    {
-        *evalues_it = it2->first;
-        sorted_eigvectors->set_column( counter, all_eigvectors->get_column( it2->second ));
-    }
-    delete all_eigvectors;
-    delete eig_permutations;
+    //(2) sort the eigenvalues
+    sort_by_magnitude();
 
     //(3) select the largest magnitude eigenvalues and the corresponding eigenvectors
-    typename vector< X, float_t >::iterator it3 = eigvalues_.begin(), it3_end = eigvalues_.end();
-    evalues_it = sorted_eigvalues->begin();
-    for( ; it3 != it3_end; ++it3, ++evalues_it )
+    for( size_t x = 0; x < X; ++x )
     {
-        *it3 = *evalues_it;
+        const size_t index = _permutation[ x ].second;
+        eigvalues_( x ) = _permutation[ x ].first;
+        for( size_t row = 0; row < N; ++row )
+        {
+            eigvectors_( row, x ) = (*_all_eigvectors)( row, index );
+        }
     }
 
-    sorted_eigvectors->get_sub_matrix( eigvectors_ );
-
-    delete sorted_eigvectors;
-    delete sorted_eigvalues;
-
     return p.info == 0;
 }
 
@@ -419,37 +477,26 @@ lapack_sym_eigs< N, float_t >::compute_1st(
                                          float_t& eigvalue_
                                          )
 {
-    //(1) get all eigenvalues and eigenvectors
-    evectors_type* all_eigvectors = new evectors_type;
-    evalues_type* all_eigvalues = new evalues_type;
-    compute_all( A, *all_eigvectors, *all_eigvalues );
-
-    //(2) sort the eigenvalues
-    //std::pair< data, original_index >;
-    std::vector< eigv_pair_type >* eig_permutations = new std::vector< eigv_pair_type >;
-
-    evalue_const_iterator it = all_eigvalues->begin(), it_end = all_eigvalues->end();
-    size_t counter = 0;
-    for( ; it != it_end; ++it, ++counter )
-    {
-        eig_permutations->push_back( eigv_pair_type( *it, counter ) );
-    }
+    *_input = A;
+    return compute_1st_and_overwrite_input( *_input, eigvector_, eigvalue_ );
+}
 
-    std::sort(
-              eig_permutations->begin(),
-              eig_permutations->end(),
-              eigenvalue_compare()
-              );
+template< size_t N, typename float_t >
+bool
+lapack_sym_eigs< N, float_t >::compute_1st_and_overwrite_input(
+                                         m_input_type& A,
+                                         evector_type& eigvector_,
+                                         float_t& eigvalue_
+                                         )
+{
+    //(1) get all eigenvalues and eigenvectors
+    compute_all_and_overwrite_input( A, *_all_eigvectors, *_all_eigvalues );
 
     //(2) select the largest magnitude eigenvalue and the corresponding eigenvector
-    typename std::vector< eigv_pair_type >::const_iterator it2 = eig_permutations->begin();
-
-    eigvalue_ = it2->first;
-    all_eigvectors->get_column( it2->second, eigvector_ );
+    sort_by_magnitude();
 
-    delete eig_permutations;
-    delete all_eigvalues;
-    delete all_eigvectors;
+    eigvalue_ = _permutation.front().first;
+    _all_eigvectors->get_column( _permutation.front().second, eigvector_ );
 
     return p.info == 0;
 }
@@ -38,6 +38,9 @@
 namespace vmml
 {
 
+// legacy code based on matrix_mxn, see batched_least_squares.hpp for
+// fitting many small problems.
+
 // beta_hat = ( Xt * X )^-1 * Xt * y;
 // beta_hat -> best-fit 'solutions' to a,b = [ a,b ]transposed.
 
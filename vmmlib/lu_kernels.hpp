@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__LU_KERNELS__HPP__
+#define __VMML__LU_KERNELS__HPP__
+
+#include <cmath>
+#include <cstddef>
+
+/**
+ *  LU factorization with partial pivoting, P * A = L * U, for fixed-size
+ *  N x N matrices stored column-major in a raw array (as matrix< N, N, T >).
+ *  the factorization is done in place: the strictly lower triangle holds L
+ *  (unit diagonal not stored), the upper triangle holds U. pivots[ j ] is the
+ *  row that was swapped with row j in step j (LAPACK getrf convention, but
+ *  zero-based).
+ *
+ *  all loop bounds depend on N only, so the compiler fully unrolls the
+ *  kernels for small N. for N > LU_BLOCK_SIZE the factorization is blocked:
+ *  a panel of LU_BLOCK_SIZE columns is factorized, then the trailing matrix
+ *  is updated with one rank-LU_BLOCK_SIZE update instead of one rank-1 update
+ *  per column, which keeps the panel in the cache.
+ *
+ *  no memory is allocated, everything works on the caller's storage.
+ */
+
+namespace vmml
+{
+namespace kernels
+{
+
+static const size_t LU_BLOCK_SIZE = 16;
+
+// factorizes a in place. returns the sign of the permutation ( +1 / -1 ),
+// or 0 if an exactly zero pivot was found; a is incomplete then.
+template< size_t N, typename T >
+int lu_factorize( T* a, size_t* pivots );
+
+// returns det( A ) from the factorization and the sign of lu_factorize.
+template< size_t N, typename T >
+T lu_determinant( const T* lu, int sign );
+
+// returns the smallest and largest magnitude of the diagonal of U.
+template< size_t N, typename T >
+void lu_pivot_range( const T* lu, T& min_pivot, T& max_pivot );
+
+// solves A * X = B in place for nrhs right-hand sides, B is N x nrhs
+// (column-major, leading dimension N).
+template< size_t N, typename T >
+void lu_solve( const T* lu, const size_t* pivots, T* b, size_t nrhs = 1 );
+
+// solves A^T * X = B in place, same layout as lu_solve.
+template< size_t N, typename T >
+void lu_solve_transposed( const T* lu, const size_t* pivots, T* b, size_t nrhs = 1 );
+
+// writes A^-1 to inverse, which must not alias lu.
+template< size_t N, typename T >
+void lu_solve_transposed( const T* lu, const size_t* pivots, T* b, size_t nrhs )
+{
+    for( size_t r = 0; r < nrhs; ++r )
+    {
+        T* x = b + r * N;
+
+        // U^T * y = b, U^T is lower triangular, column j of U is contiguous
+        for( size_t j = 0; j < N; ++j )
+        {
+            const T* col_j = lu + j * N;
+            T y = x[ j ];
+            for( size_t i = 0; i < j; ++i )
+                y -= col_j[ i ] * x[ i ];
+            x[ j ] = y / col_j[ j ];
+        }
+
+        // L^T * z = y
+        for( size_t j = N; j-- > 0; )
+        {
+            const T* col_j = lu + j * N;
+            T z = x[ j ];
+            for( size_t i = j + 1; i < N; ++i )
+                z -= col_j[ i ] * x[ i ];
+            x[ j ] = z;
+        }
+
+        // x = P^T * z, the interchanges in reverse order
+        for( size_t j = N; j-- > 0; )
+        {
+            if ( pivots[ j ] != j )
+            {
+                const T tmp = x[ j ];
+                x[ j ] = x[ pivots[ j ] ];
+                x[ pivots[ j ] ] = tmp;
+            }
+        }
+    }
+}
+
+
+
+template< size_t N, typename T >
+void lu_invert( const T* lu, const size_t* pivots, T* inverse );
+
+
+
+template< size_t N, typename T >
+int lu_factorize( T* a, size_t* pivots )
+{
+    int sign = 1;
+    for( size_t k0 = 0; k0 < N; k0 += LU_BLOCK_SIZE )
+    {
+        const size_t k1 = k0 + LU_BLOCK_SIZE < N ? k0 + LU_BLOCK_SIZE : N;
+
+        // factorize the panel, columns k0 .. k1-1
+        for( size_t j = k0; j < k1; ++j )
+        {
+            T* col_j = a + j * N;
+
+            size_t pivot = j;
+            T max_value = std::fabs( col_j[ j ] );
+            for( size_t i = j + 1; i < N; ++i )
+            {
+                const T value = std::fabs( col_j[ i ] );
+                if ( value > max_value )
+                {
+                    max_value = value;
+                    pivot = i;
+                }
+            }
+            pivots[ j ] = pivot;
+            if ( max_value == T( 0 ) )
+                return 0;
+
+            // swap whole rows, so the columns left of the panel and the
+            // ones right of it need no deferred interchanges
+            if ( pivot != j )
+            {
+                sign = -sign;
+                for( size_t c = 0; c < N; ++c )
+                {
+                    T* col = a + c * N;
+                    const T tmp = col[ j ];
+                    col[ j ] = col[ pivot ];
+                    col[ pivot ] = tmp;
+                }
+            }
+
+            const T reciprocal = T( 1 ) / col_j[ j ];
+            for( size_t i = j + 1; i < N; ++i )
+                col_j[ i ] *= reciprocal;
+
+            // rank-1 update of the rest of the panel
+            for( size_t c = j + 1; c < k1; ++c )
+            {
+                T* col = a + c * N;
+                const T u = col[ j ];
+                for( size_t i = j + 1; i < N; ++i )
+                    col[ i ] -= col_j[ i ] * u;
+            }
+        }
+
+        // U12 = L11^-1 * A12, then A22 -= L21 * U12, column by column
+        for( size_t c = k1; c < N; ++c )
+        {
+            T* col = a + c * N;
+            for( size_t j = k0; j < k1; ++j )
+            {
+                const T* col_j = a + j * N;
+                const T u = col[ j ];
+                for( size_t i = j + 1; i < k1; ++i )
+                    col[ i ] -= col_j[ i ] * u;
+            }
+            for( size_t j = k0; j < k1; ++j )
+            {
+                const T* col_j = a + j * N;
+                const T u = col[ j ];
+                for( size_t i = k1; i < N; ++i )
+                    col[ i ] -= col_j[ i ] * u;
+            }
+        }
+    }
+    return sign;
+}
+
+
+
+template< size_t N, typename T >
+T lu_determinant( const T* lu, int sign )
+{
+    if ( sign == 0 )
+        return T( 0 );
+
+    T det = T( sign );
+    for( size_t j = 0; j < N; ++j )
+        det *= lu[ j * N + j ];
+    return det;
+}
+
+
+
+template< size_t N, typename T >
+void lu_pivot_range( const T* lu, T& min_pivot, T& max_pivot )
+{
+    min_pivot = max_pivot = std::fabs( lu[ 0 ] );
+    for( size_t j = 1; j < N; ++j )
+    {
+        const T value = std::fabs( lu[ j * N + j ] );
+        if ( value < min_pivot )
+            min_pivot = value;
+        if ( value > max_pivot )
+            max_pivot = value;
+    }
+}
+
+
+
+template< size_t N, typename T >
+void lu_solve( const T* lu, const size_t* pivots, T* b, size_t nrhs )
+{
+    for( size_t r = 0; r < nrhs; ++r )
+    {
+        T* x = b + r * N;
+
+        for( size_t j = 0; j < N; ++j )
+        {
+            if ( pivots[ j ] != j )
+            {
+                const T tmp = x[ j ];
+                x[ j ] = x[ pivots[ j ] ];
+                x[ pivots[ j ] ] = tmp;
+            }
+        }
+
+        // L * y = P * b, column-oriented
+        for( size_t j = 0; j < N; ++j )
+        {
+            const T* col_j = lu + j * N;
+            const T y = x[ j ];
+            for( size_t i = j + 1; i < N; ++i )
+                x[ i ] -= col_j[ i ] * y;
+        }
+
+        // U * x = y
+        for( size_t j = N; j-- > 0; )
+        {
+            const T* col_j = lu + j * N;
+            x[ j ] /= col_j[ j ];
+            const T y = x[ j ];
+            for( size_t i = 0; i < j; ++i )
+                x[ i ] -= col_j[ i ] * y;
+        }
+    }
+}
+
+
+
+template< size_t N, typename T >
+void lu_invert( const T* lu, const size_t* pivots, T* inverse )
+{
+    for( size_t i = 0; i < N * N; ++i )
+        inverse[ i ] = T( 0 );
+    for( size_t j = 0; j < N; ++j )
+        inverse[ j * N + j ] = T( 1 );
+
+    lu_solve< N >( lu, pivots, inverse, N );
+}
+
+} // namespace kernels
+} // namespace vmml
+
+#endif
@@ -38,7 +38,9 @@
 #include <vmmlib/vector.hpp>
 #include <vmmlib/math.hpp>
 #include <vmmlib/exception.hpp>
+#include <vmmlib/random.hpp>
 #include <vmmlib/enable_if.hpp>
+#include <vmmlib/lu_kernels.hpp>
 
 #include <iostream>
 #include <iomanip>
@@ -48,11 +50,14 @@
 #include <algorithm>
 #include <string>
 #include <cstring>
+#include <cassert>
 #include <fstream>   // file I/O
 
 namespace vmml
 {
 
+template< size_t N, typename T > class symmetric_matrix;
+
 // matrix of type T with m rows and n columns
 template< size_t M, size_t N, typename T = float >
 class matrix
@@ -194,6 +199,8 @@ public:
 
     //symmetric covariance matrix of a right matrix multiplication: MxN x NxM = MxM
     void	symmetric_covariance( matrix< M, M, T >& cov_m_ ) const;
+    //same, into packed storage (see packed_matrix.hpp), half the memory and work
+    void	symmetric_covariance( symmetric_matrix< M, T >& cov_m_ ) const;
 
 
     const matrix& operator=( const matrix< M, N, T >& source_ );
@@ -225,6 +232,8 @@ public:
     //if seed is set to -1, srand( seed ) was set outside set_random
     //otherwise srand( seed ) will be called with the given seed
     void set_random( int seed = -1 );
+    // uniform in [-1, 1), reproducible and independent of rand()
+    void set_random( random_generator& rng_ );
 
     //sets all matrix values with discrete cosine transform coefficients (receive orthonormal coefficients)
     void set_dct();
@@ -249,6 +258,15 @@ public:
     template< typename TT >
         void dequantize( matrix< M, N, TT >& quantized_, const TT& min_value, const TT& max_value ) const;
 
+    // linear quantization with one min/max range per column, or per block of
+    // block_rows_ rows of each column if block_rows_ is set (0 = whole column).
+    // ranges_ stores ( min, max ) pairs, block-wise within each column
+    template< typename TT >
+        void quantize_columns( matrix< M, N, TT >& quantized_, std::vector< T >& ranges_, size_t block_rows_ = 0 ) const;
+    template< typename TT >
+        void dequantize_columns( matrix< M, N, TT >& dequantized_, const std::vector< TT >& ranges_, size_t block_rows_ = 0 ) const;
+    static size_t get_number_of_column_blocks( size_t block_rows_ );
+
     void columnwise_sum( vector< N, T>& summed_columns_ ) const;
     double sum_elements() const;
 
@@ -301,11 +319,43 @@ public:
 
     // the return value indicates if the matrix is invertible.
     // we need a tolerance term since the computation of the determinant is
-    // subject to precision errors.
+    // subject to precision errors. up to 4x4 the absolute determinant is
+    // compared with tolerance, larger matrices are inverted using an LU
+    // factorization and compare the smallest pivot with tolerance times the
+    // largest entry, see compute_lu.
     template< size_t O, size_t P, typename TT >
     bool inverse( matrix< O, P, TT >& inverse_,
                   T tolerance = std::numeric_limits<T>::epsilon(),
-        typename enable_if< M == N && O == P && O == M && M >= 2 && M <= 4, TT >::type* = 0 ) const;
+        typename enable_if< M == N && O == P && O == M && M >= 2, TT >::type* = 0 ) const;
+
+    // fast paths for 4x4 transformations, see compute_inverse_rigid,
+    // compute_inverse_affine and compute_inverse_fast.
+    template< size_t O, size_t P, typename TT >
+    void inverse_rigid( matrix< O, P, TT >& inverse_,
+        typename enable_if< M == N && O == P && O == M && M == 4, TT >::type* = 0 ) const;
+
+    template< size_t O, size_t P, typename TT >
+    bool inverse_affine( matrix< O, P, TT >& inverse_,
+                  T tolerance = std::numeric_limits<T>::epsilon(),
+        typename enable_if< M == N && O == P && O == M && M == 4, TT >::type* = 0 ) const;
+
+    template< size_t O, size_t P, typename TT >
+    bool inverse_fast( matrix< O, P, TT >& inverse_,
+                  T tolerance = std::numeric_limits<T>::epsilon(),
+        typename enable_if< M == N && O == P && O == M && M == 4, TT >::type* = 0 ) const;
+
+    // solves this * x = b using an LU factorization with partial pivoting,
+    // see compute_solve. returns false if the matrix is singular, with the
+    // relative pivot test of compute_lu for all sizes.
+    template< typename TT >
+    bool solve( const vector< M, TT >& b, vector< M, TT >& x,
+                T tolerance = std::numeric_limits<T>::epsilon(),
+        typename enable_if< M == N, TT >::type* = 0 ) const;
+
+    template< size_t O, typename TT >
+    bool solve( const matrix< M, O, TT >& b, matrix< M, O, TT >& x,
+                T tolerance = std::numeric_limits<T>::epsilon(),
+        typename enable_if< M == N, TT >::type* = 0 ) const;
 
     template< size_t O, size_t P >
     typename enable_if< O == P && M == N && O == M && M >= 2 >::type*
@@ -651,6 +701,63 @@ inline T compute_determinant( const matrix< 4, 4, T >& m )
 
 
 
+// working copy for the LU based functions below. matrices larger than
+// LU_STACK_ORDER x LU_STACK_ORDER are allocated on the heap, so loops over
+// such sizes should keep one workspace and pass it to the overloads taking
+// a lu_workspace.
+static const size_t LU_STACK_ORDER = 16;
+
+template< size_t M, typename T, bool on_heap = ( M > LU_STACK_ORDER ) >
+class lu_workspace
+{
+public:
+    matrix< M, M, T >& get() { return _lu; }
+
+private:
+    matrix< M, M, T > _lu;
+};
+
+template< size_t M, typename T >
+class lu_workspace< M, T, true >
+{
+public:
+    lu_workspace() : _lu( new matrix< M, M, T > ) {}
+    ~lu_workspace() { delete _lu; }
+    matrix< M, M, T >& get() { return *_lu; }
+
+private:
+    matrix< M, M, T >* _lu;
+
+    lu_workspace( const lu_workspace& );
+    lu_workspace& operator=( const lu_workspace& );
+};
+
+
+// product of the pivots of an LU factorization, computed in workspace_
+template< size_t M, typename T >
+inline T compute_determinant( const matrix< M, M, T >& m_,
+                              lu_workspace< M, T >& workspace_ )
+{
+    matrix< M, M, T >& lu = workspace_.get();
+    lu = m_;
+    size_t pivots[ M ];
+    const int sign = kernels::lu_factorize< M >( lu.array, pivots );
+    return kernels::lu_determinant< M >( lu.array, sign );
+}
+
+
+
+// larger matrices: LU factorization
+template< size_t M, typename T >
+inline T compute_determinant( const matrix< M, M, T >& m_,
+    typename enable_if< ( M > 4 ) >::type* = 0 )
+{
+    lu_workspace< M, T > workspace;
+    return compute_determinant( m_, workspace );
+}
+
+
+
 template< typename T >
 bool compute_inverse( const matrix< 2, 2, T >& m_, matrix< 2, 2, T >& inverse_,
                       T tolerance_ = std::numeric_limits<T>::epsilon())
@@ -769,6 +876,303 @@ bool compute_inverse( const matrix< 4, 4, T >& m_,
 }
 
 
+
+// LU factorization with partial pivoting, P * m_ = L * U, see lu_kernels.hpp
+// for the layout of lu_ and pivots_. since the determinant easily under- or
+// overflows for large matrices, m_ is considered singular if the smallest
+// pivot is not above tolerance_ times the largest absolute entry of m_.
+// note that this relative test is used by compute_solve for all sizes and
+// by compute_inverse above 4x4, while the cofactor inverses of 2x2 to 4x4
+// compare the absolute determinant with tolerance_.
+// lu_ may be m_. use kernels::lu_solve to reuse the factorization.
+template< size_t M, typename T >
+bool compute_lu( const matrix< M, M, T >& m_, matrix< M, M, T >& lu_,
+                 size_t* pivots_,
+                 T tolerance_ = std::numeric_limits<T>::epsilon() )
+{
+    T max_value = 0;
+    for( size_t i = 0; i < M * M; ++i )
+    {
+        const T value = fabs( m_.array[ i ] );
+        if ( value > max_value )
+            max_value = value;
+    }
+
+    if ( &lu_ != &m_ )
+        lu_ = m_;
+    if ( kernels::lu_factorize< M >( lu_.array, pivots_ ) == 0 )
+        return false;
+
+    T min_pivot, max_pivot;
+    kernels::lu_pivot_range< M >( lu_.array, min_pivot, max_pivot );
+    return min_pivot > tolerance_ * max_value;
+}
+
+
+
+// inverse using the LU factorization in workspace_, see compute_lu.
+template< size_t M, typename T >
+bool compute_inverse( const matrix< M, M, T >& m_, matrix< M, M, T >& inverse_,
+                      lu_workspace< M, T >& workspace_,
+                      T tolerance_ = std::numeric_limits<T>::epsilon() )
+{
+    matrix< M, M, T >& lu = workspace_.get();
+    size_t pivots[ M ];
+    if ( !compute_lu( m_, lu, pivots, tolerance_ ))
+        return false; // matrix is not invertible
+
+    kernels::lu_invert< M >( lu.array, pivots, inverse_.array );
+    return true;
+}
+
+
+
+// larger matrices are inverted using the LU factorization, see compute_lu.
+template< size_t M, typename T >
+bool compute_inverse( const matrix< M, M, T >& m_, matrix< M, M, T >& inverse_,
+                      T tolerance_ = std::numeric_limits<T>::epsilon(),
+                      typename enable_if< ( M > 4 ) >::type* = 0 )
+{
+    lu_workspace< M, T > workspace;
+    return compute_inverse( m_, inverse_, workspace, tolerance_ );
+}
+
+
+
+// solves m_ * x_ = b_ for one or several right-hand sides using an LU
+// factorization with partial pivoting. the factorization is shared by all
+// columns of b_. see compute_lu for the singularity test. x_ may be b_.
+template< size_t M, size_t O, typename T >
+bool compute_solve( const matrix< M, M, T >& m_, const matrix< M, O, T >& b_,
+                    matrix< M, O, T >& x_, lu_workspace< M, T >& workspace_,
+                    T tolerance_ = std::numeric_limits<T>::epsilon() )
+{
+    matrix< M, M, T >& lu = workspace_.get();
+    size_t pivots[ M ];
+    if ( !compute_lu( m_, lu, pivots, tolerance_ ))
+        return false;
+
+    if ( &x_ != &b_ )
+        x_ = b_;
+    kernels::lu_solve< M >( lu.array, pivots, x_.array, O );
+    return true;
+}
+
+
+
+template< size_t M, size_t O, typename T >
+bool compute_solve( const matrix< M, M, T >& m_, const matrix< M, O, T >& b_,
+                    matrix< M, O, T >& x_,
+                    T tolerance_ = std::numeric_limits<T>::epsilon() )
+{
+    lu_workspace< M, T > workspace;
+    return compute_solve( m_, b_, x_, workspace, tolerance_ );
+}
+
+
+
+template< size_t M, typename T >
+bool compute_solve( const matrix< M, M, T >& m_, const vector< M, T >& b_,
+                    vector< M, T >& x_, lu_workspace< M, T >& workspace_,
+                    T tolerance_ = std::numeric_limits<T>::epsilon() )
+{
+    matrix< M, M, T >& lu = workspace_.get();
+    size_t pivots[ M ];
+    if ( !compute_lu( m_, lu, pivots, tolerance_ ))
+        return false;
+
+    if ( &x_ != &b_ )
+        x_ = b_;
+    kernels::lu_solve< M >( lu.array, pivots, x_.array );
+    return true;
+}
+
+
+
+template< size_t M, typename T >
+bool compute_solve( const matrix< M, M, T >& m_, const vector< M, T >& b_,
+                    vector< M, T >& x_,
+                    T tolerance_ = std::numeric_limits<T>::epsilon() )
+{
+    lu_workspace< M, T > workspace;
+    return compute_solve( m_, b_, x_, workspace, tolerance_ );
+}
+
+
+
+// the last row of an affine 4x4 transformation is ( 0 0 0 1 )
+template< typename T >
+inline bool is_affine_transform( const matrix< 4, 4, T >& m_ )
+{
+    const T* array = m_.array;
+    return array[ 3 ] == T( 0 ) && array[ 7 ] == T( 0 ) &&
+           array[ 11 ] == T( 0 ) && array[ 15 ] == T( 1 );
+}
+
+
+
+// a rigid transformation is affine with an orthonormal upper-left 3x3 R
+// (rotation or reflection): || R^T * R - I ||_F <= tolerance_.
+template< typename T >
+bool is_rigid_transform( const matrix< 4, 4, T >& m_,
+                         T tolerance_ = 64 * std::numeric_limits<T>::epsilon() )
+{
+    if( !is_affine_transform( m_ ))
+        return false;
+
+    // a sum of squares instead of a maximum, which would need
+    // unpredictable branches
+    const T* c0 = m_.array;
+    const T* c1 = m_.array + 4;
+    const T* c2 = m_.array + 8;
+    const T d00 = c0[ 0 ] * c0[ 0 ] + c0[ 1 ] * c0[ 1 ] + c0[ 2 ] * c0[ 2 ] - T( 1 );
+    const T d11 = c1[ 0 ] * c1[ 0 ] + c1[ 1 ] * c1[ 1 ] + c1[ 2 ] * c1[ 2 ] - T( 1 );
+    const T d22 = c2[ 0 ] * c2[ 0 ] + c2[ 1 ] * c2[ 1 ] + c2[ 2 ] * c2[ 2 ] - T( 1 );
+    const T d01 = c0[ 0 ] * c1[ 0 ] + c0[ 1 ] * c1[ 1 ] + c0[ 2 ] * c1[ 2 ];
+    const T d02 = c0[ 0 ] * c2[ 0 ] + c0[ 1 ] * c2[ 1 ] + c0[ 2 ] * c2[ 2 ];
+    const T d12 = c1[ 0 ] * c2[ 0 ] + c1[ 1 ] * c2[ 1 ] + c1[ 2 ] * c2[ 2 ];
+
+    const T error = d00 * d00 + d11 * d11 + d22 * d22
+                  + T( 2 ) * ( d01 * d01 + d02 * d02 + d12 * d12 );
+    return error <= tolerance_ * tolerance_;
+}
+
+
+
+// [ R t; 0 1 ]^-1 = [ R^T -R^T*t; 0 1 ]: a transpose and 9 multiplications.
+// m_ must be rigid, this is only checked (assert) in debug builds.
+// inverse_ may be m_.
+template< typename T >
+void compute_inverse_rigid( const matrix< 4, 4, T >& m_, matrix< 4, 4, T >& inverse_ )
+{
+    assert( is_rigid_transform( m_, std::sqrt( std::numeric_limits<T>::epsilon( ))));
+
+    const T* array = m_.array;
+    const T r00 = array[ 0 ], r10 = array[ 1 ], r20 = array[ 2 ];
+    const T r01 = array[ 4 ], r11 = array[ 5 ], r21 = array[ 6 ];
+    const T r02 = array[ 8 ], r12 = array[ 9 ], r22 = array[ 10 ];
+    const T t0 = array[ 12 ], t1 = array[ 13 ], t2 = array[ 14 ];
+
+    T* inv = inverse_.array;
+    inv[ 0 ] = r00; inv[ 1 ] = r01; inv[ 2 ]  = r02; inv[ 3 ]  = 0;
+    inv[ 4 ] = r10; inv[ 5 ] = r11; inv[ 6 ]  = r12; inv[ 7 ]  = 0;
+    inv[ 8 ] = r20; inv[ 9 ] = r21; inv[ 10 ] = r22; inv[ 11 ] = 0;
+    inv[ 12 ] = -( r00 * t0 + r10 * t1 + r20 * t2 );
+    inv[ 13 ] = -( r01 * t0 + r11 * t1 + r21 * t2 );
+    inv[ 14 ] = -( r02 * t0 + r12 * t1 + r22 * t2 );
+    inv[ 15 ] = 1;
+}
+
+
+
+// [ A t; 0 1 ]^-1 = [ A^-1 -A^-1*t; 0 1 ]: a 3x3 inverse by cofactors and
+// 9 multiplications. m_ must be affine, this is only checked (assert) in
+// debug builds. inverse_ may be m_.
+template< typename T >
+bool compute_inverse_affine( const matrix< 4, 4, T >& m_, matrix< 4, 4, T >& inverse_,
+                             T tolerance_ = std::numeric_limits<T>::epsilon() )
+{
+    assert( is_affine_transform( m_ ));
+
+    const T* array = m_.array;
+    const T m00 = array[ 0 ], m10 = array[ 1 ], m20 = array[ 2 ];
+    const T m01 = array[ 4 ], m11 = array[ 5 ], m21 = array[ 6 ];
+    const T m02 = array[ 8 ], m12 = array[ 9 ], m22 = array[ 10 ];
+    const T t0 = array[ 12 ], t1 = array[ 13 ], t2 = array[ 14 ];
+
+    const T i00 = m11 * m22 - m12 * m21;
+    const T i01 = m02 * m21 - m01 * m22;
+    const T i02 = m01 * m12 - m02 * m11;
+    const T i10 = m12 * m20 - m10 * m22;
+    const T i11 = m00 * m22 - m02 * m20;
+    const T i12 = m02 * m10 - m00 * m12;
+    const T i20 = m10 * m21 - m11 * m20;
+    const T i21 = m01 * m20 - m00 * m21;
+    const T i22 = m00 * m11 - m01 * m10;
+
+    const T determinant = m00 * i00 + m01 * i10 + m02 * i20;
+    if( fabs( determinant ) <= tolerance_ )
+        return false; // matrix is not invertible
+
+    const T detinv = static_cast< T >( 1.0 ) / determinant;
+
+    T* inv = inverse_.array;
+    inv[ 0 ] = i00 * detinv; inv[ 1 ] = i10 * detinv; inv[ 2 ]  = i20 * detinv; inv[ 3 ]  = 0;
+    inv[ 4 ] = i01 * detinv; inv[ 5 ] = i11 * detinv; inv[ 6 ]  = i21 * detinv; inv[ 7 ]  = 0;
+    inv[ 8 ] = i02 * detinv; inv[ 9 ] = i12 * detinv; inv[ 10 ] = i22 * detinv; inv[ 11 ] = 0;
+    inv[ 12 ] = -( inv[ 0 ] * t0 + inv[ 4 ] * t1 + inv[ 8 ] * t2 );
+    inv[ 13 ] = -( inv[ 1 ] * t0 + inv[ 5 ] * t1 + inv[ 9 ] * t2 );
+    inv[ 14 ] = -( inv[ 2 ] * t0 + inv[ 6 ] * t1 + inv[ 10 ] * t2 );
+    inv[ 15 ] = 1;
+    return true;
+}
+
+
+
+// picks the cheapest inverse: rigid, affine or the general 4x4 inverse.
+// the rigid test costs 24 multiplications for affine matrices, so for
+// matrices known to be affine compute_inverse_affine is faster.
+template< typename T >
+bool compute_inverse_fast( const matrix< 4, 4, T >& m_, matrix< 4, 4, T >& inverse_,
+                           T tolerance_ = std::numeric_limits<T>::epsilon() )
+{
+    if( !is_affine_transform( m_ ))
+        return compute_inverse( m_, inverse_, tolerance_ );
+
+    if( is_rigid_transform( m_ ))
+    {
+        compute_inverse_rigid( m_, inverse_ );
+        return true;
+    }
+    return compute_inverse_affine( m_, inverse_, tolerance_ );
+}
+
+
+
+// batched versions, e.g. for skinning and scene graph traversals. large
+// batches are distributed over OpenMP threads. the affine and fast versions
+// return the number of invertible matrices.
+template< typename T >
+void compute_inverse_rigid( const matrix< 4, 4, T >* m_, matrix< 4, 4, T >* inverse_,
+                            size_t count_ )
+{
+    const long count = static_cast< long >( count_ );
+#pragma omp parallel for if( count > 4096 )
+    for( long i = 0; i < count; ++i )
+        compute_inverse_rigid( m_[ i ], inverse_[ i ] );
+}
+
+
+
+template< typename T >
+size_t compute_inverse_affine( const matrix< 4, 4, T >* m_, matrix< 4, 4, T >* inverse_,
+                               size_t count_,
+                               T tolerance_ = std::numeric_limits<T>::epsilon() )
+{
+    const long count = static_cast< long >( count_ );
+    long n_inverted = 0;
+#pragma omp parallel for reduction(+:n_inverted) if( count > 4096 )
+    for( long i = 0; i < count; ++i )
+        n_inverted += compute_inverse_affine( m_[ i ], inverse_[ i ], tolerance_ ) ? 1 : 0;
+    return static_cast< size_t >( n_inverted );
+}
+
+
+
+template< typename T >
+size_t compute_inverse_fast( const matrix< 4, 4, T >* m_, matrix< 4, 4, T >* inverse_,
+                             size_t count_,
+                             T tolerance_ = std::numeric_limits<T>::epsilon() )
+{
+    const long count = static_cast< long >( count_ );
+    long n_inverted = 0;
+#pragma omp parallel for reduction(+:n_inverted) if( count > 4096 )
+    for( long i = 0; i < count; ++i )
+        n_inverted += compute_inverse_fast( m_[ i ], inverse_[ i ], tolerance_ ) ? 1 : 0;
+    return static_cast< size_t >( n_inverted );
+}
+
+
 // this function returns the transpose of a matrix
 // however, using matrix::transpose_to( .. ) avoids the copy.
 template< size_t M, size_t N, typename T >
@@ -1268,21 +1672,35 @@ void
 matrix< M, N, T >::
 symmetric_covariance( matrix< M, M, T >& cov_m_ ) const
 {
-    T tmp = 0;
-    for( size_t row = 0; row < M; ++row )
+    // rank-1 updates of the lower triangle run down contiguous columns
+    for( size_t i = 0; i < M * M; ++i )
+        cov_m_.array[ i ] = 0;
+
+    for( size_t k = 0; k < N; ++k )
     {
-        for( size_t col = row; col < M; ++col )
+        const T* a_k = array + k * M;
+        for( size_t col = 0; col < M; ++col )
         {
-            for ( size_t k = 0; k < N; ++k )
-            {
-                tmp += (at( row, k ) * at( col, k ));
-            }
-
-            cov_m_.at( row, col ) = tmp;
-            cov_m_.at( col, row ) = tmp;
-            tmp = 0;
+            const T a_col = a_k[ col ];
+            T* c = cov_m_.array + col * M;
+            for( size_t row = col; row < M; ++row )
+                c[ row ] += a_k[ row ] * a_col;
         }
     }
+
+    for( size_t col = 0; col < M; ++col )
+        for( size_t row = col + 1; row < M; ++row )
+            cov_m_.array[ row * M + col ] = cov_m_.array[ col * M + row ];
+}
+
+
+
+template< size_t M, size_t N, typename T >
+void
+matrix< M, N, T >::
+symmetric_covariance( symmetric_matrix< M, T >& cov_m_ ) const
+{
+    cov_m_.set_aat( *this );
 }
 
 
@@ -1683,7 +2101,7 @@ template< size_t M, size_t N, typename T >
 template< size_t O, size_t P, typename TT >
 inline bool matrix< M, N, T >::inverse( matrix< O, P, TT >& inverse_,
                                         T tolerance, typename
-    enable_if< M == N && O == P && O == M && M >= 2 && M <= 4, TT >::type* )
+    enable_if< M == N && O == P && O == M && M >= 2, TT >::type* )
     const
 {
     return compute_inverse( *this, inverse_, tolerance );
@@ -1691,6 +2109,63 @@ inline bool matrix< M, N, T >::inverse( matrix< O, P, TT >& inverse_,
 
 
 
+template< size_t M, size_t N, typename T >
+template< typename TT >
+inline bool matrix< M, N, T >::solve( const vector< M, TT >& b,
+                                      vector< M, TT >& x, T tolerance,
+    typename enable_if< M == N, TT >::type* ) const
+{
+    return compute_solve( *this, b, x, tolerance );
+}
+
+
+
+template< size_t M, size_t N, typename T >
+template< size_t O, typename TT >
+inline bool matrix< M, N, T >::solve( const matrix< M, O, TT >& b,
+                                      matrix< M, O, TT >& x, T tolerance,
+    typename enable_if< M == N, TT >::type* ) const
+{
+    return compute_solve( *this, b, x, tolerance );
+}
+
+
+
+template< size_t M, size_t N, typename T >
+template< size_t O, size_t P, typename TT >
+inline void matrix< M, N, T >::inverse_rigid( matrix< O, P, TT >& inverse_,
+    typename enable_if< M == N && O == P && O == M && M == 4, TT >::type* )
+    const
+{
+    compute_inverse_rigid( *this, inverse_ );
+}
+
+
+
+template< size_t M, size_t N, typename T >
+template< size_t O, size_t P, typename TT >
+inline bool matrix< M, N, T >::inverse_affine( matrix< O, P, TT >& inverse_,
+                                               T tolerance, typename
+    enable_if< M == N && O == P && O == M && M == 4, TT >::type* )
+    const
+{
+    return compute_inverse_affine( *this, inverse_, tolerance );
+}
+
+
+
+template< size_t M, size_t N, typename T >
+template< size_t O, size_t P, typename TT >
+inline bool matrix< M, N, T >::inverse_fast( matrix< O, P, TT >& inverse_,
+                                             T tolerance, typename
+    enable_if< M == N && O == P && O == M && M == 4, TT >::type* )
+    const
+{
+    return compute_inverse_fast( *this, inverse_, tolerance );
+}
+
+
+
 template< size_t M, size_t N, typename T >
 template< size_t O, size_t P >
 typename enable_if< O == P && M == N && O == M && M >= 2 >::type*
@@ -2507,6 +2982,96 @@ matrix< M, N, T >::dequantize( matrix< M, N, TT >& dequantized_, const TT& min_v
     }
 }
 
+template< size_t M, size_t N, typename T >
+size_t
+matrix< M, N, T >::get_number_of_column_blocks( size_t block_rows_ )
+{
+    if ( block_rows_ == 0 || block_rows_ > M )
+        return 1;
+    return ( M + block_rows_ - 1 ) / block_rows_;
+}
+
+
+
+template< size_t M, size_t N, typename T >
+template< typename TT  >
+void
+matrix< M, N, T >::quantize_columns( matrix< M, N, TT >& quantized_, std::vector< T >& ranges_, size_t block_rows_ ) const
+{
+    const size_t n_blocks = get_number_of_column_blocks( block_rows_ );
+    const size_t rows_per_block = ( n_blocks == 1 ) ? M : block_rows_;
+    ranges_.resize( 2 * N * n_blocks );
+
+    const double min_tt_range = double( std::numeric_limits< TT >::min() );
+    const double tt_range = double( std::numeric_limits< TT >::max() ) - min_tt_range;
+
+    for( size_t col = 0; col < N; ++col )
+    {
+        const T* column = array + col * M;
+        TT* quantized_column = quantized_.array + col * M;
+        for( size_t block = 0; block < n_blocks; ++block )
+        {
+            const size_t row_begin = block * rows_per_block;
+            const size_t row_end = std::min( row_begin + rows_per_block, M );
+
+            T min_value = column[ row_begin ];
+            T max_value = column[ row_begin ];
+            for( size_t row = row_begin + 1; row < row_end; ++row )
+            {
+                min_value = std::min( min_value, column[ row ] );
+                max_value = std::max( max_value, column[ row ] );
+            }
+            ranges_[ 2 * ( col * n_blocks + block ) ] = min_value;
+            ranges_[ 2 * ( col * n_blocks + block ) + 1 ] = max_value;
+
+            //constant blocks are mapped to the lowest level
+            const double scale = ( max_value > min_value ) ? tt_range / double( max_value - min_value ) : 0.0;
+            for( size_t row = row_begin; row < row_end; ++row )
+            {
+                const double level = std::floor( double( column[ row ] - min_value ) * scale + 0.5 );
+                quantized_column[ row ] = TT( min_tt_range + std::min( level, tt_range ));
+            }
+        }
+    }
+}
+
+
+
+template< size_t M, size_t N, typename T >
+template< typename TT  >
+void
+matrix< M, N, T >::dequantize_columns( matrix< M, N, TT >& dequantized_, const std::vector< TT >& ranges_, size_t block_rows_ ) const
+{
+    const size_t n_blocks = get_number_of_column_blocks( block_rows_ );
+    const size_t rows_per_block = ( n_blocks == 1 ) ? M : block_rows_;
+    if ( ranges_.size() != 2 * N * n_blocks )
+        VMMLIB_ERROR( "dequantize_columns: ranges do not match the number of column blocks", VMMLIB_HERE );
+
+    const double min_t_range = double( std::numeric_limits< T >::min() );
+    const double t_range = double( std::numeric_limits< T >::max() ) - min_t_range;
+
+    for( size_t col = 0; col < N; ++col )
+    {
+        const T* column = array + col * M;
+        TT* dequantized_column = dequantized_.array + col * M;
+        for( size_t block = 0; block < n_blocks; ++block )
+        {
+            const size_t row_begin = block * rows_per_block;
+            const size_t row_end = std::min( row_begin + rows_per_block, M );
+            const TT min_value = ranges_[ 2 * ( col * n_blocks + block ) ];
+            const TT max_value = ranges_[ 2 * ( col * n_blocks + block ) + 1 ];
+            const double step = double( max_value - min_value ) / t_range;
+
+            for( size_t row = row_begin; row < row_end; ++row )
+            {
+                dequantized_column[ row ] = TT( double( min_value ) + ( double( column[ row ] ) - min_t_range ) * step );
+            }
+        }
+    }
+}
+
+
+
 template< size_t M, size_t N, typename T >
 void
 matrix< M, N, T >::columnwise_sum( vector< N, T>& summed_columns_ ) const
@@ -2593,6 +3158,13 @@ matrix< M, N, T >::set_random( int seed )
     }
 }
 
+template< size_t M, size_t N, typename T >
+void
+matrix< M, N, T >::set_random( random_generator& rng_ )
+{
+    rng_.fill_uniform( array, M * N, -1.0, 1.0 );
+}
+
 template< size_t M, size_t N, typename T >
 void
 matrix< M, N, T >::write_to_raw( const std::string& dir_, const std::string& filename_ ) const
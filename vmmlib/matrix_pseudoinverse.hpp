@@ -38,6 +38,8 @@
 #include <cstddef>
 #include <functional>
 #include <vmmlib/lapack_svd.hpp>
+#include <vmmlib/jacobi_svd.hpp>
+#include <vmmlib/cholesky_solver.hpp>
 #include <vmmlib/blas_dgemm.hpp>
 
 /*
@@ -46,9 +48,36 @@
  - the tolerance for the significant singular values is optionally set
  - implementation works only for matrices with more rows than columns or quadratic
    matrices. use a transposed input matrix for matrices with more columns than rows
+ - inputs up to 8x8 use the allocation-free jacobi_svd, larger ones lapack_svd
+
+ *** pseudoinverse_solver< M, N, T, Tinternal > ***
+ - owns its workspace (allocated once), so keep it around for repeated calls
+ - any shape, the pseudoinverse or its transpose are written directly
+ - the decomposition runs in Tinternal (double by default, as in
+   compute_pseudoinverse), the result is converted to T
+ - well-conditioned inputs use the normal equations: A^+ = ( A^T A )^-1 A^T
+   via a cholesky factorization of the gram matrix (A A^T for wide inputs).
+   the gram matrix squares the condition number, so the shortcut is only
+   taken if the reciprocal 1-norm condition number of the gram matrix, as
+   estimated by cholesky_solver (hager/higham, like lapack xPOCON), is above
+   the rcond threshold (default sqrt( eps )); the error is then about
+   eps / rcond. otherwise the SVD is used.
+ - singular values below tolerance * sigma_max are treated as zero (SVD path)
  */
 
 namespace vmml {
+
+    template< size_t M, size_t N, typename T,
+              bool small = ( M <= 8 && N <= 8 ) >
+    struct pseudoinverse_svd {
+        typedef lapack_svd< M, N, T > type;
+    };
+
+    template< size_t M, size_t N, typename T >
+    struct pseudoinverse_svd< M, N, T, true > {
+        typedef jacobi_svd< M, N, T > type;
+    };
+
     // T            - vmml::matrix<...> or compatible
     // Tinternal    - float or double
 
@@ -67,10 +96,10 @@ namespace vmml {
         typedef vector< T::COLS, Tinternal > vec_n_type;
         typedef vector< T::ROWS, Tinternal > vec_m_type;
 
-        typedef lapack_svd< T::ROWS, T::COLS, Tinternal > svd_type;
+        typedef typename pseudoinverse_svd< T::ROWS, T::COLS, Tinternal >::type svd_type;
         typedef blas_dgemm< T::COLS, 1, T::ROWS, Tinternal > blas_type;
 
-        typedef lapack_svd< T::COLS, T::ROWS, Tinternal > svd_type_inv;
+        typedef typename pseudoinverse_svd< T::COLS, T::ROWS, Tinternal >::type svd_type_inv;
         typedef blas_dgemm< T::ROWS, 1, T::COLS, Tinternal > blas_type_inv;
 
         struct tmp_matrices {
@@ -264,6 +293,223 @@ namespace vmml {
 
 
 
+    // T            - value type of the input and the result
+    // Tinternal    - float or double, type of the decomposition
+
+    template< size_t M, size_t N, typename T = double, typename Tinternal = double >
+    class pseudoinverse_solver {
+    public:
+        // the decomposition works on B = A (M >= N) or B = A^T, P x Q
+        static const size_t P = M >= N ? M : N;
+        static const size_t Q = M >= N ? N : M;
+
+        typedef matrix< M, N, T > matrix_type;
+        typedef matrix< N, M, T > pinv_type;
+        typedef typename pseudoinverse_svd< P, Q, Tinternal >::type svd_type;
+
+        pseudoinverse_solver();
+        ~pseudoinverse_solver();
+
+        // pinv_ = A^+
+        void compute(const matrix_type& A_, pinv_type& pinv_,
+                T tolerance_ = P * std::numeric_limits< T >::epsilon());
+
+        // pinv_t_ = ( A^+ )^T, the layout of compute_pseudoinverse
+        void compute_transposed(const matrix_type& A_, matrix_type& pinv_t_,
+                T tolerance_ = P * std::numeric_limits< T >::epsilon());
+
+        void set_normal_equations(bool enable_) { _normal_equations = enable_; }
+        bool get_normal_equations() const { return _normal_equations; }
+
+        void set_rcond_threshold(Tinternal threshold_) { _rcond_threshold = threshold_; }
+        Tinternal get_rcond_threshold() const { return _rcond_threshold; }
+
+        // of the last call
+        bool used_normal_equations() const { return _used_normal_equations; }
+        size_t get_rank() const { return _rank; }
+
+    protected:
+        struct workspace {
+            matrix< P, Q, Tinternal > input; // B, replaced by U
+            matrix< Q, Q, Tinternal > gram;
+            matrix< Q, Q, Tinternal > coefficients; // ( B^T B )^-1 or Vt
+            matrix< Q, Q, Tinternal > coefficients_t;
+            matrix< P, Q, Tinternal > result; // P x Q or Q x P, before the conversion to T
+            vector< Q, Tinternal > sigmas;
+            cholesky_solver< Q, Tinternal > gram_solver;
+        };
+
+        // writes pinv( B )^T ( P x Q ) if b_transposed_, else pinv( B )
+        void _compute(const matrix_type& A_, T* out_, bool b_transposed_,
+                T tolerance_);
+
+        // out = X * C (P x Q) or its transpose, X = input, the first rank_
+        // columns of X and rows of C
+        void _multiply(size_t rank_, T* out_, bool b_transposed_);
+
+        workspace* _work;
+        svd_type* _svd;
+        Tinternal _rcond_threshold;
+        bool _normal_equations;
+        bool _used_normal_equations;
+        size_t _rank;
+
+    private:
+        // owns the workspace
+        pseudoinverse_solver(const pseudoinverse_solver&);
+        pseudoinverse_solver& operator=(const pseudoinverse_solver&);
+
+    }; // class pseudoinverse_solver
+
+
+
+    template< size_t M, size_t N, typename T, typename Tinternal >
+    pseudoinverse_solver< M, N, T, Tinternal >::pseudoinverse_solver()
+    : _work(new workspace)
+    , _svd(0)
+    , _rcond_threshold(std::sqrt(std::numeric_limits< Tinternal >::epsilon()))
+    , _normal_equations(true)
+    , _used_normal_equations(false)
+    , _rank(0) {
+    }
+
+
+
+    template< size_t M, size_t N, typename T, typename Tinternal >
+    pseudoinverse_solver< M, N, T, Tinternal >::~pseudoinverse_solver() {
+        delete _svd;
+        delete _work;
+    }
+
+
+
+    template< size_t M, size_t N, typename T, typename Tinternal >
+    void
+    pseudoinverse_solver< M, N, T, Tinternal >::compute(const matrix_type& A_, pinv_type& pinv_,
+            T tolerance_) {
+        // A^+ = pinv( B ) for tall A, pinv( B )^T for wide A
+        _compute(A_, pinv_.array, M < N, tolerance_);
+    }
+
+
+
+    template< size_t M, size_t N, typename T, typename Tinternal >
+    void
+    pseudoinverse_solver< M, N, T, Tinternal >::compute_transposed(const matrix_type& A_,
+            matrix_type& pinv_t_, T tolerance_) {
+        _compute(A_, pinv_t_.array, M >= N, tolerance_);
+    }
+
+
+
+    template< size_t M, size_t N, typename T, typename Tinternal >
+    void
+    pseudoinverse_solver< M, N, T, Tinternal >::_compute(const matrix_type& A_, T* out_,
+            bool b_transposed_, T tolerance_) {
+        workspace& w = *_work;
+
+        Tinternal* in = w.input.array;
+        for (size_t col = 0; col < N; ++col) {
+            for (size_t row = 0; row < M; ++row) {
+                if (M >= N)
+                    in[ col * P + row ] = Tinternal(A_.array[ col * M + row ]);
+                else
+                    in[ row * P + col ] = Tinternal(A_.array[ col * M + row ]);
+            }
+        }
+        const Tinternal tolerance = Tinternal(tolerance_);
+
+        _used_normal_equations = false;
+        if (_normal_equations) {
+            // gram matrix B^T B
+            for (size_t i = 0; i < Q; ++i) {
+                for (size_t j = 0; j <= i; ++j) {
+                    const Tinternal* b_i = in + i * P;
+                    const Tinternal* b_j = in + j * P;
+                    Tinternal sum = 0;
+                    for (size_t k = 0; k < P; ++k)
+                        sum += b_i[ k ] * b_j[ k ];
+                    w.gram(i, j) = sum;
+                    w.gram(j, i) = sum;
+                }
+            }
+
+            const Tinternal threshold = (std::max)(_rcond_threshold, tolerance * tolerance);
+            if (w.gram_solver.factorize(w.gram) && w.gram_solver.is_spd()
+                    && w.gram_solver.reciprocal_condition_estimate() > threshold) {
+                w.gram_solver.compute_inverse(w.coefficients);
+                _used_normal_equations = true;
+                _rank = Q;
+                _multiply(Q, out_, b_transposed_);
+                return;
+            }
+        }
+
+        // B = U * diag( sigma ) * Vt, pinv( B ) = V * diag( sigma )^+ * U^T
+        if (_svd == 0)
+            _svd = new svd_type;
+        if (!_svd->compute_and_overwrite_input(w.input, w.sigmas, w.coefficients))
+            VMMLIB_ERROR("pseudoinverse - svd failed.", VMMLIB_HERE);
+
+        const Tinternal limit = tolerance * w.sigmas(0);
+        _rank = 0;
+        while (_rank < Q && w.sigmas(_rank) > limit)
+            ++_rank;
+
+        // U * diag( sigma )^+
+        for (size_t k = 0; k < _rank; ++k) {
+            const Tinternal scale = Tinternal(1) / w.sigmas(k);
+            Tinternal* u_k = in + k * P;
+            for (size_t i = 0; i < P; ++i)
+                u_k[ i ] *= scale;
+        }
+        _multiply(_rank, out_, b_transposed_);
+    }
+
+
+
+    template< size_t M, size_t N, typename T, typename Tinternal >
+    void
+    pseudoinverse_solver< M, N, T, Tinternal >::_multiply(size_t rank_, T* out_, bool b_transposed_) {
+        const Tinternal* x = _work->input.array;
+        const Tinternal* c = _work->coefficients.array;
+        Tinternal* result = _work->result.array;
+
+        for (size_t i = 0; i < P * Q; ++i)
+            result[ i ] = Tinternal(0);
+
+        if (b_transposed_) {
+            // P x Q, column i of the result is X * C( :, i )
+            for (size_t i = 0; i < Q; ++i) {
+                Tinternal* result_i = result + i * P;
+                for (size_t k = 0; k < rank_; ++k) {
+                    const Tinternal c_ki = c[ i * Q + k ];
+                    const Tinternal* x_k = x + k * P;
+                    for (size_t r = 0; r < P; ++r)
+                        result_i[ r ] += x_k[ r ] * c_ki;
+                }
+            }
+        } else {
+            // Q x P, column r of the result is C^T * X( r, : )^T
+            Tinternal* c_t = _work->coefficients_t.array;
+            _work->coefficients.transpose_to(_work->coefficients_t);
+            for (size_t r = 0; r < P; ++r) {
+                Tinternal* result_r = result + r * Q;
+                for (size_t k = 0; k < rank_; ++k) {
+                    const Tinternal x_rk = x[ k * P + r ];
+                    const Tinternal* c_t_k = c_t + k * Q;
+                    for (size_t i = 0; i < Q; ++i)
+                        result_r[ i ] += c_t_k[ i ] * x_rk;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < P * Q; ++i)
+            out_[ i ] = T(result[ i ]);
+    }
+
+
+
 
 }// end vmml namespace
 
@@ -0,0 +1,1161 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__PACKED_MATRIX__HPP__
+#define __VMML__PACKED_MATRIX__HPP__
+
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+#include <vmmlib/exception.hpp>
+#include <vmmlib/dot_kernels.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+/**
+ *
+ *   packed storage for structured square matrices.
+ *
+ *   symmetric_matrix< N, T > keeps the lower triangle column by column
+ *   (LAPACK 'L' packed layout, as used by the xSP and xPP routines):
+ *   element ( row, col ), row >= col, is at
+ *
+ *       array[ row + col * ( 2N - col - 1 ) / 2 ],
+ *
+ *   which takes N ( N + 1 ) / 2 values instead of N * N. both triangles
+ *   are accessible through operator(), writes go to the stored element.
+ *
+ *   triangular_matrix< N, T, UPPER > keeps the lower (or upper) triangle
+ *   in the same packed layout as LAPACK's xTP routines; the other
+ *   triangle reads as zero.
+ *
+ *   banded_matrix< N, KL, KU, T > keeps the KL sub- and KU
+ *   superdiagonals in the LAPACK xGB layout: element ( row, col ) with
+ *   -KU <= row - col <= KL is at array[ KU + row - col + col * LDAB ],
+ *   LDAB = KL + KU + 1. its LU factorization is a banded_matrix< N, KL,
+ *   KL + KU, T >, the layout of LAPACK's xGBTRF. for symmetric band
+ *   matrices see lapack_banded_sym_eigs.hpp.
+ *
+ *   all kernels run down the stored columns, i.e. over contiguous memory.
+ *   set() / get() convert from and to dense matrices.
+ *
+ **
+ */
+
+namespace vmml
+{
+
+template< size_t N, typename T, bool UPPER > class triangular_matrix;
+
+template< size_t N, typename T = double >
+class symmetric_matrix
+{
+public:
+    typedef T   value_type;
+
+    static const size_t ROWS = N;
+    static const size_t COLS = N;
+    static const size_t SIZE = N * ( N + 1 ) / 2;
+
+    // identity, like the square matrix
+    symmetric_matrix();
+
+    // position of ( row, col ) in array, row >= col
+    static size_t index( size_t row_, size_t col_ )
+        { return row_ + col_ * ( 2 * N - col_ - 1 ) / 2; }
+
+    // either triangle, ( row, col ) and ( col, row ) are the same element
+    inline T& operator()( size_t row_, size_t col_ );
+    inline const T& operator()( size_t row_, size_t col_ ) const;
+
+    inline T& at( size_t row_, size_t col_ );
+    inline const T& at( size_t row_, size_t col_ ) const;
+
+    void zero();
+    void identity();
+
+    bool operator==( const symmetric_matrix& other_ ) const;
+    bool operator!=( const symmetric_matrix& other_ ) const;
+    bool equals( const symmetric_matrix& other_, T tolerance_ ) const;
+
+    // conversions, set() reads the lower triangle of dense_
+    void set( const matrix< N, N, T >& dense_ );
+    void get( matrix< N, N, T >& dense_ ) const;
+
+    // A A^T of an N x K matrix (e.g. the covariance of an unfolding)
+    template< size_t K >
+    void set_aat( const matrix< N, K, T >& a_ );
+
+    // A^T A of a K x N matrix (e.g. the gram matrix of a factor matrix)
+    template< size_t K >
+    void set_ata( const matrix< K, N, T >& a_ );
+
+    // result_ = *this * x_
+    void multiply( const vector< N, T >& x_, vector< N, T >& result_ ) const;
+
+    // result_ = *this * b_
+    template< size_t K >
+    void multiply( const matrix< N, K, T >& b_, matrix< N, K, T >& result_ ) const;
+
+    // x^T * this * x
+    T quadratic_form( const vector< N, T >& x_ ) const;
+
+    // hadamard product, stays symmetric
+    void multiply_piecewise( const symmetric_matrix& other_ );
+
+    // sum / frobenius norm over all N * N elements
+    T sum_elements() const;
+    double frobenius_norm() const;
+
+    // cholesky factor L, *this = L L^T. returns false if *this is not
+    // (numerically) positive definite.
+    bool cholesky( triangular_matrix< N, T, false >& l_ ) const;
+
+    // solves *this * x = b with a cholesky factorization.
+    // returns false if *this is not positive definite.
+    bool solve( const vector< N, T >& b_, vector< N, T >& x_ ) const;
+
+    T   array[ SIZE ];
+
+}; // class symmetric_matrix
+
+
+
+template< size_t N, typename T = double, bool UPPER = false >
+class triangular_matrix
+{
+public:
+    typedef T   value_type;
+
+    static const size_t ROWS = N;
+    static const size_t COLS = N;
+    static const size_t SIZE = N * ( N + 1 ) / 2;
+
+    // identity, like the square matrix
+    triangular_matrix();
+
+    // position of ( row, col ) in array, ( row, col ) in the triangle
+    static size_t index( size_t row_, size_t col_ )
+    {
+        return UPPER ? row_ + col_ * ( col_ + 1 ) / 2
+                     : row_ + col_ * ( 2 * N - col_ - 1 ) / 2;
+    }
+
+    static bool is_stored( size_t row_, size_t col_ )
+        { return UPPER ? row_ <= col_ : row_ >= col_; }
+
+    // zero outside the triangle
+    inline T operator()( size_t row_, size_t col_ ) const;
+
+    // stored elements only
+    inline T& at( size_t row_, size_t col_ );
+    inline const T& at( size_t row_, size_t col_ ) const;
+
+    void zero();
+    void identity();
+
+    bool operator==( const triangular_matrix& other_ ) const;
+    bool operator!=( const triangular_matrix& other_ ) const;
+
+    // conversions, set() reads the triangle of dense_ and ignores the rest
+    void set( const matrix< N, N, T >& dense_ );
+    void get( matrix< N, N, T >& dense_ ) const;
+
+    // result_ = *this * x_
+    void multiply( const vector< N, T >& x_, vector< N, T >& result_ ) const;
+
+    // result_ = *this^T * x_
+    void multiply_transposed( const vector< N, T >& x_, vector< N, T >& result_ ) const;
+
+    // solves *this * x = b by substitution. returns false on a zero on
+    // the diagonal. x_ and b_ may be the same vector.
+    bool solve( const vector< N, T >& b_, vector< N, T >& x_ ) const;
+
+    // solves *this^T * x = b
+    bool solve_transposed( const vector< N, T >& b_, vector< N, T >& x_ ) const;
+
+    // solves *this * X = B for K right-hand sides
+    template< size_t K >
+    bool solve( const matrix< N, K, T >& b_, matrix< N, K, T >& x_ ) const;
+
+    T   determinant() const;
+
+    T   array[ SIZE ];
+
+protected:
+    bool _solve( T* x_ ) const;
+    bool _solve_transposed( T* x_ ) const;
+
+}; // class triangular_matrix
+
+
+
+template< size_t N, size_t KL, size_t KU, typename T = double >
+class banded_matrix
+{
+public:
+    typedef T   value_type;
+
+    static const size_t ROWS = N;
+    static const size_t COLS = N;
+    static const size_t LDAB = KL + KU + 1;
+    static const size_t SIZE = LDAB * N;
+
+    // identity, like the square matrix
+    banded_matrix();
+
+    // position of ( row, col ) in array, ( row, col ) in the band
+    static size_t index( size_t row_, size_t col_ )
+        { return KU + row_ - col_ + col_ * LDAB; }
+
+    static bool is_stored( size_t row_, size_t col_ )
+        { return row_ <= col_ + KL && col_ <= row_ + KU; }
+
+    // zero outside the band
+    inline T operator()( size_t row_, size_t col_ ) const;
+
+    // stored elements only
+    inline T& at( size_t row_, size_t col_ );
+    inline const T& at( size_t row_, size_t col_ ) const;
+
+    void zero();
+    void identity();
+
+    // conversions, set() reads the band of dense_ and ignores the rest
+    void set( const matrix< N, N, T >& dense_ );
+    void get( matrix< N, N, T >& dense_ ) const;
+
+    // result_ = *this * x_
+    void multiply( const vector< N, T >& x_, vector< N, T >& result_ ) const;
+
+    // result_ = *this^T * x_
+    void multiply_transposed( const vector< N, T >& x_, vector< N, T >& result_ ) const;
+
+    // LU factor with KL + KU superdiagonals for the fill-in of the row
+    // interchanges
+    typedef banded_matrix< N, KL, KL + KU, T > lu_type;
+
+    // LU factorization with partial pivoting, P * this = L U (as LAPACK's
+    // xGBTF2): U in the upper band of lu_, the multipliers of L below the
+    // diagonal. row j was swapped with row pivots_[ j ]. returns false if
+    // *this is singular.
+    bool lu( lu_type& lu_, size_t* pivots_ ) const;
+
+    // solves with a factorization from lu() in place (as xGBTRS)
+    static void lu_solve( const lu_type& lu_, const size_t* pivots_, T* x_ );
+
+    // solves *this * x = b with an LU factorization. returns false if
+    // *this is singular. x_ and b_ may be the same vector.
+    bool solve( const vector< N, T >& b_, vector< N, T >& x_ ) const;
+
+    // solves *this * X = B for K right-hand sides with one factorization
+    template< size_t K >
+    bool solve( const matrix< N, K, T >& b_, matrix< N, K, T >& x_ ) const;
+
+    // the slots of the LAPACK layout outside the matrix
+    // (array[ 0 .. KU - 1 ] of the first columns, ...) are kept at zero.
+    T   array[ SIZE ];
+
+}; // class banded_matrix
+
+
+
+//
+// symmetric_matrix
+//
+
+template< size_t N, typename T >
+symmetric_matrix< N, T >::symmetric_matrix()
+    : array()
+{
+    for( size_t i = 0; i < N; ++i )
+        array[ index( i, i ) ] = static_cast< T >( 1.0 );
+}
+
+
+template< size_t N, typename T >
+inline T&
+symmetric_matrix< N, T >::operator()( size_t row_, size_t col_ )
+{
+    return at( row_, col_ );
+}
+
+
+template< size_t N, typename T >
+inline const T&
+symmetric_matrix< N, T >::operator()( size_t row_, size_t col_ ) const
+{
+    return at( row_, col_ );
+}
+
+
+template< size_t N, typename T >
+inline T&
+symmetric_matrix< N, T >::at( size_t row_, size_t col_ )
+{
+#ifdef VMMLIB_SAFE_ACCESSORS
+    if ( row_ >= N || col_ >= N )
+        VMMLIB_ERROR( "at( row, col ) - index out of bounds", VMMLIB_HERE );
+#endif
+    return row_ >= col_ ? array[ index( row_, col_ ) ] : array[ index( col_, row_ ) ];
+}
+
+
+template< size_t N, typename T >
+inline const T&
+symmetric_matrix< N, T >::at( size_t row_, size_t col_ ) const
+{
+#ifdef VMMLIB_SAFE_ACCESSORS
+    if ( row_ >= N || col_ >= N )
+        VMMLIB_ERROR( "at( row, col ) - index out of bounds", VMMLIB_HERE );
+#endif
+    return row_ >= col_ ? array[ index( row_, col_ ) ] : array[ index( col_, row_ ) ];
+}
+
+
+template< size_t N, typename T >
+void
+symmetric_matrix< N, T >::zero()
+{
+    for( size_t i = 0; i < SIZE; ++i )
+        array[ i ] = static_cast< T >( 0.0 );
+}
+
+
+template< size_t N, typename T >
+void
+symmetric_matrix< N, T >::identity()
+{
+    zero();
+    for( size_t i = 0; i < N; ++i )
+        array[ index( i, i ) ] = static_cast< T >( 1.0 );
+}
+
+
+template< size_t N, typename T >
+bool
+symmetric_matrix< N, T >::operator==( const symmetric_matrix& other_ ) const
+{
+    for( size_t i = 0; i < SIZE; ++i )
+        if ( array[ i ] != other_.array[ i ] )
+            return false;
+    return true;
+}
+
+
+template< size_t N, typename T >
+bool
+symmetric_matrix< N, T >::operator!=( const symmetric_matrix& other_ ) const
+{
+    return ! operator==( other_ );
+}
+
+
+template< size_t N, typename T >
+bool
+symmetric_matrix< N, T >::equals( const symmetric_matrix& other_, T tolerance_ ) const
+{
+    for( size_t i = 0; i < SIZE; ++i )
+        if ( fabs( array[ i ] - other_.array[ i ] ) > tolerance_ )
+            return false;
+    return true;
+}
+
+
+template< size_t N, typename T >
+void
+symmetric_matrix< N, T >::set( const matrix< N, N, T >& dense_ )
+{
+    T* a = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        const T* d = dense_.array + col * N;
+        for( size_t row = col; row < N; ++row )
+            *a++ = d[ row ];
+    }
+}
+
+
+template< size_t N, typename T >
+void
+symmetric_matrix< N, T >::get( matrix< N, N, T >& dense_ ) const
+{
+    const T* a = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        T* d = dense_.array + col * N;
+        d[ col ] = *a++;
+        for( size_t row = col + 1; row < N; ++row, ++a )
+        {
+            d[ row ] = *a;
+            dense_.array[ row * N + col ] = *a;
+        }
+    }
+}
+
+
+template< size_t N, typename T >
+template< size_t K >
+void
+symmetric_matrix< N, T >::set_aat( const matrix< N, K, T >& a_ )
+{
+    // rank-1 update per column of a_, lower triangle only
+    zero();
+    for( size_t k = 0; k < K; ++k )
+    {
+        const T* a_k = a_.array + k * N;
+        T* c = array;
+        for( size_t col = 0; col < N; ++col )
+        {
+            const T a_col = a_k[ col ];
+            for( size_t row = col; row < N; ++row )
+                c[ row - col ] += a_k[ row ] * a_col;
+            c += N - col;
+        }
+    }
+}
+
+
+template< size_t N, typename T >
+template< size_t K >
+void
+symmetric_matrix< N, T >::set_ata( const matrix< K, N, T >& a_ )
+{
+    // dot products of the columns of a_
+    T* c = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        const T* a_col = a_.array + col * K;
+        for( size_t row = col; row < N; ++row )
+        {
+            const T* a_row = a_.array + row * K;
+            *c++ = static_cast< T >( kernels::dot( a_row, a_col, K, kernels::SUMMATION_PLAIN ) );
+        }
+    }
+}
+
+
+template< size_t N, typename T >
+void
+symmetric_matrix< N, T >::multiply( const vector< N, T >& x_, vector< N, T >& result_ ) const
+{
+    // x_ and result_ may be the same vector, y starts at zero
+    vector< N, T > y;
+
+    const T* a = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        const T x_col = x_.array[ col ];
+        T sum = a[ 0 ] * x_col;
+        for( size_t row = col + 1; row < N; ++row )
+        {
+            const T a_rc = a[ row - col ];
+            y.array[ row ] += a_rc * x_col;
+            sum += a_rc * x_.array[ row ];
+        }
+        y.array[ col ] += sum;
+        a += N - col;
+    }
+    result_ = y;
+}
+
+
+template< size_t N, typename T >
+template< size_t K >
+void
+symmetric_matrix< N, T >::multiply( const matrix< N, K, T >& b_, matrix< N, K, T >& result_ ) const
+{
+    vector< N, T > x;
+    for( size_t k = 0; k < K; ++k )
+    {
+        const T* b_k = b_.array + k * N;
+        for( size_t i = 0; i < N; ++i )
+            x.array[ i ] = b_k[ i ];
+        multiply( x, x );
+        T* r_k = result_.array + k * N;
+        for( size_t i = 0; i < N; ++i )
+            r_k[ i ] = x.array[ i ];
+    }
+}
+
+
+template< size_t N, typename T >
+T
+symmetric_matrix< N, T >::quadratic_form( const vector< N, T >& x_ ) const
+{
+    T diag = 0;
+    T off_diag = 0;
+    const T* a = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        const T x_col = x_.array[ col ];
+        diag += a[ 0 ] * x_col * x_col;
+        T sum = 0;
+        for( size_t row = col + 1; row < N; ++row )
+            sum += a[ row - col ] * x_.array[ row ];
+        off_diag += sum * x_col;
+        a += N - col;
+    }
+    return diag + 2 * off_diag;
+}
+
+
+template< size_t N, typename T >
+void
+symmetric_matrix< N, T >::multiply_piecewise( const symmetric_matrix& other_ )
+{
+    for( size_t i = 0; i < SIZE; ++i )
+        array[ i ] *= other_.array[ i ];
+}
+
+
+template< size_t N, typename T >
+T
+symmetric_matrix< N, T >::sum_elements() const
+{
+    T diag = 0;
+    T off_diag = 0;
+    const T* a = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        diag += a[ 0 ];
+        for( size_t row = col + 1; row < N; ++row )
+            off_diag += a[ row - col ];
+        a += N - col;
+    }
+    return diag + 2 * off_diag;
+}
+
+
+template< size_t N, typename T >
+double
+symmetric_matrix< N, T >::frobenius_norm() const
+{
+    double diag = 0.0;
+    double off_diag = 0.0;
+    const T* a = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        diag += double( a[ 0 ] ) * double( a[ 0 ] );
+        for( size_t row = col + 1; row < N; ++row )
+            off_diag += double( a[ row - col ] ) * double( a[ row - col ] );
+        a += N - col;
+    }
+    return sqrt( diag + 2.0 * off_diag );
+}
+
+
+template< size_t N, typename T >
+bool
+symmetric_matrix< N, T >::cholesky( triangular_matrix< N, T, false >& l_ ) const
+{
+    // right-looking, column by column (same layout as LAPACK's xPPTRF 'L')
+    for( size_t i = 0; i < SIZE; ++i )
+        l_.array[ i ] = array[ i ];
+
+    T* l_col = l_.array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        const T d = l_col[ 0 ];
+        if ( !( d > 0 ) )
+            return false;
+        const T l_cc = sqrt( d );
+        l_col[ 0 ] = l_cc;
+        const T inv = static_cast< T >( 1.0 ) / l_cc;
+        for( size_t row = col + 1; row < N; ++row )
+            l_col[ row - col ] *= inv;
+
+        // update the trailing lower triangle
+        T* t = l_col + N - col;
+        for( size_t k = col + 1; k < N; ++k )
+        {
+            const T l_kc = l_col[ k - col ];
+            for( size_t row = k; row < N; ++row )
+                t[ row - k ] -= l_col[ row - col ] * l_kc;
+            t += N - k;
+        }
+        l_col += N - col;
+    }
+    return true;
+}
+
+
+template< size_t N, typename T >
+bool
+symmetric_matrix< N, T >::solve( const vector< N, T >& b_, vector< N, T >& x_ ) const
+{
+    triangular_matrix< N, T, false > l;
+    if ( ! cholesky( l ) )
+        return false;
+    return l.solve( b_, x_ ) && l.solve_transposed( x_, x_ );
+}
+
+
+
+//
+// triangular_matrix
+//
+
+template< size_t N, typename T, bool UPPER >
+triangular_matrix< N, T, UPPER >::triangular_matrix()
+    : array()
+{
+    for( size_t i = 0; i < N; ++i )
+        array[ index( i, i ) ] = static_cast< T >( 1.0 );
+}
+
+
+template< size_t N, typename T, bool UPPER >
+inline T
+triangular_matrix< N, T, UPPER >::operator()( size_t row_, size_t col_ ) const
+{
+#ifdef VMMLIB_SAFE_ACCESSORS
+    if ( row_ >= N || col_ >= N )
+        VMMLIB_ERROR( "( row, col ) - index out of bounds", VMMLIB_HERE );
+#endif
+    return is_stored( row_, col_ ) ? array[ index( row_, col_ ) ] : static_cast< T >( 0.0 );
+}
+
+
+template< size_t N, typename T, bool UPPER >
+inline T&
+triangular_matrix< N, T, UPPER >::at( size_t row_, size_t col_ )
+{
+#ifdef VMMLIB_SAFE_ACCESSORS
+    if ( row_ >= N || col_ >= N || ! is_stored( row_, col_ ) )
+        VMMLIB_ERROR( "at( row, col ) - index outside the triangle", VMMLIB_HERE );
+#endif
+    return array[ index( row_, col_ ) ];
+}
+
+
+template< size_t N, typename T, bool UPPER >
+inline const T&
+triangular_matrix< N, T, UPPER >::at( size_t row_, size_t col_ ) const
+{
+#ifdef VMMLIB_SAFE_ACCESSORS
+    if ( row_ >= N || col_ >= N || ! is_stored( row_, col_ ) )
+        VMMLIB_ERROR( "at( row, col ) - index outside the triangle", VMMLIB_HERE );
+#endif
+    return array[ index( row_, col_ ) ];
+}
+
+
+template< size_t N, typename T, bool UPPER >
+void
+triangular_matrix< N, T, UPPER >::zero()
+{
+    for( size_t i = 0; i < SIZE; ++i )
+        array[ i ] = static_cast< T >( 0.0 );
+}
+
+
+template< size_t N, typename T, bool UPPER >
+void
+triangular_matrix< N, T, UPPER >::identity()
+{
+    zero();
+    for( size_t i = 0; i < N; ++i )
+        array[ index( i, i ) ] = static_cast< T >( 1.0 );
+}
+
+
+template< size_t N, typename T, bool UPPER >
+bool
+triangular_matrix< N, T, UPPER >::operator==( const triangular_matrix& other_ ) const
+{
+    for( size_t i = 0; i < SIZE; ++i )
+        if ( array[ i ] != other_.array[ i ] )
+            return false;
+    return true;
+}
+
+
+template< size_t N, typename T, bool UPPER >
+bool
+triangular_matrix< N, T, UPPER >::operator!=( const triangular_matrix& other_ ) const
+{
+    return ! operator==( other_ );
+}
+
+
+template< size_t N, typename T, bool UPPER >
+void
+triangular_matrix< N, T, UPPER >::set( const matrix< N, N, T >& dense_ )
+{
+    T* a = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        const T* d = dense_.array + col * N;
+        const size_t first = UPPER ? 0 : col;
+        const size_t last = UPPER ? col + 1 : N;
+        for( size_t row = first; row < last; ++row )
+            *a++ = d[ row ];
+    }
+}
+
+
+template< size_t N, typename T, bool UPPER >
+void
+triangular_matrix< N, T, UPPER >::get( matrix< N, N, T >& dense_ ) const
+{
+    const T* a = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        T* d = dense_.array + col * N;
+        for( size_t row = 0; row < N; ++row )
+            d[ row ] = is_stored( row, col ) ? *a++ : static_cast< T >( 0.0 );
+    }
+}
+
+
+template< size_t N, typename T, bool UPPER >
+void
+triangular_matrix< N, T, UPPER >::multiply( const vector< N, T >& x_, vector< N, T >& result_ ) const
+{
+    vector< N, T > y;
+
+    const T* a = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        const T x_col = x_.array[ col ];
+        const size_t first = UPPER ? 0 : col;
+        const size_t last = UPPER ? col + 1 : N;
+        for( size_t row = first; row < last; ++row )
+            y.array[ row ] += a[ row - first ] * x_col;
+        a += last - first;
+    }
+    result_ = y;
+}
+
+
+template< size_t N, typename T, bool UPPER >
+void
+triangular_matrix< N, T, UPPER >::multiply_transposed( const vector< N, T >& x_, vector< N, T >& result_ ) const
+{
+    vector< N, T > y;
+    const T* a = array;
+    for( size_t col = 0; col < N; ++col )
+    {
+        const size_t first = UPPER ? 0 : col;
+        const size_t last = UPPER ? col + 1 : N;
+        T sum = 0;
+        for( size_t row = first; row < last; ++row )
+            sum += a[ row - first ] * x_.array[ row ];
+        y.array[ col ] = sum;
+        a += last - first;
+    }
+    result_ = y;
+}
+
+
+template< size_t N, typename T, bool UPPER >
+bool
+triangular_matrix< N, T, UPPER >::_solve( T* x_ ) const
+{
+    if ( UPPER )
+    {
+        // backward, column oriented
+        for( size_t c = N; c > 0; --c )
+        {
+            const size_t col = c - 1;
+            const T* a = array + col * ( col + 1 ) / 2;
+            if ( a[ col ] == 0 )
+                return false;
+            x_[ col ] /= a[ col ];
+            const T x_col = x_[ col ];
+            for( size_t row = 0; row < col; ++row )
+                x_[ row ] -= a[ row ] * x_col;
+        }
+    } else {
+        // forward, column oriented
+        const T* a = array;
+        for( size_t col = 0; col < N; ++col )
+        {
+            if ( a[ 0 ] == 0 )
+                return false;
+            x_[ col ] /= a[ 0 ];
+            const T x_col = x_[ col ];
+            for( size_t row = col + 1; row < N; ++row )
+                x_[ row ] -= a[ row - col ] * x_col;
+            a += N - col;
+        }
+    }
+    return true;
+}
+
+
+template< size_t N, typename T, bool UPPER >
+bool
+triangular_matrix< N, T, UPPER >::_solve_transposed( T* x_ ) const
+{
+    if ( UPPER )
+    {
+        // forward, dot products with the stored columns
+        const T* a = array;
+        for( size_t col = 0; col < N; ++col )
+        {
+            if ( a[ col ] == 0 )
+                return false;
+            T sum = x_[ col ];
+            for( size_t row = 0; row < col; ++row )
+                sum -= a[ row ] * x_[ row ];
+            x_[ col ] = sum / a[ col ];
+            a += col + 1;
+        }
+    } else {
+        // backward, dot products with the stored columns
+        for( size_t c = N; c > 0; --c )
+        {
+            const size_t col = c - 1;
+            const T* a = array + index( col, col );
+            if ( a[ 0 ] == 0 )
+                return false;
+            T sum = x_[ col ];
+            for( size_t row = col + 1; row < N; ++row )
+                sum -= a[ row - col ] * x_[ row ];
+            x_[ col ] = sum / a[ 0 ];
+        }
+    }
+    return true;
+}
+
+
+template< size_t N, typename T, bool UPPER >
+bool
+triangular_matrix< N, T, UPPER >::solve( const vector< N, T >& b_, vector< N, T >& x_ ) const
+{
+    x_ = b_;
+    return _solve( x_.array );
+}
+
+
+template< size_t N, typename T, bool UPPER >
+bool
+triangular_matrix< N, T, UPPER >::solve_transposed( const vector< N, T >& b_, vector< N, T >& x_ ) const
+{
+    x_ = b_;
+    return _solve_transposed( x_.array );
+}
+
+
+template< size_t N, typename T, bool UPPER >
+template< size_t K >
+bool
+triangular_matrix< N, T, UPPER >::solve( const matrix< N, K, T >& b_, matrix< N, K, T >& x_ ) const
+{
+    x_ = b_;
+    for( size_t k = 0; k < K; ++k )
+        if ( ! _solve( x_.array + k * N ) )
+            return false;
+    return true;
+}
+
+
+template< size_t N, typename T, bool UPPER >
+T
+triangular_matrix< N, T, UPPER >::determinant() const
+{
+    T det = static_cast< T >( 1.0 );
+    for( size_t i = 0; i < N; ++i )
+        det *= array[ index( i, i ) ];
+    return det;
+}
+
+
+
+//
+// banded_matrix
+//
+
+template< size_t N, size_t KL, size_t KU, typename T >
+banded_matrix< N, KL, KU, T >::banded_matrix()
+    : array()
+{
+    for( size_t i = 0; i < N; ++i )
+        array[ index( i, i ) ] = static_cast< T >( 1.0 );
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+inline T
+banded_matrix< N, KL, KU, T >::operator()( size_t row_, size_t col_ ) const
+{
+#ifdef VMMLIB_SAFE_ACCESSORS
+    if ( row_ >= N || col_ >= N )
+        VMMLIB_ERROR( "( row, col ) - index out of bounds", VMMLIB_HERE );
+#endif
+    return is_stored( row_, col_ ) ? array[ index( row_, col_ ) ] : static_cast< T >( 0.0 );
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+inline T&
+banded_matrix< N, KL, KU, T >::at( size_t row_, size_t col_ )
+{
+#ifdef VMMLIB_SAFE_ACCESSORS
+    if ( row_ >= N || col_ >= N || ! is_stored( row_, col_ ) )
+        VMMLIB_ERROR( "at( row, col ) - index outside the band", VMMLIB_HERE );
+#endif
+    return array[ index( row_, col_ ) ];
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+inline const T&
+banded_matrix< N, KL, KU, T >::at( size_t row_, size_t col_ ) const
+{
+#ifdef VMMLIB_SAFE_ACCESSORS
+    if ( row_ >= N || col_ >= N || ! is_stored( row_, col_ ) )
+        VMMLIB_ERROR( "at( row, col ) - index outside the band", VMMLIB_HERE );
+#endif
+    return array[ index( row_, col_ ) ];
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+void
+banded_matrix< N, KL, KU, T >::zero()
+{
+    for( size_t i = 0; i < SIZE; ++i )
+        array[ i ] = static_cast< T >( 0.0 );
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+void
+banded_matrix< N, KL, KU, T >::identity()
+{
+    zero();
+    for( size_t i = 0; i < N; ++i )
+        array[ index( i, i ) ] = static_cast< T >( 1.0 );
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+void
+banded_matrix< N, KL, KU, T >::set( const matrix< N, N, T >& dense_ )
+{
+    zero();
+    for( size_t col = 0; col < N; ++col )
+    {
+        const size_t first = col > KU ? col - KU : 0;
+        const size_t last = ( std::min )( N, col + KL + 1 );
+        const T* d = dense_.array + col * N;
+        for( size_t row = first; row < last; ++row )
+            array[ index( row, col ) ] = d[ row ];
+    }
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+void
+banded_matrix< N, KL, KU, T >::get( matrix< N, N, T >& dense_ ) const
+{
+    for( size_t col = 0; col < N; ++col )
+    {
+        T* d = dense_.array + col * N;
+        for( size_t row = 0; row < N; ++row )
+            d[ row ] = operator()( row, col );
+    }
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+void
+banded_matrix< N, KL, KU, T >::multiply( const vector< N, T >& x_, vector< N, T >& result_ ) const
+{
+    vector< N, T > y;
+
+    for( size_t col = 0; col < N; ++col )
+    {
+        const size_t first = col > KU ? col - KU : 0;
+        const size_t last = ( std::min )( N, col + KL + 1 );
+        const T* a = array + index( first, col );
+        const T x_col = x_.array[ col ];
+        for( size_t row = first; row < last; ++row )
+            y.array[ row ] += a[ row - first ] * x_col;
+    }
+    result_ = y;
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+void
+banded_matrix< N, KL, KU, T >::multiply_transposed( const vector< N, T >& x_, vector< N, T >& result_ ) const
+{
+    vector< N, T > y;
+    for( size_t col = 0; col < N; ++col )
+    {
+        const size_t first = col > KU ? col - KU : 0;
+        const size_t last = ( std::min )( N, col + KL + 1 );
+        const T* a = array + index( first, col );
+        T sum = 0;
+        for( size_t row = first; row < last; ++row )
+            sum += a[ row - first ] * x_.array[ row ];
+        y.array[ col ] = sum;
+    }
+    result_ = y;
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+bool
+banded_matrix< N, KL, KU, T >::lu( lu_type& lu_, size_t* pivots_ ) const
+{
+    lu_.zero();
+    for( size_t col = 0; col < N; ++col )
+    {
+        const size_t first = col > KU ? col - KU : 0;
+        const size_t last = ( std::min )( N, col + KL + 1 );
+        for( size_t row = first; row < last; ++row )
+            lu_.array[ lu_type::index( row, col ) ] = array[ index( row, col ) ];
+    }
+
+    // last column touched by the interchanges so far
+    size_t last_col = 0;
+    for( size_t j = 0; j < N; ++j )
+    {
+        const size_t rows = ( std::min )( KL, N - 1 - j );
+        T* col_j = lu_.array + lu_type::index( j, j );
+
+        size_t pivot = 0;
+        T max_value = fabs( col_j[ 0 ] );
+        for( size_t i = 1; i <= rows; ++i )
+        {
+            if ( fabs( col_j[ i ] ) > max_value )
+            {
+                max_value = fabs( col_j[ i ] );
+                pivot = i;
+            }
+        }
+        pivots_[ j ] = j + pivot;
+        if ( !( max_value > 0 ) )
+            return false;
+
+        last_col = ( std::max )( last_col, ( std::min )( j + KU + pivot, N - 1 ));
+
+        // swap rows j and j + pivot in all columns they reach
+        if ( pivot != 0 )
+        {
+            for( size_t col = j; col <= last_col; ++col )
+            {
+                T& a = lu_.array[ lu_type::index( j, col ) ];
+                T& b = lu_.array[ lu_type::index( j + pivot, col ) ];
+                const T tmp = a;
+                a = b;
+                b = tmp;
+            }
+        }
+
+        const T inv = static_cast< T >( 1.0 ) / col_j[ 0 ];
+        for( size_t i = 1; i <= rows; ++i )
+            col_j[ i ] *= inv;
+
+        for( size_t col = j + 1; col <= last_col; ++col )
+        {
+            T* c = lu_.array + lu_type::index( j, col );
+            const T u = c[ 0 ];
+            for( size_t i = 1; i <= rows; ++i )
+                c[ i ] -= col_j[ i ] * u;
+        }
+    }
+    return true;
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+void
+banded_matrix< N, KL, KU, T >::lu_solve( const lu_type& lu_, const size_t* pivots_, T* x_ )
+{
+    // L * y = P * b, the interchanges are applied as they were found
+    for( size_t j = 0; j < N; ++j )
+    {
+        if ( pivots_[ j ] != j )
+        {
+            const T tmp = x_[ j ];
+            x_[ j ] = x_[ pivots_[ j ] ];
+            x_[ pivots_[ j ] ] = tmp;
+        }
+        const size_t rows = ( std::min )( KL, N - 1 - j );
+        const T* col_j = lu_.array + lu_type::index( j, j );
+        const T y = x_[ j ];
+        for( size_t i = 1; i <= rows; ++i )
+            x_[ j + i ] -= col_j[ i ] * y;
+    }
+
+    // U * x = y, U has KL + KU superdiagonals
+    for( size_t j = N; j-- > 0; )
+    {
+        const size_t first = j > KL + KU ? j - KL - KU : 0;
+        const T* col_j = lu_.array + lu_type::index( first, j );
+        x_[ j ] /= col_j[ j - first ];
+        const T x_j = x_[ j ];
+        for( size_t i = first; i < j; ++i )
+            x_[ i ] -= col_j[ i - first ] * x_j;
+    }
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+bool
+banded_matrix< N, KL, KU, T >::solve( const vector< N, T >& b_, vector< N, T >& x_ ) const
+{
+    lu_type f;
+    size_t pivots[ N ];
+    if ( ! lu( f, pivots ) )
+        return false;
+    x_ = b_;
+    lu_solve( f, pivots, x_.array );
+    return true;
+}
+
+
+template< size_t N, size_t KL, size_t KU, typename T >
+template< size_t K >
+bool
+banded_matrix< N, KL, KU, T >::solve( const matrix< N, K, T >& b_, matrix< N, K, T >& x_ ) const
+{
+    lu_type f;
+    size_t pivots[ N ];
+    if ( ! lu( f, pivots ) )
+        return false;
+    x_ = b_;
+    for( size_t k = 0; k < K; ++k )
+        lu_solve( f, pivots, x_.array + k * N );
+    return true;
+}
+
+
+} // namespace vmml
+
+#endif
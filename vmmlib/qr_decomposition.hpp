@@ -35,6 +35,7 @@
 #include <vmmlib/matrix.hpp>
 #include <vmmlib/vector.hpp>
 #include <vmmlib/exception.hpp>
+#include <vmmlib/blas_dgemm.hpp>
 
 #include <cmath>
 #include <vector>
@@ -44,6 +45,19 @@
 * A  -> matrix to be factorized
 * Q  -> orthonormal
 * Rn -> upper triangular
+*
+* QR decomposition using blocked householder reflections (compact WY form)
+* qr_decompose_householder computes the thin factorization A = Q R of a
+* tall M x N matrix (M >= N), Q is M x N. Q is orthonormal to working
+* precision independently of the condition of A, which gram-schmidt does
+* not guarantee; prefer it to qr_decompose_gram_schmidt.
+*
+* the raw routines work in place on column-major arrays, like LAPACK's
+* GEQRF / ORGQR: qr_householder_factorize stores R in the upper triangle
+* and the householder vectors below it. panels of QR_BLOCK_SIZE columns
+* are factorized column by column; the accumulated block reflector
+* I - V T V^T is then applied to the trailing columns with two gemm's,
+* which go to the configured blas backend for float and double.
 */
 
 namespace vmml
@@ -116,6 +130,345 @@ void qr_decompose_gram_schmidt(
 }
 
 
+
+static const blas::blas_int QR_BLOCK_SIZE = 16;
+
+
+namespace qr_detail
+{
+
+// column-major C = alpha * op(A) * op(B) + beta * C
+template< typename T >
+inline void
+gemm( bool trans_a_, bool trans_b_, blas::blas_int m_, blas::blas_int n_, blas::blas_int k_,
+      T alpha_, const T* a_, blas::blas_int lda_, const T* b_, blas::blas_int ldb_,
+      T beta_, T* c_, blas::blas_int ldc_ )
+{
+    blas::builtin::gemm( trans_a_, trans_b_, m_, n_, k_, alpha_, a_, lda_, b_, ldb_, beta_, c_, ldc_ );
+}
+
+template< typename T >
+inline void
+gemm_call( bool trans_a_, bool trans_b_, blas::blas_int m_, blas::blas_int n_, blas::blas_int k_,
+           T alpha_, const T* a_, blas::blas_int lda_, const T* b_, blas::blas_int ldb_,
+           T beta_, T* c_, blas::blas_int ldc_ )
+{
+    blas::dgemm_params< T > p;
+    p.order     = CblasColMajor;
+    p.trans_a   = trans_a_ ? CblasTrans : CblasNoTrans;
+    p.trans_b   = trans_b_ ? CblasTrans : CblasNoTrans;
+    p.m         = m_;
+    p.n         = n_;
+    p.k         = k_;
+    p.alpha     = alpha_;
+    p.a         = a_;
+    p.lda       = lda_;
+    p.b         = b_;
+    p.ldb       = ldb_;
+    p.beta      = beta_;
+    p.c         = c_;
+    p.ldc       = ldc_;
+    blas::dgemm_call( p );
+}
+
+inline void
+gemm( bool trans_a_, bool trans_b_, blas::blas_int m_, blas::blas_int n_, blas::blas_int k_,
+      float alpha_, const float* a_, blas::blas_int lda_, const float* b_, blas::blas_int ldb_,
+      float beta_, float* c_, blas::blas_int ldc_ )
+{
+    gemm_call( trans_a_, trans_b_, m_, n_, k_, alpha_, a_, lda_, b_, ldb_, beta_, c_, ldc_ );
+}
+
+inline void
+gemm( bool trans_a_, bool trans_b_, blas::blas_int m_, blas::blas_int n_, blas::blas_int k_,
+      double alpha_, const double* a_, blas::blas_int lda_, const double* b_, blas::blas_int ldb_,
+      double beta_, double* c_, blas::blas_int ldc_ )
+{
+    gemm_call( trans_a_, trans_b_, m_, n_, k_, alpha_, a_, lda_, b_, ldb_, beta_, c_, ldc_ );
+}
+
+
+// householder reflection H = I - tau v v^T with v(0) = 1 that maps the
+// column x (length m_) to ( beta, 0, ..., 0 ); v(1:) overwrites x(1:)
+template< typename T >
+inline T
+make_reflector( blas::blas_int m_, T* x_ )
+{
+    T tail_max = 0;
+    for( blas::blas_int i = 1; i < m_; ++i )
+        tail_max = fabs( x_[ i ] ) > tail_max ? fabs( x_[ i ] ) : tail_max;
+    if ( tail_max == T( 0 ) )
+        return T( 0 );
+
+    // scaled sum of squares, so that huge or tiny columns do not overflow
+    const T alpha = x_[ 0 ];
+    const T scale = fabs( alpha ) > tail_max ? fabs( alpha ) : tail_max;
+    T sum = 0;
+    for( blas::blas_int i = 0; i < m_; ++i )
+    {
+        const T x = x_[ i ] / scale;
+        sum += x * x;
+    }
+    T beta = scale * sqrt( sum );
+    if ( alpha >= T( 0 ) )
+        beta = -beta;
+
+    const T tau = ( beta - alpha ) / beta;
+    const T inv = T( 1 ) / ( alpha - beta );
+    for( blas::blas_int i = 1; i < m_; ++i )
+        x_[ i ] *= inv;
+    x_[ 0 ] = beta;
+    return tau;
+}
+
+
+// unit lower trapezoidal V (m_ x k_, dense copy) and upper triangular T
+// (k_ x k_) of the block reflector H_1 ... H_k = I - V T V^T
+template< typename T >
+void
+form_block_reflector( blas::blas_int m_, blas::blas_int k_, const T* a_, blas::blas_int lda_,
+                      const T* tau_, T* v_, T* t_ )
+{
+    for( blas::blas_int j = 0; j < k_; ++j )
+    {
+        T* v = v_ + j * m_;
+        const T* a = a_ + j * lda_;
+        for( blas::blas_int i = 0; i < j; ++i )
+            v[ i ] = 0;
+        v[ j ] = 1;
+        for( blas::blas_int i = j + 1; i < m_; ++i )
+            v[ i ] = a[ i ];
+    }
+
+    for( blas::blas_int j = 0; j < k_; ++j )
+    {
+        T* t = t_ + j * k_;
+        for( blas::blas_int i = 0; i < k_; ++i )
+            t[ i ] = 0;
+        if ( tau_[ j ] == T( 0 ) )
+            continue;
+
+        // t(0:j) = -tau_j * T(0:j,0:j) * V(:,0:j)^T v_j
+        const T* v_j = v_ + j * m_;
+        for( blas::blas_int i = 0; i < j; ++i )
+        {
+            const T* v_i = v_ + i * m_;
+            T sum = 0;
+            for( blas::blas_int r = j; r < m_; ++r )
+                sum += v_i[ r ] * v_j[ r ];
+            t[ i ] = -tau_[ j ] * sum;
+        }
+        for( blas::blas_int i = 0; i < j; ++i )
+        {
+            T sum = 0;
+            for( blas::blas_int l = i; l < j; ++l )
+                sum += t_[ i + l * k_ ] * t[ l ];
+            t[ i ] = sum;
+        }
+        t[ j ] = tau_[ j ];
+    }
+}
+
+
+// C = ( I - V op(T) V^T ) C for the m_ x n_ block C; op(T) = T^T if transpose_
+template< typename T >
+void
+apply_block_reflector( bool transpose_, blas::blas_int m_, blas::blas_int n_, blas::blas_int k_,
+                       const T* v_, const T* t_, T* c_, blas::blas_int ldc_, T* work_ )
+{
+    if ( n_ <= 0 )
+        return;
+
+    // W = V^T C
+    gemm( true, false, k_, n_, m_, T( 1 ), v_, m_, c_, ldc_, T( 0 ), work_, k_ );
+
+    // W = op(T) W, T is upper triangular
+    for( blas::blas_int col = 0; col < n_; ++col )
+    {
+        T* w = work_ + col * k_;
+        if ( transpose_ )
+        {
+            for( blas::blas_int i = k_ - 1; i >= 0; --i )
+            {
+                T sum = 0;
+                for( blas::blas_int l = 0; l <= i; ++l )
+                    sum += t_[ l + i * k_ ] * w[ l ];
+                w[ i ] = sum;
+            }
+        } else {
+            for( blas::blas_int i = 0; i < k_; ++i )
+            {
+                T sum = 0;
+                for( blas::blas_int l = i; l < k_; ++l )
+                    sum += t_[ i + l * k_ ] * w[ l ];
+                w[ i ] = sum;
+            }
+        }
+    }
+
+    // C -= V W
+    gemm( false, false, m_, n_, k_, T( -1 ), v_, m_, work_, k_, T( 1 ), c_, ldc_ );
+}
+
+} // namespace qr_detail
+
+
+// in-place householder QR of the column-major m_ x n_ array a_ (m_ >= n_);
+// tau_ receives the n_ reflector coefficients
+template< typename T >
+void
+qr_householder_factorize( blas::blas_int m_, blas::blas_int n_, T* a_, blas::blas_int lda_, T* tau_ )
+{
+    if ( m_ < n_ )
+    {
+        VMMLIB_ERROR( "householder qr needs at least as many rows as columns", VMMLIB_HERE );
+    }
+
+    std::vector< T > v( m_ * QR_BLOCK_SIZE );
+    std::vector< T > t( QR_BLOCK_SIZE * QR_BLOCK_SIZE );
+    std::vector< T > work( QR_BLOCK_SIZE * n_ );
+
+    for( blas::blas_int j0 = 0; j0 < n_; j0 += QR_BLOCK_SIZE )
+    {
+        const blas::blas_int nb = n_ - j0 < QR_BLOCK_SIZE ? n_ - j0 : QR_BLOCK_SIZE;
+        const blas::blas_int mb = m_ - j0;
+        T* panel = a_ + j0 + j0 * lda_;
+
+        // unblocked factorization of the panel
+        for( blas::blas_int j = 0; j < nb; ++j )
+        {
+            T* col = panel + j + j * lda_;
+            const blas::blas_int len = mb - j;
+            const T tau = qr_detail::make_reflector( len, col );
+            tau_[ j0 + j ] = tau;
+            if ( tau == T( 0 ) )
+                continue;
+
+            for( blas::blas_int c = j + 1; c < nb; ++c )
+            {
+                T* other = panel + j + c * lda_;
+                T w = other[ 0 ];
+                for( blas::blas_int i = 1; i < len; ++i )
+                    w += col[ i ] * other[ i ];
+                w *= tau;
+                other[ 0 ] -= w;
+                for( blas::blas_int i = 1; i < len; ++i )
+                    other[ i ] -= w * col[ i ];
+            }
+        }
+
+        // trailing columns: C = H_nb^T ... H_1^T C = ( I - V T^T V^T ) C
+        const blas::blas_int n_trailing = n_ - j0 - nb;
+        if ( n_trailing > 0 )
+        {
+            qr_detail::form_block_reflector( mb, nb, panel, lda_, tau_ + j0, &v[ 0 ], &t[ 0 ] );
+            qr_detail::apply_block_reflector( true, mb, n_trailing, nb, &v[ 0 ], &t[ 0 ],
+                panel + nb * lda_, lda_, &work[ 0 ] );
+        }
+    }
+}
+
+
+// thin Q (m_ x n_) of a factorization computed by qr_householder_factorize
+template< typename T >
+void
+qr_householder_thin_q( blas::blas_int m_, blas::blas_int n_, const T* a_, blas::blas_int lda_,
+                       const T* tau_, T* q_, blas::blas_int ldq_ )
+{
+    for( blas::blas_int j = 0; j < n_; ++j )
+    {
+        for( blas::blas_int i = 0; i < m_; ++i )
+            q_[ i + j * ldq_ ] = 0;
+    }
+    if ( n_ <= 0 )
+        return;
+
+    std::vector< T > v( m_ * QR_BLOCK_SIZE );
+    std::vector< T > t( QR_BLOCK_SIZE * QR_BLOCK_SIZE );
+    std::vector< T > work( QR_BLOCK_SIZE * n_ );
+
+    // Q = H_1 ... H_n [ I; 0 ], built from the last block on: the block
+    // reflector updates the columns right of the block, which are complete,
+    // and the block's own columns are generated column by column
+    const blas::blas_int last = ( ( n_ - 1 ) / QR_BLOCK_SIZE ) * QR_BLOCK_SIZE;
+    for( blas::blas_int j0 = last; j0 >= 0; j0 -= QR_BLOCK_SIZE )
+    {
+        const blas::blas_int nb = n_ - j0 < QR_BLOCK_SIZE ? n_ - j0 : QR_BLOCK_SIZE;
+        const blas::blas_int mb = m_ - j0;
+        const T* panel = a_ + j0 + j0 * lda_;
+        T* q_block = q_ + j0 + j0 * ldq_;
+
+        const blas::blas_int n_right = n_ - j0 - nb;
+        if ( n_right > 0 )
+        {
+            qr_detail::form_block_reflector( mb, nb, panel, lda_, tau_ + j0, &v[ 0 ], &t[ 0 ] );
+            qr_detail::apply_block_reflector( false, mb, n_right, nb, &v[ 0 ], &t[ 0 ],
+                q_block + nb * ldq_, ldq_, &work[ 0 ] );
+        }
+
+        for( blas::blas_int j = nb - 1; j >= 0; --j )
+        {
+            const T* col = panel + j + j * lda_;
+            const T tau = tau_[ j0 + j ];
+            const blas::blas_int len = mb - j;
+
+            // H_j on the block columns right of j, which are zero above row j
+            for( blas::blas_int c = j + 1; c < nb; ++c )
+            {
+                T* other = q_block + j + c * ldq_;
+                T w = other[ 0 ];
+                for( blas::blas_int i = 1; i < len; ++i )
+                    w += col[ i ] * other[ i ];
+                w *= tau;
+                other[ 0 ] -= w;
+                for( blas::blas_int i = 1; i < len; ++i )
+                    other[ i ] -= w * col[ i ];
+            }
+
+            // column j of H_j
+            T* q_col = q_block + j + j * ldq_;
+            q_col[ 0 ] = T( 1 ) - tau;
+            for( blas::blas_int i = 1; i < len; ++i )
+                q_col[ i ] = -tau * col[ i ];
+        }
+    }
+}
+
+
+// thin QR, A_ = Q R with Q^T Q = I and a non-negative diagonal of R
+template< size_t M, size_t N, typename T >
+void qr_decompose_householder(
+    const matrix< M, N, T >& A_,
+    matrix< M, N, T >& Q,
+    matrix< N, N, T >& R
+    )
+{
+    std::vector< T > a( A_.array, A_.array + M * N );
+    std::vector< T > tau( N );
+
+    qr_householder_factorize< T >( M, N, &a[ 0 ], M, &tau[ 0 ] );
+    qr_householder_thin_q< T >( M, N, &a[ 0 ], M, &tau[ 0 ], Q.array, M );
+
+    for( size_t j = 0; j < N; ++j )
+    {
+        for( size_t i = 0; i < N; ++i )
+            R( i, j ) = ( i <= j ) ? a[ i + j * M ] : T( 0 );
+    }
+
+    // unique factorization: flip rows of R and columns of Q where R(i,i) < 0
+    for( size_t i = 0; i < N; ++i )
+    {
+        if ( R( i, i ) < T( 0 ) )
+        {
+            for( size_t j = i; j < N; ++j )
+                R( i, j ) = -R( i, j );
+            for( size_t r = 0; r < M; ++r )
+                Q( r, i ) = -Q( r, i );
+        }
+    }
+}
+
+
 } // namespace vmml
 
 #endif
@@ -35,6 +35,7 @@
  * Quantized version of Tucker3 tensor
  * - 16bit linear factor matrices quantization
  * - 8bit logarithmic core tensor quantization
+ * - per-column (or per-block) linear factor matrices quantization
  *
  * reference:
  * - Suter, Iglesias, Marton, Agus, Elsener, Zollikofer, Gopi, Gobbetti, and Pajarola:
@@ -152,6 +153,26 @@ namespace vmml
                        T_internal& core_min_, T_internal& core_max_,
                        T_init init );
 
+        //per-column quantization of the basis matrices: one min/max range per
+        //column of U1-U3 (or per block of block_rows_ rows within each column)
+        template< typename T_init>
+        void decompose( const t3_type& data_,
+                       std::vector< T_internal >& u1_ranges_,
+                       std::vector< T_internal >& u2_ranges_,
+                       std::vector< T_internal >& u3_ranges_,
+                       T_internal& core_min_, T_internal& core_max_,
+                       T_init init, size_t block_rows_ = 0 );
+        void reconstruct( t3_type& data_,
+                         const std::vector< T_internal >& u1_ranges_,
+                         const std::vector< T_internal >& u2_ranges_,
+                         const std::vector< T_internal >& u3_ranges_,
+                         const T_internal& core_min_, const T_internal& core_max_,
+                         size_t block_rows_ = 0 );
+
+        //reconstruct from the current dequantized core and basis matrices,
+        //e.g., after importing a (partial) progressive stream
+        void reconstruct_dequantized( t3_type& data_ ) { reconstruct( data_ ); }
+
         template< typename T_init>
         void tucker_als( const t3_type& data_, T_init init  );
 
@@ -177,8 +198,10 @@ namespace vmml
         void cast_comp_members();
         void quantize_basis_matrices( T_internal& u_min_, T_internal& u_max_ );
         void quantize_basis_matrices( T_internal& u1_min_, T_internal& u1_max_, T_internal& u2_min_, T_internal& u2_max_, T_internal& u3_min_, T_internal& u3_max_ );
+        void quantize_basis_matrices_per_column( std::vector< T_internal >& u1_ranges_, std::vector< T_internal >& u2_ranges_, std::vector< T_internal >& u3_ranges_, size_t block_rows_ = 0 );
         void quantize_core( T_internal& core_min_, T_internal& core_max_ );
         void dequantize_basis_matrices( const T_internal& u1_min_, const T_internal& u1_max_, const T_internal& u2_min_, const T_internal& u2_max_, const T_internal& u3_min_, const T_internal& u3_max_ );
+        void dequantize_basis_matrices_per_column( const std::vector< T_internal >& u1_ranges_, const std::vector< T_internal >& u2_ranges_, const std::vector< T_internal >& u3_ranges_, size_t block_rows_ = 0 );
         void dequantize_core( const T_internal& core_min_, const T_internal& core_max_ );
 
     protected:
@@ -411,6 +434,19 @@ VMML_TEMPLATE_CLASSNAME::quantize_basis_matrices(T_internal& u_min_, T_internal&
 }
 
 
+VMML_TEMPLATE_STRING
+void
+VMML_TEMPLATE_CLASSNAME::quantize_basis_matrices_per_column( std::vector< T_internal >& u1_ranges_,
+                                                            std::vector< T_internal >& u2_ranges_,
+                                                            std::vector< T_internal >& u3_ranges_,
+                                                            size_t block_rows_ )
+{
+    _u1_comp->quantize_columns( *_u1, u1_ranges_, block_rows_ );
+    _u2_comp->quantize_columns( *_u2, u2_ranges_, block_rows_ );
+    _u3_comp->quantize_columns( *_u3, u3_ranges_, block_rows_ );
+}
+
+
 VMML_TEMPLATE_STRING
 void
 VMML_TEMPLATE_CLASSNAME::quantize_core( T_internal& core_min_, T_internal& core_max_ )
@@ -441,6 +477,18 @@ VMML_TEMPLATE_CLASSNAME::dequantize_basis_matrices( const T_internal& u1_min_, c
     _u3->dequantize( *_u3_comp, u3_min_, u3_max_ );
 }
 
+VMML_TEMPLATE_STRING
+void
+VMML_TEMPLATE_CLASSNAME::dequantize_basis_matrices_per_column( const std::vector< T_internal >& u1_ranges_,
+                                                              const std::vector< T_internal >& u2_ranges_,
+                                                              const std::vector< T_internal >& u3_ranges_,
+                                                              size_t block_rows_ )
+{
+    _u1->dequantize_columns( *_u1_comp, u1_ranges_, block_rows_ );
+    _u2->dequantize_columns( *_u2_comp, u2_ranges_, block_rows_ );
+    _u3->dequantize_columns( *_u3_comp, u3_ranges_, block_rows_ );
+}
+
 VMML_TEMPLATE_STRING
 void
 VMML_TEMPLATE_CLASSNAME::dequantize_core( const T_internal& core_min_, const T_internal& core_max_ )
@@ -506,6 +554,23 @@ VMML_TEMPLATE_CLASSNAME::reconstruct( t3_type& data_,
     reconstruct( data_ );
 }
 
+VMML_TEMPLATE_STRING
+void
+VMML_TEMPLATE_CLASSNAME::reconstruct( t3_type& data_,
+                                     const std::vector< T_internal >& u1_ranges_,
+                                     const std::vector< T_internal >& u2_ranges_,
+                                     const std::vector< T_internal >& u3_ranges_,
+                                     const T_internal& core_min_, const T_internal& core_max_,
+                                     size_t block_rows_ )
+{
+    //the quantized coefficients are dequantized straight into the
+    //internal basis matrices that feed the ttm, no intermediate copies
+    dequantize_basis_matrices_per_column( u1_ranges_, u2_ranges_, u3_ranges_, block_rows_ );
+    dequantize_core( core_min_, core_max_ );
+
+    reconstruct( data_ );
+}
+
 VMML_TEMPLATE_STRING
 void
 VMML_TEMPLATE_CLASSNAME::reconstruct( t3_type& data_ )
@@ -565,6 +630,24 @@ VMML_TEMPLATE_CLASSNAME::decompose( const t3_type& data_,
 }
 
 
+VMML_TEMPLATE_STRING
+template< typename T_init>
+void
+VMML_TEMPLATE_CLASSNAME::decompose( const t3_type& data_,
+                                   std::vector< T_internal >& u1_ranges_,
+                                   std::vector< T_internal >& u2_ranges_,
+                                   std::vector< T_internal >& u3_ranges_,
+                                   T_internal& core_min_, T_internal& core_max_,
+                                   T_init init, size_t block_rows_ )
+
+{
+    decompose( data_, init );
+
+    quantize_basis_matrices_per_column( u1_ranges_, u2_ranges_, u3_ranges_, block_rows_ );
+    quantize_core(core_min_, core_max_ );
+}
+
+
 VMML_TEMPLATE_STRING
 template< typename T_init >
 void
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__RANDOM__HPP__
+#define __VMML__RANDOM__HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+/**
+ *
+ *   counter-based random number generator Philox4x32-10 (Salmon et al.,
+ *   2011: Parallel random numbers: as easy as 1, 2, 3). block c of the
+ *   stream is a pure function of the key (the seed) and the counter
+ *   ( c, stream ): ten rounds of two 32x32->64 bit multiplications and
+ *   xors. there is no state besides the counter, so jumping ahead is
+ *   O( 1 ) and every block can be computed independently.
+ *
+ *   the fills are vectorized and parallel: each block gives two values
+ *   (53 random bits each), BLOCK_LANES blocks are generated side by side
+ *   in a loop the compiler can vectorize, and large fills are distributed
+ *   over OpenMP threads. value i of a fill always
+ *   comes from block position + i / 2, so the result depends on the seed
+ *   and position only, not on the number of threads. after a fill of n
+ *   values the position has advanced by ( n + 1 ) / 2 blocks.
+ *
+ *   a generator is not shared between threads; use one per thread with
+ *   the same seed and different streams (or positions) instead.
+ *
+ **
+ */
+
+namespace vmml
+{
+
+class random_generator
+{
+public:
+    typedef unsigned int        word_type;      // 32 bit
+    typedef unsigned long long  counter_type;   // 64 bit
+
+    // enumerators rather than static const members: they have no storage,
+    // so passing them by reference, e.g. to std::min, needs no definition
+    enum
+    {
+        // blocks generated side by side in a fill
+        BLOCK_LANES = 16,
+        // fills with fewer values stay on the calling thread
+        PARALLEL_THRESHOLD = 1 << 16
+    };
+
+    explicit random_generator( counter_type seed_ = 0, counter_type stream_ = 0 )
+        { seed( seed_, stream_ ); }
+
+    // restarts the stream stream_ of seed_ at position 0
+    void seed( counter_type seed_, counter_type stream_ = 0 );
+
+    counter_type get_position() const { return _position; }
+    void set_position( counter_type position_ ) { _position = position_; }
+    void skip( counter_type n_blocks_ ) { _position += n_blocks_; }
+
+    // the four words of block position_, does not advance the position
+    void get_block( counter_type position_, word_type block_[ 4 ] ) const;
+
+    // uniform in [ min_, max_ ), computed in double and cast to T
+    template< typename T >
+    void fill_uniform( T* data_, size_t n_, double min_ = 0.0, double max_ = 1.0 );
+
+    // normal distribution (Box-Muller)
+    template< typename T >
+    void fill_normal( T* data_, size_t n_, double mean_ = 0.0, double stddev_ = 1.0 );
+
+    // single values, each takes a block of its own
+    double uniform();
+    double normal();
+
+protected:
+    // the two values of the blocks first_block_ + l, l < BLOCK_LANES, as
+    // uniform [0,1) values, or normal values for the first n_blocks_
+    void _uniform_lanes( counter_type first_block_,
+                         double u0_[ BLOCK_LANES ], double u1_[ BLOCK_LANES ] ) const;
+    void _normal_lanes( counter_type first_block_, size_t n_blocks_,
+                        double z0_[ BLOCK_LANES ], double z1_[ BLOCK_LANES ] ) const;
+
+    template< typename T, bool NORMAL >
+    void _fill( T* data_, size_t n_, double offset_, double scale_ );
+
+    word_type       _key[ 2 ];
+    counter_type    _stream;
+    counter_type    _position;
+
+}; // class random_generator
+
+
+
+inline void
+random_generator::seed( counter_type seed_, counter_type stream_ )
+{
+    _key[ 0 ] = static_cast< word_type >( seed_ );
+    _key[ 1 ] = static_cast< word_type >( seed_ >> 32 );
+    _stream = stream_;
+    _position = 0;
+}
+
+
+
+namespace random_detail
+{
+
+// Philox4x32-10 on L counters, x_[ word ][ lane ]. the rounds of a lane
+// stay in registers, the compiler vectorizes the loop over the lanes.
+template< size_t L >
+inline void
+philox4x32_10( random_generator::word_type x_[ 4 ][ L ],
+               random_generator::word_type k0_, random_generator::word_type k1_ )
+{
+    typedef random_generator::word_type word_type;
+    typedef random_generator::counter_type counter_type;
+
+    const counter_type m0 = 0xD2511F53u;
+    const counter_type m1 = 0xCD9E8D57u;
+    for( size_t l = 0; l < L; ++l )
+    {
+        word_type x0 = x_[ 0 ][ l ];
+        word_type x1 = x_[ 1 ][ l ];
+        word_type x2 = x_[ 2 ][ l ];
+        word_type x3 = x_[ 3 ][ l ];
+        word_type k0 = k0_;
+        word_type k1 = k1_;
+        for( size_t round = 0; round < 10; ++round )
+        {
+            const counter_type p0 = m0 * x0;
+            const counter_type p1 = m1 * x2;
+            x0 = static_cast< word_type >( p1 >> 32 ) ^ x1 ^ k0;
+            x1 = static_cast< word_type >( p1 );
+            x2 = static_cast< word_type >( p0 >> 32 ) ^ x3 ^ k1;
+            x3 = static_cast< word_type >( p0 );
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        x_[ 0 ][ l ] = x0;
+        x_[ 1 ][ l ] = x1;
+        x_[ 2 ][ l ] = x2;
+        x_[ 3 ][ l ] = x3;
+    }
+}
+
+// 53 random bits from two words as a double in [0,1)
+inline double
+to_unit( random_generator::word_type hi_, random_generator::word_type lo_ )
+{
+    // through int, the unsigned conversion does not vectorize
+    return ( double( int( hi_ >> 5 )) * 67108864.0 + double( int( lo_ >> 6 )))
+        * ( 1.0 / 9007199254740992.0 );
+}
+
+} // namespace random_detail
+
+
+
+inline void
+random_generator::get_block( counter_type position_, word_type block_[ 4 ] ) const
+{
+    word_type x[ 4 ][ 1 ];
+    x[ 0 ][ 0 ] = static_cast< word_type >( position_ );
+    x[ 1 ][ 0 ] = static_cast< word_type >( position_ >> 32 );
+    x[ 2 ][ 0 ] = static_cast< word_type >( _stream );
+    x[ 3 ][ 0 ] = static_cast< word_type >( _stream >> 32 );
+    random_detail::philox4x32_10< 1 >( x, _key[ 0 ], _key[ 1 ] );
+    for( size_t i = 0; i < 4; ++i )
+        block_[ i ] = x[ i ][ 0 ];
+}
+
+
+
+inline void
+random_generator::_uniform_lanes( counter_type first_block_,
+    double u0_[ BLOCK_LANES ], double u1_[ BLOCK_LANES ] ) const
+{
+    word_type x[ 4 ][ BLOCK_LANES ];
+    const word_type s0 = static_cast< word_type >( _stream );
+    const word_type s1 = static_cast< word_type >( _stream >> 32 );
+    for( size_t l = 0; l < BLOCK_LANES; ++l )
+    {
+        const counter_type c = first_block_ + l;
+        x[ 0 ][ l ] = static_cast< word_type >( c );
+        x[ 1 ][ l ] = static_cast< word_type >( c >> 32 );
+        x[ 2 ][ l ] = s0;
+        x[ 3 ][ l ] = s1;
+    }
+
+    random_detail::philox4x32_10< BLOCK_LANES >( x, _key[ 0 ], _key[ 1 ] );
+
+    for( size_t l = 0; l < BLOCK_LANES; ++l )
+    {
+        u0_[ l ] = random_detail::to_unit( x[ 0 ][ l ], x[ 1 ][ l ] );
+        u1_[ l ] = random_detail::to_unit( x[ 2 ][ l ], x[ 3 ][ l ] );
+    }
+}
+
+
+
+inline void
+random_generator::_normal_lanes( counter_type first_block_, size_t n_blocks_,
+    double z0_[ BLOCK_LANES ], double z1_[ BLOCK_LANES ] ) const
+{
+    const double two_pi = 6.283185307179586476925286766559;
+    double u0[ BLOCK_LANES ], u1[ BLOCK_LANES ];
+    _uniform_lanes( first_block_, u0, u1 );
+
+    // 1 - u0 is in ( 0, 1 ]
+    for( size_t l = 0; l < n_blocks_; ++l )
+    {
+        const double r = std::sqrt( -2.0 * std::log( 1.0 - u0[ l ] ));
+        const double phi = two_pi * u1[ l ];
+        z0_[ l ] = r * std::cos( phi );
+        z1_[ l ] = r * std::sin( phi );
+    }
+}
+
+
+
+template< typename T, bool NORMAL >
+void
+random_generator::_fill( T* data_, size_t n_, double offset_, double scale_ )
+{
+    const size_t n_blocks = ( n_ + 1 ) / 2;
+    const long n_groups = static_cast< long >( ( n_blocks + BLOCK_LANES - 1 ) / BLOCK_LANES );
+    const counter_type first = _position;
+
+#pragma omp parallel for if( n_ >= PARALLEL_THRESHOLD )
+    for( long group = 0; group < n_groups; ++group )
+    {
+        const size_t first_block = static_cast< size_t >( group ) * BLOCK_LANES;
+        const size_t n = ( std::min )( size_t( BLOCK_LANES ), n_blocks - first_block );
+        double v0[ BLOCK_LANES ], v1[ BLOCK_LANES ];
+        if ( NORMAL )
+            _normal_lanes( first + first_block, n, v0, v1 );
+        else
+            _uniform_lanes( first + first_block, v0, v1 );
+
+        T* out = data_ + 2 * first_block;
+        const size_t n_values = ( std::min )( 2 * n, n_ - 2 * first_block );
+        if ( n_values == 2 * BLOCK_LANES )
+        {
+            for( size_t l = 0; l < BLOCK_LANES; ++l )
+            {
+                out[ 2 * l ] = static_cast< T >( offset_ + scale_ * v0[ l ] );
+                out[ 2 * l + 1 ] = static_cast< T >( offset_ + scale_ * v1[ l ] );
+            }
+        }
+        else
+        {
+            for( size_t i = 0; i < n_values; ++i )
+            {
+                const double v = ( i & 1 ) ? v1[ i / 2 ] : v0[ i / 2 ];
+                out[ i ] = static_cast< T >( offset_ + scale_ * v );
+            }
+        }
+    }
+    _position += n_blocks;
+}
+
+
+
+template< typename T >
+void
+random_generator::fill_uniform( T* data_, size_t n_, double min_, double max_ )
+{
+    _fill< T, false >( data_, n_, min_, max_ - min_ );
+}
+
+
+
+template< typename T >
+void
+random_generator::fill_normal( T* data_, size_t n_, double mean_, double stddev_ )
+{
+    _fill< T, true >( data_, n_, mean_, stddev_ );
+}
+
+
+
+inline double
+random_generator::uniform()
+{
+    double value;
+    fill_uniform( &value, 1 );
+    return value;
+}
+
+
+
+inline double
+random_generator::normal()
+{
+    double value;
+    fill_normal( &value, 1 );
+    return value;
+}
+
+} // namespace vmml
+
+#endif
@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* reads the .dat descriptors written by t3_converter::write_datfile and
+ * loads the corresponding .raw files with the element type, dimensions and
+ * byte order taken from the descriptor at runtime:
+ * - into a runtime-sized volume (std::vector plus resolution), or
+ * - into a tensor3 of static size, after checking that the sizes match.
+ * voxels are converted to the requested value type.
+ */
+
+#ifndef __VMML__RAW_VOLUME_LOADER__HPP__
+#define __VMML__RAW_VOLUME_LOADER__HPP__
+
+#include <vmmlib/tensor3.hpp>
+#include <vmmlib/exception.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef VMMLIB_USE_OPENMP
+#  include <omp.h>
+#endif
+
+namespace vmml {
+
+    struct raw_descriptor
+    {
+        enum format_type { UNKNOWN, UCHAR, CHAR, USHORT, SHORT, UINT, INT, FLOAT, DOUBLE };
+
+        raw_descriptor() : format(UNKNOWN), big_endian(false) {
+            resolution[0] = resolution[1] = resolution[2] = 0;
+            slice_thickness[0] = slice_thickness[1] = slice_thickness[2] = 1.0;
+        }
+
+        size_t get_element_size() const;
+        size_t get_number_of_voxels() const { return resolution[0] * resolution[1] * resolution[2]; };
+        size_t get_raw_size() const { return get_number_of_voxels() * get_element_size(); };
+
+        static format_type parse_format(const std::string& format_);
+        static const char* get_format_name(format_type format_);
+        template< typename T >
+        static format_type get_format();
+
+        std::string object_file_name;
+        size_t resolution[3];
+        double slice_thickness[3];
+        format_type format;
+        bool big_endian;
+    };
+
+    //runtime-sized volume, same memory layout as tensor3 (i1 fastest)
+    template< typename T >
+    struct raw_volume
+    {
+        size_t resolution[3];
+        std::vector< T > data;
+
+        T& at(size_t i1_, size_t i2_, size_t i3_) { return data[(i3_ * resolution[1] + i2_) * resolution[0] + i1_]; };
+        const T& at(size_t i1_, size_t i2_, size_t i3_) const { return data[(i3_ * resolution[1] + i2_) * resolution[0] + i1_]; };
+    };
+
+    class raw_volume_loader
+    {
+    public:
+        static void read_datfile(const std::string& dir_, const std::string& filename_, raw_descriptor& desc_);
+        static void parse_datfile(std::istream& in_, raw_descriptor& desc_);
+
+        //runtime-sized volume
+        template< typename T >
+        static void read_raw(const std::string& dir_, const raw_descriptor& desc_, raw_volume< T >& volume_);
+
+        //static size, the resolution in the descriptor has to match
+        template< size_t I1, size_t I2, size_t I3, typename T >
+        static void read_raw(const std::string& dir_, const raw_descriptor& desc_, tensor3< I1, I2, I3, T >& data_);
+
+        //.dat file and its .raw file in one go
+        template< typename T >
+        static void load(const std::string& dir_, const std::string& dat_filename_, raw_volume< T >& volume_);
+        template< size_t I1, size_t I2, size_t I3, typename T >
+        static void load(const std::string& dir_, const std::string& dat_filename_, tensor3< I1, I2, I3, T >& data_);
+
+        static void swap_bytes(unsigned char* data_, size_t n_elements_, size_t element_size_);
+        static bool is_big_endian_host();
+
+    protected:
+        static void concat_path(const std::string& dir_, const std::string& filename_, std::string& path_);
+        static void read_file(const std::string& path_, size_t len_expected_, std::vector< unsigned char >& bytes_);
+
+        template< typename T >
+        static void convert(const raw_descriptor& desc_, std::vector< unsigned char >& bytes_, T* out_);
+
+        template< typename T_in, typename T >
+        static void convert_from(const unsigned char* in_, size_t n_elements_, T* out_);
+
+    }; //end raw_volume_loader
+
+
+
+    inline size_t
+    raw_descriptor::get_element_size() const {
+        switch (format) {
+            case UCHAR: case CHAR: return 1;
+            case USHORT: case SHORT: return 2;
+            case UINT: case INT: case FLOAT: return 4;
+            case DOUBLE: return 8;
+            default: return 0;
+        }
+    }
+
+    inline raw_descriptor::format_type
+    raw_descriptor::parse_format(const std::string& format_) {
+        if (format_ == "UCHAR" || format_ == "BYTE") return UCHAR;
+        if (format_ == "CHAR") return CHAR;
+        if (format_ == "USHORT") return USHORT;
+        if (format_ == "SHORT") return SHORT;
+        if (format_ == "UINT") return UINT;
+        if (format_ == "INT") return INT;
+        if (format_ == "FLOAT") return FLOAT;
+        if (format_ == "DOUBLE") return DOUBLE;
+        return UNKNOWN;
+    }
+
+    inline const char*
+    raw_descriptor::get_format_name(format_type format_) {
+        switch (format_) {
+            case UCHAR: return "UCHAR";
+            case CHAR: return "CHAR";
+            case USHORT: return "USHORT";
+            case SHORT: return "SHORT";
+            case UINT: return "UINT";
+            case INT: return "INT";
+            case FLOAT: return "FLOAT";
+            case DOUBLE: return "DOUBLE";
+            default: return "UNKNOWN";
+        }
+    }
+
+    template< typename T >
+    raw_descriptor::format_type
+    raw_descriptor::get_format() {
+        if (!std::numeric_limits< T >::is_integer)
+            return sizeof (T) == 4 ? FLOAT : (sizeof (T) == 8 ? DOUBLE : UNKNOWN);
+        const bool is_signed = std::numeric_limits< T >::is_signed;
+        switch (sizeof (T)) {
+            case 1: return is_signed ? CHAR : UCHAR;
+            case 2: return is_signed ? SHORT : USHORT;
+            case 4: return is_signed ? INT : UINT;
+            default: return UNKNOWN;
+        }
+    }
+
+    inline void
+    raw_volume_loader::concat_path(const std::string& dir_, const std::string& filename_, std::string& path_) {
+        int dir_length = dir_.size() - 1;
+        int last_separator = dir_.find_last_of("/");
+        path_ = dir_;
+        if (last_separator < dir_length) {
+            path_.append("/");
+        }
+        path_.append(filename_);
+    }
+
+    inline bool
+    raw_volume_loader::is_big_endian_host() {
+        const unsigned short probe = 1;
+        return *((const unsigned char*) &probe) == 0;
+    }
+
+    inline void
+    raw_volume_loader::parse_datfile(std::istream& in_, raw_descriptor& desc_) {
+        desc_ = raw_descriptor();
+        std::string line;
+        while (std::getline(in_, line)) {
+            const size_t separator = line.find(':');
+            if (separator == std::string::npos)
+                continue;
+            std::string key = line.substr(0, separator);
+            std::istringstream values(line.substr(separator + 1));
+
+            if (key == "ObjectFileName") {
+                values >> desc_.object_file_name;
+            } else if (key == "Resolution") {
+                values >> desc_.resolution[0] >> desc_.resolution[1] >> desc_.resolution[2];
+                if (values.fail())
+                    VMMLIB_ERROR("invalid resolution in .dat file", VMMLIB_HERE);
+            } else if (key == "SliceThickness") {
+                values >> desc_.slice_thickness[0] >> desc_.slice_thickness[1] >> desc_.slice_thickness[2];
+            } else if (key == "Format") {
+                std::string format;
+                values >> format;
+                desc_.format = raw_descriptor::parse_format(format);
+                if (desc_.format == raw_descriptor::UNKNOWN)
+                    VMMLIB_ERROR("unsupported format in .dat file: " + format, VMMLIB_HERE);
+            } else if (key == "Endianness" || key == "Endianess" || key == "ByteOrder") {
+                std::string order;
+                values >> order;
+                desc_.big_endian = (order.find("BIG") != std::string::npos);
+            }
+        }
+        if (desc_.object_file_name.empty() || desc_.format == raw_descriptor::UNKNOWN
+                || desc_.get_number_of_voxels() == 0)
+            VMMLIB_ERROR(".dat file misses ObjectFileName, Resolution or Format", VMMLIB_HERE);
+    }
+
+    inline void
+    raw_volume_loader::read_datfile(const std::string& dir_, const std::string& filename_, raw_descriptor& desc_) {
+        std::string path;
+        concat_path(dir_, filename_, path);
+        std::ifstream infile(path.c_str(), std::ios::in);
+        if (!infile.is_open())
+            VMMLIB_ERROR("cannot open .dat file " + path, VMMLIB_HERE);
+        parse_datfile(infile, desc_);
+    }
+
+    inline void
+    raw_volume_loader::read_file(const std::string& path_, size_t len_expected_, std::vector< unsigned char >& bytes_) {
+        std::ifstream infile(path_.c_str(), std::ios::in | std::ios::binary);
+        if (!infile.is_open())
+            VMMLIB_ERROR("cannot open .raw file " + path_, VMMLIB_HERE);
+
+        //check the length before reading anything
+        infile.seekg(0, std::ios::end);
+        const size_t len_file = size_t(infile.tellg());
+        infile.seekg(0, std::ios::beg);
+        if (len_file != len_expected_) {
+            std::ostringstream error;
+            error << "size of " << path_ << " is " << len_file << " bytes, the .dat file describes " << len_expected_ << " bytes";
+            VMMLIB_ERROR(error.str(), VMMLIB_HERE);
+        }
+
+        bytes_.resize(len_expected_);
+        const size_t max_read_len = 1u << 30;
+        for (size_t pos = 0; pos < len_expected_; pos += max_read_len) {
+            infile.read((char*) &bytes_[pos], (std::min)(max_read_len, len_expected_ - pos));
+        }
+        if (!infile)
+            VMMLIB_ERROR("failed to read " + path_, VMMLIB_HERE);
+    }
+
+    inline void
+    raw_volume_loader::swap_bytes(unsigned char* data_, size_t n_elements_, size_t element_size_) {
+        //fixed-size inner loops, which the compiler turns into byte shuffles
+        const long n = long(n_elements_);
+        switch (element_size_) {
+            case 2:
+#pragma omp parallel for
+                for (long i = 0; i < n; ++i) {
+                    unsigned char* e = data_ + 2 * i;
+                    const unsigned char b0 = e[0];
+                    e[0] = e[1]; e[1] = b0;
+                }
+                break;
+            case 4:
+#pragma omp parallel for
+                for (long i = 0; i < n; ++i) {
+                    unsigned char* e = data_ + 4 * i;
+                    const unsigned char b0 = e[0], b1 = e[1];
+                    e[0] = e[3]; e[1] = e[2]; e[2] = b1; e[3] = b0;
+                }
+                break;
+            case 8:
+#pragma omp parallel for
+                for (long i = 0; i < n; ++i) {
+                    unsigned char* e = data_ + 8 * i;
+                    for (size_t b = 0; b < 4; ++b) {
+                        const unsigned char tmp = e[b];
+                        e[b] = e[7 - b]; e[7 - b] = tmp;
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    template< typename T_in, typename T >
+    void
+    raw_volume_loader::convert_from(const unsigned char* in_, size_t n_elements_, T* out_) {
+        const long n = long(n_elements_);
+#pragma omp parallel for
+        for (long i = 0; i < n; ++i) {
+            T_in value;
+            memcpy(&value, in_ + i * sizeof (T_in), sizeof (T_in));
+            out_[i] = static_cast< T > (value);
+        }
+    }
+
+    template< typename T >
+    void
+    raw_volume_loader::convert(const raw_descriptor& desc_, std::vector< unsigned char >& bytes_, T* out_) {
+        const size_t n = desc_.get_number_of_voxels();
+        if (desc_.big_endian != is_big_endian_host())
+            swap_bytes(&bytes_[0], n, desc_.get_element_size());
+
+        const unsigned char* in = &bytes_[0];
+        switch (desc_.format) {
+            case raw_descriptor::UCHAR: convert_from< unsigned char > (in, n, out_); break;
+            case raw_descriptor::CHAR: convert_from< signed char > (in, n, out_); break;
+            case raw_descriptor::USHORT: convert_from< unsigned short > (in, n, out_); break;
+            case raw_descriptor::SHORT: convert_from< short > (in, n, out_); break;
+            case raw_descriptor::UINT: convert_from< unsigned int > (in, n, out_); break;
+            case raw_descriptor::INT: convert_from< int > (in, n, out_); break;
+            case raw_descriptor::FLOAT: convert_from< float > (in, n, out_); break;
+            case raw_descriptor::DOUBLE: convert_from< double > (in, n, out_); break;
+            default: VMMLIB_ERROR("unsupported format", VMMLIB_HERE);
+        }
+    }
+
+    template< typename T >
+    void
+    raw_volume_loader::read_raw(const std::string& dir_, const raw_descriptor& desc_, raw_volume< T >& volume_) {
+        std::string path;
+        concat_path(dir_, desc_.object_file_name, path);
+        std::vector< unsigned char > bytes;
+        read_file(path, desc_.get_raw_size(), bytes);
+
+        for (size_t mode = 0; mode < 3; ++mode) {
+            volume_.resolution[mode] = desc_.resolution[mode];
+        }
+        volume_.data.resize(desc_.get_number_of_voxels());
+        convert(desc_, bytes, &volume_.data[0]);
+    }
+
+    template< size_t I1, size_t I2, size_t I3, typename T >
+    void
+    raw_volume_loader::read_raw(const std::string& dir_, const raw_descriptor& desc_, tensor3< I1, I2, I3, T >& data_) {
+        if (desc_.resolution[0] != I1 || desc_.resolution[1] != I2 || desc_.resolution[2] != I3) {
+            std::ostringstream error;
+            error << "resolution " << desc_.resolution[0] << "x" << desc_.resolution[1] << "x" << desc_.resolution[2]
+                    << " does not match tensor3 " << I1 << "x" << I2 << "x" << I3;
+            VMMLIB_ERROR(error.str(), VMMLIB_HERE);
+        }
+        std::string path;
+        concat_path(dir_, desc_.object_file_name, path);
+        std::vector< unsigned char > bytes;
+        read_file(path, desc_.get_raw_size(), bytes);
+        convert(desc_, bytes, data_.get_array_ptr());
+    }
+
+    template< typename T >
+    void
+    raw_volume_loader::load(const std::string& dir_, const std::string& dat_filename_, raw_volume< T >& volume_) {
+        raw_descriptor desc;
+        read_datfile(dir_, dat_filename_, desc);
+        read_raw(dir_, desc, volume_);
+    }
+
+    template< size_t I1, size_t I2, size_t I3, typename T >
+    void
+    raw_volume_loader::load(const std::string& dir_, const std::string& dat_filename_, tensor3< I1, I2, I3, T >& data_) {
+        raw_descriptor desc;
+        read_datfile(dir_, dat_filename_, desc);
+        read_raw(dir_, desc, data_);
+    }
+
+}//end vmml namespace
+
+#endif
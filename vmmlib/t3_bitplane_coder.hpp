@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* embedded bit-plane coding of a (Tucker3 core) tensor3
+ *
+ * the coefficient magnitudes are linearly quantized to n_bitplanes_ bits and
+ * emitted bit-plane by bit-plane (most significant plane first). within a
+ * plane, the coefficients are visited in hot-first order (by r1+r2+r3, i.e.,
+ * starting at the high-energy corner of the core). a coefficient sends its
+ * sign when it becomes significant, later planes refine its magnitude.
+ *
+ * the decoder accepts any prefix of the stream and can be fed incrementally;
+ * coefficients are reconstructed at the midpoint of their uncertainty interval.
+ *
+ * reference:
+ * - Shapiro, 1993: Embedded image coding using zerotrees of wavelet
+ *   coefficients, IEEE Transactions on Signal Processing.
+ */
+
+#ifndef __VMML__T3_BITPLANE_CODER__HPP__
+#define __VMML__T3_BITPLANE_CODER__HPP__
+
+#include <vmmlib/tensor3.hpp>
+#include <vmmlib/exception.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace vmml {
+
+    template< size_t R1, size_t R2, size_t R3, typename T = float >
+    class t3_bitplane_coder
+    {
+    public:
+        typedef tensor3< R1, R2, R3, T > t3_core_t;
+        typedef std::vector< unsigned char > bytes_t;
+
+        static const size_t SIZE = R1 * R2 * R3;
+        static const size_t MAX_BITPLANES = 31;
+
+        //encoder
+        static void encode(const t3_core_t& core_, T max_abs_, size_t n_bitplanes_, bytes_t& out_);
+        static T get_max_abs(const t3_core_t& core_);
+        static size_t get_max_stream_size(size_t n_bitplanes_);
+
+        //decoder
+        t3_bitplane_coder();
+        t3_bitplane_coder(T max_abs_, size_t n_bitplanes_);
+        void init(T max_abs_, size_t n_bitplanes_);
+        bool is_initialized() const { return _n_bitplanes > 0; };
+
+        //decodes the bits of in_ that have not been decoded by a previous call.
+        //in_ is the received prefix of the stream, i.e., it contains the bytes of previous calls.
+        void decode(const unsigned char* in_, size_t len_);
+        void decode(const bytes_t& in_);
+        void get_core(t3_core_t& core_) const;
+
+        bool is_complete() const { return is_initialized() && _bitplane < 0; };
+        long get_current_bitplane() const { return _bitplane; };
+        size_t get_decoded_bits() const { return _bit_pos; };
+
+    protected:
+        static void get_scan_order(std::vector< size_t >& order_);
+        static unsigned long quantize(T value_, T max_abs_, size_t n_bitplanes_);
+
+        struct hot_first
+        {
+            bool operator()(size_t a_, size_t b_) const {
+                const size_t dist_a = a_ % R1 + (a_ / R1) % R2 + a_ / (R1 * R2);
+                const size_t dist_b = b_ % R1 + (b_ / R1) % R2 + b_ / (R1 * R2);
+                return dist_a < dist_b || (dist_a == dist_b && a_ < b_);
+            }
+        };
+
+        T _max_abs;
+        size_t _n_bitplanes;
+        std::vector< size_t > _order;
+        std::vector< unsigned long > _magnitudes;
+        std::vector< char > _signs;
+        std::vector< bool > _significant;
+        long _bitplane;
+        size_t _scan_pos;
+        size_t _bit_pos;
+
+    }; //end t3_bitplane_coder
+
+
+
+#define VMML_TEMPLATE_STRING        template< size_t R1, size_t R2, size_t R3, typename T >
+#define VMML_TEMPLATE_CLASSNAME     t3_bitplane_coder< R1, R2, R3, T >
+
+    VMML_TEMPLATE_STRING
+    VMML_TEMPLATE_CLASSNAME::t3_bitplane_coder()
+    : _max_abs(0)
+    , _n_bitplanes(0)
+    , _bitplane(-1)
+    , _scan_pos(0)
+    , _bit_pos(0) {
+    }
+
+    VMML_TEMPLATE_STRING
+    VMML_TEMPLATE_CLASSNAME::t3_bitplane_coder(T max_abs_, size_t n_bitplanes_) {
+        init(max_abs_, n_bitplanes_);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::init(T max_abs_, size_t n_bitplanes_) {
+        if (n_bitplanes_ == 0 || n_bitplanes_ > MAX_BITPLANES)
+            VMMLIB_ERROR("number of bit-planes out of range", VMMLIB_HERE);
+        _max_abs = max_abs_;
+        _n_bitplanes = n_bitplanes_;
+        _magnitudes.assign(SIZE, 0);
+        _signs.assign(SIZE, 0);
+        _significant.assign(SIZE, false);
+        _bitplane = long(n_bitplanes_) - 1;
+        _scan_pos = 0;
+        _bit_pos = 0;
+        get_scan_order(_order);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::get_scan_order(std::vector< size_t >& order_) {
+        order_.resize(SIZE);
+        for (size_t index = 0; index < SIZE; ++index) {
+            order_[index] = index;
+        }
+        std::sort(order_.begin(), order_.end(), hot_first());
+    }
+
+    VMML_TEMPLATE_STRING
+    T
+    VMML_TEMPLATE_CLASSNAME::get_max_abs(const t3_core_t& core_) {
+        T max_abs = 0;
+        const T* core = core_.get_array_ptr();
+        for (size_t index = 0; index < SIZE; ++index) {
+            max_abs = (std::max)(max_abs, T(fabs(core[index])));
+        }
+        return max_abs;
+    }
+
+    VMML_TEMPLATE_STRING
+    size_t
+    VMML_TEMPLATE_CLASSNAME::get_max_stream_size(size_t n_bitplanes_) {
+        //one bit per coefficient and plane, plus one sign bit per coefficient
+        return ((n_bitplanes_ + 1) * SIZE + 7) / 8;
+    }
+
+    VMML_TEMPLATE_STRING
+    unsigned long
+    VMML_TEMPLATE_CLASSNAME::quantize(T value_, T max_abs_, size_t n_bitplanes_) {
+        if (max_abs_ <= 0)
+            return 0;
+        const double levels = double((1ul << n_bitplanes_) - 1);
+        const double q = floor(fabs(double(value_)) / double(max_abs_) * levels + 0.5);
+        return (unsigned long) ((std::min)(q, levels));
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::encode(const t3_core_t& core_, T max_abs_, size_t n_bitplanes_, bytes_t& out_) {
+        if (n_bitplanes_ == 0 || n_bitplanes_ > MAX_BITPLANES)
+            VMMLIB_ERROR("number of bit-planes out of range", VMMLIB_HERE);
+
+        std::vector< size_t > order;
+        get_scan_order(order);
+
+        const T* core = core_.get_array_ptr();
+        std::vector< unsigned long > magnitudes(SIZE);
+        for (size_t index = 0; index < SIZE; ++index) {
+            magnitudes[index] = quantize(core[index], max_abs_, n_bitplanes_);
+        }
+
+        out_.clear();
+        out_.reserve(get_max_stream_size(n_bitplanes_));
+        std::vector< bool > significant(SIZE, false);
+        unsigned char byte = 0;
+        size_t n_bits = 0;
+        for (long plane = long(n_bitplanes_) - 1; plane >= 0; --plane) {
+            for (size_t scan = 0; scan < SIZE; ++scan) {
+                const size_t index = order[scan];
+                const bool bit = (magnitudes[index] >> plane) & 1;
+                bool bits[2] = { bit, core[index] < 0 };
+                //significance pass: a newly significant coefficient is followed by its sign
+                const size_t count = (!significant[index] && bit) ? 2 : 1;
+                if (bit)
+                    significant[index] = true;
+                for (size_t b = 0; b < count; ++b) {
+                    byte = (unsigned char) ((byte << 1) | (bits[b] ? 1 : 0));
+                    if (++n_bits == 8) {
+                        out_.push_back(byte);
+                        byte = 0;
+                        n_bits = 0;
+                    }
+                }
+            }
+        }
+        if (n_bits > 0)
+            out_.push_back((unsigned char) (byte << (8 - n_bits)));
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::decode(const bytes_t& in_) {
+        if (!in_.empty())
+            decode(&in_[0], in_.size());
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::decode(const unsigned char* in_, size_t len_) {
+        if (!is_initialized())
+            VMMLIB_ERROR("bit-plane decoder is not initialized", VMMLIB_HERE);
+        const size_t n_bits = len_ * 8;
+        while (_bitplane >= 0) {
+            const size_t index = _order[_scan_pos];
+            if (_bit_pos >= n_bits)
+                break;
+            const bool bit = (in_[_bit_pos / 8] >> (7 - _bit_pos % 8)) & 1;
+            if (bit && !_significant[index]) {
+                //wait for the sign bit
+                if (_bit_pos + 1 >= n_bits)
+                    break;
+                _signs[index] = (in_[(_bit_pos + 1) / 8] >> (7 - (_bit_pos + 1) % 8)) & 1;
+                _significant[index] = true;
+                ++_bit_pos;
+            }
+            ++_bit_pos;
+            if (bit)
+                _magnitudes[index] |= 1ul << _bitplane;
+
+            if (++_scan_pos == SIZE) {
+                _scan_pos = 0;
+                --_bitplane;
+            }
+        }
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::get_core(t3_core_t& core_) const {
+        if (!is_initialized())
+            VMMLIB_ERROR("bit-plane decoder is not initialized", VMMLIB_HERE);
+        const double levels = double((1ul << _n_bitplanes) - 1);
+        T* core = core_.get_array_ptr();
+        for (size_t scan = 0; scan < SIZE; ++scan) {
+            const size_t index = _order[scan];
+            if (!_significant[index]) {
+                core[index] = 0;
+                continue;
+            }
+            //lowest plane known for this coefficient, the bits below are unknown
+            const long known_plane = (scan < _scan_pos) ? _bitplane : _bitplane + 1;
+            double magnitude = double(_magnitudes[index]);
+            if (known_plane > 0)
+                magnitude += 0.5 * double((1ul << known_plane) - 1);
+            const double value = magnitude / levels * double(_max_abs);
+            core[index] = T(_signs[index] ? -value : value);
+        }
+    }
+
+#undef VMML_TEMPLATE_STRING
+#undef VMML_TEMPLATE_CLASSNAME
+
+}//end vmml namespace
+
+#endif
@@ -36,6 +36,8 @@
 #define __VMML__T3_CONVERTER__HPP__
 
 #include <vmmlib/tensor3.hpp>
+#include <vmmlib/raw_volume_loader.hpp>
+#include <vmmlib/csv_formatter.hpp>
 
 namespace vmml {
 
@@ -64,7 +66,11 @@ namespace vmml {
         static void write_to_raw(const t3_t& data_, const std::string& dir_, const std::string& filename_); // OK
         static void read_from_raw(t3_t& data_, const std::string& dir_, const std::string& filename_); // OK
         static void write_datfile(const std::string& dir_, const std::string& filename_);
-        static void write_to_csv(const t3_t& data_, const std::string& dir_, const std::string& filename_);
+        //reads the .dat file and converts its .raw file (any format, byte order) to T
+        static void read_from_dat(t3_t& data_, const std::string& dir_, const std::string& dat_filename_);
+        //one frontal slice after the other, precision_ = 0: round-trip precision for floating point values
+        static void write_to_csv(const t3_t& data_, const std::string& dir_, const std::string& filename_, int precision_ = 0);
+        static void read_from_csv(t3_t& data_, const std::string& dir_, const std::string& filename_);
         static void remove_normals_from_raw(const t3_t& data_, const std::string& dir_, const std::string& filename_);
         static double rmse_from_files(const std::string& dir_, const std::string& filename_a_, const std::string& filename_b_ );
 
@@ -77,6 +83,7 @@ namespace vmml {
     protected:
 
         static void concat_path(const std::string& dir_, const std::string& filename_, std::string& path_);
+        static void concat_csv_path(const std::string& dir_, const std::string& filename_, std::string& path_);
 
     }; //end t3_converter
 
@@ -463,13 +470,15 @@ namespace vmml {
 
         std::string path_dat = path;
 
-        const char* format = (sizeof (T) == 2) ? "USHORT" : "UCHAR";
+        const char* format = raw_descriptor::get_format_name(raw_descriptor::get_format< T >());
 
         FILE* datfile = fopen(path_dat.c_str(), "w");
         fprintf(datfile, "ObjectFileName:\t%s.raw\n", filename.c_str());
         fprintf(datfile, "TaggedFileName:\t---\nResolution:\t%i %i %i\n", int(I1), int(I2), int(I3));
         fprintf(datfile, "SliceThickness:\t1.0 1.0 1.0\n");
         fprintf(datfile, "Format:\t%s\nNbrTags:\t0\n", format);
+        //write_to_raw stores the host byte order
+        fprintf(datfile, "Endianness:\t%s\n", raw_volume_loader::is_big_endian_host() ? "BIG_ENDIAN" : "LITTLE_ENDIAN");
         fprintf(datfile, "ObjectType:\tTEXTURE_VOLUME_OBJECT\nObjectModel:\tI\nGridType:\tEQUIDISTANT\n");
         fprintf(datfile, "Modality:\tunknown\nTimeStep:\t0\n");
         fclose(datfile);
@@ -477,34 +486,42 @@ namespace vmml {
 
     VMML_TEMPLATE_STRING
     void
-    VMML_TEMPLATE_CLASSNAME::write_to_csv(const t3_t& data_, const std::string& dir_, const std::string& filename_) {
+    VMML_TEMPLATE_CLASSNAME::read_from_dat(t3_t& data_, const std::string& dir_, const std::string& dat_filename_) {
+        raw_volume_loader::load(dir_, dat_filename_, data_);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::write_to_csv(const t3_t& data_, const std::string& dir_, const std::string& filename_, int precision_) {
+        std::string path;
+        concat_csv_path(dir_, filename_, path);
+        csv_formatter::write(path, data_.get_array_ptr(), I1, I2, I3, 0, precision_);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::read_from_csv(t3_t& data_, const std::string& dir_, const std::string& filename_) {
+        std::string path;
+        concat_csv_path(dir_, filename_, path);
+        csv_formatter::read(path, data_.get_array_ptr(), I1, I2, I3);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::concat_csv_path(const std::string& dir_, const std::string& filename_, std::string& path_) {
         int dir_length = dir_.size() - 1;
         int last_separator = dir_.find_last_of("/");
-        std::string path = dir_;
+        path_ = dir_;
         if (last_separator < dir_length) {
-            path.append("/");
+            path_.append("/");
         }
-        path.append(filename_);
+        path_.append(filename_);
         //check for format
         if (filename_.find("csv", filename_.size() - 3) == std::string::npos)
         {
-            path.append(".");
-            path.append("csv");
-        }
-
-        std::ofstream outfile;
-        outfile.open(path.c_str());
-        if (outfile.is_open()) {
-
-            for (size_t i = 0; i < I3; ++i) {
-                outfile << data_.get_frontal_slice_fwd(i) << std::endl;
-            }
-
-            outfile.close();
-        } else {
-            std::cout << "no file open" << std::endl;
+            path_.append(".");
+            path_.append("csv");
         }
-
     }
 
     VMML_TEMPLATE_STRING
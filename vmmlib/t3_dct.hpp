@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__T3_DCT__HPP__
+#define __VMML__T3_DCT__HPP__
+
+#include <vmmlib/tensor3.hpp>
+#include <vmmlib/dct.hpp>
+#include <vmmlib/exception.hpp>
+
+/*
+ * orthonormal DCT-II (forward) and DCT-III (inverse) along the modes of a
+ * tensor3, in place. the result along mode n equals the n-mode product
+ * with the matrix built by matrix::set_dct(), without forming it.
+ * see dct.hpp for the kernel.
+ */
+
+namespace vmml
+{
+
+class t3_dct
+{
+public:
+    template< size_t I1, size_t I2, size_t I3, typename T >
+    static void forward( tensor3< I1, I2, I3, T >& t3_, size_t mode_ );
+
+    template< size_t I1, size_t I2, size_t I3, typename T >
+    static void inverse( tensor3< I1, I2, I3, T >& t3_, size_t mode_ );
+
+    // all three modes
+    template< size_t I1, size_t I2, size_t I3, typename T >
+    static void forward( tensor3< I1, I2, I3, T >& t3_ );
+
+    template< size_t I1, size_t I2, size_t I3, typename T >
+    static void inverse( tensor3< I1, I2, I3, T >& t3_ );
+
+protected:
+    template< size_t I1, size_t I2, size_t I3, typename T >
+    static void _transform( tensor3< I1, I2, I3, T >& t3_, size_t mode_, bool inverse_ );
+
+    template< size_t N, typename T >
+    static void _apply( dct< N, T >& dct_, bool inverse_, T* data_, size_t n_lines_,
+                        size_t element_stride_, size_t line_stride_ );
+
+}; // class t3_dct
+
+
+
+template< size_t N, typename T >
+void
+t3_dct::_apply( dct< N, T >& dct_, bool inverse_, T* data_, size_t n_lines_,
+                size_t element_stride_, size_t line_stride_ )
+{
+    if ( inverse_ )
+        dct_.inverse( data_, n_lines_, element_stride_, line_stride_ );
+    else
+        dct_.forward( data_, n_lines_, element_stride_, line_stride_ );
+}
+
+
+
+template< size_t I1, size_t I2, size_t I3, typename T >
+void
+t3_dct::_transform( tensor3< I1, I2, I3, T >& t3_, size_t mode_, bool inverse_ )
+{
+    // element ( i1, i2, i3 ) is at i3 * I1 * I2 + i2 * I1 + i1
+    T* data = t3_.get_array_ptr();
+    switch( mode_ )
+    {
+        case 1:
+        {
+            dct< I1, T > dct1;
+            _apply( dct1, inverse_, data, I2 * I3, 1, I1 );
+            break;
+        }
+        case 2:
+        {
+            // mode-2 fibers of a frontal slice lie side by side
+            dct< I2, T > dct2;
+            for( size_t i3 = 0; i3 < I3; ++i3 )
+                _apply( dct2, inverse_, data + i3 * I1 * I2, I1, I1, 1 );
+            break;
+        }
+        case 3:
+        {
+            dct< I3, T > dct3;
+            _apply( dct3, inverse_, data, I1 * I2, I1 * I2, 1 );
+            break;
+        }
+        default:
+            VMMLIB_ERROR( "t3_dct - mode must be 1, 2 or 3", VMMLIB_HERE );
+    }
+}
+
+
+
+template< size_t I1, size_t I2, size_t I3, typename T >
+void
+t3_dct::forward( tensor3< I1, I2, I3, T >& t3_, size_t mode_ )
+{
+    _transform( t3_, mode_, false );
+}
+
+
+
+template< size_t I1, size_t I2, size_t I3, typename T >
+void
+t3_dct::inverse( tensor3< I1, I2, I3, T >& t3_, size_t mode_ )
+{
+    _transform( t3_, mode_, true );
+}
+
+
+
+template< size_t I1, size_t I2, size_t I3, typename T >
+void
+t3_dct::forward( tensor3< I1, I2, I3, T >& t3_ )
+{
+    for( size_t mode = 1; mode <= 3; ++mode )
+        _transform( t3_, mode, false );
+}
+
+
+
+template< size_t I1, size_t I2, size_t I3, typename T >
+void
+t3_dct::inverse( tensor3< I1, I2, I3, T >& t3_ )
+{
+    for( size_t mode = 1; mode <= 3; ++mode )
+        _transform( t3_, mode, true );
+}
+
+
+} // namespace vmml
+
+#endif
@@ -91,6 +91,15 @@ namespace vmml {
          the inversion is done with a matrix pseudoinverse computation
          */
         static void derive_core(const t3_type& data_, const u1_type& u1_, const u2_type& u2_, const u3_type& u3_, t3_core_type& core_);
+
+        //pseudoinverse solvers of derive_core; pass the same instance to
+        //repeated calls so that their workspaces are allocated only once
+        struct core_solvers {
+            pseudoinverse_solver< I1, R1, T > u1;
+            pseudoinverse_solver< I2, R2, T > u2;
+            pseudoinverse_solver< I3, R3, T > u3;
+        };
+        static void derive_core(const t3_type& data_, const u1_type& u1_, const u2_type& u2_, const u3_type& u3_, t3_core_type& core_, core_solvers& solvers_);
         //faster: but only if basis matrices are orthogonal
         static void derive_core_orthogonal_bases(const t3_type& data_, const u1_type& u1_, const u2_type& u2_, const u3_type& u3_, t3_core_type& core_);
 
@@ -106,14 +115,20 @@ namespace vmml {
 
         struct init_random {
 
+            // seeded with the time by default, pass a seed for reproducible results
+            init_random() : seed(time(NULL)) {}
+            explicit init_random(random_generator::counter_type seed_) : seed(seed_) {}
+
             inline void operator()(const t3_type&, u2_type& u2_, u3_type & u3_) {
-                srand(time(NULL));
-                u2_.set_random();
-                u3_.set_random();
+                random_generator rng(seed);
+                u2_.set_random(rng);
+                u3_.set_random(rng);
 
                 u2_ /= u2_.frobenius_norm();
                 u3_ /= u3_.frobenius_norm();
             }
+
+            random_generator::counter_type seed;
         };
 
         struct init_dct {
@@ -328,37 +343,30 @@ namespace vmml {
     VMML_TEMPLATE_STRING
     void
     VMML_TEMPLATE_CLASSNAME::derive_core(const t3_type& data_, const u1_type& u1_, const u2_type& u2_, const u3_type& u3_, t3_core_type& core_) {
+        core_solvers solvers;
+        derive_core(data_, u1_, u2_, u3_, core_, solvers);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::derive_core(const t3_type& data_, const u1_type& u1_, const u2_type& u2_, const u3_type& u3_, t3_core_type& core_, core_solvers& solvers_) {
 
 #if 1
         //faster approach
         //compute pseudo inverse for matrices u1-u3
-        u1_type* u1_pinv_t = new u1_type;
-        u2_type* u2_pinv_t = new u2_type;
-        u3_type* u3_pinv_t = new u3_type;
-
-        compute_pseudoinverse< u1_type > compute_pinv_u1;
-        compute_pinv_u1(u1_, *u1_pinv_t);
-        compute_pseudoinverse< u2_type > compute_pinv_u2;
-        compute_pinv_u2(u2_, *u2_pinv_t);
-        compute_pseudoinverse< u3_type > compute_pinv_u3;
-        compute_pinv_u3(u3_, *u3_pinv_t);
-
         u1_t_type* u1_pinv = new u1_t_type;
         u2_t_type* u2_pinv = new u2_t_type;
         u3_t_type* u3_pinv = new u3_t_type;
 
-        u1_pinv_t->transpose_to(*u1_pinv);
-        u2_pinv_t->transpose_to(*u2_pinv);
-        u3_pinv_t->transpose_to(*u3_pinv);
+        solvers_.u1.compute(u1_, *u1_pinv);
+        solvers_.u2.compute(u2_, *u2_pinv);
+        solvers_.u3.compute(u3_, *u3_pinv);
 
         t3_ttm::full_tensor3_matrix_multiplication(data_, *u1_pinv, *u2_pinv, *u3_pinv, core_);
 
         delete u1_pinv;
         delete u2_pinv;
         delete u3_pinv;
-        delete u1_pinv_t;
-        delete u2_pinv_t;
-        delete u3_pinv_t;
 
 #else
         //previous version of compute core
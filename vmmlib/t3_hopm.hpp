@@ -49,7 +49,10 @@
 
 #include <vmmlib/t3_hosvd.hpp>
 #include <vmmlib/matrix_pseudoinverse.hpp>
+#include <vmmlib/cholesky_solver.hpp>
 #include <vmmlib/blas_dgemm.hpp>
+#include <vmmlib/blas_dsyrk.hpp>
+#include <vmmlib/packed_matrix.hpp>
 #include <vmmlib/blas_dot.hpp>
 #include <vmmlib/validator.hpp>
 #include <vmmlib/t3_ttv.hpp>
@@ -77,6 +80,8 @@ namespace vmml {
         typedef matrix< I3, I1*I2, T > u3_unfolded_type;
 
         typedef matrix< R, R, T > m_r2_type;
+        typedef symmetric_matrix< R, T > m_r2_sym_type;
+        typedef pseudoinverse_solver< R, R, T > pinv_solver_type;
 
         typedef typename lambda_type::iterator lvalue_iterator;
         typedef typename lambda_type::const_iterator lvalue_const_iterator;
@@ -103,11 +108,17 @@ namespace vmml {
 
         struct init_random {
 
+            // seeded with the time by default, pass a seed for reproducible results
+            init_random() : seed(time(NULL)) {}
+            explicit init_random(random_generator::counter_type seed_) : seed(seed_) {}
+
             inline void operator()(const t3_type&, u2_type& u2_, u3_type & u3_) {
-                srand(time(NULL));
-                u2_.set_random();
-                u3_.set_random();
+                random_generator rng(seed);
+                u2_.set_random(rng);
+                u3_.set_random(rng);
             }
+
+            random_generator::counter_type seed;
         };
 
         //FIXME: check test on linux
@@ -125,15 +136,18 @@ namespace vmml {
 
     protected:
 
-        static void optimize_mode1(const t3_type& data_, u1_type& u1, const u2_type& u2_, const u3_type& u3_, lambda_type& lambdas_);
-        static void optimize_mode2(const t3_type& data_, const u1_type& u1_, u2_type& u2_, const u3_type& u3_, lambda_type& lambdas_);
-        static void optimize_mode3(const t3_type& data_, const u1_type& u1_, const u2_type& u2_, u3_type& u3_, lambda_type& lambdas_);
+        //compute_pinv_ is the fallback for ill-conditioned gram matrices,
+        //shared by all iterations so that its workspace is allocated once
+        static void optimize_mode1(const t3_type& data_, u1_type& u1, const u2_type& u2_, const u3_type& u3_, lambda_type& lambdas_, pinv_solver_type& compute_pinv_);
+        static void optimize_mode2(const t3_type& data_, const u1_type& u1_, u2_type& u2_, const u3_type& u3_, lambda_type& lambdas_, pinv_solver_type& compute_pinv_);
+        static void optimize_mode3(const t3_type& data_, const u1_type& u1_, const u2_type& u2_, u3_type& u3_, lambda_type& lambdas_, pinv_solver_type& compute_pinv_);
 
         template< size_t J, size_t K, size_t L >
         static void optimize(const matrix< J, K*L, T >& unfolding_,
                 matrix< J, R, T >& uj_,
                 const matrix< K, R, T >& uk_, const matrix< L, R, T >& ul_,
-                vector< R, T>& lambdas_
+                vector< R, T>& lambdas_,
+                pinv_solver_type& compute_pinv_
                 );
 
         static void sort_dec(u1_type& u1_, u2_type& u2_, u3_type& u3_, lambda_type& lambdas_);
@@ -195,6 +209,8 @@ namespace vmml {
         std::cout << convert.str() + "-R rank CP ALS: HOPM (for tensor3) " << std::endl;
 #endif
 
+        pinv_solver_type compute_pinv;
+
         size_t i = 0;
         while (i < max_iterations_ && (tolerance_ < 0 || fitchange >= tolerance_)) //do until converges
         {
@@ -203,17 +219,17 @@ namespace vmml {
             //            timer myTimer;
             //            myTimer.start();
 
-            optimize_mode1(data_, u1_, u2_, u3_, lambdas_);
+            optimize_mode1(data_, u1_, u2_, u3_, lambdas_, compute_pinv);
             //#if CP_LOG
             //            std::cerr << myTimer.get_seconds() << " ";
             //            myTimer.start();
             //#endif
-            optimize_mode2(data_, u1_, u2_, u3_, lambdas_);
+            optimize_mode2(data_, u1_, u2_, u3_, lambdas_, compute_pinv);
 #if CP_LOG
             //            std::cerr << myTimer.get_seconds() << " ";
             //            myTimer.start();
 #endif
-            optimize_mode3(data_, u1_, u2_, u3_, lambdas_);
+            optimize_mode3(data_, u1_, u2_, u3_, lambdas_, compute_pinv);
             //#if CP_LOG
             //            std::cerr << myTimer.get_seconds() << " ";
             //#endif
@@ -270,42 +286,42 @@ namespace vmml {
 
     VMML_TEMPLATE_STRING
     void
-    VMML_TEMPLATE_CLASSNAME::optimize_mode1(const t3_type& data_, u1_type& u1_, const u2_type& u2_, const u3_type& u3_, lambda_type& lambdas_) {
+    VMML_TEMPLATE_CLASSNAME::optimize_mode1(const t3_type& data_, u1_type& u1_, const u2_type& u2_, const u3_type& u3_, lambda_type& lambdas_, pinv_solver_type& compute_pinv_) {
         u1_unfolded_type* unfolding = new u1_unfolded_type; // -> u1
         //data_.horizontal_unfolding_bwd( *unfolding ); //lathauwer
         data_.frontal_unfolding_fwd(*unfolding);
 
         assert(validator::is_valid(u2_) && validator::is_valid(u3_));
 
-        optimize(*unfolding, u1_, u2_, u3_, lambdas_);
+        optimize(*unfolding, u1_, u2_, u3_, lambdas_, compute_pinv_);
 
         delete unfolding;
     }
 
     VMML_TEMPLATE_STRING
     void
-    VMML_TEMPLATE_CLASSNAME::optimize_mode2(const t3_type& data_, const u1_type& u1_, u2_type& u2_, const u3_type& u3_, lambda_type& lambdas_) {
+    VMML_TEMPLATE_CLASSNAME::optimize_mode2(const t3_type& data_, const u1_type& u1_, u2_type& u2_, const u3_type& u3_, lambda_type& lambdas_, pinv_solver_type& compute_pinv_) {
         u2_unfolded_type* unfolding = new u2_unfolded_type; // -> u2
         data_.frontal_unfolding_bwd(*unfolding); //lathauwer
         //data_.horizontal_unfolding_fwd( *unfolding );
 
         assert(validator::is_valid(u1_) && validator::is_valid(u3_));
 
-        optimize(*unfolding, u2_, u1_, u3_, lambdas_);
+        optimize(*unfolding, u2_, u1_, u3_, lambdas_, compute_pinv_);
 
         delete unfolding;
     }
 
     VMML_TEMPLATE_STRING
     void
-    VMML_TEMPLATE_CLASSNAME::optimize_mode3(const t3_type& data_, const u1_type& u1_, const u2_type& u2_, u3_type& u3_, lambda_type& lambdas_) {
+    VMML_TEMPLATE_CLASSNAME::optimize_mode3(const t3_type& data_, const u1_type& u1_, const u2_type& u2_, u3_type& u3_, lambda_type& lambdas_, pinv_solver_type& compute_pinv_) {
         u3_unfolded_type* unfolding = new u3_unfolded_type; //-> u3
         //data_.horizontal_unfolding_bwd( *unfolding );//lathauwer
         data_.lateral_unfolding_fwd(*unfolding);
 
         assert(validator::is_valid(u1_) && validator::is_valid(u2_));
 
-        optimize(*unfolding, u3_, u1_, u2_, lambdas_);
+        optimize(*unfolding, u3_, u1_, u2_, lambdas_, compute_pinv_);
 
         delete unfolding;
     }
@@ -317,7 +333,8 @@ namespace vmml {
             const matrix< J, K*L, T >& unfolding_,
             matrix< J, R, T >& uj_,
             const matrix< K, R, T >& uk_, const matrix< L, R, T >& ul_,
-            vector< R, T>& lambdas_
+            vector< R, T>& lambdas_,
+            pinv_solver_type& compute_pinv_
             ) {
 
         typedef matrix< K*L, R, T > krp_matrix_type;
@@ -331,25 +348,30 @@ namespace vmml {
         blas_dgemm< J, K*L, R, T> blas_dgemm1;
         blas_dgemm1.compute(unfolding_, *krp_prod, *u_new);
 
-        //square matrix of U_l and U_k
-        m_r2_type* uk_r = new m_r2_type;
+        //gram matrices of U_k and U_l, dense for the cholesky solver
+        m_r2_type* gram = new m_r2_type;
         m_r2_type* ul_r = new m_r2_type;
 
-        blas_dgemm< R, K, R, T> blas_dgemm2;
-        blas_dgemm2.compute_t(uk_, *uk_r);
-        assert(validator::is_valid(*uk_r));
+        blas_dsyrk< R, K, T> blas_dsyrk2;
+        blas_dsyrk2.compute_t(uk_, *gram);
 
-        blas_dgemm< R, L, R, T> blas_dgemm3;
-        blas_dgemm3.compute_t(ul_, *ul_r);
-        assert(validator::is_valid(*ul_r));
+        blas_dsyrk< R, L, T> blas_dsyrk3;
+        blas_dsyrk3.compute_t(ul_, *ul_r);
 
-        uk_r->multiply_piecewise(*ul_r);
-        assert(validator::is_valid(*uk_r));
+        gram->multiply_piecewise(*ul_r);
+        assert(validator::is_valid(*gram));
 
+        // the gram matrix is spd unless the factors are rank deficient;
+        // the svd based pseudoinverse is used once the inverse would lose
+        // more than half of the digits
         m_r2_type* pinv_t = new m_r2_type;
-        compute_pseudoinverse< m_r2_type > compute_pinv;
-
-        compute_pinv(*uk_r, *pinv_t);
+        cholesky_solver< R, T > gram_solver;
+        if (gram_solver.factorize(*gram) && gram_solver.is_spd()
+            && gram_solver.reciprocal_condition_estimate() > std::sqrt(std::numeric_limits< T >::epsilon())) {
+            gram_solver.compute_inverse(*pinv_t);
+        } else {
+            compute_pinv_.compute_transposed(*gram, *pinv_t);
+        }
 
         blas_dgemm< J, R, R, T> blas_dgemm4;
         blas_dgemm4.compute_bt(*u_new, *pinv_t, uj_);
@@ -377,8 +399,8 @@ namespace vmml {
         assert(validator::is_valid(uj_));
 
         delete krp_prod;
-        delete uk_r;
         delete ul_r;
+        delete gram;
         delete pinv_t;
         delete u_new;
         delete diag_lambdas;
@@ -411,34 +433,28 @@ namespace vmml {
     VMML_TEMPLATE_STRING
     double
     VMML_TEMPLATE_CLASSNAME::norm_ktensor(const u1_type& u1_, const u2_type& u2_, const u3_type& u3_, const lambda_type& lambdas_) {
-        m_r2_type* coeff2_matrix = new m_r2_type;
-        m_r2_type* cov_u1 = new m_r2_type;
-        m_r2_type* cov_u2 = new m_r2_type;
-        m_r2_type* cov_u3 = new m_r2_type;
-
-        blas_dgemm< R, 1, R, T >* blas_l2 = new blas_dgemm< R, 1, R, T>;
-        blas_l2->compute_vv_outer(lambdas_, lambdas_, *coeff2_matrix);
-        delete blas_l2;
+        // ||X||^2 = lambda^T ( U1^T U1 .* U2^T U2 .* U3^T U3 ) lambda
+        m_r2_sym_type* cov_u1 = new m_r2_sym_type;
+        m_r2_sym_type* cov_u2 = new m_r2_sym_type;
+        m_r2_sym_type* cov_u3 = new m_r2_sym_type;
 
-        blas_dgemm< R, I1, R, T >* blas_u1cov = new blas_dgemm< R, I1, R, T>;
+        blas_dsyrk< R, I1, T >* blas_u1cov = new blas_dsyrk< R, I1, T>;
         blas_u1cov->compute_t(u1_, *cov_u1);
         delete blas_u1cov;
 
-        blas_dgemm< R, I2, R, T >* blas_u2cov = new blas_dgemm< R, I2, R, T>;
+        blas_dsyrk< R, I2, T >* blas_u2cov = new blas_dsyrk< R, I2, T>;
         blas_u2cov->compute_t(u2_, *cov_u2);
         delete blas_u2cov;
 
-        blas_dgemm< R, I3, R, T >* blas_u3cov = new blas_dgemm< R, I3, R, T>;
+        blas_dsyrk< R, I3, T >* blas_u3cov = new blas_dsyrk< R, I3, T>;
         blas_u3cov->compute_t(u3_, *cov_u3);
         delete blas_u3cov;
 
-        coeff2_matrix->multiply_piecewise(*cov_u1);
-        coeff2_matrix->multiply_piecewise(*cov_u2);
-        coeff2_matrix->multiply_piecewise(*cov_u3);
+        cov_u1->multiply_piecewise(*cov_u2);
+        cov_u1->multiply_piecewise(*cov_u3);
 
-        double nrm = coeff2_matrix->sum_elements();
+        double nrm = cov_u1->quadratic_form(lambdas_);
 
-        delete coeff2_matrix;
         delete cov_u1;
         delete cov_u2;
         delete cov_u3;
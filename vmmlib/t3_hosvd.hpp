@@ -47,7 +47,9 @@
 #include <vmmlib/tensor3.hpp>
 #include <vmmlib/lapack_svd.hpp>
 #include <vmmlib/lapack_sym_eigs.hpp>
+#include <vmmlib/lapack_solver_pool.hpp>
 #include <vmmlib/blas_dgemm.hpp>
+#include <vmmlib/blas_dsyrk.hpp>
 #include <vmmlib/blas_daxpy.hpp>
 
 enum hosvd_method {
@@ -76,6 +78,7 @@ namespace vmml
 		typedef matrix< I2, I1*I3, T > u2_unfolded_type;
 		typedef matrix< I3, I1*I2, T > u3_unfolded_type;
 		
+		// covariances are computed with syrk, dense since dsyevx needs a full matrix
 		typedef matrix< I1, I1, T > u1_cov_type;
 		typedef matrix< I2, I2, T > u2_cov_type;
 		typedef matrix< I3, I3, T > u3_cov_type;
@@ -252,13 +255,8 @@ VMML_TEMPLATE_CLASSNAME::eigs_mode1( const t3_type& data_, u1_type& u1_ )
 	
 	//covariance matrix of unfolded data
 	u1_cov_type* cov  = new u1_cov_type;
-#if 1
-	blas_dgemm< I1, I2*I3, I1, T>* blas_cov = new blas_dgemm< I1, I2*I3, I1, T>;
+	blas_dsyrk< I1, I2*I3, T>* blas_cov = new blas_dsyrk< I1, I2*I3, T>;
 	blas_cov->compute( *m_lateral, *cov );
-#else
-	blas_daxpy< I1, T>* blas_cov = new blas_daxpy< I1, T>;
-	blas_cov->compute_mmm( *m_lateral, *cov );
-#endif
 	delete blas_cov;
 	delete m_lateral;
 
@@ -278,13 +276,8 @@ VMML_TEMPLATE_CLASSNAME::eigs_mode2( const t3_type& data_, u2_type& u2_ )
 	
 	//covariance matrix of unfolded data
 	u2_cov_type* cov  = new u2_cov_type;
-#if 1
-	blas_dgemm< I2, I1*I3, I2, T>* blas_cov = new blas_dgemm< I2, I1*I3, I2, T>;
+	blas_dsyrk< I2, I1*I3, T>* blas_cov = new blas_dsyrk< I2, I1*I3, T>;
 	blas_cov->compute( *m_frontal, *cov );
-#else
-	blas_daxpy< I2, T>* blas_cov = new blas_daxpy< I2, T>;
-	blas_cov->compute_mmm( *m_frontal, *cov );
-#endif
 	
 	delete blas_cov;
 	delete m_frontal;
@@ -305,13 +298,8 @@ VMML_TEMPLATE_CLASSNAME::eigs_mode3( const t3_type& data_, u3_type& u3_)
 	
 	//covariance matrix of unfolded data
 	u3_cov_type* cov  = new u3_cov_type;
-#if 1
-	blas_dgemm< I3, I1*I2, I3, T>* blas_cov = new blas_dgemm< I3, I1*I2, I3, T>;
+	blas_dsyrk< I3, I1*I2, T>* blas_cov = new blas_dsyrk< I3, I1*I2, T>;
 	blas_cov->compute( *m_horizontal, *cov );
-#else
-	blas_daxpy< I3, T>* blas_cov = new blas_daxpy< I3, T>;
-	blas_cov->compute_mmm( *m_horizontal, *cov );
-#endif	
 	
 	delete blas_cov;
 	delete m_horizontal;
@@ -331,19 +319,20 @@ template< size_t N, size_t R >
 void 
 VMML_TEMPLATE_CLASSNAME::get_eigs_u_red( const matrix< N, N, T >& data_, matrix< N, R, T >& u_ )
 {
-	typedef matrix< N, N, T_svd > cov_matrix_type;
 	typedef vector< R, T_svd > eigval_type;
 	typedef	matrix< N, R, T_svd > eigvec_type;
+	typedef lapack_sym_eigs< N, T_svd > eigs_type;
 	//typedef	matrix< N, R, T_coeff > coeff_type;
 	
 	//compute x largest magnitude eigenvalues; x = R
 	eigval_type* eigxvalues =  new eigval_type;
 	eigvec_type* eigxvectors = new eigvec_type; 
 	
-	lapack_sym_eigs< N, T_svd >  eigs;
-	cov_matrix_type* data = new cov_matrix_type;
-	data->cast_from( data_ );
-	if( eigs.compute_x( *data, *eigxvectors, *eigxvalues) ) {
+	//reuse the solver (workspace and input scratch) of this thread
+	eigs_type& eigs = lapack_solver_pool< eigs_type >::get_local();
+	typename eigs_type::m_input_type& data = eigs.get_input_scratch();
+	data.cast_from( data_ );
+	if( eigs.compute_x_and_overwrite_input( data, *eigxvectors, *eigxvalues) ) {
 		
 		/*if( _is_quantify_coeff ){
 			coeff_type* evec_quant = new coeff_type; 
@@ -364,8 +353,6 @@ VMML_TEMPLATE_CLASSNAME::get_eigs_u_red( const matrix< N, N, T >& data_, matrix<
 	
 	delete eigxvalues;
 	delete eigxvectors;
-	delete data;
-	
 }
 
 VMML_TEMPLATE_STRING
@@ -373,43 +360,33 @@ template< size_t M, size_t N, size_t R >
 void 
 VMML_TEMPLATE_CLASSNAME::get_svd_u_red( const matrix< M, N, T >& data_, matrix< M, R, T >& u_ )
 {
-	typedef	matrix< M, N, T_svd > svd_m_type;
+	typedef lapack_svd< M, N, T_svd > svd_type;
 	//FIXME: typedef	matrix< M, N, T_coeff > coeff_type;
-	typedef	matrix< M, N, T > m_type;
-	typedef vector< N, T_svd > lambdas_type;
-	
-	svd_m_type* u_double = new svd_m_type; 
-	u_double->cast_from( data_ );
 	
-	//FIXME:: coeff_type* u_quant = new coeff_type; 
-	m_type* u_out = new m_type; 
+	//reuse the solver (workspace, input and sigma scratch) of this thread
+	svd_type& svd = lapack_solver_pool< svd_type >::get_local();
+	typename svd_type::m_input_type& u_double = svd.get_input_scratch();
+	u_double.cast_from( data_ );
 	
-	lambdas_type* lambdas  = new lambdas_type;
-	lapack_svd< M, N, T_svd >* svd = new lapack_svd<  M, N, T_svd >();
-	if( svd->compute_and_overwrite_input( *u_double, *lambdas )) {
+	if( svd.compute_and_overwrite_input( u_double, svd.get_sigma_scratch() )) {
 		
 		/*		if( _is_quantify_coeff ){
 		 T min_value = 0; T max_value = 0;
 		 u_comp->cast_from( *u_double );
 		 //FIXME: u_comp->quantize( *u_quant, min_value, max_value );
 		 //FIXME: u_quant->dequantize( *u_internal, min_value, max_value );
-		 } else */ if ( sizeof( T ) != 4 ){
-			 u_out->cast_from( *u_double );
-		 } else {
-			 *u_out = *u_double;
-		 }
-		
-		u_out->get_sub_matrix( u_ );
+		 } else */
+		for( size_t col = 0; col < R; ++col )
+		{
+			for( size_t row = 0; row < M; ++row )
+			{
+				u_( row, col ) = static_cast< T >( u_double( row, col ) );
+			}
+		}
 		
 	} else {
 		u_.zero();
 	}
-	
-	delete lambdas;
-	delete svd;
-	delete u_double;
-	//delete u_quant;
-	delete u_out;
 }	
 
 #undef VMML_TEMPLATE_STRING
@@ -204,11 +204,13 @@ namespace vmml {
         t3_core_tmp_type* t3_core_tmp = new t3_core_tmp_type;
         t3_core_tmp->zero();
         u1_tmp_type* u1_tmp = new u1_tmp_type;
-        u1_tmp_type* u1_tmp2 = new u1_tmp_type;
         u2_tmp_type* u2_tmp = new u2_tmp_type;
-        u2_tmp_type* u2_tmp2 = new u2_tmp_type;
         u3_tmp_type* u3_tmp = new u3_tmp_type;
-        u3_tmp_type* u3_tmp2 = new u3_tmp_type;
+
+        // reused for all blocks
+        pseudoinverse_solver< I1, R1 / NBLOCKS, T_coeff > compute_pinv1;
+        pseudoinverse_solver< I2, R2 / NBLOCKS, T_coeff > compute_pinv2;
+        pseudoinverse_solver< I3, R3 / NBLOCKS, T_coeff > compute_pinv3;
 
         t3_core_incr_type* t3_core_incr = new t3_core_incr_type;
         t3_core_incr->zero();
@@ -250,19 +252,13 @@ namespace vmml {
 
             // Compute the pseudoinverses
             u1_cp_tmp->get_sub_matrix(*u1_tmp, 0, 0);
-            compute_pseudoinverse< u1_tmp_type > compute_pinv1;
-            compute_pinv1(*u1_tmp, *u1_tmp2);
-            u1_tmp2->transpose_to(*u1_inv_tmp);
+            compute_pinv1.compute(*u1_tmp, *u1_inv_tmp);
 
             u2_cp_tmp->get_sub_matrix(*u2_tmp, 0, 0);
-            compute_pseudoinverse< u2_tmp_type > compute_pinv2;
-            compute_pinv2(*u2_tmp, *u2_tmp2);
-            u2_tmp2->transpose_to(*u2_inv_tmp);
+            compute_pinv2.compute(*u2_tmp, *u2_inv_tmp);
 
             u3_cp_tmp->get_sub_matrix(*u3_tmp, 0, 0);
-            compute_pseudoinverse< u3_tmp_type > compute_pinv3;
-            compute_pinv3(*u3_tmp, *u3_tmp2);
-            u3_tmp2->transpose_to(*u3_inv_tmp);
+            compute_pinv3.compute(*u3_tmp, *u3_inv_tmp);
             //            hooi_type::als(*residual_data, *u1_tmp, *u2_tmp, *u3_tmp, *t3_core_tmp, typename hooi_type::init_hosvd());
 
             // Project the initial data onto the pseudoinverses to get the core
@@ -0,0 +1,542 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* lossless (and near-lossless) predictive coding of integer volumes
+ *
+ * - 3D Lorenzo predictor, evaluated per brick so that every brick can be
+ *   decoded on its own (random access)
+ * - prediction residuals are zigzag mapped and bit-packed in groups of 32
+ * - bricks are encoded and decoded in parallel (OpenMP)
+ * - optional reference volume (e.g., a Tucker3 reconstruction): only the
+ *   difference to the reference is coded
+ * - optional error bound max_error_: every reconstructed voxel lies within
+ *   +/- max_error_ of the original (0 = lossless)
+ *
+ * reference:
+ * - Ibarria, Lindstrom, Rossignac, Szymczak, 2003: Out-of-core compression
+ *   and decompression of large n-dimensional scalar fields, Eurographics.
+ */
+
+#ifndef __VMML__T3_PREDICTIVE_CODEC__HPP__
+#define __VMML__T3_PREDICTIVE_CODEC__HPP__
+
+#include <vmmlib/tensor3.hpp>
+#include <vmmlib/exception.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+#ifdef VMMLIB_USE_OPENMP
+#  include <omp.h>
+#endif
+
+namespace vmml {
+
+    template< size_t I1, size_t I2, size_t I3, typename T = unsigned char >
+    class t3_predictive_codec
+    {
+    public:
+        typedef tensor3< I1, I2, I3, T > t3_t;
+        typedef std::vector< unsigned char > bytes_t;
+        typedef long long residual_t;
+        typedef unsigned long long code_t;
+
+        static const size_t GROUP_SIZE = 32;
+        static const size_t HEADER_SIZE = 64;
+
+        static void encode(const t3_t& data_, bytes_t& out_, size_t brick_size_ = 32, size_t max_error_ = 0);
+        static void decode(const bytes_t& in_, t3_t& data_);
+
+        //codes data_ - reference_, the same reference must be used for decoding
+        static void encode(const t3_t& data_, const t3_t& reference_, bytes_t& out_, size_t brick_size_ = 32, size_t max_error_ = 0);
+        static void decode(const bytes_t& in_, const t3_t& reference_, t3_t& data_);
+
+        //random access: decodes only the voxels of one brick into data_
+        static void decode_brick(const bytes_t& in_, size_t brick_, t3_t& data_);
+        static void decode_brick(const bytes_t& in_, size_t brick_, const t3_t& reference_, t3_t& data_);
+
+        static size_t get_number_of_bricks(size_t brick_size_);
+        static size_t get_brick_size(const bytes_t& in_);
+
+        static void write_to_file(const t3_t& data_, const std::string& dir_, const std::string& filename_, size_t brick_size_ = 32, size_t max_error_ = 0);
+        static void read_from_file(t3_t& data_, const std::string& dir_, const std::string& filename_);
+
+    protected:
+        struct brick_extent
+        {
+            size_t begin[3];
+            size_t end[3];
+        };
+
+        static void encode(const t3_t& data_, const t3_t* reference_, bytes_t& out_, size_t brick_size_, size_t max_error_);
+        static void decode(const bytes_t& in_, const t3_t* reference_, t3_t& data_, long brick_);
+
+        static void get_brick_extent(size_t brick_, size_t brick_size_, brick_extent& extent_);
+        static void encode_brick(const t3_t& data_, const t3_t* reference_, const brick_extent& extent_, size_t max_error_, bytes_t& out_);
+        static void decode_brick(const unsigned char* in_, size_t len_, const t3_t* reference_, const brick_extent& extent_, size_t max_error_, t3_t& data_);
+
+        static void read_header(const bytes_t& in_, size_t& brick_size_, size_t& max_error_, size_t& n_bricks_);
+        static void put_u64(unsigned char* out_, code_t value_);
+        static code_t get_u64(const unsigned char* in_);
+        static void concat_path(const std::string& dir_, const std::string& filename_, std::string& path_);
+
+    }; //end t3_predictive_codec
+
+
+
+#define VMML_TEMPLATE_STRING        template< size_t I1, size_t I2, size_t I3, typename T >
+#define VMML_TEMPLATE_CLASSNAME     t3_predictive_codec< I1, I2, I3, T >
+
+    VMML_TEMPLATE_STRING
+    size_t
+    VMML_TEMPLATE_CLASSNAME::get_number_of_bricks(size_t brick_size_) {
+        if (brick_size_ == 0)
+            VMMLIB_ERROR("brick size must be larger than zero", VMMLIB_HERE);
+        return ((I1 + brick_size_ - 1) / brick_size_)
+                * ((I2 + brick_size_ - 1) / brick_size_)
+                * ((I3 + brick_size_ - 1) / brick_size_);
+    }
+
+    VMML_TEMPLATE_STRING
+    size_t
+    VMML_TEMPLATE_CLASSNAME::get_brick_size(const bytes_t& in_) {
+        size_t brick_size, max_error, n_bricks;
+        read_header(in_, brick_size, max_error, n_bricks);
+        return brick_size;
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::get_brick_extent(size_t brick_, size_t brick_size_, brick_extent& extent_) {
+        const size_t dims[3] = { I1, I2, I3 };
+        const size_t n1 = (I1 + brick_size_ - 1) / brick_size_;
+        const size_t n2 = (I2 + brick_size_ - 1) / brick_size_;
+        const size_t index[3] = { brick_ % n1, (brick_ / n1) % n2, brick_ / (n1 * n2) };
+
+        for (size_t mode = 0; mode < 3; ++mode) {
+            extent_.begin[mode] = index[mode] * brick_size_;
+            extent_.end[mode] = (std::min)(extent_.begin[mode] + brick_size_, dims[mode]);
+        }
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::put_u64(unsigned char* out_, code_t value_) {
+        for (size_t byte = 0; byte < 8; ++byte) {
+            out_[byte] = (unsigned char) ((value_ >> (8 * byte)) & 0xff);
+        }
+    }
+
+    VMML_TEMPLATE_STRING
+    typename VMML_TEMPLATE_CLASSNAME::code_t
+    VMML_TEMPLATE_CLASSNAME::get_u64(const unsigned char* in_) {
+        code_t value = 0;
+        for (size_t byte = 0; byte < 8; ++byte) {
+            value |= code_t(in_[byte]) << (8 * byte);
+        }
+        return value;
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::encode(const t3_t& data_, bytes_t& out_, size_t brick_size_, size_t max_error_) {
+        encode(data_, 0, out_, brick_size_, max_error_);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::encode(const t3_t& data_, const t3_t& reference_, bytes_t& out_, size_t brick_size_, size_t max_error_) {
+        encode(data_, &reference_, out_, brick_size_, max_error_);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::decode(const bytes_t& in_, t3_t& data_) {
+        decode(in_, 0, data_, -1);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::decode(const bytes_t& in_, const t3_t& reference_, t3_t& data_) {
+        decode(in_, &reference_, data_, -1);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::decode_brick(const bytes_t& in_, size_t brick_, t3_t& data_) {
+        decode(in_, 0, data_, long(brick_));
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::decode_brick(const bytes_t& in_, size_t brick_, const t3_t& reference_, t3_t& data_) {
+        decode(in_, &reference_, data_, long(brick_));
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::encode(const t3_t& data_, const t3_t* reference_, bytes_t& out_, size_t brick_size_, size_t max_error_) {
+        if (!std::numeric_limits< T >::is_integer || sizeof (T) > 4)
+            VMMLIB_ERROR("predictive coding supports integer voxels of up to 32 bits", VMMLIB_HERE);
+
+        const size_t n_bricks = get_number_of_bricks(brick_size_);
+        std::vector< bytes_t > bricks(n_bricks);
+
+#pragma omp parallel for schedule(dynamic)
+        for (long brick = 0; brick < long(n_bricks); ++brick) {
+            brick_extent extent;
+            get_brick_extent(brick, brick_size_, extent);
+            encode_brick(data_, reference_, extent, max_error_, bricks[brick]);
+        }
+
+        //header, brick offsets (relative to the end of the offset table), brick data
+        size_t len_table = 8 * (n_bricks + 1);
+        size_t len_data = 0;
+        for (size_t brick = 0; brick < n_bricks; ++brick) {
+            len_data += bricks[brick].size();
+        }
+        out_.assign(HEADER_SIZE + len_table + len_data, 0);
+
+        unsigned char* header = &out_[0];
+        memcpy(header, "VT3P", 4);
+        header[4] = 1; //version
+        header[5] = (unsigned char) sizeof (T);
+        header[6] = std::numeric_limits< T >::is_signed ? 1 : 0;
+        header[7] = reference_ ? 1 : 0;
+        put_u64(header + 8, I1);
+        put_u64(header + 16, I2);
+        put_u64(header + 24, I3);
+        put_u64(header + 32, brick_size_);
+        put_u64(header + 40, max_error_);
+        put_u64(header + 48, n_bricks);
+
+        unsigned char* table = header + HEADER_SIZE;
+        unsigned char* data = table + len_table;
+        size_t offset = 0;
+        for (size_t brick = 0; brick < n_bricks; ++brick) {
+            put_u64(table + 8 * brick, offset);
+            if (!bricks[brick].empty())
+                memcpy(data + offset, &bricks[brick][0], bricks[brick].size());
+            offset += bricks[brick].size();
+        }
+        put_u64(table + 8 * n_bricks, offset);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::read_header(const bytes_t& in_, size_t& brick_size_, size_t& max_error_, size_t& n_bricks_) {
+        if (in_.size() < HEADER_SIZE || memcmp(&in_[0], "VT3P", 4) != 0 || in_[4] != 1)
+            VMMLIB_ERROR("input is not a predictively coded tensor3", VMMLIB_HERE);
+
+        const unsigned char* header = &in_[0];
+        if (header[5] != sizeof (T) || header[6] != (std::numeric_limits< T >::is_signed ? 1 : 0))
+            VMMLIB_ERROR("voxel type of the coded data does not match", VMMLIB_HERE);
+        if (get_u64(header + 8) != I1 || get_u64(header + 16) != I2 || get_u64(header + 24) != I3)
+            VMMLIB_ERROR("dimensions of the coded data do not match", VMMLIB_HERE);
+
+        brick_size_ = size_t(get_u64(header + 32));
+        max_error_ = size_t(get_u64(header + 40));
+        n_bricks_ = size_t(get_u64(header + 48));
+        if (n_bricks_ != get_number_of_bricks(brick_size_)
+                || in_.size() < HEADER_SIZE + 8 * (n_bricks_ + 1))
+            VMMLIB_ERROR("corrupt brick table", VMMLIB_HERE);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::decode(const bytes_t& in_, const t3_t* reference_, t3_t& data_, long brick_) {
+        size_t brick_size, max_error, n_bricks;
+        read_header(in_, brick_size, max_error, n_bricks);
+        if ((in_[7] == 1) != (reference_ != 0))
+            VMMLIB_ERROR("data was coded with a different reference setting", VMMLIB_HERE);
+
+        const unsigned char* table = &in_[0] + HEADER_SIZE;
+        const unsigned char* data = table + 8 * (n_bricks + 1);
+        const size_t len_data = in_.size() - HEADER_SIZE - 8 * (n_bricks + 1);
+        if (get_u64(table + 8 * n_bricks) > len_data)
+            VMMLIB_ERROR("coded data is truncated", VMMLIB_HERE);
+        //every brick must lie inside the payload: 0 <= begin <= end <= len_data
+        for (size_t brick = 0; brick < n_bricks; ++brick) {
+            if (get_u64(table + 8 * brick) > get_u64(table + 8 * (brick + 1)))
+                VMMLIB_ERROR("corrupt brick table", VMMLIB_HERE);
+        }
+
+        long first = 0;
+        long last = long(n_bricks);
+        if (brick_ >= 0) {
+            if (brick_ >= long(n_bricks))
+                VMMLIB_ERROR("brick index out of bounds", VMMLIB_HERE);
+            first = brick_;
+            last = brick_ + 1;
+        }
+
+        //exceptions must not leave the parallel region
+        bool corrupt = false;
+#pragma omp parallel for schedule(dynamic)
+        for (long brick = first; brick < last; ++brick) {
+            const size_t begin = size_t(get_u64(table + 8 * brick));
+            const size_t end = size_t(get_u64(table + 8 * (brick + 1)));
+            brick_extent extent;
+            get_brick_extent(brick, brick_size, extent);
+            try {
+                decode_brick(data + begin, end - begin, reference_, extent, max_error, data_);
+            } catch (...) {
+#pragma omp critical(vmmlib_predictive_codec)
+                corrupt = true;
+            }
+        }
+        if (corrupt)
+            VMMLIB_ERROR("coded brick is corrupt", VMMLIB_HERE);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::encode_brick(const t3_t& data_, const t3_t* reference_, const brick_extent& extent_, size_t max_error_, bytes_t& out_) {
+        const size_t b1 = extent_.end[0] - extent_.begin[0];
+        const size_t b2 = extent_.end[1] - extent_.begin[1];
+        const size_t b3 = extent_.end[2] - extent_.begin[2];
+        const residual_t step = residual_t(2 * max_error_ + 1);
+
+        //reconstructed values (closed loop, so that the decoder sees the same predictions)
+        std::vector< residual_t > recon(b1 * b2 * b3);
+        std::vector< code_t > codes(b1 * b2 * b3);
+
+        size_t index = 0;
+        for (size_t k3 = 0; k3 < b3; ++k3) {
+            for (size_t k2 = 0; k2 < b2; ++k2) {
+                for (size_t k1 = 0; k1 < b1; ++k1, ++index) {
+                    const size_t i1 = extent_.begin[0] + k1;
+                    const size_t i2 = extent_.begin[1] + k2;
+                    const size_t i3 = extent_.begin[2] + k3;
+
+                    residual_t value = residual_t(data_.at(i1, i2, i3));
+                    if (reference_)
+                        value -= residual_t(reference_->at(i1, i2, i3));
+
+                    //lorenzo predictor, voxels outside the brick count as zero
+                    const residual_t* r = &recon[index];
+                    const size_t s2 = b1;
+                    const size_t s3 = b1 * b2;
+                    residual_t prediction = 0;
+                    if (k1) prediction += r[-1];
+                    if (k2) prediction += r[-long(s2)];
+                    if (k3) prediction += r[-long(s3)];
+                    if (k1 && k2) prediction -= r[-long(s2) - 1];
+                    if (k1 && k3) prediction -= r[-long(s3) - 1];
+                    if (k2 && k3) prediction -= r[-long(s3) - long(s2)];
+                    if (k1 && k2 && k3) prediction += r[-long(s3) - long(s2) - 1];
+
+                    residual_t residual = value - prediction;
+                    if (step > 1) {
+                        residual = (residual >= 0) ? (residual + residual_t(max_error_)) / step
+                                : -((-residual + residual_t(max_error_)) / step);
+                    }
+                    recon[index] = prediction + residual * step;
+
+                    //zigzag mapping: small magnitudes -> small codes
+                    codes[index] = (code_t(residual) << 1) ^ code_t(residual >> 63);
+                }
+            }
+        }
+
+        //bit-pack groups of GROUP_SIZE codes with the bit width of the largest code
+        out_.clear();
+        out_.reserve(codes.size() / 2 + 16);
+        for (size_t group = 0; group < codes.size(); group += GROUP_SIZE) {
+            const size_t group_end = (std::min)(group + GROUP_SIZE, codes.size());
+            code_t max_code = 0;
+            for (size_t i = group; i < group_end; ++i) {
+                max_code |= codes[i];
+            }
+            unsigned char width = 0;
+            while (width < 64 && (max_code >> width) != 0) {
+                ++width;
+            }
+            out_.push_back(width);
+
+            code_t buffer = 0;
+            size_t buffered = 0;
+            for (size_t i = group; i < group_end && width > 0; ++i) {
+                size_t remaining = width;
+                code_t code = codes[i];
+                while (remaining > 0) {
+                    const size_t chunk = (std::min)(remaining, size_t(32));
+                    buffer |= (code & ((code_t(1) << chunk) - 1)) << buffered;
+                    buffered += chunk;
+                    code >>= chunk;
+                    remaining -= chunk;
+                    while (buffered >= 8) {
+                        out_.push_back((unsigned char) (buffer & 0xff));
+                        buffer >>= 8;
+                        buffered -= 8;
+                    }
+                }
+            }
+            if (buffered > 0)
+                out_.push_back((unsigned char) (buffer & 0xff));
+        }
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::decode_brick(const unsigned char* in_, size_t len_, const t3_t* reference_, const brick_extent& extent_, size_t max_error_, t3_t& data_) {
+        const size_t b1 = extent_.end[0] - extent_.begin[0];
+        const size_t b2 = extent_.end[1] - extent_.begin[1];
+        const size_t b3 = extent_.end[2] - extent_.begin[2];
+        const size_t n_values = b1 * b2 * b3;
+        const residual_t step = residual_t(2 * max_error_ + 1);
+        const residual_t min_value = residual_t((std::numeric_limits< T >::min)());
+        const residual_t max_value = residual_t((std::numeric_limits< T >::max)());
+
+        //unpack the residual codes
+        std::vector< code_t > codes(n_values);
+        size_t pos = 0;
+        for (size_t group = 0; group < n_values; group += GROUP_SIZE) {
+            const size_t group_end = (std::min)(group + GROUP_SIZE, n_values);
+            if (pos >= len_)
+                VMMLIB_ERROR("coded brick is truncated", VMMLIB_HERE);
+            const size_t width = in_[pos++];
+            if (width > 64 || pos + (width * (group_end - group) + 7) / 8 > len_)
+                VMMLIB_ERROR("coded brick is corrupt", VMMLIB_HERE);
+
+            code_t buffer = 0;
+            size_t buffered = 0;
+            for (size_t i = group; i < group_end; ++i) {
+                code_t code = 0;
+                size_t decoded = 0;
+                while (decoded < width) {
+                    const size_t chunk = (std::min)(width - decoded, size_t(32));
+                    while (buffered < chunk) {
+                        buffer |= code_t(in_[pos++]) << buffered;
+                        buffered += 8;
+                    }
+                    code |= (buffer & ((code_t(1) << chunk) - 1)) << decoded;
+                    buffer >>= chunk;
+                    buffered -= chunk;
+                    decoded += chunk;
+                }
+                codes[i] = code;
+            }
+        }
+
+        std::vector< residual_t > recon(n_values);
+        size_t index = 0;
+        for (size_t k3 = 0; k3 < b3; ++k3) {
+            for (size_t k2 = 0; k2 < b2; ++k2) {
+                for (size_t k1 = 0; k1 < b1; ++k1, ++index) {
+                    const residual_t* r = &recon[index];
+                    const size_t s2 = b1;
+                    const size_t s3 = b1 * b2;
+                    residual_t prediction = 0;
+                    if (k1) prediction += r[-1];
+                    if (k2) prediction += r[-long(s2)];
+                    if (k3) prediction += r[-long(s3)];
+                    if (k1 && k2) prediction -= r[-long(s2) - 1];
+                    if (k1 && k3) prediction -= r[-long(s3) - 1];
+                    if (k2 && k3) prediction -= r[-long(s3) - long(s2)];
+                    if (k1 && k2 && k3) prediction += r[-long(s3) - long(s2) - 1];
+
+                    const code_t code = codes[index];
+                    const residual_t residual = residual_t(code >> 1) ^ -residual_t(code & 1);
+                    recon[index] = prediction + residual * step;
+
+                    const size_t i1 = extent_.begin[0] + k1;
+                    const size_t i2 = extent_.begin[1] + k2;
+                    const size_t i3 = extent_.begin[2] + k3;
+                    residual_t value = recon[index];
+                    if (reference_)
+                        value += residual_t(reference_->at(i1, i2, i3));
+                    data_.at(i1, i2, i3) = T((std::min)((std::max)(value, min_value), max_value));
+                }
+            }
+        }
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::concat_path(const std::string& dir_, const std::string& filename_, std::string& path_) {
+        int dir_length = dir_.size() - 1;
+        int last_separator = dir_.find_last_of("/");
+        path_ = dir_;
+        if (last_separator < dir_length) {
+            path_.append("/");
+        }
+        path_.append(filename_);
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::write_to_file(const t3_t& data_, const std::string& dir_, const std::string& filename_, size_t brick_size_, size_t max_error_) {
+        std::string path;
+        concat_path(dir_, filename_, path);
+
+        bytes_t coded;
+        encode(data_, coded, brick_size_, max_error_);
+
+        std::ofstream outfile;
+        outfile.open(path.c_str(), std::ios::out | std::ios::binary);
+        if (outfile.is_open()) {
+            outfile.write((const char*) &coded[0], coded.size());
+            outfile.close();
+        } else {
+            std::cout << "no file open" << std::endl;
+        }
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::read_from_file(t3_t& data_, const std::string& dir_, const std::string& filename_) {
+        std::string path;
+        concat_path(dir_, filename_, path);
+
+        std::ifstream infile;
+        infile.open(path.c_str(), std::ios::in | std::ios::binary);
+        if (infile.is_open()) {
+            infile.seekg(0, std::ios::end);
+            bytes_t coded(size_t(infile.tellg()));
+            infile.seekg(0, std::ios::beg);
+            if (!coded.empty())
+                infile.read((char*) &coded[0], coded.size());
+            infile.close();
+            decode(coded, data_);
+        } else {
+            std::cout << "no file open" << std::endl;
+        }
+    }
+
+#undef VMML_TEMPLATE_STRING
+#undef VMML_TEMPLATE_CLASSNAME
+
+}//end vmml namespace
+
+#endif
@@ -353,6 +353,9 @@ VMML_TEMPLATE_CLASSNAME::multiply_horizontal_bwd( const tensor3< J1, J2, J3, T_b
 	typedef matrix< I3, J2, T_blas > slice_new_t;
 	typedef blas_dgemm< I3, J3, J2, T_blas > blas_t;
     
+#ifdef VMMLIB_USE_OPENMP
+	blas::serial_region single_threaded_blas;
+#endif
 #pragma omp parallel for
 	for ( int i1 = 0; i1 < (int)J1; ++i1 )
 	{
@@ -383,6 +386,9 @@ VMML_TEMPLATE_CLASSNAME::multiply_lateral_bwd( const tensor3< J1, J2, J3, T_blas
 	typedef matrix< I1, J3, T_blas > slice_new_t;
 	typedef blas_dgemm< I1, J1, J3, T_blas > blas_t;
 	
+#ifdef VMMLIB_USE_OPENMP
+	blas::serial_region single_threaded_blas;
+#endif
 #pragma omp parallel for
 	for ( int i2 = 0; i2 < (int)J2; ++i2 )
 	{
@@ -414,6 +420,9 @@ VMML_TEMPLATE_CLASSNAME::multiply_frontal_bwd( const tensor3< J1, J2, J3, T_blas
 	typedef matrix< I2, J1, T_blas > slice_new_t;
 	typedef blas_dgemm< I2, J2, J1, T_blas > blas_t;
 		
+#ifdef VMMLIB_USE_OPENMP
+	blas::serial_region single_threaded_blas;
+#endif
 #pragma omp parallel for
 	for ( int i3 = 0; i3 < (int)J3; ++i3 )
 	{
@@ -447,6 +456,9 @@ VMML_TEMPLATE_CLASSNAME::multiply_horizontal_fwd( const tensor3< J1, J2, J3, T_b
 	typedef matrix< I2, J3, T_blas > slice_new_t;
 	typedef blas_dgemm< I2, J2, J3, T_blas > blas_t;
 	
+#ifdef VMMLIB_USE_OPENMP
+	blas::serial_region single_threaded_blas;
+#endif
 #pragma omp parallel for
 	for ( int i1 = 0; i1 < (int)J1; ++i1 )
 	{
@@ -477,6 +489,9 @@ VMML_TEMPLATE_CLASSNAME::multiply_lateral_fwd( const tensor3< J1, J2, J3, T_blas
 	typedef matrix< I3, J1, T_blas > slice_new_t;
 	typedef blas_dgemm< I3, J3, J1, T_blas > blas_t;
 	
+#ifdef VMMLIB_USE_OPENMP
+	blas::serial_region single_threaded_blas;
+#endif
 #pragma omp parallel for
 	for ( int i2 = 0; i2 < (int)J2; ++i2 )
 	{
@@ -509,6 +524,9 @@ VMML_TEMPLATE_CLASSNAME::multiply_frontal_fwd( const tensor3< J1, J2, J3, T_blas
 	
 	typedef blas_dgemm< I1, J1, J2, T_blas > blas_t;
 	
+#ifdef VMMLIB_USE_OPENMP
+	blas::serial_region single_threaded_blas;
+#endif
 #pragma omp parallel for
 	for ( int i3 = 0; i3 < (int)J3; ++i3 )
 	{
@@ -41,6 +41,7 @@
 #define __VMML__T4_CONVERTER__HPP__
 
 #include "tensor4.hpp"
+#include <vmmlib/csv_formatter.hpp>
 
 namespace vmml
 {
@@ -61,7 +62,8 @@ namespace vmml
 		static void read_from_raw( t4_t& data_, const std::string& dir_, const std::string& filename_ ) ; //TODO: DK done
 
 		static void write_datfile( const std::string& dir_, const std::string& filename_ );
-		static void write_to_csv( const t4_t& data_, const std::string& dir_, const std::string& filename_ ); //TODO: DK done
+		static void write_to_csv( const t4_t& data_, const std::string& dir_, const std::string& filename_, int precision_ = 0 ); //TODO: DK done
+		static void read_from_csv( t4_t& data_, const std::string& dir_, const std::string& filename_ );
 
 
 	protected:
@@ -99,39 +101,26 @@ namespace vmml
 
 	VMML_TEMPLATE_STRING
 	void
-	VMML_TEMPLATE_CLASSNAME::write_to_csv( const t4_t& data_, const std::string& dir_, const std::string& filename_ )
+	VMML_TEMPLATE_CLASSNAME::write_to_csv( const t4_t& data_, const std::string& dir_, const std::string& filename_, int precision_ )
 	{
 		std::string path_raw;
 		concat_path(dir_, filename_, path_raw);
 		path_raw.replace(path_raw.size() - 3, 3, "csv");
 
-		std::ofstream outfile(path_raw.c_str());
-		if(outfile.is_open())
-		{
-			for( size_t i4 = 0; i4 < data_.T3S; ++i4 )
-			{
-				for( size_t i3 = 0; i3 < data_.SLICES; ++i3 )
-				{
-					for( size_t i1 = 0; i1 < data_.ROWS; ++i1 )
-					{
-						for( size_t i2 = 0; i2 < data_.COLS; ++i2 )
-						{
-							outfile << data_(i1,i2,i3,i4) << ", ";
-						}
-						outfile.seekp( -2, std::ios_base::cur); // remove superfluous comma signs
-						outfile << std::endl;
-					}
-					outfile << std::endl;
-				}
-				outfile << std::endl;
-			}
+		//rows of the frontal slices, empty line after each slice and each tensor3
+		csv_formatter::write( path_raw, data_.get_array_ptr(), I1, I2, I3 * I4, I3, precision_ );
+	}
 
-			outfile.close();
-		}else {
-			outfile.close();
-			std::cout << "no file open" << std::endl;
-		}
 
+	VMML_TEMPLATE_STRING
+	void
+	VMML_TEMPLATE_CLASSNAME::read_from_csv( t4_t& data_, const std::string& dir_, const std::string& filename_ )
+	{
+		std::string path_raw;
+		concat_path(dir_, filename_, path_raw);
+		path_raw.replace(path_raw.size() - 3, 3, "csv");
+
+		csv_formatter::read( path_raw, data_.get_array_ptr(), I1, I2, I3 * I4 );
 	}
 
 
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2006-2014, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __VMML__T4_DCT__HPP__
+#define __VMML__T4_DCT__HPP__
+
+#include <vmmlib/tensor4.hpp>
+#include <vmmlib/t3_dct.hpp>
+
+/*
+ * orthonormal DCT-II (forward) and DCT-III (inverse) along the modes of a
+ * tensor4, in place. see t3_dct.hpp.
+ */
+
+namespace vmml
+{
+
+class t4_dct : public t3_dct
+{
+public:
+    template< size_t I1, size_t I2, size_t I3, size_t I4, typename T >
+    static void forward( tensor4< I1, I2, I3, I4, T >& t4_, size_t mode_ );
+
+    template< size_t I1, size_t I2, size_t I3, size_t I4, typename T >
+    static void inverse( tensor4< I1, I2, I3, I4, T >& t4_, size_t mode_ );
+
+    // all four modes
+    template< size_t I1, size_t I2, size_t I3, size_t I4, typename T >
+    static void forward( tensor4< I1, I2, I3, I4, T >& t4_ );
+
+    template< size_t I1, size_t I2, size_t I3, size_t I4, typename T >
+    static void inverse( tensor4< I1, I2, I3, I4, T >& t4_ );
+
+protected:
+    template< size_t I1, size_t I2, size_t I3, size_t I4, typename T >
+    static void _transform( tensor4< I1, I2, I3, I4, T >& t4_, size_t mode_, bool inverse_ );
+
+}; // class t4_dct
+
+
+
+template< size_t I1, size_t I2, size_t I3, size_t I4, typename T >
+void
+t4_dct::_transform( tensor4< I1, I2, I3, I4, T >& t4_, size_t mode_, bool inverse_ )
+{
+    // element ( i1, i2, i3, i4 ) is at ( ( i4 * I3 + i3 ) * I2 + i2 ) * I1 + i1
+    T* data = t4_.get_array_ptr();
+    switch( mode_ )
+    {
+        case 1:
+        {
+            dct< I1, T > dct1;
+            _apply( dct1, inverse_, data, I2 * I3 * I4, 1, I1 );
+            break;
+        }
+        case 2:
+        {
+            dct< I2, T > dct2;
+            for( size_t slice = 0; slice < I3 * I4; ++slice )
+                _apply( dct2, inverse_, data + slice * I1 * I2, I1, I1, 1 );
+            break;
+        }
+        case 3:
+        {
+            dct< I3, T > dct3;
+            for( size_t i4 = 0; i4 < I4; ++i4 )
+                _apply( dct3, inverse_, data + i4 * I1 * I2 * I3, I1 * I2, I1 * I2, 1 );
+            break;
+        }
+        case 4:
+        {
+            dct< I4, T > dct4;
+            _apply( dct4, inverse_, data, I1 * I2 * I3, I1 * I2 * I3, 1 );
+            break;
+        }
+        default:
+            VMMLIB_ERROR( "t4_dct - mode must be 1, 2, 3 or 4", VMMLIB_HERE );
+    }
+}
+
+
+
+template< size_t I1, size_t I2, size_t I3, size_t I4, typename T >
+void
+t4_dct::forward( tensor4< I1, I2, I3, I4, T >& t4_, size_t mode_ )
+{
+    _transform( t4_, mode_, false );
+}
+
+
+
+template< size_t I1, size_t I2, size_t I3, size_t I4, typename T >
+void
+t4_dct::inverse( tensor4< I1, I2, I3, I4, T >& t4_, size_t mode_ )
+{
+    _transform( t4_, mode_, true );
+}
+
+
+
+template< size_t I1, size_t I2, size_t I3, size_t I4, typename T >
+void
+t4_dct::forward( tensor4< I1, I2, I3, I4, T >& t4_ )
+{
+    for( size_t mode = 1; mode <= 4; ++mode )
+        _transform( t4_, mode, false );
+}
+
+
+
+template< size_t I1, size_t I2, size_t I3, size_t I4, typename T >
+void
+t4_dct::inverse( tensor4< I1, I2, I3, I4, T >& t4_ )
+{
+    for( size_t mode = 1; mode <= 4; ++mode )
+        _transform( t4_, mode, true );
+}
+
+
+} // namespace vmml
+
+#endif
@@ -79,16 +79,22 @@ namespace vmml {
 
         struct init_random {
 
+            // seeded with the time by default, pass a seed for reproducible results
+            init_random() : seed(time(NULL)) {}
+            explicit init_random(random_generator::counter_type seed_) : seed(seed_) {}
+
             inline void operator()(const t4_type&, u2_type& u2_, u3_type & u3_, u4_type & u4_) {
-                srand(time(NULL));
-                u2_.set_random();
-                u3_.set_random();
-                u4_.set_random();
+                random_generator rng(seed);
+                u2_.set_random(rng);
+                u3_.set_random(rng);
+                u4_.set_random(rng);
 
                 u2_ /= u2_.frobenius_norm();
                 u3_ /= u3_.frobenius_norm();
                 u4_ /= u4_.frobenius_norm();
             }
+
+            random_generator::counter_type seed;
         };
 
     protected:
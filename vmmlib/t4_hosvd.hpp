@@ -36,7 +36,9 @@
 #include <vmmlib/tensor4.hpp>
 #include <vmmlib/lapack_svd.hpp>
 #include <vmmlib/lapack_sym_eigs.hpp>
+#include <vmmlib/lapack_solver_pool.hpp>
 #include <vmmlib/blas_dgemm.hpp>
+#include <vmmlib/blas_dsyrk.hpp>
 #include <vmmlib/blas_daxpy.hpp>
 
 namespace vmml
@@ -59,6 +61,7 @@ namespace vmml
 		typedef matrix< I3, I1*I2*I4, T > u3_unfolded_type;
         typedef matrix< I4, I1*I2*I3, T > u4_unfolded_type;
 		
+		// covariances are computed with syrk, dense since dsyevx needs a full matrix
 		typedef matrix< I1, I1, T > u1_cov_type;
 		typedef matrix< I2, I2, T > u2_cov_type;
 		typedef matrix< I3, I3, T > u3_cov_type;
@@ -125,7 +128,7 @@ VMML_TEMPLATE_CLASSNAME::eigs_mode1( const t4_type& data_, u1_type& u1_ )
 	
 	//covariance matrix of unfolded data
 	u1_cov_type* cov  = new u1_cov_type;
-	blas_dgemm< I1, I2*I3*I4, I1, T>* blas_cov = new blas_dgemm< I1, I2*I3*I4, I1, T>;
+	blas_dsyrk< I1, I2*I3*I4, T>* blas_cov = new blas_dsyrk< I1, I2*I3*I4, T>;
 	blas_cov->compute( *unfolding, *cov );
 	delete blas_cov;
 	delete unfolding;
@@ -146,7 +149,7 @@ VMML_TEMPLATE_CLASSNAME::eigs_mode2( const t4_type& data_, u2_type& u2_ )
     
 	//covariance matrix of unfolded data
 	u2_cov_type* cov  = new u2_cov_type;
-	blas_dgemm< I2, I1*I3*I4, I2, T>* blas_cov = new blas_dgemm< I2, I1*I3*I4, I2, T>;
+	blas_dsyrk< I2, I1*I3*I4, T>* blas_cov = new blas_dsyrk< I2, I1*I3*I4, T>;
 	blas_cov->compute( *unfolding, *cov );
 	delete blas_cov;
 	delete unfolding;
@@ -167,7 +170,7 @@ VMML_TEMPLATE_CLASSNAME::eigs_mode3( const t4_type& data_, u3_type& u3_)
 
 	//covariance matrix of unfolded data
 	u3_cov_type* cov  = new u3_cov_type;
-	blas_dgemm< I3, I1*I2*I4, I3, T>* blas_cov = new blas_dgemm< I3, I1*I2*I4, I3, T>;
+	blas_dsyrk< I3, I1*I2*I4, T>* blas_cov = new blas_dsyrk< I3, I1*I2*I4, T>;
 	blas_cov->compute( *unfolding, *cov );
 	delete blas_cov;
 	delete unfolding;
@@ -188,7 +191,7 @@ VMML_TEMPLATE_CLASSNAME::eigs_mode4( const t4_type& data_, u4_type& u4_)
 
 	//covariance matrix of unfolded data
 	u4_cov_type* cov  = new u4_cov_type;
-	blas_dgemm< I4, I1*I2*I3, I4, T>* blas_cov = new blas_dgemm< I4, I1*I2*I3, I4, T>;
+	blas_dsyrk< I4, I1*I2*I3, T>* blas_cov = new blas_dsyrk< I4, I1*I2*I3, T>;
 	blas_cov->compute( *unfolding, *cov );
 	delete blas_cov;
 	delete unfolding;
@@ -215,10 +218,12 @@ VMML_TEMPLATE_CLASSNAME::get_eigs_u_red( const matrix< N, N, T >& data_, matrix<
 	eigval_type* eigxvalues =  new eigval_type;
 	eigvec_type* eigxvectors = new eigvec_type; 
 	
-	lapack_sym_eigs< N, T >  eigs;
-	cov_matrix_type* data = new cov_matrix_type;
-	data->cast_from( data_ );
-	if( !eigs.compute_x( *data, *eigxvectors, *eigxvalues) ) {
+	//reuse the solver (workspace and input scratch) of this thread
+	typedef lapack_sym_eigs< N, T > eigs_type;
+	eigs_type& eigs = lapack_solver_pool< eigs_type >::get_local();
+	cov_matrix_type& data = eigs.get_input_scratch();
+	data.cast_from( data_ );
+	if( !eigs.compute_x_and_overwrite_input( data, *eigxvectors, *eigxvalues) ) {
 		
 		/*if( _is_quantify_coeff ){
 			coeff_type* evec_quant = new coeff_type; 
@@ -234,7 +239,6 @@ VMML_TEMPLATE_CLASSNAME::get_eigs_u_red( const matrix< N, N, T >& data_, matrix<
 	
 	delete eigxvalues;
 	delete eigxvectors;
-	delete data;	
 }
 
 #undef VMML_TEMPLATE_STRING
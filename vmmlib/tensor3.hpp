@@ -44,6 +44,8 @@
 #include <vmmlib/tensor3_iterator.hpp>
 #include <vmmlib/enable_if.hpp>
 #include <vmmlib/blas_dot.hpp>
+#include <vmmlib/dot_kernels.hpp>
+#include <vmmlib/random.hpp>
 #include <fcntl.h>
 #include <limits>
 #ifdef VMMLIB_USE_OPENMP
@@ -212,6 +214,9 @@ namespace vmml {
         //otherwise srand( seed ) will be called with the given seed
         void fill_random(int seed = -1);
         void fill_random_signed(int seed = -1);
+        //same ranges, from the given generator (parallel and reproducible)
+        void fill_random(random_generator& rng_);
+        void fill_random_signed(random_generator& rng_);
         void fill_increasing_values();
         void fill_rand_sym_slices(int seed = -1);
         void fill_rand_sym(int seed = -1);
@@ -312,6 +317,9 @@ namespace vmml {
                 const vmml::matrix< I2, R, TT >& V,
                 const vmml::matrix< I3, R, TT >& W) const;
 
+        // inner product of the two tensors seen as vectors
+        double dot(const tensor3< I1, I2, I3, T >& other) const;
+
         //error computation
         double frobenius_norm() const;
         double frobenius_norm(const tensor3< I1, I2, I3, T >& other) const;
@@ -888,6 +896,21 @@ namespace vmml {
         }
     }
 
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::
+    fill_random(random_generator& rng_) {
+        rng_.fill_uniform(_array, SIZE, 0.0, double(std::numeric_limits< T >::max()));
+    }
+
+    VMML_TEMPLATE_STRING
+    void
+    VMML_TEMPLATE_CLASSNAME::
+    fill_random_signed(random_generator& rng_) {
+        const double half = double(std::numeric_limits< T >::max() / 2);
+        rng_.fill_uniform(_array, SIZE, -half, half);
+    }
+
     VMML_TEMPLATE_STRING
     void
     VMML_TEMPLATE_CLASSNAME::
@@ -1462,52 +1485,26 @@ namespace vmml {
 
     VMML_TEMPLATE_STRING
     double
-    VMML_TEMPLATE_CLASSNAME::frobenius_norm(const tensor3< I1, I2, I3, T>& other_) const {
-        double f_norm = 0.0;
-        T abs_diff = 0;
-        const_iterator it = begin(), it_end = end();
-        const_iterator it_other = other_.begin();
-        for (; it != it_end; ++it, ++it_other) {
-            abs_diff = fabs(*it - *it_other);
-            f_norm += abs_diff * abs_diff;
-        }
+    VMML_TEMPLATE_CLASSNAME::dot(const tensor3< I1, I2, I3, T>& other_) const {
+        return kernels::dot(_array, other_._array, SIZE);
+    }
 
-        return sqrt(f_norm);
+    VMML_TEMPLATE_STRING
+    double
+    VMML_TEMPLATE_CLASSNAME::frobenius_norm(const tensor3< I1, I2, I3, T>& other_) const {
+        return kernels::distance(_array, other_._array, SIZE);
     }
 
     VMML_TEMPLATE_STRING
     double
     VMML_TEMPLATE_CLASSNAME::frobenius_norm() const {
-        double f_norm = 0.0;
-#if 0
-        const_iterator it = begin(), it_end = end();
-        for (; it != it_end; ++it)
-            f_norm += *it * *it;
-#else
-        for (long i3 = 0; i3 < long(I3); ++i3) {
-            for (long i1 = 0; i1 < long(I1); ++i1) {
-                long i2 = 0;
-                for (i2 = 0; i2 < long(I2); ++i2) {
-                    f_norm += at(i1, i2, i3) * at(i1, i2, i3);
-                }
-            }
-        }
-
-#endif
-
-        return sqrt(f_norm);
+        return kernels::norm(_array, SIZE);
     }
 
     VMML_TEMPLATE_STRING
     double
     VMML_TEMPLATE_CLASSNAME::avg_frobenius_norm() const {
-        double af_norm = 0.0;
-        const_iterator it = begin(), it_end = end();
-        for (; it != it_end; ++it)
-            af_norm += *it * *it;
-
-        af_norm /= size();
-        return sqrt(af_norm);
+        return sqrt(kernels::squared_norm(_array, SIZE) / size());
     }
 
     VMML_TEMPLATE_STRING
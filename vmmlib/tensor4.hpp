@@ -129,6 +129,9 @@ namespace vmml
         //if seed is 0 or greater srand( seed ) will be called with the given seed
         void fill_random( int seed = -1 );
         void fill_random_signed( int seed = -1 );
+        // same ranges, from the given generator (parallel and reproducible)
+        void fill_random( random_generator& rng_ );
+        void fill_random_signed( random_generator& rng_ );
         void fill_increasing_values( );
 
         const tensor4& operator=( const tensor4& source_ );
@@ -151,6 +154,9 @@ namespace vmml
         size_t nnz( const T& threshold_ ) const;
         void threshold( const T& threshold_value_ );
 
+        // inner product of the two tensors seen as vectors
+        double dot( const tensor4< I1, I2, I3, I4, T >& other ) const;
+
         //error computation
         double frobenius_norm() const;
         double frobenius_norm( const tensor4< I1, I2, I3, I4, T >& other ) const;
@@ -713,6 +719,21 @@ namespace vmml
             }
         }
 
+        VMML_TEMPLATE_STRING
+        void
+        VMML_TEMPLATE_CLASSNAME::fill_random( random_generator& rng_ )
+        {
+            rng_.fill_uniform( _array, SIZE, 0.0, double( (std::numeric_limits< T >::max)() ));
+        }
+
+        VMML_TEMPLATE_STRING
+        void
+        VMML_TEMPLATE_CLASSNAME::fill_random_signed( random_generator& rng_ )
+        {
+            const double half = double( (std::numeric_limits< T >::max)() / 2 );
+            rng_.fill_uniform( _array, SIZE, -half, half );
+        }
+
         VMML_TEMPLATE_STRING
         const VMML_TEMPLATE_CLASSNAME&
         VMML_TEMPLATE_CLASSNAME::operator=( const VMML_TEMPLATE_CLASSNAME& source_ )
@@ -1145,36 +1166,22 @@ namespace vmml
             }
         }
 
+        VMML_TEMPLATE_STRING
+        double
+        VMML_TEMPLATE_CLASSNAME::dot(const tensor4< I1, I2, I3, I4, T>& other_) const {
+            return kernels::dot(_array, other_._array, SIZE);
+        }
+
 		VMML_TEMPLATE_STRING
         double
         VMML_TEMPLATE_CLASSNAME::frobenius_norm() const {
-            double f_norm = 0.0;
-            for (long i3 = 0; i3 < long(I3); ++i3) {
-                for (long i4 = 0; i4 < long(I4); ++i4) {
-                    for (long i1 = 0; i1 < long(I1); ++i1) {
-                        long i2 = 0;
-                        for (i2 = 0; i2 < long(I2); ++i2) {
-                            f_norm += at(i1, i2, i3, i4) * at(i1, i2, i3, i4);
-                        }
-                    }
-                }
-            }
-            return sqrt(f_norm);
+            return kernels::norm(_array, SIZE);
         }
 
         VMML_TEMPLATE_STRING
         double
         VMML_TEMPLATE_CLASSNAME::frobenius_norm(const tensor4< I1, I2, I3, I4, T>& other_) const {
-            double f_norm = 0.0;
-            T abs_diff = 0;
-            T *it = _array, *it_end = _array + I1*I2*I3*I4;
-            T *it_other = other_._array;
-            for (; it != it_end; ++it, ++it_other) {
-                abs_diff = fabs(*it - *it_other);
-                f_norm += abs_diff * abs_diff;
-            }
-
-            return sqrt(f_norm);
+            return kernels::distance(_array, other_._array, SIZE);
         }
 
         VMML_TEMPLATE_STRING
@@ -41,6 +41,8 @@
 #define __VMML__TUCK3_EXPORTER__HPP__
 
 #include <vmmlib/qtucker3_tensor.hpp>
+#include <vmmlib/t3_bitplane_coder.hpp>
+#include <stdint.h>
 
 
 /* FIXME:
@@ -79,6 +81,8 @@ namespace vmml
 		typedef typename u3_type::const_iterator u3_const_iterator;
 		
 		typedef tensor3< R1, R2, R3, char > t3_core_signs_type;
+		typedef tensor3< R1, R2, R3, T_internal > t3_core_comp_type;
+		typedef t3_bitplane_coder< R1, R2, R3, T_internal > core_coder_type;
 		
 		template< typename T >
 		static void export_to( std::vector< T >& data_, tucker3_type& tuck3_data_ );
@@ -94,6 +98,17 @@ namespace vmml
 		//use this version for the ttm export/import (core: backward cyclic), without plain hot value 
 		static void export_ttm_quantized_to(  std::vector<unsigned char>& data_out_, qtucker3_type& tuck3_data_   );
 		
+		//like export_hot_quantized_to, but with one min/max range per column of u1-u3
+		//(or per block of block_rows_ rows): allows 8bit basis matrices at equal error.
+		//block_rows_ is stored in the header as uint32_t, 0 as max( I1, I2, I3 )
+		static void export_column_quantized_to(  std::vector<unsigned char>& data_out_, qtucker3_type& tuck3_data_, size_t block_rows_ = 0 );
+		
+		//progressive version: basis matrices and hot value first, then the core in bit-planes
+		//(hot-first order), any prefix that contains the basis matrices can be imported
+		static void export_progressive_to(  std::vector<unsigned char>& data_out_, qtucker3_type& tuck3_data_, size_t n_bitplanes_ = 16 );
+		
+		static size_t get_progressive_header_size();
+		
 	
 	}; //end tucker3 exporter class
 	
@@ -385,6 +400,147 @@ VMML_TEMPLATE_CLASSNAME::export_ttm_quantized_to( std::vector<unsigned char>& da
 	delete u3;
 }
 	
+VMML_TEMPLATE_STRING
+void
+VMML_TEMPLATE_CLASSNAME::export_column_quantized_to( std::vector<unsigned char>& data_out_, qtucker3_type& tuck3_data_, size_t block_rows_ )
+{
+	tuck3_data_.enable_quantify_hot();
+	//quantize tucker3 components (u1-u3 and core)
+	std::vector< T_internal > u1_ranges, u2_ranges, u3_ranges;
+	tuck3_data_.quantize_basis_matrices_per_column( u1_ranges, u2_ranges, u3_ranges, block_rows_ );
+	
+	T_internal core_min, core_max;
+	tuck3_data_.quantize_core( core_min, core_max );
+	
+	size_t len_t_comp = sizeof( T_internal );
+	size_t len_ranges = ( u1_ranges.size() + u2_ranges.size() + u3_ranges.size() ) * len_t_comp;
+	size_t len_export_data = R1*R2*R3 + (R1*I1 + R2*I2 + R3*I3) * sizeof(T_coeff) + sizeof( uint32_t ) + 2 * len_t_comp + len_ranges;
+	data_out_.resize( len_export_data );
+	unsigned char* data = &data_out_[0];
+	size_t end_data = 0;
+	
+	//block size of the ranges, so that the importer needs no parameter.
+	//one block per column (0 or more than I_max rows) is stored as I_max
+	const size_t I_max = (std::max)( I1, (std::max)( I2, I3 ));
+	uint32_t block_rows = uint32_t( block_rows_ == 0 || block_rows_ > I_max ? I_max : block_rows_ );
+	memcpy( data + end_data, &block_rows, sizeof( uint32_t ) ); end_data += sizeof( uint32_t );
+	
+	//copy min-max values per column (block) of u1-u3
+	memcpy( data + end_data, &u1_ranges[0], u1_ranges.size() * len_t_comp ); end_data += u1_ranges.size() * len_t_comp;
+	memcpy( data + end_data, &u2_ranges[0], u2_ranges.size() * len_t_comp ); end_data += u2_ranges.size() * len_t_comp;
+	memcpy( data + end_data, &u3_ranges[0], u3_ranges.size() * len_t_comp ); end_data += u3_ranges.size() * len_t_comp;
+	
+	//core_min is always zero in log quant
+	memcpy( data + end_data, &core_max, len_t_comp ); end_data += len_t_comp;
+	
+	u1_type* u1 = new u1_type;
+	u2_type* u2 = new u2_type;
+	u3_type* u3 = new u3_type;
+	t3_core_type core;
+	t3_core_signs_type signs;
+	
+	tuck3_data_.get_u1( *u1 );
+	tuck3_data_.get_u2( *u2 );
+	tuck3_data_.get_u3( *u3 );
+	tuck3_data_.get_core( core );
+	tuck3_data_.get_core_signs( signs );
+	T_internal hottest_value = tuck3_data_.get_hottest_value();
+	
+	//copy first value of core tensor separately as a float
+	memcpy( data + end_data, &hottest_value, len_t_comp ); end_data += len_t_comp;
+	
+	//copy data for u1
+	size_t len_u1 = I1 * R1 * sizeof( T_coeff );
+	memcpy( data + end_data, *u1, len_u1 ); end_data += len_u1;
+	
+	//copy data for u2
+	size_t len_u2 = I2 * R2 * sizeof( T_coeff );
+	memcpy( data + end_data, *u2, len_u2 ); end_data += len_u2;
+	
+	//copy data for u3
+	size_t len_u3 = I3 * R3 * sizeof( T_coeff );
+	memcpy( data + end_data, *u3, len_u3 ); end_data += len_u3;
+	
+	//copy data for core: 1 bit for sign and 7 bit for values, colume-first iteration
+	for (size_t r3 = 0; r3 < R3; ++r3 ) {
+		for (size_t r2 = 0; r2 < R2; ++r2 ) {
+			for (size_t r1 = 0; r1 < R1; ++r1 ) {
+				data[end_data] = (core.at( r1, r2, r3 ) | (signs.at( r1, r2, r3) * 0x80 ));
+				++end_data;
+			}
+		}
+	}
+	
+	delete u1;
+	delete u2;
+	delete u3;
+}
+	
+VMML_TEMPLATE_STRING
+size_t
+VMML_TEMPLATE_CLASSNAME::get_progressive_header_size()
+{
+	//u_min, u_max, hottest value, core max, number of bit-planes, u1-u3
+	return 5 * sizeof( T_internal ) + (R1*I1 + R2*I2 + R3*I3) * sizeof(T_coeff);
+}
+
+VMML_TEMPLATE_STRING
+void
+VMML_TEMPLATE_CLASSNAME::export_progressive_to( std::vector<unsigned char>& data_out_, qtucker3_type& tuck3_data_, size_t n_bitplanes_ )
+{
+	tuck3_data_.enable_quantify_hot();
+	//quantize basis matrices, the core is coded from its unquantized values
+	T_internal u_min, u_max;
+	tuck3_data_.quantize_basis_matrices( u_min, u_max );
+	
+	t3_core_comp_type core;
+	tuck3_data_.get_core_comp( core );
+	//the hot core quantization moves the first core value to the hottest value
+	T_internal hottest_value = core.at( 0, 0, 0 );
+	if ( hottest_value == 0 )
+		hottest_value = tuck3_data_.get_hottest_value();
+	core.at( 0, 0, 0 ) = 0;
+	T_internal core_max = core_coder_type::get_max_abs( core );
+	T_internal n_bitplanes = T_internal( n_bitplanes_ );
+	
+	std::vector<unsigned char> core_bits;
+	core_coder_type::encode( core, core_max, n_bitplanes_, core_bits );
+	
+	size_t len_t_comp = sizeof( T_internal );
+	size_t len_header = get_progressive_header_size();
+	data_out_.resize( len_header + core_bits.size() );
+	unsigned char* data = &data_out_[0];
+	size_t end_data = 0;
+	
+	memcpy( data + end_data, &u_min, len_t_comp ); end_data += len_t_comp;
+	memcpy( data + end_data, &u_max, len_t_comp ); end_data += len_t_comp;
+	memcpy( data + end_data, &hottest_value, len_t_comp ); end_data += len_t_comp;
+	memcpy( data + end_data, &core_max, len_t_comp ); end_data += len_t_comp;
+	memcpy( data + end_data, &n_bitplanes, len_t_comp ); end_data += len_t_comp;
+	
+	u1_type* u1 = new u1_type;
+	u2_type* u2 = new u2_type;
+	u3_type* u3 = new u3_type;
+	tuck3_data_.get_u1( *u1 );
+	tuck3_data_.get_u2( *u2 );
+	tuck3_data_.get_u3( *u3 );
+	
+	size_t len_u1 = I1 * R1 * sizeof( T_coeff );
+	memcpy( data + end_data, *u1, len_u1 ); end_data += len_u1;
+	size_t len_u2 = I2 * R2 * sizeof( T_coeff );
+	memcpy( data + end_data, *u2, len_u2 ); end_data += len_u2;
+	size_t len_u3 = I3 * R3 * sizeof( T_coeff );
+	memcpy( data + end_data, *u3, len_u3 ); end_data += len_u3;
+	
+	//core bit-planes
+	if ( ! core_bits.empty() )
+		memcpy( data + end_data, &core_bits[0], core_bits.size() );
+	
+	delete u1;
+	delete u2;
+	delete u3;
+}
+	
 #undef VMML_TEMPLATE_STRING
 #undef VMML_TEMPLATE_CLASSNAME
 
@@ -41,6 +41,8 @@
 #define __VMML__TUCK3_IMPORTER__HPP__
 
 #include <vmmlib/qtucker3_tensor.hpp>
+#include <vmmlib/t3_bitplane_coder.hpp>
+#include <stdint.h>
 
 /* FIXME:
  *
@@ -80,6 +82,8 @@ namespace vmml
 		typedef matrix< R1, R2, T_coeff > front_core_slice_type; //fwd: forward cylcling (after kiers et al., 2000)
 
 		typedef tensor3< R1, R2, R3, char > t3_core_signs_type;
+		typedef tensor3< R1, R2, R3, T_internal > t3_core_comp_type;
+		typedef t3_bitplane_coder< R1, R2, R3, T_internal > core_coder_type;
 		
 		template< typename T >
 		static void import_from( const std::vector< T >& data_, tucker3_type& tuck3_data_ );
@@ -95,6 +99,17 @@ namespace vmml
 		//use this version for the ttm export/import (core: backward cyclic), without plain hot value 
 		static void import_ttm_quantized_from( const std::vector<unsigned char>& data_in_, qtucker3_type& tuck3_data_  );
 		
+		//counterpart of export_column_quantized_to, the block size is read from the header
+		static void import_column_quantized_from( const std::vector<unsigned char>& data_in_, qtucker3_type& tuck3_data_ );
+		
+		//counterpart of export_progressive_to: data_in_ may be any prefix that contains the basis matrices,
+		//the core is reconstructed from the bit-planes received so far (use reconstruct_dequantized)
+		static void import_progressive_from( const std::vector<unsigned char>& data_in_, qtucker3_type& tuck3_data_ );
+		//incremental version: decoder_ keeps the decoding state, call again with the same
+		//tuck3_data_ as more bytes arrive; the basis matrices are read and dequantized only
+		//on the first call (uninitialized decoder_)
+		static void import_progressive_from( const std::vector<unsigned char>& data_in_, qtucker3_type& tuck3_data_, core_coder_type& decoder_ );
+		
 		
 	}; //end tucker3 importer class
 	
@@ -401,6 +416,155 @@ VMML_TEMPLATE_CLASSNAME::import_ttm_quantized_from( const std::vector<unsigned c
 	delete u3;	
 }
 	
+VMML_TEMPLATE_STRING
+void
+VMML_TEMPLATE_CLASSNAME::import_column_quantized_from( const std::vector<unsigned char>& data_in_, qtucker3_type& tuck3_data_ )
+{
+	tuck3_data_.enable_quantify_hot();
+	size_t end_data = 0;
+	size_t len_t_comp = sizeof( T_internal );
+	
+	if ( data_in_.size() < sizeof( uint32_t ) )
+		VMMLIB_ERROR( "import_column_quantized_from: input data is too short", VMMLIB_HERE );
+	const unsigned char* data = &data_in_[0];
+	uint32_t block_rows = 0;
+	memcpy( &block_rows, data + end_data, sizeof( uint32_t ) ); end_data += sizeof( uint32_t );
+	const size_t I_max = (std::max)( I1, (std::max)( I2, I3 ));
+	if ( block_rows == 0 || block_rows > I_max )
+		VMMLIB_ERROR( "import_column_quantized_from: invalid block size", VMMLIB_HERE );
+	const size_t block_rows_ = block_rows;
+	
+	std::vector< T_internal > u1_ranges( 2 * R1 * u1_type::get_number_of_column_blocks( block_rows_ ));
+	std::vector< T_internal > u2_ranges( 2 * R2 * u2_type::get_number_of_column_blocks( block_rows_ ));
+	std::vector< T_internal > u3_ranges( 2 * R3 * u3_type::get_number_of_column_blocks( block_rows_ ));
+	size_t len_ranges = ( u1_ranges.size() + u2_ranges.size() + u3_ranges.size() ) * len_t_comp;
+	size_t len_export_data = R1*R2*R3 + (R1*I1 + R2*I2 + R3*I3) * sizeof(T_coeff) + sizeof( uint32_t ) + 2 * len_t_comp + len_ranges;
+	if ( data_in_.size() < len_export_data )
+		VMMLIB_ERROR( "import_column_quantized_from: input data is too short", VMMLIB_HERE );
+	
+	//copy min-max values per column (block) of u1-u3
+	memcpy( &u1_ranges[0], data + end_data, u1_ranges.size() * len_t_comp ); end_data += u1_ranges.size() * len_t_comp;
+	memcpy( &u2_ranges[0], data + end_data, u2_ranges.size() * len_t_comp ); end_data += u2_ranges.size() * len_t_comp;
+	memcpy( &u3_ranges[0], data + end_data, u3_ranges.size() * len_t_comp ); end_data += u3_ranges.size() * len_t_comp;
+	
+	T_internal core_min = 0; T_internal core_max = 0; //core_min is 0
+	memcpy( &core_max, data + end_data, len_t_comp ); end_data += len_t_comp;
+	//copy first value of core tensor separately as a float
+	T_internal hottest_value = 0;
+	memcpy( &hottest_value, data + end_data, len_t_comp ); end_data += len_t_comp;
+	tuck3_data_.set_hottest_value( hottest_value );
+	
+	u1_type* u1 = new u1_type;
+	u2_type* u2 = new u2_type;
+	u3_type* u3 = new u3_type;
+	t3_core_type core;
+	t3_core_signs_type signs;
+	
+	//copy data to u1
+	size_t len_u1 = I1 * R1 * sizeof( T_coeff );
+	memcpy( *u1, data + end_data, len_u1 ); end_data += len_u1;
+	
+	//copy data to u2
+	size_t len_u2 = I2 * R2 * sizeof( T_coeff );
+	memcpy( *u2, data + end_data, len_u2 ); end_data += len_u2;
+	
+	//copy data to u3
+	size_t len_u3 = I3 * R3 * sizeof( T_coeff );
+	memcpy( *u3, data + end_data, len_u3 ); end_data += len_u3;
+	
+	//copy data to core: 1 bit for sign and 7 bit for values
+	unsigned char core_el;
+	for (size_t r3 = 0; r3 < R3; ++r3 ) {
+		for (size_t r2 = 0; r2 < R2; ++r2 ) {
+			for (size_t r1 = 0; r1 < R1; ++r1 ) {
+				core_el = data[end_data];
+				signs.at( r1, r2, r3 ) = (core_el & 0x80)/128;
+				core.at( r1, r2, r3 ) = core_el & 0x7f ;
+				++end_data;
+			}
+		}
+	}
+	
+	tuck3_data_.set_u1( *u1 );
+	tuck3_data_.set_u2( *u2 );
+	tuck3_data_.set_u3( *u3 );
+	tuck3_data_.set_core( core );
+	tuck3_data_.set_core_signs( signs );
+	
+	//dequantize tucker3 components (u1-u3 and core)
+	tuck3_data_.dequantize_basis_matrices_per_column( u1_ranges, u2_ranges, u3_ranges, block_rows_ );
+	tuck3_data_.dequantize_core( core_min, core_max );
+	
+	delete u1;
+	delete u2;
+	delete u3;
+}
+	
+VMML_TEMPLATE_STRING
+void
+VMML_TEMPLATE_CLASSNAME::import_progressive_from( const std::vector<unsigned char>& data_in_, qtucker3_type& tuck3_data_ )
+{
+	core_coder_type decoder;
+	import_progressive_from( data_in_, tuck3_data_, decoder );
+}
+
+VMML_TEMPLATE_STRING
+void
+VMML_TEMPLATE_CLASSNAME::import_progressive_from( const std::vector<unsigned char>& data_in_, qtucker3_type& tuck3_data_, core_coder_type& decoder_ )
+{
+	tuck3_data_.enable_quantify_hot();
+	size_t end_data = 0;
+	size_t len_t_comp = sizeof( T_internal );
+	size_t len_header = 5 * len_t_comp + (R1*I1 + R2*I2 + R3*I3) * sizeof(T_coeff);
+	if ( data_in_.size() < len_header )
+		VMMLIB_ERROR( "import_progressive_from: input data is too short", VMMLIB_HERE );
+	const unsigned char* data = &data_in_[0];
+	
+	T_internal u_min = 0; T_internal u_max = 0;
+	memcpy( &u_min, data + end_data, len_t_comp ); end_data += len_t_comp;
+	memcpy( &u_max, data + end_data, len_t_comp ); end_data += len_t_comp;
+	T_internal hottest_value = 0; T_internal core_max = 0; T_internal n_bitplanes = 0;
+	memcpy( &hottest_value, data + end_data, len_t_comp ); end_data += len_t_comp;
+	memcpy( &core_max, data + end_data, len_t_comp ); end_data += len_t_comp;
+	memcpy( &n_bitplanes, data + end_data, len_t_comp ); end_data += len_t_comp;
+	
+	//the basis matrices are complete in every prefix: dequantize them once
+	if ( ! decoder_.is_initialized() )
+	{
+		tuck3_data_.set_hottest_value( hottest_value );
+		
+		u1_type* u1 = new u1_type;
+		u2_type* u2 = new u2_type;
+		u3_type* u3 = new u3_type;
+		
+		size_t len_u1 = I1 * R1 * sizeof( T_coeff );
+		memcpy( *u1, data + end_data, len_u1 ); end_data += len_u1;
+		size_t len_u2 = I2 * R2 * sizeof( T_coeff );
+		memcpy( *u2, data + end_data, len_u2 ); end_data += len_u2;
+		size_t len_u3 = I3 * R3 * sizeof( T_coeff );
+		memcpy( *u3, data + end_data, len_u3 ); end_data += len_u3;
+		
+		tuck3_data_.set_u1( *u1 );
+		tuck3_data_.set_u2( *u2 );
+		tuck3_data_.set_u3( *u3 );
+		tuck3_data_.dequantize_basis_matrices( u_min, u_max, u_min, u_max, u_min, u_max );
+		
+		delete u1;
+		delete u2;
+		delete u3;
+		
+		decoder_.init( core_max, size_t( n_bitplanes ) );
+	}
+	
+	//decode the core bit-planes received so far (only the new ones for a running decoder)
+	decoder_.decode( data + len_header, data_in_.size() - len_header );
+	
+	t3_core_comp_type core;
+	decoder_.get_core( core );
+	core.at( 0, 0, 0 ) = hottest_value;
+	tuck3_data_.set_core_comp( core );
+}
+	
 #undef VMML_TEMPLATE_STRING
 #undef VMML_TEMPLATE_CLASSNAME
 
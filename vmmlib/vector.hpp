@@ -37,6 +37,7 @@
 #include <vmmlib/math.hpp>
 #include <vmmlib/enable_if.hpp>
 #include <vmmlib/exception.hpp>
+#include <vmmlib/random.hpp>
 
 #include <iostream>
 #include <iomanip>
@@ -237,6 +238,8 @@ public:
     //if seed is set to -1, srand( seed ) was set outside set_random
     //otherwise srand( seed ) will be called with the given seed
     void set_random( int seed = -1 );
+    // uniform in [-1, 1), reproducible and independent of rand()
+    void set_random( random_generator& rng_ );
 
     inline T length() const;
     inline T squared_length() const;
@@ -1776,6 +1779,13 @@ vector< M, T >::set_random( int seed )
     }
 }
 
+template< size_t M, typename T >
+void
+vector< M, T >::set_random( random_generator& rng_ )
+{
+    rng_.fill_uniform( array, M, -1.0, 1.0 );
+}
+
 
 } // namespace vmml
 
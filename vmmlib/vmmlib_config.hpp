@@ -73,4 +73,13 @@ typedef SSIZE_T ssize_t;
 #  define VMMLIB_ALIGN( var ) var
 #endif
 
+// storage class of thread-local variables of POD type
+#ifdef __GNUC__
+#  define VMMLIB_THREAD_LOCAL __thread
+#elif defined WIN32
+#  define VMMLIB_THREAD_LOCAL __declspec (thread)
+#elif __cplusplus >= 201103L
+#  define VMMLIB_THREAD_LOCAL thread_local
+#endif
+
 #endif